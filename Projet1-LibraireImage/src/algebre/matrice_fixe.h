@@ -0,0 +1,317 @@
+/****************************************************************************************
+    MATRICE_FIXE.H
+
+    Ce module contient des matrices et des vecteurs de taille fixe (3, 4 et 8)
+    pour les petits calculs geometriques faits par pixel (homographies,
+    transformations affines, etc.).
+
+    Contrairement aux tableaux 2D de tableau2d.h, les elements sont ranges
+    directement dans la structure: une matrice peut donc etre declaree sur la
+    pile, sans aucune allocation. Toutes les dimensions sont des constantes,
+    ce qui permet au compilateur de derouler les boucles. Les operations 3 x 3
+    (determinant, inverse) sont ecrites explicitement.
+
+    Chaque dimension N definit les types t_matrice<N> et t_vecteur<N> ainsi que
+    les sous-programmes suivants:
+      - matrice<N>_identite         : Initialise une matrice identite;
+      - matrice<N>_multiplier       : Produit de deux matrices;
+      - matrice<N>_appliquer        : Produit d'une matrice et d'un vecteur;
+      - matrice<N>_determinant      : Determinant d'une matrice;
+      - matrice<N>_inverser         : Inverse d'une matrice;
+      - matrice<N>_depuis_tableau2d : Copie d'un tableau 2D (double**) vers une matrice;
+      - matrice<N>_vers_tableau2d   : Copie d'une matrice vers un tableau 2D (double**).
+
+    Le module ajoute aussi matrice3_transformer_point, qui applique une
+    homographie 3 x 3 a un point (x, y).
+
+*****************************************************************************************/
+#ifndef MATRICE_FIXE
+#define MATRICE_FIXE
+
+#include "solveur.h"
+
+#include <math.h>
+
+
+/****************************************************************************************
+*                               DEFINTION DES CONSTANTES                                *
+****************************************************************************************/
+
+/*
+    DEFINIR_MATRICE_FIXE
+
+    Definit les types t_matrice<N> et t_vecteur<N> et les operations qui ne
+    dependent pas d'une formule particuliere a la dimension.
+*/
+#define DEFINIR_MATRICE_FIXE(N)                                                         \
+                                                                                        \
+typedef struct                                                                          \
+{                                                                                       \
+    double m[N][N];                                                                     \
+}t_matrice##N;                                                                          \
+                                                                                        \
+typedef struct                                                                          \
+{                                                                                       \
+    double v[N];                                                                        \
+}t_vecteur##N;                                                                          \
+                                                                                        \
+static inline void matrice##N##_identite(t_matrice##N* a)                               \
+{                                                                                       \
+    int i, j;                                                                           \
+    for(i = 0; i < N; i++)                                                              \
+        for(j = 0; j < N; j++)                                                          \
+            a->m[i][j] = (i == j) ? 1.0 : 0.0;                                          \
+}                                                                                       \
+                                                                                        \
+static inline void matrice##N##_multiplier(const t_matrice##N* a,                       \
+                                           const t_matrice##N* b,                       \
+                                           t_matrice##N* resultat)                      \
+{                                                                                       \
+    t_matrice##N produit;                                                               \
+    int i, j, k;                                                                        \
+    for(i = 0; i < N; i++)                                                              \
+    {                                                                                   \
+        for(j = 0; j < N; j++)                                                          \
+            produit.m[i][j] = 0;                                                        \
+        for(k = 0; k < N; k++)                                                          \
+            for(j = 0; j < N; j++)                                                      \
+                produit.m[i][j] += a->m[i][k] * b->m[k][j];                             \
+    }                                                                                   \
+    *resultat = produit;                                                                \
+}                                                                                       \
+                                                                                        \
+static inline void matrice##N##_appliquer(const t_matrice##N* a,                        \
+                                          const t_vecteur##N* x,                        \
+                                          t_vecteur##N* resultat)                       \
+{                                                                                       \
+    t_vecteur##N produit;                                                               \
+    int i, j;                                                                           \
+    for(i = 0; i < N; i++)                                                              \
+    {                                                                                   \
+        produit.v[i] = 0;                                                               \
+        for(j = 0; j < N; j++)                                                          \
+            produit.v[i] += a->m[i][j] * x->v[j];                                       \
+    }                                                                                   \
+    *resultat = produit;                                                                \
+}                                                                                       \
+                                                                                        \
+static inline void matrice##N##_depuis_tableau2d(double** tableau, t_matrice##N* a)     \
+{                                                                                       \
+    int i, j;                                                                           \
+    for(i = 0; i < N; i++)                                                              \
+        for(j = 0; j < N; j++)                                                          \
+            a->m[i][j] = tableau[i][j];                                                 \
+}                                                                                       \
+                                                                                        \
+static inline void matrice##N##_vers_tableau2d(const t_matrice##N* a, double** tableau) \
+{                                                                                       \
+    int i, j;                                                                           \
+    for(i = 0; i < N; i++)                                                              \
+        for(j = 0; j < N; j++)                                                          \
+            tableau[i][j] = a->m[i][j];                                                 \
+}
+
+
+/*
+    DEFINIR_INVERSION_FIXE
+
+    Definit le determinant (elimination de Gauss) et l'inverse (Gauss-Jordan)
+    avec pivot partiel pour une dimension N.
+*/
+#define DEFINIR_INVERSION_FIXE(N)                                                       \
+                                                                                        \
+static inline double matrice##N##_determinant(const t_matrice##N* a)                    \
+{                                                                                       \
+    t_matrice##N lu = *a;                                                               \
+    double determinant = 1.0;                                                           \
+    double facteur, temporaire;                                                         \
+    int i, j, k, pivot;                                                                 \
+    for(k = 0; k < N; k++)                                                              \
+    {                                                                                   \
+        pivot = k;                                                                      \
+        for(i = k + 1; i < N; i++)                                                      \
+            if(fabs(lu.m[i][k]) > fabs(lu.m[pivot][k]))                                 \
+                pivot = i;                                                              \
+        if(lu.m[pivot][k] == 0)                                                         \
+            return 0;                                                                   \
+        if(pivot != k)                                                                  \
+        {                                                                               \
+            for(j = 0; j < N; j++)                                                      \
+            {                                                                           \
+                temporaire       = lu.m[k][j];                                          \
+                lu.m[k][j]       = lu.m[pivot][j];                                      \
+                lu.m[pivot][j]   = temporaire;                                          \
+            }                                                                           \
+            determinant = -determinant;                                                 \
+        }                                                                               \
+        determinant *= lu.m[k][k];                                                      \
+        for(i = k + 1; i < N; i++)                                                      \
+        {                                                                               \
+            facteur = lu.m[i][k] / lu.m[k][k];                                          \
+            for(j = k + 1; j < N; j++)                                                  \
+                lu.m[i][j] -= facteur * lu.m[k][j];                                     \
+        }                                                                               \
+    }                                                                                   \
+    return determinant;                                                                 \
+}                                                                                       \
+                                                                                        \
+static inline int matrice##N##_inverser(const t_matrice##N* a, t_matrice##N* inverse)   \
+{                                                                                       \
+    t_matrice##N copie = *a;                                                            \
+    t_matrice##N resultat;                                                              \
+    double facteur, temporaire;                                                         \
+    int i, j, k, pivot;                                                                 \
+    matrice##N##_identite(&resultat);                                                   \
+    for(k = 0; k < N; k++)                                                              \
+    {                                                                                   \
+        pivot = k;                                                                      \
+        for(i = k + 1; i < N; i++)                                                      \
+            if(fabs(copie.m[i][k]) > fabs(copie.m[pivot][k]))                           \
+                pivot = i;                                                              \
+        if(fabs(copie.m[pivot][k]) < EPSILON_PIVOT)                                     \
+            return 0;                                                                   \
+        if(pivot != k)                                                                  \
+        {                                                                               \
+            for(j = 0; j < N; j++)                                                      \
+            {                                                                           \
+                temporaire          = copie.m[k][j];                                    \
+                copie.m[k][j]       = copie.m[pivot][j];                                \
+                copie.m[pivot][j]   = temporaire;                                       \
+                temporaire          = resultat.m[k][j];                                 \
+                resultat.m[k][j]    = resultat.m[pivot][j];                             \
+                resultat.m[pivot][j]= temporaire;                                       \
+            }                                                                           \
+        }                                                                               \
+        facteur = 1.0 / copie.m[k][k];                                                  \
+        for(j = 0; j < N; j++)                                                          \
+        {                                                                               \
+            copie.m[k][j]    *= facteur;                                                \
+            resultat.m[k][j] *= facteur;                                                \
+        }                                                                               \
+        for(i = 0; i < N; i++)                                                          \
+        {                                                                               \
+            if(i == k)                                                                  \
+                continue;                                                               \
+            facteur = copie.m[i][k];                                                    \
+            for(j = 0; j < N; j++)                                                      \
+            {                                                                           \
+                copie.m[i][j]    -= facteur * copie.m[k][j];                            \
+                resultat.m[i][j] -= facteur * resultat.m[k][j];                         \
+            }                                                                           \
+        }                                                                               \
+    }                                                                                   \
+    *inverse = resultat;                                                                \
+    return 1;                                                                           \
+}
+
+
+/****************************************************************************************
+*                       DECLARATION DES FONCTIONS PUBLIQUES                             *
+****************************************************************************************/
+
+DEFINIR_MATRICE_FIXE(3)
+DEFINIR_MATRICE_FIXE(4)
+DEFINIR_MATRICE_FIXE(8)
+
+DEFINIR_INVERSION_FIXE(4)
+DEFINIR_INVERSION_FIXE(8)
+
+
+/*
+    MATRICE3_DETERMINANT
+
+    Cette fonction calcule le determinant d'une matrice 3 x 3 par un
+    developpement en cofacteurs selon la premiere ligne.
+
+    Parametres:
+        - [t_matrice3*] a : La matrice.
+
+    Retour:
+        Le determinant de la matrice.
+*/
+static inline double matrice3_determinant(const t_matrice3* a)
+{
+    return a->m[0][0] * (a->m[1][1] * a->m[2][2] - a->m[1][2] * a->m[2][1])
+         - a->m[0][1] * (a->m[1][0] * a->m[2][2] - a->m[1][2] * a->m[2][0])
+         + a->m[0][2] * (a->m[1][0] * a->m[2][1] - a->m[1][1] * a->m[2][0]);
+}
+
+
+
+/*
+    MATRICE3_INVERSER
+
+    Cette fonction calcule l'inverse d'une matrice 3 x 3 par la matrice des
+    cofacteurs.
+
+    Parametres:
+        - [t_matrice3*] a       : La matrice a inverser.
+        - [t_matrice3*] inverse : Recoit l'inverse (peut etre la meme que a).
+
+    Retour:
+        1 si la matrice est inversible, 0 sinon.
+*/
+static inline int matrice3_inverser(const t_matrice3* a, t_matrice3* inverse)
+{
+    t_matrice3 resultat;    // L'inverse, avant d'etre copie dans 'inverse'.
+    double determinant;     // Le determinant de la matrice.
+    double facteur;         // L'inverse du determinant.
+
+    determinant = matrice3_determinant(a);
+    if(fabs(determinant) < EPSILON_PIVOT)
+        return 0;
+
+    facteur = 1.0 / determinant;
+
+    resultat.m[0][0] =  (a->m[1][1] * a->m[2][2] - a->m[1][2] * a->m[2][1]) * facteur;
+    resultat.m[0][1] = -(a->m[0][1] * a->m[2][2] - a->m[0][2] * a->m[2][1]) * facteur;
+    resultat.m[0][2] =  (a->m[0][1] * a->m[1][2] - a->m[0][2] * a->m[1][1]) * facteur;
+    resultat.m[1][0] = -(a->m[1][0] * a->m[2][2] - a->m[1][2] * a->m[2][0]) * facteur;
+    resultat.m[1][1] =  (a->m[0][0] * a->m[2][2] - a->m[0][2] * a->m[2][0]) * facteur;
+    resultat.m[1][2] = -(a->m[0][0] * a->m[1][2] - a->m[0][2] * a->m[1][0]) * facteur;
+    resultat.m[2][0] =  (a->m[1][0] * a->m[2][1] - a->m[1][1] * a->m[2][0]) * facteur;
+    resultat.m[2][1] = -(a->m[0][0] * a->m[2][1] - a->m[0][1] * a->m[2][0]) * facteur;
+    resultat.m[2][2] =  (a->m[0][0] * a->m[1][1] - a->m[0][1] * a->m[1][0]) * facteur;
+
+    *inverse = resultat;
+    return 1;
+}
+
+
+
+/*
+    MATRICE3_TRANSFORMER_POINT
+
+    Cette procedure applique une homographie (ou une transformation affine
+    dont la derniere ligne est 0 0 1) au point (x, y).
+
+    Parametres:
+        - [t_matrice3*] h  : La transformation.
+        - [double     ] x  : L'abscisse du point.
+        - [double     ] y  : L'ordonnee du point.
+        - [double*    ] xt : Recoit l'abscisse du point transforme.
+        - [double*    ] yt : Recoit l'ordonnee du point transforme.
+
+    Retour:
+        Aucun.
+
+    Exemple d'utilisation:
+
+        t_matrice3 h;
+        double     xt, yt;
+
+        matrice3_depuis_tableau2d(homographie, &h);
+        matrice3_transformer_point(&h, colonne, ligne, &xt, &yt);
+*/
+static inline void matrice3_transformer_point(const t_matrice3* h, double x, double y,
+                                              double* xt, double* yt)
+{
+    double w;   // La coordonnee homogene du point transforme.
+
+    w   = h->m[2][0] * x + h->m[2][1] * y + h->m[2][2];
+    *xt = (h->m[0][0] * x + h->m[0][1] * y + h->m[0][2]) / w;
+    *yt = (h->m[1][0] * x + h->m[1][1] * y + h->m[1][2]) / w;
+}
+
+
+#endif
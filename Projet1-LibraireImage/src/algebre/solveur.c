@@ -0,0 +1,477 @@
+/****************************************************************************************
+    SOLVEUR.C
+
+    Ce module contient des sous-programmes qui permettent de resoudre des systemes
+    lineaires denses (LU, QR et moindres carres).
+****************************************************************************************/
+#include "solveur.h"
+#include "../outils/instrumentation.h"
+#include "../outils/memoire.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/****************************************************************************************
+*                               DEFINTION DES CONSTANTES                                *
+****************************************************************************************/
+
+// Les valeurs binaires.
+#define VRAI    1
+#define FAUX    0
+
+// Le type d'une fonction de resolution d'un petit systeme contigu.
+typedef int (*t_resolution_fixe)(double* a, double* b, double* x);
+
+
+/****************************************************************************************
+*                           DECLARATION DES FONCTIONS PRIVEES                           *
+****************************************************************************************/
+
+
+/*
+    COPIER_MATRICE
+
+    Cette fonction cree une copie d'une matrice. Les lignes de la copie sont
+    allouees dans un seul bloc, dont l'adresse est gardee apres le dernier
+    pointeur de ligne; la copie doit etre liberee avec liberer_copie.
+
+    Parametres:
+      - [double**] matrice     : La matrice a copier.
+      - [int     ] nb_lignes   : Le nombre de lignes de la matrice.
+      - [int     ] nb_colonnes : Le nombre de colonnes de la matrice.
+
+    Retour: La copie, ou NULL si la memoire manque.
+*/
+static double** copier_matrice(double** matrice, int nb_lignes, int nb_colonnes);
+
+
+
+/*
+    LIBERER_COPIE
+
+    Cette procedure libere une matrice creee par copier_matrice.
+
+    Parametres:
+      - [double**] copie     : La matrice a liberer.
+      - [int     ] nb_lignes : Le nombre de lignes de la matrice.
+
+    Retour: Aucun.
+*/
+static void liberer_copie(double** copie, int nb_lignes);
+
+
+
+/*
+    RESOUDRE_PETIT_SYSTEME
+
+    Cette fonction resout un systeme n x n contigu par elimination de Gauss avec
+    pivot partiel. Elle est destinee a etre appelee avec une dimension
+    constante afin que le compilateur deroule les boucles.
+
+    Parametres:
+      - [double*] a : La matrice n x n, ligne par ligne (modifiee).
+      - [double*] b : Le second membre (modifie).
+      - [double*] x : Recoit la solution.
+      - [int    ] n : La dimension du systeme.
+
+    Retour: 1 si le systeme a ete resolu, 0 si la matrice est singuliere.
+*/
+static inline int resoudre_petit_systeme(double* a, double* b, double* x, const int n);
+
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PUBLIQUES                            *
+****************************************************************************************/
+int decomposer_lu(double** matrice, int n, int* permutation)
+{
+    int     i, j, k;        // Iterateurs sur les lignes et les colonnes.
+    int     pivot;          // La ligne du pivot de la colonne courante.
+    double  maximum;        // La valeur absolue du plus grand pivot trouve.
+    double  facteur;        // Le multiplicateur de la ligne du pivot.
+    double* ligne;          // Pour echanger deux lignes.
+    int     indice;         // Pour echanger deux elements de la permutation.
+
+    for(i = 0; i < n; i++)
+        permutation[i] = i;
+
+    for(k = 0; k < n; k++)
+    {
+        // Chercher le plus grand pivot de la colonne.
+        pivot   = k;
+        maximum = fabs(matrice[k][k]);
+        for(i = k + 1; i < n; i++)
+        {
+            if(fabs(matrice[i][k]) > maximum)
+            {
+                maximum = fabs(matrice[i][k]);
+                pivot   = i;
+            }
+        }
+
+        if(maximum < EPSILON_PIVOT)
+            return FAUX;
+
+        // Echanger les lignes en permutant seulement les pointeurs.
+        if(pivot != k)
+        {
+            ligne            = matrice[k];
+            matrice[k]       = matrice[pivot];
+            matrice[pivot]   = ligne;
+
+            indice             = permutation[k];
+            permutation[k]     = permutation[pivot];
+            permutation[pivot] = indice;
+        }
+
+        // Eliminer la colonne sous le pivot.
+        for(i = k + 1; i < n; i++)
+        {
+            facteur = matrice[i][k] / matrice[k][k];
+            matrice[i][k] = facteur;
+
+            for(j = k + 1; j < n; j++)
+                matrice[i][j] -= facteur * matrice[k][j];
+        }
+    }
+
+    return VRAI;
+}
+
+
+
+void resoudre_lu(double** lu, int n, int* permutation, double* b, double* x)
+{
+    int    i, j;            // Iterateurs sur les lignes et les colonnes.
+    double somme;           // L'accumulation d'une substitution.
+
+    // Substitution avant: Ly = Pb (y est conserve dans x).
+    for(i = 0; i < n; i++)
+    {
+        somme = b[permutation[i]];
+        for(j = 0; j < i; j++)
+            somme -= lu[i][j] * x[j];
+        x[i] = somme;
+    }
+
+    // Substitution arriere: Ux = y.
+    for(i = n - 1; i >= 0; i--)
+    {
+        somme = x[i];
+        for(j = i + 1; j < n; j++)
+            somme -= lu[i][j] * x[j];
+        x[i] = somme / lu[i][i];
+    }
+}
+
+
+
+int resoudre_systeme(double** matrice, int n, double* b, double* x)
+{
+    int      a_ete_resolu;  // La reussite ou l'echec de la resolution.
+    double** lu;            // La copie de la matrice qui recevra les facteurs.
+    int*     permutation;   // La permutation des lignes.
+
+    INSTRUMENTER_DEBUT(ETAPE_RESOUDRE_SYSTEME);
+
+    a_ete_resolu = FAUX;
+
+    lu          = copier_matrice(matrice, n, n);
+    permutation = (int*) ALLOUER(n * sizeof(int));
+    INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 1);
+
+    if(lu != NULL && permutation != NULL && decomposer_lu(lu, n, permutation))
+    {
+        resoudre_lu(lu, n, permutation, b, x);
+        a_ete_resolu = VRAI;
+    }
+
+    liberer_copie(lu, n);
+    LIBERER(permutation);
+
+    INSTRUMENTER_FIN(ETAPE_RESOUDRE_SYSTEME);
+    INSTRUMENTER_COMPTER(COMPTEUR_SYSTEMES_RESOLUS, a_ete_resolu);
+
+    return a_ete_resolu;
+}
+
+
+
+int decomposer_qr(double** matrice, int nb_lignes, int nb_colonnes, double* tau)
+{
+    int    i, j, k;         // Iterateurs sur les lignes et les colonnes.
+    double norme;           // La norme de la colonne sous la diagonale.
+    double x0;              // L'element diagonal avant la reflexion.
+    double beta;            // L'element diagonal de R apres la reflexion.
+    double echelle;         // Pour normaliser le vecteur de Householder.
+    double somme;           // Le produit scalaire v'a d'une colonne.
+
+    for(k = 0; k < nb_colonnes; k++)
+    {
+        // Norme de la colonne k a partir de la diagonale.
+        norme = 0;
+        for(i = k; i < nb_lignes; i++)
+            norme += matrice[i][k] * matrice[i][k];
+        norme = sqrt(norme);
+
+        if(norme < EPSILON_PIVOT)
+            return FAUX;
+
+        // Construire la reflexion qui annule la colonne sous la diagonale.
+        x0     = matrice[k][k];
+        beta   = (x0 >= 0) ? -norme : norme;
+        tau[k] = (beta - x0) / beta;
+
+        echelle = 1.0 / (x0 - beta);
+        for(i = k + 1; i < nb_lignes; i++)
+            matrice[i][k] *= echelle;
+        matrice[k][k] = beta;
+
+        // Appliquer la reflexion aux colonnes restantes.
+        for(j = k + 1; j < nb_colonnes; j++)
+        {
+            somme = matrice[k][j];
+            for(i = k + 1; i < nb_lignes; i++)
+                somme += matrice[i][k] * matrice[i][j];
+            somme *= tau[k];
+
+            matrice[k][j] -= somme;
+            for(i = k + 1; i < nb_lignes; i++)
+                matrice[i][j] -= somme * matrice[i][k];
+        }
+    }
+
+    return VRAI;
+}
+
+
+
+int resoudre_moindres_carres(double** matrice, int nb_lignes, int nb_colonnes,
+                             double* b, double* x)
+{
+    int      a_ete_resolu;  // La reussite ou l'echec de la resolution.
+    double** qr;            // La copie de la matrice qui recevra les facteurs.
+    double*  tau;           // Les facteurs des reflexions.
+    double*  qtb;           // Le produit Q'b.
+    int      i, j, k;       // Iterateurs sur les lignes et les colonnes.
+    double   somme;         // L'accumulation d'un produit scalaire.
+
+    a_ete_resolu = FAUX;
+
+    if(nb_lignes < nb_colonnes)
+        return a_ete_resolu;
+
+    INSTRUMENTER_DEBUT(ETAPE_MOINDRES_CARRES);
+
+    qr  = copier_matrice(matrice, nb_lignes, nb_colonnes);
+    tau = (double*) ALLOUER(nb_colonnes * sizeof(double));
+    qtb = (double*) ALLOUER(nb_lignes * sizeof(double));
+    INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 2);
+
+    if(qr != NULL && tau != NULL && qtb != NULL &&
+       decomposer_qr(qr, nb_lignes, nb_colonnes, tau))
+    {
+        memcpy(qtb, b, nb_lignes * sizeof(double));
+
+        // Appliquer les reflexions au second membre: Q'b.
+        for(k = 0; k < nb_colonnes; k++)
+        {
+            somme = qtb[k];
+            for(i = k + 1; i < nb_lignes; i++)
+                somme += qr[i][k] * qtb[i];
+            somme *= tau[k];
+
+            qtb[k] -= somme;
+            for(i = k + 1; i < nb_lignes; i++)
+                qtb[i] -= somme * qr[i][k];
+        }
+
+        // Substitution arriere: Rx = (Q'b)[0..n-1].
+        for(i = nb_colonnes - 1; i >= 0; i--)
+        {
+            somme = qtb[i];
+            for(j = i + 1; j < nb_colonnes; j++)
+                somme -= qr[i][j] * x[j];
+            x[i] = somme / qr[i][i];
+        }
+
+        a_ete_resolu = VRAI;
+    }
+
+    liberer_copie(qr, nb_lignes);
+    LIBERER(tau);
+    LIBERER(qtb);
+
+    INSTRUMENTER_FIN(ETAPE_MOINDRES_CARRES);
+    INSTRUMENTER_COMPTER(COMPTEUR_SYSTEMES_RESOLUS, a_ete_resolu);
+
+    return a_ete_resolu;
+}
+
+
+
+// Les chemins de code de taille fixe du mode par lot.
+#define DEFINIR_RESOLUTION_FIXE(N)                                          \
+    static int resoudre_fixe_##N(double* a, double* b, double* x)           \
+    {                                                                       \
+        return resoudre_petit_systeme(a, b, x, N);                          \
+    }
+
+DEFINIR_RESOLUTION_FIXE(2)
+DEFINIR_RESOLUTION_FIXE(3)
+DEFINIR_RESOLUTION_FIXE(4)
+DEFINIR_RESOLUTION_FIXE(8)
+
+
+int resoudre_lot(double* matrices, double* b, double* x, int n, int nb_systemes,
+                 int* reussites)
+{
+    t_resolution_fixe resolution;   // Le chemin de taille fixe, s'il existe.
+    int               s;            // Iterateur sur les systemes.
+    int               a_reussi;     // Le resultat d'un systeme.
+    int               nb_resolus;   // Le nombre de systemes resolus.
+    long              taille;       // Le nombre d'elements d'une matrice.
+
+    switch(n)
+    {
+        case 2:  resolution = resoudre_fixe_2; break;
+        case 3:  resolution = resoudre_fixe_3; break;
+        case 4:  resolution = resoudre_fixe_4; break;
+        case 8:  resolution = resoudre_fixe_8; break;
+        default: resolution = NULL;            break;
+    }
+
+    INSTRUMENTER_DEBUT(ETAPE_RESOUDRE_LOT);
+
+    taille     = (long) n * n;
+    nb_resolus = 0;
+
+    for(s = 0; s < nb_systemes; s++)
+    {
+        if(resolution != NULL)
+            a_reussi = resolution(matrices + s * taille, b + s * n, x + s * n);
+        else
+            a_reussi = resoudre_petit_systeme(matrices + s * taille, b + s * n,
+                                                                     x + s * n, n);
+
+        if(reussites != NULL)
+            reussites[s] = a_reussi;
+
+        nb_resolus += a_reussi;
+    }
+
+    INSTRUMENTER_FIN(ETAPE_RESOUDRE_LOT);
+    INSTRUMENTER_COMPTER(COMPTEUR_SYSTEMES_RESOLUS, nb_resolus);
+
+    return nb_resolus;
+}
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PRIVEES                            *
+****************************************************************************************/
+
+
+static double** copier_matrice(double** matrice, int nb_lignes, int nb_colonnes)
+{
+    double** copie;     // La matrice a retourner.
+    double*  bloc;      // Le bloc qui contient toutes les lignes.
+    int      i;         // Iterateur sur les lignes.
+
+    copie = (double**) ALLOUER((nb_lignes + 1) * sizeof(double*));
+    bloc  = (double*)  ALLOUER((size_t) nb_lignes * nb_colonnes * sizeof(double));
+    INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 2);
+
+    if(copie == NULL || bloc == NULL)
+    {
+        LIBERER(copie);
+        LIBERER(bloc);
+        return NULL;
+    }
+
+    // Les decompositions peuvent permuter les lignes: le bloc est retrouve
+    // par ce pointeur, qui n'est jamais permute.
+    copie[nb_lignes] = bloc;
+    for(i = 0; i < nb_lignes; i++)
+    {
+        copie[i] = bloc + (size_t) i * nb_colonnes;
+        memcpy(copie[i], matrice[i], nb_colonnes * sizeof(double));
+    }
+
+    return copie;
+}
+
+
+static void liberer_copie(double** copie, int nb_lignes)
+{
+    if(copie == NULL)
+        return;
+
+    LIBERER(copie[nb_lignes]);
+    LIBERER(copie);
+}
+
+
+static inline int resoudre_petit_systeme(double* a, double* b, double* x, const int n)
+{
+    int    i, j, k;         // Iterateurs sur les lignes et les colonnes.
+    int    pivot;           // La ligne du pivot de la colonne courante.
+    double maximum;         // La valeur absolue du plus grand pivot trouve.
+    double facteur;         // Le multiplicateur de la ligne du pivot.
+    double temporaire;      // Pour echanger deux elements.
+    double somme;           // L'accumulation de la substitution arriere.
+
+    for(k = 0; k < n; k++)
+    {
+        // Chercher le plus grand pivot de la colonne.
+        pivot   = k;
+        maximum = fabs(a[k * n + k]);
+        for(i = k + 1; i < n; i++)
+        {
+            if(fabs(a[i * n + k]) > maximum)
+            {
+                maximum = fabs(a[i * n + k]);
+                pivot   = i;
+            }
+        }
+
+        if(maximum < EPSILON_PIVOT)
+            return FAUX;
+
+        // Echanger les lignes k et pivot.
+        if(pivot != k)
+        {
+            for(j = k; j < n; j++)
+            {
+                temporaire       = a[k * n + j];
+                a[k * n + j]     = a[pivot * n + j];
+                a[pivot * n + j] = temporaire;
+            }
+            temporaire = b[k];
+            b[k]       = b[pivot];
+            b[pivot]   = temporaire;
+        }
+
+        // Eliminer la colonne sous le pivot.
+        for(i = k + 1; i < n; i++)
+        {
+            facteur = a[i * n + k] / a[k * n + k];
+            for(j = k + 1; j < n; j++)
+                a[i * n + j] -= facteur * a[k * n + j];
+            b[i] -= facteur * b[k];
+        }
+    }
+
+    // Substitution arriere.
+    for(i = n - 1; i >= 0; i--)
+    {
+        somme = b[i];
+        for(j = i + 1; j < n; j++)
+            somme -= a[i * n + j] * x[j];
+        x[i] = somme / a[i * n + i];
+    }
+
+    return VRAI;
+}
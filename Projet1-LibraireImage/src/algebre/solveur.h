@@ -0,0 +1,198 @@
+/****************************************************************************************
+    SOLVEUR.H
+
+    Ce module contient des sous-programmes qui permettent de resoudre des systemes
+    lineaires denses. Les matrices sont des tableaux 2D crees avec creer_tableau2d
+    (voir tableau2d.h).
+
+    Les decompositions se font sur place: la matrice recue est ecrasee par ses
+    facteurs. Lorsque la matrice d'origine doit etre conservee, il faut en faire
+    une copie avant l'appel.
+
+    Le mode par lot travaille plutot sur des matrices contigues (ligne par ligne)
+    et utilise des chemins de code specialises pour les petites tailles
+    frequentes (2, 3, 4 et 8) afin que le compilateur puisse derouler les boucles.
+
+    Liste des sous-programmes publiques:
+      - decomposer_lu            : Decomposition LU avec pivot partiel;
+      - resoudre_lu              : Resolution a partir d'une decomposition LU;
+      - resoudre_systeme         : Resolution directe de Ax = b;
+      - decomposer_qr            : Decomposition QR par reflexions de Householder;
+      - resoudre_moindres_carres : Solution au sens des moindres carres de Ax = b;
+      - resoudre_lot             : Resolution d'un lot de petits systemes.
+
+*****************************************************************************************/
+#ifndef SOLVEUR
+#define SOLVEUR
+
+
+/****************************************************************************************
+*                               DEFINTION DES CONSTANTES                                *
+****************************************************************************************/
+
+// Un pivot plus petit que cette valeur (en valeur absolue) indique une matrice
+// singuliere.
+#define EPSILON_PIVOT   1e-12
+
+
+/****************************************************************************************
+*                       DECLARATION DES FONCTIONS PUBLIQUES                             *
+****************************************************************************************/
+
+
+/*
+    DECOMPOSER_LU
+
+    Cette fonction decompose une matrice carree A en PA = LU, avec pivot
+    partiel. La matrice est remplacee par ses facteurs: L (diagonale unitaire
+    implicite) sous la diagonale et U sur et au-dessus de la diagonale.
+
+    Les echanges de lignes se font en permutant les pointeurs de lignes du
+    tableau 2D, sans copier les donnees.
+
+    Parametres:
+        - [double**] matrice     : La matrice n x n a decomposer (modifiee).
+        - [int     ] n           : La dimension de la matrice.
+        - [int*    ] permutation : Un tableau de n entiers qui recevra, pour chaque
+                                   ligne de LU, l'indice de la ligne d'origine.
+
+    Retour:
+        1 si la decomposition a reussi, 0 si la matrice est singuliere.
+*/
+int decomposer_lu(double** matrice, int n, int* permutation);
+
+
+
+/*
+    RESOUDRE_LU
+
+    Cette procedure resout Ax = b a partir de la decomposition obtenue avec
+    decomposer_lu.
+
+    Parametres:
+        - [double**] lu          : Les facteurs retournes par decomposer_lu.
+        - [int     ] n           : La dimension du systeme.
+        - [int*    ] permutation : La permutation retournee par decomposer_lu.
+        - [double* ] b           : Le second membre (n elements, non modifie).
+        - [double* ] x           : Recoit la solution (n elements).
+
+    Retour:
+        Aucun.
+*/
+void resoudre_lu(double** lu, int n, int* permutation, double* b, double* x);
+
+
+
+/*
+    RESOUDRE_SYSTEME
+
+    Cette fonction resout le systeme carre Ax = b. La matrice A n'est pas
+    modifiee.
+
+    Parametres:
+        - [double**] matrice : La matrice n x n du systeme.
+        - [int     ] n       : La dimension du systeme.
+        - [double* ] b       : Le second membre (n elements).
+        - [double* ] x       : Recoit la solution (n elements).
+
+    Retour:
+        1 si le systeme a ete resolu, 0 si la matrice est singuliere.
+
+    Exemple d'utilisation:
+
+        double** a = creer_tableau2d(3, 3);
+        double b[3], x[3];
+
+        [ ... Remplir a et b ... ]
+
+        if(resoudre_systeme(a, 3, b, x))
+        {
+            [...]
+        }
+*/
+int resoudre_systeme(double** matrice, int n, double* b, double* x);
+
+
+
+/*
+    DECOMPOSER_QR
+
+    Cette fonction decompose une matrice A (nb_lignes >= nb_colonnes) en A = QR
+    a l'aide de reflexions de Householder. La matrice est remplacee par R sur
+    et au-dessus de la diagonale, et par les vecteurs de Householder (premiere
+    composante unitaire implicite) sous la diagonale.
+
+    Parametres:
+        - [double**] matrice     : La matrice a decomposer (modifiee).
+        - [int     ] nb_lignes   : Le nombre de lignes de la matrice.
+        - [int     ] nb_colonnes : Le nombre de colonnes de la matrice.
+        - [double* ] tau         : Un tableau de nb_colonnes elements qui recevra
+                                   le facteur d'echelle de chaque reflexion.
+
+    Retour:
+        1 si la matrice est de rang plein, 0 sinon.
+*/
+int decomposer_qr(double** matrice, int nb_lignes, int nb_colonnes, double* tau);
+
+
+
+/*
+    RESOUDRE_MOINDRES_CARRES
+
+    Cette fonction trouve x qui minimise ||Ax - b|| pour un systeme
+    surdetermine (nb_lignes >= nb_colonnes), a l'aide de la decomposition QR.
+    La matrice A et le vecteur b ne sont pas modifies.
+
+    Parametres:
+        - [double**] matrice     : La matrice du systeme.
+        - [int     ] nb_lignes   : Le nombre d'equations.
+        - [int     ] nb_colonnes : Le nombre d'inconnues.
+        - [double* ] b           : Le second membre (nb_lignes elements).
+        - [double* ] x           : Recoit la solution (nb_colonnes elements).
+
+    Retour:
+        1 si le systeme a ete resolu, 0 si la matrice n'est pas de rang plein.
+
+    Exemple d'utilisation (droite y = a*x + b passant par des points):
+
+        double** a = creer_tableau2d(nb_points, 2);
+        double*  y = creer_tableau1d(nb_points);
+        double   droite[2];
+
+        [ ... a[i][0] = x_i, a[i][1] = 1, y[i] = y_i ... ]
+
+        resoudre_moindres_carres(a, nb_points, 2, y, droite);
+*/
+int resoudre_moindres_carres(double** matrice, int nb_lignes, int nb_colonnes,
+                             double* b, double* x);
+
+
+
+/*
+    RESOUDRE_LOT
+
+    Cette fonction resout un lot de petits systemes carres independants de
+    meme dimension. Les matrices sont contigues, rangees ligne par ligne, les
+    unes a la suite des autres. Les dimensions 2, 3, 4 et 8 utilisent un chemin
+    de code de taille fixe.
+
+    Les matrices et les seconds membres recus sont utilises comme espace de
+    travail et sont donc modifies.
+
+    Parametres:
+        - [double*] matrices   : nb_systemes matrices n x n (modifiees).
+        - [double*] b          : nb_systemes vecteurs de n elements (modifies).
+        - [double*] x          : Recoit les nb_systemes solutions de n elements.
+        - [int    ] n          : La dimension de chaque systeme.
+        - [int    ] nb_systemes: Le nombre de systemes a resoudre.
+        - [int*   ] reussites  : Si non NULL, recoit 1 ou 0 pour chaque systeme
+                                 selon qu'il a ete resolu ou non.
+
+    Retour:
+        Le nombre de systemes resolus.
+*/
+int resoudre_lot(double* matrices, double* b, double* x, int n, int nb_systemes,
+                 int* reussites);
+
+
+#endif
@@ -0,0 +1,1533 @@
+/****************************************************************************************
+    BANC_ESSAI.C
+
+    Ce programme mesure le temps d'execution des sous-programmes de la librairie
+    (lire, ecrire, les deux conversions et les operations de tableau1d et
+    tableau2d) sur des images synthetiques de 64 x 64 jusqu'a 16384 x 16384.
+
+    Pour chaque operation et chaque taille, il rapporte le debit (Mo/s et
+    Mpix/s), les percentiles du temps d'execution et le nombre d'allocations
+    faites par appel. Lorsque la librairie est compilee avec
+    LIBRAIRIE_SUIVI_MEMOIRE, le maximum de memoire allouee par appel est aussi
+    rapporte. Un resume est affiche sur la sortie d'erreur et les
+    resultats complets sont ecrits dans un fichier JSON afin de suivre les
+    regressions d'une version a l'autre.
+
+    Les sous-programmes de tableau1d et tableau2d affichent leurs resultats: la
+    sortie standard est donc redirigee vers le peripherique nul pendant les
+    mesures.
+
+    Utilisation:
+        Projet1_BancEssai [-m taille_max] [-n repetitions_min] [-o fichier.json]
+                          [-d repertoire] [-t trace.json]
+
+      -m : La plus grande taille (cote de l'image) a mesurer. Defaut: 16384.
+      -n : Le nombre minimal de repetitions par mesure. Defaut: 5.
+      -o : Le fichier JSON a produire. Defaut: banc_essai.json.
+      -d : Le repertoire des fichiers .bmp temporaires. Defaut: repertoire courant.
+      -t : Le fichier de trace (Chrome trace-event) a produire lorsque la
+           librairie est compilee avec LIBRAIRIE_INSTRUMENTATION.
+
+****************************************************************************************/
+#include "image/bitmap.h"
+#include "image/bitmap_interne.h"
+#include "image/vue.h"
+#include "outils/chrono.h"
+#include "outils/instrumentation.h"
+#include "outils/memoire.h"
+#include "pipeline/localisation.h"
+#include "reconnaissance/cascade.h"
+#include "reconnaissance/gabarits.h"
+#include "reconnaissance/hog.h"
+#include "tableau/tableau1d.h"
+#include "tableau/tableau2d.h"
+#include "traitement/bilateral.h"
+#include "traitement/coins.h"
+#include "traitement/contours.h"
+#include "traitement/contraste.h"
+#include "traitement/correlation.h"
+#include "traitement/distance.h"
+#include "traitement/hough.h"
+#include "traitement/pyramide.h"
+#include "traitement/redimension.h"
+#include "traitement/transformation.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/****************************************************************************************
+*                               DEFINTION DES CONSTANTES                                *
+****************************************************************************************/
+
+// Les tailles (cote de l'image carree) mesurees.
+static const int TAILLES[] = { 64, 256, 1024, 4096, 16384 };
+#define NB_TAILLES      ((int) (sizeof(TAILLES) / sizeof(TAILLES[0])))
+
+// Les valeurs par defaut des options.
+#define TAILLE_MAX_DEFAUT           16384
+#define REPETITIONS_MIN_DEFAUT      5
+#define FICHIER_JSON_DEFAUT         "banc_essai.json"
+#define REPERTOIRE_DEFAUT           "."
+
+// Une mesure est repetee jusqu'a ce que ce temps total soit atteint, sans depasser
+// la duree maximale (preparation et nettoyage compris).
+#define DUREE_MIN_MESURE    0.5
+#define DUREE_MAX_MESURE    5.0
+#define REPETITIONS_MAX     1000
+
+// Le nombre d'octets dans un megaoctet et de pixels dans un megapixel.
+#define OCTETS_PAR_MO       (1024.0 * 1024.0)
+#define PIXELS_PAR_MPIX     1e6
+
+// Le nombre de bits par pixel des conversions mesurees (RGB) et des fichiers
+// ecrits par ecrire (gris avec palette).
+#define NB_BITS_IMAGE       24
+#define NB_BITS_FICHIER     8
+
+// lire_region lit un rectangle centre de 1/FACTEUR_REGION de chaque cote de l'image.
+#define FACTEUR_REGION      4
+
+// lire_reduite lit l'image reduite de 1/FACTEUR_REDUCTION de chaque cote.
+#define FACTEUR_REDUCTION   4
+
+// redimensionner reduit l'image a 1/FACTEUR_REDIMENSION de chaque cote, un
+// facteur qui n'est pas une puissance de 2.
+#define FACTEUR_REDIMENSION 3
+
+// detecter_droites prend les pixels plus grands que SEUIL_CONTOURS (environ 1 %
+// de l'image synthetique) et cherche NB_DROITES droites a +/- ECART_ANGLES
+// degres de l'horizontale.
+#define SEUIL_CONTOURS      0.99
+#define NB_DROITES          8
+#define ECART_ANGLES        10
+
+// trouver_contours prend aussi les pixels plus grands que SEUIL_CONTOURS; les
+// contours sont ensuite simplifies a TOLERANCE_CONTOURS pixels pres.
+#define TOLERANCE_CONTOURS  2.0
+
+// reconnaitre_caracteres cree une banque de NB_GABARITS_BANC gabarits de
+// LIGNES_GLYPHE x COLONNES_GLYPHE pixels (pris dans l'image synthetique), puis
+// classe les glyphes de la premiere bande de l'image, comme les caracteres
+// d'une plaque, en gardant les NB_CANDIDATS plus proches gabarits.
+#define NB_GABARITS_BANC    256
+#define LIGNES_GLYPHE       24
+#define COLONNES_GLYPHE     16
+#define NB_CANDIDATS        3
+
+// correler cherche le coin superieur gauche de l'image, de 1 / FACTEUR_GABARIT
+// de son cote, dans la region de lire_region: le gabarit grandit avec l'image,
+// et la methode choisie passe de directe a FFT.
+#define FACTEUR_GABARIT     16
+
+// detecter_objets balaie l'image avec une cascade synthetique (des contours
+// horizontaux et verticaux, puis des barres) de fenetres de COTE_CASCADE
+// pixels, agrandies de FACTEUR_CASCADE d'une echelle a l'autre et decalees de
+// PAS_CASCADE pixels a l'echelle 1.
+#define COTE_CASCADE        24
+#define FACTEUR_CASCADE     1.25
+#define PAS_CASCADE         2.0
+
+// trouver_coins garde, avec Shi et Tomasi, au plus un coin par cellule de
+// CELLULE_COINS pixels, raffine a une fraction de pixel; la fenetre du tenseur
+// a un rayon de RAYON_COINS pixels.
+#define RAYON_COINS         2
+#define CELLULE_COINS       16
+#define SEUIL_COINS         0.01
+
+// egaliser_contraste decoupe l'image en TUILES_CONTRASTE x TUILES_CONTRASTE
+// tuiles, et plafonne les classes a LIMITE_CONTRASTE fois la hauteur moyenne.
+#define TUILES_CONTRASTE    8
+#define LIMITE_CONTRASTE    3.0
+
+// filtrer_bilateral lisse l'image avec des ecarts types de SIGMA_ESPACE pixels
+// et de SIGMA_INTENSITE, dans les unites de l'image (entre 0 et 1).
+#define SIGMA_ESPACE        8.0
+#define SIGMA_INTENSITE     0.08
+
+// Le peripherique qui absorbe l'affichage des tableaux.
+#ifdef _WIN32
+#define PERIPHERIQUE_NUL    "NUL"
+#else
+#define PERIPHERIQUE_NUL    "/dev/null"
+#endif
+
+// Represention d'un byte en C.
+typedef unsigned char byte;
+
+// Le format des images 1D mesurees: RGB 24 bits, de la ligne du bas vers le haut.
+static const t_format_pixels FORMAT_IMAGE = { NB_BITS_IMAGE, 0, 0, 0, { 0, 0, 0 }, NULL };
+
+
+/*
+    T_CONTEXTE
+
+    Les donnees partagees par les operations mesurees pour une taille d'image.
+*/
+typedef struct
+{
+    int      nb_lignes;         // La taille de l'image synthetique.
+    int      nb_colonnes;
+    char     fichier[1024];     // Le fichier .bmp temporaire.
+    byte*    image_1D;          // L'image au format bitmap (BGR, lignes alignees).
+    double** image;             // L'image en niveaux de gris.
+    double*  vecteur;           // Un tableau 1D de nb_lignes * nb_colonnes elements.
+    void*    resultat;          // Le resultat d'une operation, libere apres la mesure.
+
+}t_contexte;
+
+
+/*
+    T_BANC_CORRELATION
+
+    Le resultat de l'operation correler: le correlateur et les correlations.
+*/
+typedef struct
+{
+    t_correlateur* correlateur;
+    double**       correlations;
+    int            nb_lignes;       // La taille des correlations.
+    int            nb_colonnes;
+
+}t_banc_correlation;
+
+
+/*
+    T_BANC_CASCADE
+
+    Le resultat de l'operation detecter_objets: la cascade et le detecteur.
+*/
+typedef struct
+{
+    t_cascade*   cascade;
+    t_detecteur* detecteur;
+
+}t_banc_cascade;
+
+
+/*
+    T_BANC_CONTRASTE
+
+    Le resultat de l'operation egaliser_contraste: l'egaliseur et l'image
+    egalisee.
+*/
+typedef struct
+{
+    t_egaliseur* egaliseur;
+    double**     egalisee;
+
+}t_banc_contraste;
+
+
+/*
+    T_BANC_BILATERAL
+
+    Le resultat de l'operation filtrer_bilateral: le filtre et l'image lissee.
+*/
+typedef struct
+{
+    t_filtre_bilateral* filtre;
+    double**            lissee;
+
+}t_banc_bilateral;
+
+
+/*
+    T_OPERATION
+
+    Une operation a mesurer. La preparation et le nettoyage ne sont pas
+    chronometres.
+*/
+typedef struct
+{
+    const char* nom;                            // Le nom rapporte.
+    void (*preparer)(t_contexte* contexte);     // Peut etre NULL.
+    void (*executer)(t_contexte* contexte);     // L'operation chronometree.
+    void (*nettoyer)(t_contexte* contexte);     // Peut etre NULL.
+    double (*octets)(t_contexte* contexte);     // Le nombre d'octets traites.
+
+}t_operation;
+
+
+/*
+    T_RESULTAT
+
+    Le resultat de la mesure d'une operation pour une taille.
+*/
+typedef struct
+{
+    int    repetitions;         // Le nombre d'executions chronometrees.
+    double minimum;             // Les statistiques du temps, en secondes.
+    double moyenne;
+    double p50;
+    double p90;
+    double p99;
+    double mo_par_seconde;      // Le debit, a partir de la mediane.
+    double mpix_par_seconde;
+    double allocations;         // Le nombre moyen d'allocations par appel, ou -1.
+    double octets_max;          // Le maximum de memoire allouee par un appel, ou -1.
+
+}t_resultat;
+
+
+/****************************************************************************************
+*                               COMPTE DES ALLOCATIONS                                  *
+****************************************************************************************/
+
+// Le programme est lie avec --wrap=malloc,calloc,realloc lorsque l'editeur de liens le
+// permet: chaque allocation faite par la librairie passe alors par ces fonctions.
+#ifdef COMPTER_ALLOCATIONS
+
+static long nb_allocations = 0;
+
+void* __real_malloc(size_t taille);
+void* __real_calloc(size_t nombre, size_t taille);
+void* __real_realloc(void* pointeur, size_t taille);
+
+void* __wrap_malloc(size_t taille)
+{
+    nb_allocations++;
+    return __real_malloc(taille);
+}
+
+void* __wrap_calloc(size_t nombre, size_t taille)
+{
+    nb_allocations++;
+    return __real_calloc(nombre, taille);
+}
+
+void* __wrap_realloc(void* pointeur, size_t taille)
+{
+    nb_allocations++;
+    return __real_realloc(pointeur, taille);
+}
+
+#endif
+
+
+/****************************************************************************************
+*                           DECLARATION DES FONCTIONS PRIVEES                           *
+****************************************************************************************/
+
+
+/*
+    MESURER_LISTE
+
+    Cette procedure mesure une liste d'operations pour une taille et ajoute
+    chaque resultat au resume et au fichier JSON.
+
+    Parametres:
+      - [t_operation*] operations      : Les operations a mesurer.
+      - [int         ] nb_operations   : Le nombre d'operations.
+      - [t_contexte* ] contexte        : Les donnees de la taille courante.
+      - [int         ] repetitions_min : Le nombre minimal de repetitions.
+      - [FILE*       ] json            : Le fichier des resultats.
+      - [int*        ] premier         : Vrai tant qu'aucun resultat n'a ete ecrit.
+
+    Retour: Aucun.
+*/
+static void mesurer_liste(const t_operation* operations, int nb_operations,
+                          t_contexte* contexte, int repetitions_min,
+                          FILE* json, int* premier);
+
+
+
+/*
+    ECRIRE_RESULTAT
+
+    Cette procedure ajoute une mesure au resume (sortie d'erreur) et au
+    fichier JSON.
+
+    Parametres:
+      - [FILE*      ] json     : Le fichier des resultats.
+      - [int*       ] premier  : Vrai tant qu'aucun resultat n'a ete ecrit.
+      - [char*      ] nom      : Le nom de l'operation.
+      - [t_contexte*] contexte : Les donnees de la taille courante.
+      - [t_resultat*] resultat : Les statistiques de la mesure.
+
+    Retour: Aucun.
+*/
+static void ecrire_resultat(FILE* json, int* premier, const char* nom,
+                            t_contexte* contexte, t_resultat* resultat);
+
+
+
+/*
+    MESURER
+
+    Cette fonction execute une operation jusqu'a ce que le nombre minimal de
+    repetitions et la duree minimale soient atteints, puis calcule les
+    statistiques.
+
+    Parametres:
+      - [t_operation*] operation       : L'operation a mesurer.
+      - [t_contexte* ] contexte        : Les donnees de l'operation.
+      - [int         ] repetitions_min : Le nombre minimal de repetitions.
+
+    Retour: Les statistiques de la mesure.
+*/
+static t_resultat mesurer(const t_operation* operation, t_contexte* contexte,
+                          int repetitions_min);
+
+
+
+/*
+    PERCENTILE
+
+    Cette fonction retourne le percentile demande (rang le plus proche) d'un
+    tableau trie.
+
+    Parametres:
+      - [double*] valeurs    : Les valeurs triees en ordre croissant.
+      - [int    ] nb_valeurs : Le nombre de valeurs.
+      - [double ] fraction   : Le percentile voulu, entre 0 et 1.
+
+    Retour: La valeur du percentile.
+*/
+static double percentile(double* valeurs, int nb_valeurs, double fraction);
+
+
+
+/*
+    COMPARER_DOUBLES
+
+    Fonction de comparaison pour qsort.
+*/
+static int comparer_doubles(const void* a, const void* b);
+
+
+
+/*
+    PREPARER_IMAGE / LIBERER_IMAGE
+
+    Ces procedures creent (ou liberent) l'image synthetique d'une taille, au
+    format bitmap et en niveaux de gris.
+*/
+static int  preparer_image(t_contexte* contexte);
+static void liberer_image(t_contexte* contexte);
+
+
+// Les operations mesurees.
+static void executer_conversion_2D_a_1D(t_contexte* contexte);
+static void executer_conversion_1D_a_2D(t_contexte* contexte);
+static void executer_conversion_1D_a_gris(t_contexte* contexte);
+static void executer_ecrire(t_contexte* contexte);
+static void executer_lire(t_contexte* contexte);
+static void executer_lire_gris(t_contexte* contexte);
+static void executer_lire_region(t_contexte* contexte);
+static void executer_lire_reduite(t_contexte* contexte);
+static void executer_creer_vue(t_contexte* contexte);
+static void executer_creer_pyramide(t_contexte* contexte);
+static void executer_redimensionner(t_contexte* contexte);
+static void executer_transformer_perspective(t_contexte* contexte);
+static void executer_detecter_droites(t_contexte* contexte);
+static void executer_calculer_distances(t_contexte* contexte);
+static void executer_trouver_contours(t_contexte* contexte);
+static void executer_localiser_plaques(t_contexte* contexte);
+static void executer_reconnaitre_caracteres(t_contexte* contexte);
+static void executer_correler(t_contexte* contexte);
+static void executer_calculer_hog(t_contexte* contexte);
+static void executer_detecter_objets(t_contexte* contexte);
+static void executer_trouver_coins(t_contexte* contexte);
+static void executer_egaliser_contraste(t_contexte* contexte);
+static void executer_filtrer_bilateral(t_contexte* contexte);
+static void executer_creer_tableau1d(t_contexte* contexte);
+static void executer_afficher_tableau1d(t_contexte* contexte);
+static void executer_somme_tableau1d(t_contexte* contexte);
+static void executer_produit_tableau1d(t_contexte* contexte);
+static void executer_produit_scalaire1d(t_contexte* contexte);
+static void executer_detruire_tableau1d(t_contexte* contexte);
+static void executer_creer_tableau2d(t_contexte* contexte);
+static void executer_afficher_tableau2d(t_contexte* contexte);
+static void executer_initialiser_tableau2d(t_contexte* contexte);
+static void executer_detruire_tableau2d(t_contexte* contexte);
+
+// Les preparations et les nettoyages.
+static void preparer_tableau1d(t_contexte* contexte);
+static void preparer_tableau2d(t_contexte* contexte);
+static void preparer_redimension(t_contexte* contexte);
+static void preparer_contours(t_contexte* contexte);
+static void preparer_localisateur(t_contexte* contexte);
+static void preparer_banque(t_contexte* contexte);
+static void preparer_correlation(t_contexte* contexte);
+static void preparer_hog(t_contexte* contexte);
+static void preparer_cascade(t_contexte* contexte);
+static void preparer_coins(t_contexte* contexte);
+static void preparer_hough(t_contexte* contexte);
+static void preparer_contraste(t_contexte* contexte);
+static void preparer_bilateral(t_contexte* contexte);
+static void liberer_resultat(t_contexte* contexte);
+static void detruire_resultat_image(t_contexte* contexte);
+static void detruire_resultat_region(t_contexte* contexte);
+static void detruire_resultat_reduite(t_contexte* contexte);
+static void detruire_resultat_vue(t_contexte* contexte);
+static void detruire_resultat_pyramide(t_contexte* contexte);
+static void detruire_resultat_redimension(t_contexte* contexte);
+static void detruire_resultat_contours(t_contexte* contexte);
+static void detruire_resultat_localisateur(t_contexte* contexte);
+static void detruire_resultat_banque(t_contexte* contexte);
+static void detruire_resultat_correlation(t_contexte* contexte);
+static void detruire_resultat_hog(t_contexte* contexte);
+static void detruire_resultat_cascade(t_contexte* contexte);
+static void detruire_resultat_coins(t_contexte* contexte);
+static void detruire_resultat_hough(t_contexte* contexte);
+static void detruire_resultat_contraste(t_contexte* contexte);
+static void detruire_resultat_bilateral(t_contexte* contexte);
+static void detruire_resultat_tableau1d(t_contexte* contexte);
+static void detruire_resultat_tableau2d(t_contexte* contexte);
+
+// Le nombre d'octets traites par les operations.
+static double octets_bitmap(t_contexte* contexte);
+static double octets_fichier(t_contexte* contexte);
+static double octets_region(t_contexte* contexte);
+static double octets_tableau(t_contexte* contexte);
+static double octets_bande(t_contexte* contexte);
+
+
+/****************************************************************************************
+*                               LISTE DES OPERATIONS                                    *
+****************************************************************************************/
+
+// Les operations qui travaillent sur l'image. Lorsqu'une operation garde son
+// espace de travail d'une image a l'autre, son preparer le cree et fait un
+// premier appel: la mesure reutilise alors les tableaux deja alloues, comme
+// d'une image a l'autre d'une video.
+static const t_operation OPERATIONS_IMAGE[] =
+{
+    { "conversion_2D_a_1D",      NULL,                   executer_conversion_2D_a_1D,       liberer_resultat,                octets_bitmap  },
+    { "conversion_1D_a_2D",      NULL,                   executer_conversion_1D_a_2D,       detruire_resultat_image,         octets_bitmap  },
+    { "conversion_1D_a_gris",    NULL,                   executer_conversion_1D_a_gris,     liberer_resultat,                octets_bitmap  },
+    { "ecrire",                  NULL,                   executer_ecrire,                   NULL,                            octets_fichier },
+    { "lire",                    NULL,                   executer_lire,                     detruire_resultat_image,         octets_fichier },
+    { "lire_gris",               NULL,                   executer_lire_gris,                liberer_resultat,                octets_fichier },
+    { "lire_region",             NULL,                   executer_lire_region,              detruire_resultat_region,        octets_region  },
+    { "lire_reduite",            NULL,                   executer_lire_reduite,             detruire_resultat_reduite,       octets_fichier },
+    { "creer_vue",               NULL,                   executer_creer_vue,                detruire_resultat_vue,           octets_region  },
+    { "creer_pyramide",          NULL,                   executer_creer_pyramide,           detruire_resultat_pyramide,      octets_tableau },
+    { "redimensionner",          preparer_redimension,   executer_redimensionner,           detruire_resultat_redimension,   octets_tableau },
+    { "transformer_perspective", preparer_tableau2d,     executer_transformer_perspective,  detruire_resultat_image,         octets_tableau },
+    { "calculer_distances",      preparer_tableau2d,     executer_calculer_distances,       detruire_resultat_image,         octets_tableau },
+    { "trouver_contours",        preparer_contours,      executer_trouver_contours,         detruire_resultat_contours,      octets_tableau },
+    { "localiser_plaques",       preparer_localisateur,  executer_localiser_plaques,        detruire_resultat_localisateur,  octets_tableau },
+    { "reconnaitre_caracteres",  preparer_banque,        executer_reconnaitre_caracteres,   detruire_resultat_banque,        octets_bande   },
+    { "correler",                preparer_correlation,   executer_correler,                 detruire_resultat_correlation,   octets_region  },
+    { "calculer_hog",            preparer_hog,           executer_calculer_hog,             detruire_resultat_hog,           octets_tableau },
+    { "detecter_objets",         preparer_cascade,       executer_detecter_objets,          detruire_resultat_cascade,       octets_tableau },
+    { "trouver_coins",           preparer_coins,         executer_trouver_coins,            detruire_resultat_coins,         octets_tableau },
+    { "egaliser_contraste",      preparer_contraste,     executer_egaliser_contraste,       detruire_resultat_contraste,     octets_tableau },
+    { "filtrer_bilateral",       preparer_bilateral,     executer_filtrer_bilateral,        detruire_resultat_bilateral,     octets_tableau },
+    { "detecter_droites",        preparer_hough,         executer_detecter_droites,         detruire_resultat_hough,         octets_tableau },
+};
+
+// Les operations de tableau1d, sur nb_lignes * nb_colonnes elements.
+static const t_operation OPERATIONS_TABLEAU1D[] =
+{
+    { "creer_tableau1d",    NULL,               executer_creer_tableau1d,    detruire_resultat_tableau1d, octets_tableau },
+    { "afficher_tableau1d", NULL,               executer_afficher_tableau1d, NULL,                        octets_tableau },
+    { "somme_tableau1d",    NULL,               executer_somme_tableau1d,    NULL,                        octets_tableau },
+    { "produit_tableau1d",  NULL,               executer_produit_tableau1d,  NULL,                        octets_tableau },
+    { "produit_scalaire1d", NULL,               executer_produit_scalaire1d, NULL,                        octets_tableau },
+    { "detruire_tableau1d", preparer_tableau1d, executer_detruire_tableau1d, NULL,                        octets_tableau },
+};
+
+// Les operations de tableau2d, sur nb_lignes x nb_colonnes elements.
+static const t_operation OPERATIONS_TABLEAU2D[] =
+{
+    { "creer_tableau2d",       NULL,            executer_creer_tableau2d,       detruire_resultat_tableau2d, octets_tableau },
+    { "afficher_tableau2d",    NULL,            executer_afficher_tableau2d,    NULL,                        octets_tableau },
+    { "initialiser_tableau2d", NULL,            executer_initialiser_tableau2d, NULL,                        octets_tableau },
+    { "detruire_tableau2d",    preparer_tableau2d, executer_detruire_tableau2d, NULL,                     octets_tableau },
+};
+
+#define NB_OPERATIONS(liste)    ((int) (sizeof(liste) / sizeof(liste[0])))
+
+
+/****************************************************************************************
+*                                   PROGRAMME PRINCIPAL                                 *
+****************************************************************************************/
+
+int main(int argc, char* argv[])
+{
+    int         taille_max;         // Les options de la ligne de commande.
+    int         repetitions_min;
+    const char* nom_json;
+    const char* repertoire;
+    const char* nom_trace;
+    FILE*       json;               // Le fichier des resultats.
+    int         premier;            // Vrai tant qu'aucun resultat n'a ete ecrit.
+    int         i, t;               // Iterateurs.
+    t_contexte  contexte;           // Les donnees de la taille courante.
+
+    taille_max      = TAILLE_MAX_DEFAUT;
+    repetitions_min = REPETITIONS_MIN_DEFAUT;
+    nom_json        = FICHIER_JSON_DEFAUT;
+    repertoire      = REPERTOIRE_DEFAUT;
+    nom_trace       = NULL;
+
+    for(i = 1; i + 1 < argc; i += 2)
+    {
+        if(strcmp(argv[i], "-m") == 0)
+            taille_max = atoi(argv[i + 1]);
+        else if(strcmp(argv[i], "-n") == 0)
+            repetitions_min = atoi(argv[i + 1]);
+        else if(strcmp(argv[i], "-o") == 0)
+            nom_json = argv[i + 1];
+        else if(strcmp(argv[i], "-d") == 0)
+            repertoire = argv[i + 1];
+        else if(strcmp(argv[i], "-t") == 0)
+            nom_trace = argv[i + 1];
+    }
+
+    if(repetitions_min < 1)
+        repetitions_min = 1;
+
+    json = fopen(nom_json, "w");
+    if(json == NULL)
+    {
+        fprintf(stderr, "Impossible de creer %s\n", nom_json);
+        return EXIT_FAILURE;
+    }
+
+    // Les operations de tableau affichent leurs resultats.
+    freopen(PERIPHERIQUE_NUL, "w", stdout);
+
+    fprintf(json, "{\n  \"resultats\": [");
+    premier = 1;
+
+    for(t = 0; t < NB_TAILLES && TAILLES[t] <= taille_max; t++)
+    {
+        memset(&contexte, 0, sizeof(contexte));
+        contexte.nb_lignes   = TAILLES[t];
+        contexte.nb_colonnes = TAILLES[t];
+        snprintf(contexte.fichier, sizeof(contexte.fichier), "%s/banc_essai_%d.bmp",
+                                                             repertoire, TAILLES[t]);
+
+        if(!preparer_image(&contexte))
+        {
+            fprintf(stderr, "Memoire insuffisante pour %d x %d\n", TAILLES[t], TAILLES[t]);
+            liberer_image(&contexte);
+            break;
+        }
+
+        // L'image: les conversions, ecrire, puis lire le fichier ecrit.
+        mesurer_liste(OPERATIONS_IMAGE, NB_OPERATIONS(OPERATIONS_IMAGE),
+                      &contexte, repetitions_min, json, &premier);
+        remove(contexte.fichier);
+        liberer_image(&contexte);
+
+        // Les tableaux 1D.
+        contexte.vecteur = (double*) malloc((size_t) contexte.nb_lignes *
+                                            contexte.nb_colonnes * sizeof(double));
+        if(contexte.vecteur != NULL)
+        {
+            for(i = 0; i < contexte.nb_lignes * contexte.nb_colonnes; i++)
+                contexte.vecteur[i] = (i % 255) / 255.0;
+
+            mesurer_liste(OPERATIONS_TABLEAU1D, NB_OPERATIONS(OPERATIONS_TABLEAU1D),
+                          &contexte, repetitions_min, json, &premier);
+            free(contexte.vecteur);
+            contexte.vecteur = NULL;
+        }
+
+        // Les tableaux 2D.
+        contexte.image = creer_tableau2d(contexte.nb_lignes, contexte.nb_colonnes);
+        if(contexte.image != NULL)
+        {
+            mesurer_liste(OPERATIONS_TABLEAU2D, NB_OPERATIONS(OPERATIONS_TABLEAU2D),
+                          &contexte, repetitions_min, json, &premier);
+            detruire_tableau2d(contexte.image, contexte.nb_lignes);
+        }
+    }
+
+    fprintf(json, "\n  ]\n}\n");
+    fclose(json);
+
+    // Les tables de poids conservees ne sont pas des fuites.
+    redimension_vider_cache();
+
+    // Le detail par etape, si la librairie est instrumentee.
+    instrumentation_afficher(stderr);
+    if(nom_trace != NULL)
+        instrumentation_ecrire_trace(nom_trace);
+
+    return EXIT_SUCCESS;
+}
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PRIVEES                            *
+****************************************************************************************/
+
+
+static void mesurer_liste(const t_operation* operations, int nb_operations,
+                          t_contexte* contexte, int repetitions_min,
+                          FILE* json, int* premier)
+{
+    int        i;           // Iterateur sur les operations.
+    t_resultat resultat;    // La mesure d'une operation.
+
+    for(i = 0; i < nb_operations; i++)
+    {
+        resultat = mesurer(&operations[i], contexte, repetitions_min);
+        ecrire_resultat(json, premier, operations[i].nom, contexte, &resultat);
+    }
+}
+
+
+static void ecrire_resultat(FILE* json, int* premier, const char* nom,
+                            t_contexte* contexte, t_resultat* resultat)
+{
+    fprintf(stderr, "%-22s %6d x %-6d %6d rep.  p50 %12.6f s  p90 %12.6f s  p99 %12.6f s"
+                    "  %10.1f Mo/s  %10.1f Mpix/s  ",
+            nom, contexte->nb_lignes, contexte->nb_colonnes, resultat->repetitions,
+            resultat->p50, resultat->p90, resultat->p99,
+            resultat->mo_par_seconde, resultat->mpix_par_seconde);
+
+    if(resultat->allocations >= 0)
+        fprintf(stderr, "%10.1f alloc.", resultat->allocations);
+    else
+        fprintf(stderr, "%10s alloc.", "n/d");
+
+    if(resultat->octets_max >= 0)
+        fprintf(stderr, "  %14.0f octets max\n", resultat->octets_max);
+    else
+        fprintf(stderr, "\n");
+
+    fprintf(json, "%s\n    {\"operation\": \"%s\", \"lignes\": %d, \"colonnes\": %d, "
+                  "\"repetitions\": %d, \"secondes\": {\"min\": %.9f, \"moyenne\": %.9f, "
+                  "\"p50\": %.9f, \"p90\": %.9f, \"p99\": %.9f}, "
+                  "\"mo_par_seconde\": %.3f, \"mpix_par_seconde\": %.3f, ",
+            *premier ? "" : ",", nom, contexte->nb_lignes, contexte->nb_colonnes,
+            resultat->repetitions, resultat->minimum, resultat->moyenne,
+            resultat->p50, resultat->p90, resultat->p99,
+            resultat->mo_par_seconde, resultat->mpix_par_seconde);
+
+    if(resultat->allocations >= 0)
+        fprintf(json, "\"allocations\": %.1f, ", resultat->allocations);
+    else
+        fprintf(json, "\"allocations\": null, ");
+
+    if(resultat->octets_max >= 0)
+        fprintf(json, "\"octets_max\": %.0f}", resultat->octets_max);
+    else
+        fprintf(json, "\"octets_max\": null}");
+
+    *premier = 0;
+}
+
+
+static t_resultat mesurer(const t_operation* operation, t_contexte* contexte,
+                          int repetitions_min)
+{
+    t_resultat resultat;                    // Les statistiques a retourner.
+    double     temps[REPETITIONS_MAX];      // Le temps de chaque repetition.
+    double     total;                       // Le temps total chronometre.
+    double     debut;                       // Le debut d'une repetition.
+    double     debut_mesure;                // Le debut de la mesure complete.
+    double     pixels;                      // Le nombre de pixels traites.
+    long       allocations;                 // Les allocations de toutes les repetitions.
+    size_t     vivants;                     // La memoire allouee avant un appel.
+    size_t     octets_max;                  // Le maximum alloue par un appel.
+    int        n;                           // Le nombre de repetitions faites.
+
+    total       = 0;
+    allocations = 0;
+    octets_max  = 0;
+    n           = 0;
+
+    debut_mesure = chrono_mur();
+    while(n < REPETITIONS_MAX &&
+          (n < repetitions_min ||
+           (total < DUREE_MIN_MESURE && chrono_mur() - debut_mesure < DUREE_MAX_MESURE)))
+    {
+        if(operation->preparer != NULL)
+            operation->preparer(contexte);
+
+#ifdef COMPTER_ALLOCATIONS
+        allocations -= nb_allocations;
+#endif
+        memoire_reinitialiser_max();
+        vivants = memoire_octets_vivants();
+
+        debut = chrono_mur();
+        operation->executer(contexte);
+        temps[n] = chrono_mur() - debut;
+
+        if(memoire_octets_max() - vivants > octets_max)
+            octets_max = memoire_octets_max() - vivants;
+#ifdef COMPTER_ALLOCATIONS
+        allocations += nb_allocations;
+#endif
+
+        if(operation->nettoyer != NULL)
+            operation->nettoyer(contexte);
+
+        total += temps[n];
+        n++;
+    }
+
+    qsort(temps, n, sizeof(double), comparer_doubles);
+
+    pixels = (double) contexte->nb_lignes * contexte->nb_colonnes;
+
+    resultat.repetitions      = n;
+    resultat.minimum          = temps[0];
+    resultat.moyenne          = total / n;
+    resultat.p50              = percentile(temps, n, 0.50);
+    resultat.p90              = percentile(temps, n, 0.90);
+    resultat.p99              = percentile(temps, n, 0.99);
+    resultat.mo_par_seconde   = operation->octets(contexte) / OCTETS_PAR_MO / resultat.p50;
+    resultat.mpix_par_seconde = pixels / PIXELS_PAR_MPIX / resultat.p50;
+#ifdef COMPTER_ALLOCATIONS
+    resultat.allocations      = (double) allocations / n;
+#else
+    resultat.allocations      = -1;
+#endif
+#ifdef MEMOIRE_SUIVIE
+    resultat.octets_max       = (double) octets_max;
+#else
+    resultat.octets_max       = -1;
+#endif
+
+    return resultat;
+}
+
+
+static double percentile(double* valeurs, int nb_valeurs, double fraction)
+{
+    int rang;   // Le rang (a partir de 1) de la valeur retournee.
+
+    rang = (int) ceil(fraction * nb_valeurs);
+    if(rang < 1)
+        rang = 1;
+
+    return valeurs[rang - 1];
+}
+
+
+static int comparer_doubles(const void* a, const void* b)
+{
+    double x = *(const double*) a;
+    double y = *(const double*) b;
+
+    return (x > y) - (x < y);
+}
+
+
+static int preparer_image(t_contexte* contexte)
+{
+    int ligne, colonne;     // Iterateurs sur l'image.
+
+    // Une image synthetique avec des motifs qui varient dans les deux directions.
+    contexte->image = creer_tableau2d(contexte->nb_lignes, contexte->nb_colonnes);
+    if(contexte->image == NULL)
+        return 0;
+
+    for(ligne = 0; ligne < contexte->nb_lignes; ligne++)
+    {
+        for(colonne = 0; colonne < contexte->nb_colonnes; colonne++)
+        {
+            contexte->image[ligne][colonne] = ((ligne * 7 + colonne * 13) % 256) / 255.0;
+        }
+    }
+
+    contexte->image_1D = (byte*) conversion_2D_a_1D(contexte->image, contexte->nb_lignes,
+                                                                     contexte->nb_colonnes,
+                                                                     NB_BITS_IMAGE);
+
+    // Le fichier lu par lire est produit une premiere fois par ecrire.
+    ecrire(contexte->fichier, contexte->image, contexte->nb_lignes, contexte->nb_colonnes);
+
+    return contexte->image_1D != NULL;
+}
+
+
+static void liberer_image(t_contexte* contexte)
+{
+    if(contexte->image != NULL)
+        detruire(contexte->image, contexte->nb_lignes, contexte->nb_colonnes);
+    LIBERER(contexte->image_1D);
+
+    contexte->image    = NULL;
+    contexte->image_1D = NULL;
+}
+
+
+static void executer_conversion_2D_a_1D(t_contexte* contexte)
+{
+    contexte->resultat = conversion_2D_a_1D(contexte->image, contexte->nb_lignes,
+                                                             contexte->nb_colonnes,
+                                                             NB_BITS_IMAGE);
+}
+
+
+static void executer_conversion_1D_a_2D(t_contexte* contexte)
+{
+    contexte->resultat = conversion_1D_a_2D(contexte->image_1D, contexte->nb_lignes,
+                                                                contexte->nb_colonnes,
+                                                                &FORMAT_IMAGE);
+}
+
+
+static void executer_conversion_1D_a_gris(t_contexte* contexte)
+{
+    contexte->resultat = conversion_1D_a_gris(contexte->image_1D, contexte->nb_lignes,
+                                                                  contexte->nb_colonnes,
+                                                                  &FORMAT_IMAGE,
+                                                                  LUMINANCE_BT601);
+}
+
+
+static void executer_ecrire(t_contexte* contexte)
+{
+    ecrire(contexte->fichier, contexte->image, contexte->nb_lignes, contexte->nb_colonnes);
+}
+
+
+static void executer_lire(t_contexte* contexte)
+{
+    int nb_lignes, nb_colonnes;     // La taille de l'image lue.
+
+    contexte->resultat = NULL;
+    lire(contexte->fichier, &contexte->resultat, &nb_lignes, &nb_colonnes);
+}
+
+
+static void executer_lire_gris(t_contexte* contexte)
+{
+    unsigned char* image;           // L'image lue.
+    int nb_lignes, nb_colonnes;     // La taille de l'image lue.
+
+    image = NULL;
+    lire_gris(contexte->fichier, &image, &nb_lignes, &nb_colonnes, LUMINANCE_BT601);
+    contexte->resultat = image;
+}
+
+
+static void executer_lire_region(t_contexte* contexte)
+{
+    int nb_lignes, nb_colonnes;     // La taille du rectangle lu.
+
+    nb_lignes   = contexte->nb_lignes   / FACTEUR_REGION;
+    nb_colonnes = contexte->nb_colonnes / FACTEUR_REGION;
+
+    contexte->resultat = NULL;
+    lire_region(contexte->fichier, &contexte->resultat, (contexte->nb_lignes   - nb_lignes)   / 2,
+                                                        (contexte->nb_colonnes - nb_colonnes) / 2,
+                                                        nb_lignes, nb_colonnes);
+}
+
+
+static void executer_lire_reduite(t_contexte* contexte)
+{
+    int nb_lignes, nb_colonnes;     // La taille de l'image reduite.
+
+    contexte->resultat = NULL;
+    lire_reduite(contexte->fichier, &contexte->resultat, &nb_lignes, &nb_colonnes,
+                                                        FACTEUR_REDUCTION);
+}
+
+
+static void executer_creer_vue(t_contexte* contexte)
+{
+    int nb_lignes, nb_colonnes;     // La taille du rectangle, comme pour lire_region.
+
+    nb_lignes   = contexte->nb_lignes   / FACTEUR_REGION;
+    nb_colonnes = contexte->nb_colonnes / FACTEUR_REGION;
+
+    contexte->resultat = creer_vue(contexte->image, (contexte->nb_lignes   - nb_lignes)   / 2,
+                                                    (contexte->nb_colonnes - nb_colonnes) / 2,
+                                                    nb_lignes, nb_colonnes);
+}
+
+
+static void executer_creer_pyramide(t_contexte* contexte)
+{
+    contexte->resultat = creer_pyramide(contexte->image, contexte->nb_lignes,
+                                        contexte->nb_colonnes, 0, PYRAMIDE_GAUSS);
+}
+
+
+static void executer_redimensionner(t_contexte* contexte)
+{
+    redimensionner(contexte->image, contexte->nb_lignes, contexte->nb_colonnes,
+                   (double**) contexte->resultat, contexte->nb_lignes   / FACTEUR_REDIMENSION,
+                                                  contexte->nb_colonnes / FACTEUR_REDIMENSION,
+                   REDIMENSION_LANCZOS3);
+}
+
+
+static void executer_transformer_perspective(t_contexte* contexte)
+{
+    double   coins[NB_COINS][2];        // Les coins de l'image, deplaces.
+    double   rectangle[NB_COINS][2];    // Les coins de l'image.
+    double   h[3][3];                   // L'homographie, sur la pile.
+    double*  lignes[3];                 // Les lignes de l'homographie.
+    double   l, c;                      // La derniere ligne et la derniere colonne.
+
+    l = contexte->nb_lignes   - 1;
+    c = contexte->nb_colonnes - 1;
+
+    // Un quadrilatere de biais, comme une plaque vue de cote.
+    rectangle[0][0] = 0;  rectangle[0][1] = 0;
+    rectangle[1][0] = c;  rectangle[1][1] = 0;
+    rectangle[2][0] = c;  rectangle[2][1] = l;
+    rectangle[3][0] = 0;  rectangle[3][1] = l;
+    coins[0][0] = 0.10 * c;  coins[0][1] = 0.05 * l;
+    coins[1][0] = 0.95 * c;  coins[1][1] = 0.20 * l;
+    coins[2][0] = 0.90 * c;  coins[2][1] = 0.85 * l;
+    coins[3][0] = 0.05 * c;  coins[3][1] = 0.95 * l;
+
+    lignes[0] = h[0];
+    lignes[1] = h[1];
+    lignes[2] = h[2];
+
+    if(calculer_homographie(coins, rectangle, lignes))
+        transformer_perspective(contexte->image, contexte->nb_lignes, contexte->nb_colonnes,
+                                (double**) contexte->resultat, contexte->nb_lignes,
+                                contexte->nb_colonnes, lignes, 0.0);
+}
+
+
+static void executer_detecter_droites(t_contexte* contexte)
+{
+    t_droite droites[NB_DROITES];   // Les droites trouvees.
+
+    detecter_droites((t_hough*) contexte->resultat, contexte->image, contexte->nb_lignes,
+                     contexte->nb_colonnes, SEUIL_CONTOURS,
+                     (90 - ECART_ANGLES) * RESOLUTION_THETA,
+                     (90 + ECART_ANGLES) * RESOLUTION_THETA, 1, droites, NB_DROITES);
+}
+
+
+static void executer_calculer_distances(t_contexte* contexte)
+{
+    calculer_distances(contexte->image, contexte->nb_lignes, contexte->nb_colonnes,
+                       SEUIL_CONTOURS, PIXELS_ALLUMES, (double**) contexte->resultat);
+}
+
+
+static void executer_trouver_contours(t_contexte* contexte)
+{
+    if(trouver_contours(contexte->image, contexte->nb_lignes, contexte->nb_colonnes,
+                        SEUIL_CONTOURS, (t_contours*) contexte->resultat) >= 0)
+        simplifier_contours((t_contours*) contexte->resultat, TOLERANCE_CONTOURS);
+}
+
+
+static void executer_localiser_plaques(t_contexte* contexte)
+{
+    localiser_plaques((t_localisateur*) contexte->resultat, contexte->image,
+                      contexte->nb_lignes, contexte->nb_colonnes);
+}
+
+
+static void executer_reconnaitre_caracteres(t_contexte* contexte)
+{
+    t_correspondance meilleures[NB_CANDIDATS];  // Les gabarits retenus d'un glyphe.
+    int              colonne;                   // Le glyphe classe.
+
+    for(colonne = 0; colonne + COLONNES_GLYPHE <= contexte->nb_colonnes;
+        colonne += COLONNES_GLYPHE)
+        reconnaitre_caractere((t_banque*) contexte->resultat, contexte->image, 0, colonne,
+                              LIGNES_GLYPHE, COLONNES_GLYPHE, meilleures, NB_CANDIDATS);
+}
+
+
+static void executer_correler(t_contexte* contexte)
+{
+    t_banc_correlation* banc = (t_banc_correlation*) contexte->resultat;
+
+    correler(banc->correlateur, contexte->image, contexte->nb_lignes   / FACTEUR_REGION,
+                                                 contexte->nb_colonnes / FACTEUR_REGION,
+             contexte->image, contexte->nb_lignes   / FACTEUR_GABARIT,
+                              contexte->nb_colonnes / FACTEUR_GABARIT,
+             CORRELATION_AUTOMATIQUE, banc->correlations);
+}
+
+
+static void executer_calculer_hog(t_contexte* contexte)
+{
+    calculer_hog((t_hog*) contexte->resultat, contexte->image, contexte->nb_lignes,
+                 contexte->nb_colonnes);
+}
+
+
+static void executer_detecter_objets(t_contexte* contexte)
+{
+    t_banc_cascade* banc = (t_banc_cascade*) contexte->resultat;
+
+    detecter_objets(banc->detecteur, banc->cascade, contexte->image, contexte->nb_lignes,
+                    contexte->nb_colonnes, FACTEUR_CASCADE, PAS_CASCADE);
+}
+
+
+static void executer_trouver_coins(t_contexte* contexte)
+{
+    trouver_coins((t_coins*) contexte->resultat, contexte->image, contexte->nb_lignes,
+                  contexte->nb_colonnes, COINS_SHI_TOMASI, K_HARRIS, RAYON_COINS,
+                  CELLULE_COINS, SEUIL_COINS, 1);
+}
+
+
+static void executer_egaliser_contraste(t_contexte* contexte)
+{
+    t_banc_contraste* banc = (t_banc_contraste*) contexte->resultat;
+
+    egaliser_contraste(banc->egaliseur, contexte->image, contexte->nb_lignes,
+                       contexte->nb_colonnes, TUILES_CONTRASTE, TUILES_CONTRASTE,
+                       LIMITE_CONTRASTE, banc->egalisee);
+}
+
+
+static void executer_filtrer_bilateral(t_contexte* contexte)
+{
+    t_banc_bilateral* banc = (t_banc_bilateral*) contexte->resultat;
+
+    filtrer_bilateral(banc->filtre, contexte->image, contexte->nb_lignes,
+                      contexte->nb_colonnes, SIGMA_ESPACE, SIGMA_INTENSITE, banc->lissee);
+}
+
+
+static void executer_creer_tableau1d(t_contexte* contexte)
+{
+    contexte->resultat = creer_tableau1d(contexte->nb_lignes * contexte->nb_colonnes);
+}
+
+
+static void executer_afficher_tableau1d(t_contexte* contexte)
+{
+    afficher_tableau1d(contexte->vecteur, contexte->nb_lignes * contexte->nb_colonnes);
+}
+
+
+static void executer_somme_tableau1d(t_contexte* contexte)
+{
+    somme_tableau1d(contexte->vecteur, contexte->nb_lignes * contexte->nb_colonnes);
+}
+
+
+static void executer_produit_tableau1d(t_contexte* contexte)
+{
+    produit_tableau1d(contexte->vecteur, contexte->nb_lignes * contexte->nb_colonnes, 0.5);
+}
+
+
+static void executer_produit_scalaire1d(t_contexte* contexte)
+{
+    produit_scalaire1d(contexte->vecteur, contexte->vecteur,
+                       contexte->nb_lignes * contexte->nb_colonnes);
+}
+
+
+static void executer_detruire_tableau1d(t_contexte* contexte)
+{
+    detruire_tableau1d((double*) contexte->resultat);
+}
+
+
+static void executer_creer_tableau2d(t_contexte* contexte)
+{
+    contexte->resultat = creer_tableau2d(contexte->nb_lignes, contexte->nb_colonnes);
+}
+
+
+static void executer_afficher_tableau2d(t_contexte* contexte)
+{
+    afficher_tableau2d(contexte->image, contexte->nb_lignes, contexte->nb_colonnes);
+}
+
+
+static void executer_initialiser_tableau2d(t_contexte* contexte)
+{
+    initialiser_tableau2d(contexte->image, contexte->nb_lignes, contexte->nb_colonnes, 0.5);
+}
+
+
+static void executer_detruire_tableau2d(t_contexte* contexte)
+{
+    detruire_tableau2d((double**) contexte->resultat, contexte->nb_lignes);
+}
+
+
+static void preparer_tableau1d(t_contexte* contexte)
+{
+    contexte->resultat = creer_tableau1d(contexte->nb_lignes * contexte->nb_colonnes);
+}
+
+
+static void preparer_tableau2d(t_contexte* contexte)
+{
+    contexte->resultat = creer_tableau2d(contexte->nb_lignes, contexte->nb_colonnes);
+}
+
+
+static void preparer_redimension(t_contexte* contexte)
+{
+    contexte->resultat = creer_tableau2d(contexte->nb_lignes   / FACTEUR_REDIMENSION,
+                                         contexte->nb_colonnes / FACTEUR_REDIMENSION);
+}
+
+
+static void preparer_contours(t_contexte* contexte)
+{
+    contexte->resultat = creer_contours();
+    if(contexte->resultat != NULL)
+        executer_trouver_contours(contexte);
+}
+
+
+static void preparer_localisateur(t_contexte* contexte)
+{
+    contexte->resultat = creer_localisateur();
+    if(contexte->resultat != NULL)
+        executer_localiser_plaques(contexte);
+}
+
+
+static void preparer_banque(t_contexte* contexte)
+{
+    t_banque* banque;   // La banque creee.
+    int       i;        // Iterateur sur les gabarits.
+
+    banque = creer_banque(LIGNES_GLYPHE, COLONNES_GLYPHE);
+    contexte->resultat = banque;
+    if(banque == NULL)
+        return;
+
+    // Des rectangles repartis dans l'image, un caractere par gabarit.
+    for(i = 0; i < NB_GABARITS_BANC; i++)
+        ajouter_gabarit(banque, contexte->image,
+                        i * 37 % (contexte->nb_lignes   - LIGNES_GLYPHE   + 1),
+                        i * 53 % (contexte->nb_colonnes - COLONNES_GLYPHE + 1),
+                        LIGNES_GLYPHE, COLONNES_GLYPHE, (char) ('!' + i % 94));
+}
+
+
+static void preparer_correlation(t_contexte* contexte)
+{
+    t_banc_correlation* banc;   // Le correlateur et les correlations.
+
+    banc = (t_banc_correlation*) ALLOUER(sizeof(t_banc_correlation));
+    contexte->resultat = banc;
+    if(banc == NULL)
+        return;
+
+    banc->nb_lignes    = contexte->nb_lignes / FACTEUR_REGION -
+                         contexte->nb_lignes / FACTEUR_GABARIT + 1;
+    banc->nb_colonnes  = contexte->nb_colonnes / FACTEUR_REGION -
+                         contexte->nb_colonnes / FACTEUR_GABARIT + 1;
+    banc->correlateur  = creer_correlateur();
+    banc->correlations = creer_tableau2d(banc->nb_lignes, banc->nb_colonnes);
+
+    if(banc->correlateur != NULL && banc->correlations != NULL)
+        executer_correler(contexte);
+}
+
+
+static void preparer_hog(t_contexte* contexte)
+{
+    contexte->resultat = creer_hog();
+    if(contexte->resultat != NULL)
+        executer_calculer_hog(contexte);
+}
+
+
+static void preparer_cascade(t_contexte* contexte)
+{
+    t_banc_cascade* banc;   // La cascade et le detecteur.
+    int             i;      // Iterateur sur les classifieurs.
+
+    // Des contours (haut / bas, gauche / droite) au premier etage, des
+    // barres (trois rectangles) au second.
+    const t_classifieur_faible classifieurs[] =
+    {
+        { { {  0,  0, 12, 24, -1.0 }, { 12,  0, 12, 24,  1.0 } }, 2,  0.05, -1.0, 1.0 },
+        { { {  0,  0, 24, 12, -1.0 }, {  0, 12, 24, 12,  1.0 } }, 2, -0.05,  1.0, 0.5 },
+        { { {  0,  0,  8, 24,  1.0 }, {  8,  0,  8, 24, -2.0 },
+            { 16,  0,  8, 24,  1.0 } }, 3,  0.0,  -1.0, 1.0 },
+        { { {  0,  0, 24,  8,  1.0 }, {  0,  8, 24,  8, -2.0 },
+            {  0, 16, 24,  8,  1.0 } }, 3,  0.0,  -1.0, 1.0 },
+    };
+    const int premier_etage = 2;    // Le nombre de classifieurs du premier etage.
+
+    banc = (t_banc_cascade*) ALLOUER(sizeof(t_banc_cascade));
+    contexte->resultat = banc;
+    if(banc == NULL)
+        return;
+
+    banc->cascade   = creer_cascade(COTE_CASCADE, COTE_CASCADE);
+    banc->detecteur = creer_detecteur();
+    if(banc->cascade == NULL || banc->detecteur == NULL)
+        return;
+
+    for(i = 0; i < (int) (sizeof(classifieurs) / sizeof(classifieurs[0])); i++)
+    {
+        if(i == 0 || i == premier_etage)
+            ajouter_etage(banc->cascade, 0.0);
+        ajouter_classifieur(banc->cascade, &classifieurs[i]);
+    }
+
+    executer_detecter_objets(contexte);
+}
+
+
+static void preparer_coins(t_contexte* contexte)
+{
+    contexte->resultat = creer_coins();
+    if(contexte->resultat != NULL)
+        executer_trouver_coins(contexte);
+}
+
+
+static void preparer_hough(t_contexte* contexte)
+{
+    contexte->resultat = creer_hough();
+    if(contexte->resultat != NULL)
+        executer_detecter_droites(contexte);
+}
+
+
+static void preparer_contraste(t_contexte* contexte)
+{
+    t_banc_contraste* banc;     // L'egaliseur et l'image egalisee.
+
+    banc = (t_banc_contraste*) ALLOUER(sizeof(t_banc_contraste));
+    contexte->resultat = banc;
+    if(banc == NULL)
+        return;
+
+    banc->egaliseur = creer_egaliseur();
+    banc->egalisee  = creer_tableau2d(contexte->nb_lignes, contexte->nb_colonnes);
+
+    if(banc->egaliseur != NULL && banc->egalisee != NULL)
+        executer_egaliser_contraste(contexte);
+}
+
+
+static void preparer_bilateral(t_contexte* contexte)
+{
+    t_banc_bilateral* banc;     // Le filtre et l'image lissee.
+
+    banc = (t_banc_bilateral*) ALLOUER(sizeof(t_banc_bilateral));
+    contexte->resultat = banc;
+    if(banc == NULL)
+        return;
+
+    banc->filtre = creer_filtre_bilateral();
+    banc->lissee = creer_tableau2d(contexte->nb_lignes, contexte->nb_colonnes);
+
+    if(banc->filtre != NULL && banc->lissee != NULL)
+        executer_filtrer_bilateral(contexte);
+}
+
+
+static void liberer_resultat(t_contexte* contexte)
+{
+    LIBERER(contexte->resultat);
+    contexte->resultat = NULL;
+}
+
+
+static void detruire_resultat_image(t_contexte* contexte)
+{
+    if(contexte->resultat != NULL)
+        detruire(contexte->resultat, contexte->nb_lignes, contexte->nb_colonnes);
+    contexte->resultat = NULL;
+}
+
+
+static void detruire_resultat_region(t_contexte* contexte)
+{
+    if(contexte->resultat != NULL)
+        detruire(contexte->resultat, contexte->nb_lignes   / FACTEUR_REGION,
+                                     contexte->nb_colonnes / FACTEUR_REGION);
+    contexte->resultat = NULL;
+}
+
+
+static void detruire_resultat_reduite(t_contexte* contexte)
+{
+    if(contexte->resultat != NULL)
+        detruire(contexte->resultat, contexte->nb_lignes   / FACTEUR_REDUCTION,
+                                     contexte->nb_colonnes / FACTEUR_REDUCTION);
+    contexte->resultat = NULL;
+}
+
+
+static void detruire_resultat_vue(t_contexte* contexte)
+{
+    detruire_vue((double**) contexte->resultat);
+    contexte->resultat = NULL;
+}
+
+
+static void detruire_resultat_pyramide(t_contexte* contexte)
+{
+    detruire_pyramide((t_pyramide*) contexte->resultat);
+    contexte->resultat = NULL;
+}
+
+
+static void detruire_resultat_redimension(t_contexte* contexte)
+{
+    if(contexte->resultat != NULL)
+        detruire(contexte->resultat, contexte->nb_lignes   / FACTEUR_REDIMENSION,
+                                     contexte->nb_colonnes / FACTEUR_REDIMENSION);
+    contexte->resultat = NULL;
+}
+
+
+static void detruire_resultat_contours(t_contexte* contexte)
+{
+    detruire_contours((t_contours*) contexte->resultat);
+    contexte->resultat = NULL;
+}
+
+
+static void detruire_resultat_localisateur(t_contexte* contexte)
+{
+    detruire_localisateur((t_localisateur*) contexte->resultat);
+    contexte->resultat = NULL;
+}
+
+
+static void detruire_resultat_banque(t_contexte* contexte)
+{
+    detruire_banque((t_banque*) contexte->resultat);
+    contexte->resultat = NULL;
+}
+
+
+static void detruire_resultat_correlation(t_contexte* contexte)
+{
+    t_banc_correlation* banc = (t_banc_correlation*) contexte->resultat;
+
+    if(banc != NULL)
+    {
+        detruire_correlateur(banc->correlateur);
+        if(banc->correlations != NULL)
+            detruire(banc->correlations, banc->nb_lignes, banc->nb_colonnes);
+        LIBERER(banc);
+    }
+    contexte->resultat = NULL;
+}
+
+
+static void detruire_resultat_hog(t_contexte* contexte)
+{
+    detruire_hog((t_hog*) contexte->resultat);
+    contexte->resultat = NULL;
+}
+
+
+static void detruire_resultat_cascade(t_contexte* contexte)
+{
+    t_banc_cascade* banc = (t_banc_cascade*) contexte->resultat;
+
+    if(banc != NULL)
+    {
+        detruire_cascade(banc->cascade);
+        detruire_detecteur(banc->detecteur);
+        LIBERER(banc);
+    }
+    contexte->resultat = NULL;
+}
+
+
+static void detruire_resultat_coins(t_contexte* contexte)
+{
+    detruire_coins((t_coins*) contexte->resultat);
+    contexte->resultat = NULL;
+}
+
+
+static void detruire_resultat_hough(t_contexte* contexte)
+{
+    detruire_hough((t_hough*) contexte->resultat);
+    contexte->resultat = NULL;
+}
+
+
+static void detruire_resultat_contraste(t_contexte* contexte)
+{
+    t_banc_contraste* banc = (t_banc_contraste*) contexte->resultat;
+
+    if(banc != NULL)
+    {
+        detruire_egaliseur(banc->egaliseur);
+        if(banc->egalisee != NULL)
+            detruire(banc->egalisee, contexte->nb_lignes, contexte->nb_colonnes);
+        LIBERER(banc);
+    }
+    contexte->resultat = NULL;
+}
+
+
+static void detruire_resultat_bilateral(t_contexte* contexte)
+{
+    t_banc_bilateral* banc = (t_banc_bilateral*) contexte->resultat;
+
+    if(banc != NULL)
+    {
+        detruire_filtre_bilateral(banc->filtre);
+        if(banc->lissee != NULL)
+            detruire(banc->lissee, contexte->nb_lignes, contexte->nb_colonnes);
+        LIBERER(banc);
+    }
+    contexte->resultat = NULL;
+}
+
+
+static void detruire_resultat_tableau1d(t_contexte* contexte)
+{
+    detruire_tableau1d((double*) contexte->resultat);
+    contexte->resultat = NULL;
+}
+
+
+static void detruire_resultat_tableau2d(t_contexte* contexte)
+{
+    detruire_tableau2d((double**) contexte->resultat, contexte->nb_lignes);
+    contexte->resultat = NULL;
+}
+
+
+static double octets_bitmap(t_contexte* contexte)
+{
+    long taille_ligne;  // Le nombre d'octets d'une ligne alignee sur 4 octets.
+
+    taille_ligne = ((long) contexte->nb_colonnes * NB_BITS_IMAGE / 8 + 3) / 4 * 4;
+
+    return (double) taille_ligne * contexte->nb_lignes;
+}
+
+
+static double octets_fichier(t_contexte* contexte)
+{
+    long taille_ligne;  // Le nombre d'octets d'une ligne alignee sur 4 octets.
+
+    taille_ligne = ((long) contexte->nb_colonnes * NB_BITS_FICHIER / 8 + 3) / 4 * 4;
+
+    return (double) taille_ligne * contexte->nb_lignes;
+}
+
+
+static double octets_region(t_contexte* contexte)
+{
+    return octets_fichier(contexte) / (FACTEUR_REGION * FACTEUR_REGION);
+}
+
+
+static double octets_tableau(t_contexte* contexte)
+{
+    return (double) contexte->nb_lignes * contexte->nb_colonnes * sizeof(double);
+}
+
+
+static double octets_bande(t_contexte* contexte)
+{
+    return (double) LIGNES_GLYPHE * contexte->nb_colonnes * sizeof(double);
+}
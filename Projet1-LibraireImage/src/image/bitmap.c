@@ -9,9 +9,14 @@
     bitmap.
 ****************************************************************************************/
 #include "bitmap.h"
+#include "bitmap_interne.h"
+#include "../outils/instrumentation.h"
+#include "../outils/memoire.h"
 
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 
 
@@ -29,8 +34,20 @@
 #define ID1 'B'
 #define ID2 'M'
 
-// Indique qu'il n'y a pas de compression.
-#define SANS_COMPRESSION    0
+// Les types de compression supports.
+#define SANS_COMPRESSION        0
+#define COMPRESSION_RLE8        1
+#define COMPRESSION_RLE4        2
+#define COMPRESSION_BITFIELDS   3
+
+// Le plus grand nombre de pixels d'une image lue (16384 x 16384). Une image
+// compresse peut annoncer des dimensions sans rapport avec sa taille.
+#define NB_PIXELS_MAX       (1LL << 28)
+
+// Les commandes (prcdes d'un octet  0) d'un flux RLE.
+#define RLE_FIN_LIGNE       0
+#define RLE_FIN_IMAGE       1
+#define RLE_DEPLACEMENT     2
 
 // Le nombre de pixel par mtre lorsqu'on crit une image.
 #define PIXEL_PAR_METRE     4000
@@ -38,10 +55,45 @@
 // Le nombre de bits dans une image RGB et le nombre de couleurs.
 #define NB_BITS_3_COULEURS  24
 
+// Les autres nombres de bits par pixel supports en lecture.
+#define NB_BITS_MONOCHROME  1
+#define NB_BITS_16_COULEURS 4
+#define NB_BITS_BGRA        32
+
+// Les masques usuels des couleurs d'un pixel de 32 bits (BGRA).
+#define MASQUE_ROUGE        0x00FF0000u
+#define MASQUE_VERT         0x0000FF00u
+#define MASQUE_BLEU         0x000000FFu
+
+// Le nombre de bits d'une image  palette de 256 couleurs, comme celles
+// crites par ecrire, et la taille d'une entre de la palette (BGR + rserv).
+#define NB_BITS_GRIS        8
+#define TAILLE_COULEUR      4
+
+// La position des couleurs dans un pixel ou une couleur de palette du 
+// fichier, qui sont rangs en BGR.
+#define OCTET_BLEU          0
+#define OCTET_VERT          1
+#define OCTET_ROUGE         2
+#define OCTET_RESERVE       3
+
 // Les valeurs binaires.
 #define VRAI    1
 #define FAUX    0
 
+// Le nombre de valeurs d'un octet et la somme maximale des trois couleurs
+// d'un pixel.
+#define NB_VALEURS_OCTET    256
+#define SOMME_MAX_RGB       (NB_COULEURS_RGB * 255)
+
+// La taille en octets d'une palette complte.
+#define TAILLE_PALETTE      (NB_VALEURS_OCTET * TAILLE_COULEUR)
+
+// Les pondrations de la luminance sont en virgule fixe Q16: 1.0 vaut
+// 1 << BITS_VIRGULE_FIXE.
+#define BITS_VIRGULE_FIXE   16
+#define UN_VIRGULE_FIXE     (1 << BITS_VIRGULE_FIXE)
+
 #pragma pack(1)
 
 /*
@@ -95,6 +147,38 @@ typedef struct
 typedef unsigned char byte;
 
 
+/*
+    T_CANAL
+
+    L'extraction d'une couleur d'un pixel de 32 bits selon son masque: la 
+    couleur vaut table[(pixel & masque) >> decalage].
+*/
+typedef struct
+{
+    unsigned int masque;                // Les bits de la couleur dans le pixel.
+    int          decalage;              // Ramne les 8 bits de poids fort de la couleur
+                                        // au bas du pixel.
+    byte         table[NB_VALEURS_OCTET];   // tire les couleurs de moins de 8 bits.
+
+}t_canal;
+
+
+/*
+    T_REGION
+
+    Un rectangle de l'image, en lignes et colonnes  partir du coin en haut
+     gauche.
+*/
+typedef struct
+{
+    int ligne;          // La premire ligne et la premire colonne de la rgion.
+    int colonne;
+    int nb_lignes;      // La taille de la rgion.
+    int nb_colonnes;
+
+}t_region;
+
+
 
 /****************************************************************************************
 *                           DCLARATION DES FONCTIONS PRIVES                           *
@@ -136,38 +220,140 @@ static int est_bitmap(t_entete_bmp entete);
 
 
 /*
-    CONVERSION_2D_A_1D
+    TAILLE_LIGNE_FICHIER
 
-    Cette fonction permet de convertir une image (tableau 3D) en un
-    tableau 1D sous le format du standard bitmap.
-    
-    Paramtre:
-      - [void *] image: L'image  convertir.
-      - [int   ] nb_lignes      : Le nombre de lignes de l'image finale.
-      - [int   ] nb_colonnes    : Le nombre de colonnes de l'image finale.
-    
-    Retour: L'image sous la forme d'un tableau 1D.
+    Cette fonction calcule le nombre d'octets d'une ligne de pixels dans un
+    fichier bitmap, alignement sur 4 octets compris.
+
+    Paramtres:
+      [int] nb_bits_pixel : Le nombre de bits par pixel (1, 4, 8, 24 ou 32).
+      [int] nb_colonnes   : Le nombre de colonnes de l'image.
+
+    Retour: La taille d'une ligne en octets.
 */
-static void* conversion_2D_a_1D(void* image, int nb_lignes, int nb_colonnes);
+static long taille_ligne_fichier(int nb_bits_pixel, int nb_colonnes);
 
 
 
 /*
-    CONVERSION_1D_A_2D
-    Cette fonction converti une image qui a t vectorise (1D) en tableau
-    2D.
-    
+    LIRE_PIXELS
+
+    Cette fonction ouvre un fichier bitmap, vrifie ses enttes et lit les
+    lignes d'une rgion de l'image telles que ranges dans le fichier (des
+    lignes compltes, chacune complte  un multiple de 4). Puisque les
+    lignes sont  des positions fixes, seules celles de la rgion sont lues,
+    en une seule lecture. Les images compresses en RLE4 ou RLE8 sont lues au
+    complet puis dcompresses en index de 8 bits.
+
     Paramtres:
-      - [void* ] image_1D       : L'image 1D  modifier.
-      - [int   ] nb_lignes      : Le nombre de lignes de l'image finale.
-      - [int   ] nb_colonnes    : Le nombre de colonnes de l'image finale.
-      - [int   ] nb_bits_pixel  : Le nombre de bits par pixel de l'image.
-    
-    Retour: L'image reu en paramtre, mais organise en tableau 2D.
-*/    
-static void* conversion_1D_a_2D(void* image_1D, int nb_lignes,
-                                                int nb_colonnes,
-                                                int nb_bits_pixel);
+      - [char*           ] nom_fichier : Le chemin du fichier  ouvrir.
+      - [t_format_pixels*] format      : Reoit le format des pixels lus, dont la
+                                         largeur des lignes et la premire colonne
+                                         de la rgion.
+      - [byte*           ] palette     : Reoit la palette d'une image de 1, 4 ou 
+                                         8 bits (TAILLE_PALETTE octets); les 
+                                         couleurs absentes du fichier sont noires.
+      - [t_region*       ] region      : La rgion  lire. Si elle est vide 
+                                         (0 ligne), elle reoit la plus grande 
+                                         partie de l'image,  partir du coin en
+                                         haut  gauche, dont les dimensions sont
+                                         des multiples de 'facteur'.
+      - [int             ] facteur     : 1 pour lire toute l'image.
+
+    Retour: Les lignes de la rgion ( librer avec LIBERER), ou NULL si le
+            fichier n'existe pas, n'est pas d'un format support, est tronqu
+            ou si la rgion dpasse de l'image.
+*/
+static byte* lire_pixels(char* nom_fichier, t_format_pixels* format, byte* palette,
+                         t_region* region, int facteur);
+
+
+
+/*
+    DECOMPRESSER_RLE
+
+    Cette fonction dcompresse les pixels d'une image RLE8 ou RLE4 en index
+    de 8 bits, rangs comme ceux d'une image de 8 bits sans compression. Les
+    pixels sauts par le flux (fin de ligne ou dplacement) valent 0. Un flux
+    corrompu arrte la dcompression sans jamais crire hors de l'image.
+
+    Paramtres:
+      - [byte*] donnees       : Les pixels compresss.
+      - [long ] taille        : La taille des pixels compresss en octets.
+      - [int  ] nb_lignes     : Le nombre de lignes de l'image.
+      - [int  ] nb_colonnes   : Le nombre de colonnes de l'image.
+      - [int  ] nb_bits_pixel : 8 pour RLE8, 4 pour RLE4.
+
+    Retour: Les index dcompresss, ou NULL si la mmoire manque.
+*/
+static byte* decompresser_rle(const byte* donnees, long taille, int nb_lignes,
+                                                              int nb_colonnes,
+                                                              int nb_bits_pixel);
+
+
+
+/*
+    PREPARER_CANAUX
+
+    Cette fonction prpare l'extraction des couleurs d'un pixel de 32 bits 
+    selon les masques du format. Chaque couleur est ramene sur 8 bits.
+
+    Paramtres:
+      - [t_format_pixels*] format : Le format des pixels.
+      - [t_canal         ] canaux : Reoit l'extraction de chaque couleur,
+                                    dans l'ordre ROUGE, VERT, BLEU.
+
+    Retour: 1 si les masques ne sont pas les masques usuels (0x00FF0000, 
+            0x0000FF00, 0x000000FF) et qu'il faut extraire les couleurs, 0 si
+            les pixels peuvent tre lus directement en BGRA.
+*/
+static int preparer_canaux(const t_format_pixels* format, t_canal canaux[NB_COULEURS_RGB]);
+
+
+
+/*
+    LIGNE_CANONIQUE
+
+    Cette fonction retourne une ligne de pixels sous l'une des trois formes
+    traites par les conversions: un index de 8 bits par pixel (images de 1,
+    4 et 8 bits), BGR (24 bits) ou BGRA (32 bits). Lorsque la ligne du
+    fichier a dj cette forme, elle est retourne telle quelle; sinon, elle
+    est dpaquete dans le tampon.
+
+    Paramtres:
+      - [byte*           ] ligne_1D    : La ligne telle que range dans le fichier.
+      - [int             ] premiere_colonne : La premire colonne  convertir.
+      - [int             ] nb_colonnes : Le nombre de colonnes  convertir.
+      - [t_format_pixels*] format      : Le format des pixels.
+      - [t_canal*        ] canaux      : L'extraction des couleurs en 32 bits, ou
+                                         NULL si les pixels sont dj en BGRA.
+      - [byte*           ] tampon      : Au moins nb_colonnes * TAILLE_COULEUR octets.
+
+    Retour: La ligne sous sa forme canonique.
+*/
+static const byte* ligne_canonique(const byte* ligne_1D, int premiere_colonne,
+                                   int nb_colonnes, const t_format_pixels* format,
+                                   const t_canal* canaux, byte* tampon);
+
+
+
+/*
+    CONSTRUIRE_TABLES_LUMINANCE
+
+    Cette procdure remplit une table par couleur qui donne, pour chaque valeur
+    d'octet, sa contribution  la luminance en virgule fixe Q16. La luminance
+    d'un pixel est alors la somme de trois lectures de tables.
+
+    Paramtres:
+      - [int         ] luminance : LUMINANCE_MOYENNE, LUMINANCE_BT601 ou
+                                   LUMINANCE_BT709.
+      - [unsigned int] tables    : Les tables  remplir, indexes par couleur
+                                   (ROUGE, VERT, BLEU) puis par valeur.
+
+    Retour: 1 si la pondration est connue, 0 sinon.
+*/
+static int construire_tables_luminance(int luminance,
+                                       unsigned int tables[NB_COULEURS_RGB][NB_VALEURS_OCTET]);
 
 
 
@@ -183,7 +369,8 @@ static void* conversion_1D_a_2D(void* image_1D, int nb_lignes,
       - [int   ] nb_colonnes    : Le nombre de colonnes de l'image finale.
       - [int   ] nb_bits_pixel  : Le nombre de bits par pixel de l'image.
     
-    Retour: L'image reu en paramtre, mais organise en tableau 2D.
+    Retour: L'image reu en paramtre, mais organise en tableau 2D, ou NULL
+            si la mmoire manque.
 */    
 static double** creer_image_2D(int nb_lignes, int nb_colonnes);
 
@@ -211,53 +398,164 @@ static double clamp(double valeur, double min, double max);
 int lire(char* nom_fichier, void** image, int* nb_lignes, int* nb_colonnes)
 {
     int             a_ete_charger;  // La russite ou l'chec de la lecture du fichier.
-    FILE*           no_fichier;     // Le numro du fichier.
-    t_entete_bmp    entete_bmp;     // L'entte du fichier bitmap.
-    t_entete_dib    entete_dib;     // L'entte qui contient l'information sur l'image.
+    t_format_pixels format;         // Le format des pixels du fichier.
     byte*           image_1D;       // L'image qui sera retourne par la fonction dans 
                                     // un tableau 1D.
+    byte            palette[TAILLE_PALETTE];    // La palette d'une image de 1, 4 ou 8 bits.
+    t_region        region = { 0 }; // La rgion lue: toute l'image.
     
+    INSTRUMENTER_DEBUT(ETAPE_LIRE);
+
     // On emet comme hypothese que le fichier ne sera pas charg.
     a_ete_charger = FAUX;
     
-    // Ouvrir l'image reu en lecture binaire.
-    no_fichier = fopen(nom_fichier, "rb");
-    if(no_fichier != NULL)
+    // Lire l'image (tableau de pixels) au complet.
+    image_1D = lire_pixels(nom_fichier, &format, palette, &region, 1);
+    if(image_1D != NULL)
     {
-        // Lire les enttes du fichier.
-        fread(&entete_bmp, sizeof(entete_bmp), 1, no_fichier);
-        fread(&entete_dib, sizeof(entete_dib), 1, no_fichier);
+        // Transformer l'image en tableau 3D.
+        (*image) = conversion_1D_a_2D(image_1D, region.nb_lignes, region.nb_colonnes, &format);
 
-        // Vrifier si le fichier respecte le format bitmap.
-        if(est_bitmap(entete_bmp))
+        // L'image 1D n'est plus ncessaire.
+        LIBERER(image_1D);
+    
+        // La conversion choue si la mmoire manque.
+        if(*image != NULL)
         {
+            // L'image est charg avec success.
+            *nb_lignes    = region.nb_lignes;
+            *nb_colonnes  = region.nb_colonnes;
+            a_ete_charger = VRAI;
+        }
+    }
+
+    INSTRUMENTER_FIN(ETAPE_LIRE);
+
+    return a_ete_charger;
+}
+
 
-            // Si il y a de la compression ou si le nombre de bits par pixel n'est pas 24, on arrte.
-            if(entete_dib.type_compression == SANS_COMPRESSION && 
-               entete_dib.nb_bits_pixel    == NB_BITS_3_COULEURS)
+
+int lire_gris(char* nom_fichier, unsigned char** image, int* nb_lignes,
+                                                         int* nb_colonnes,
+                                                         int luminance)
+{
+    int             a_ete_charger;  // La russite ou l'chec de la lecture du fichier.
+    t_format_pixels format;         // Le format des pixels du fichier.
+    byte*           image_1D;       // Les pixels tels que rangs dans le fichier.
+    byte            palette[TAILLE_PALETTE];    // La palette d'une image de 1, 4 ou 8 bits.
+    t_region        region = { 0 }; // La rgion lue: toute l'image.
+    
+    INSTRUMENTER_DEBUT(ETAPE_LIRE_GRIS);
+
+    // On emet comme hypothese que le fichier ne sera pas charg.
+    a_ete_charger = FAUX;
+
+    image_1D = lire_pixels(nom_fichier, &format, palette, &region, 1);
+    if(image_1D != NULL)
+    {
+        (*image) = (unsigned char*) conversion_1D_a_gris(image_1D, region.nb_lignes,
+                                                         region.nb_colonnes,
+                                                         &format, luminance);
+        LIBERER(image_1D);
+
+        // La conversion choue si la pondration est inconnue.
+        if(*image != NULL)
+        {
+            *nb_lignes    = region.nb_lignes;
+            *nb_colonnes  = region.nb_colonnes;
+            a_ete_charger = VRAI;
+        }
+    }
+
+    INSTRUMENTER_FIN(ETAPE_LIRE_GRIS);
+
+    return a_ete_charger;
+}
+
+
+
+int lire_region(char* nom_fichier, void** image, int ligne, int colonne,
+                                                 int nb_lignes, int nb_colonnes)
+{
+    int             a_ete_charger;  // La russite ou l'chec de la lecture du fichier.
+    t_format_pixels format;         // Le format des pixels du fichier.
+    byte*           image_1D;       // Les lignes de la rgion, telles que ranges
+                                    // dans le fichier.
+    byte            palette[TAILLE_PALETTE];    // La palette d'une image de 1, 4 ou 8 bits.
+    t_region        region;         // La rgion  lire.
+    
+    INSTRUMENTER_DEBUT(ETAPE_LIRE_REGION);
+
+    // On emet comme hypothese que le fichier ne sera pas charg.
+    a_ete_charger = FAUX;
+
+    // Une rgion vide n'est pas une image.
+    if(nb_lignes > 0 && nb_colonnes > 0)
+    {
+        region.ligne       = ligne;
+        region.colonne     = colonne;
+        region.nb_lignes   = nb_lignes;
+        region.nb_colonnes = nb_colonnes;
+
+        // Seules les lignes de la rgion sont lues, et seules ses colonnes 
+        // sont converties.
+        image_1D = lire_pixels(nom_fichier, &format, palette, &region, 1);
+        if(image_1D != NULL)
+        {
+            (*image) = conversion_1D_a_2D(image_1D, nb_lignes, nb_colonnes, &format);
+            LIBERER(image_1D);
+
+            if(*image != NULL)
+                a_ete_charger = VRAI;
+        }
+    }
+
+    INSTRUMENTER_FIN(ETAPE_LIRE_REGION);
+
+    return a_ete_charger;
+}
+
+
+
+int lire_reduite(char* nom_fichier, void** image, int* nb_lignes, int* nb_colonnes,
+                                                  int facteur)
+{
+    int             a_ete_charger;  // La russite ou l'chec de la lecture du fichier.
+    t_format_pixels format;         // Le format des pixels du fichier.
+    byte*           image_1D;       // Les lignes des blocs complets, telles que ranges
+                                    // dans le fichier.
+    byte            palette[TAILLE_PALETTE];    // La palette d'une image de 1, 4 ou 8 bits.
+    t_region        region = { 0 }; // La rgion lue: les blocs complets de l'image.
+    
+    INSTRUMENTER_DEBUT(ETAPE_LIRE_REDUITE);
+
+    // On emet comme hypothese que le fichier ne sera pas charg.
+    a_ete_charger = FAUX;
+
+    if(facteur >= 1 && facteur <= FACTEUR_REDUCTION_MAX)
+    {
+        // Les dernires lignes qui ne forment pas un bloc complet ne sont pas
+        // lues, ni leurs dernires colonnes converties.
+        image_1D = lire_pixels(nom_fichier, &format, palette, &region, facteur);
+        if(image_1D != NULL)
+        {
+            (*image) = conversion_1D_a_2D_reduite(image_1D, region.nb_lignes / facteur,
+                                                  region.nb_colonnes / facteur,
+                                                  &format, facteur);
+            LIBERER(image_1D);
+
+            if(*image != NULL)
             {
-        
-                // Lire l'image (tableau de pixels) au complet.
-                image_1D = (byte*) malloc(entete_dib.taille * sizeof(byte));
-                fread(image_1D, sizeof(byte), entete_dib.taille, no_fichier);
-            
-                // Transformer l'image en tableau 3D.
-                (*image) = conversion_1D_a_2D(image_1D, entete_dib.hauteur,
-                                                        entete_dib.largeur, 
-                                                        entete_dib.nb_bits_pixel);
-            
-                // L'image est charg avec success.
-                *nb_lignes    = entete_dib.hauteur;
-                *nb_colonnes  = entete_dib.largeur;
+                *nb_lignes    = region.nb_lignes   / facteur;
+                *nb_colonnes  = region.nb_colonnes / facteur;
                 a_ete_charger = VRAI;
-        
             }
         }
-        
-        // Fermer le fichier.
-        fclose(no_fichier);
     }
 
+    INSTRUMENTER_FIN(ETAPE_LIRE_REDUITE);
+
     return a_ete_charger;
 }
 
@@ -270,17 +568,32 @@ void ecrire(char* nom_fichier, void* image, int nb_lignes, int nb_colonnes)
     t_entete_bmp entete_bmp;    // Les deux enttes du fichier bitmap.
     t_entete_dib entete_dib;
     long    taille_image;       // Le nombre de byte de donnes dans l'image.
+    byte    palette[TAILLE_PALETTE];    // La palette de gris de l'image.
+    int     i;                  // Itrateur sur les couleurs de la palette.
             
-    // Tranformer l'image 3D en un tableau 1D.
-    image_1D     = (byte*) conversion_2D_a_1D(image, nb_lignes, nb_colonnes);
-    taille_image =  nb_lignes*(nb_colonnes * NB_COULEURS_RGB +
-                               octets_a_sauter(NB_BITS_3_COULEURS, nb_colonnes));
+    INSTRUMENTER_DEBUT(ETAPE_ECRIRE);
+
+    // Tranformer l'image 3D en un tableau 1D. L'image tant en niveaux de
+    // gris, chaque pixel est un index de 8 bits dans une palette de gris: le
+    // fichier est 3 fois plus petit qu'en RGB 24 bits.
+    image_1D     = (byte*) conversion_2D_a_1D(image, nb_lignes, nb_colonnes, NB_BITS_GRIS);
+    taille_image =  nb_lignes*(nb_colonnes +
+                               octets_a_sauter(NB_BITS_GRIS, nb_colonnes));
+
+    // La couleur i de la palette est le gris (i, i, i).
+    for(i = 0; i < NB_VALEURS_OCTET; i++)
+    {
+        palette[i * TAILLE_COULEUR + OCTET_BLEU   ] = (byte) i;
+        palette[i * TAILLE_COULEUR + OCTET_VERT   ] = (byte) i;
+        palette[i * TAILLE_COULEUR + OCTET_ROUGE  ] = (byte) i;
+        palette[i * TAILLE_COULEUR + OCTET_RESERVE] = 0;
+    }
 
     // Initialiser les enttes.
     entete_bmp.id[0] = ID1;
     entete_bmp.id[1] = ID2;
-    entete_bmp.debut_image = sizeof(entete_bmp) + sizeof(entete_dib);
-    entete_bmp.taille      = sizeof(entete_bmp) + sizeof(entete_dib) + taille_image;
+    entete_bmp.debut_image = sizeof(entete_bmp) + sizeof(entete_dib) + TAILLE_PALETTE;
+    entete_bmp.taille      = entete_bmp.debut_image + taille_image;
                              
                                                 
     
@@ -288,29 +601,39 @@ void ecrire(char* nom_fichier, void* image, int nb_lignes, int nb_colonnes)
     entete_dib.largeur = nb_colonnes;
     entete_dib.hauteur = nb_lignes;
     entete_dib.nb_plans_couleur = 1;
-    entete_dib.nb_bits_pixel = NB_BITS_3_COULEURS;
+    entete_dib.nb_bits_pixel = NB_BITS_GRIS;
     entete_dib.type_compression = SANS_COMPRESSION;
     entete_dib.taille =taille_image;
     entete_dib.resolution_horizontale = PIXEL_PAR_METRE;
     entete_dib.resolution_verticale = PIXEL_PAR_METRE;
-    entete_dib.nb_couleurs_palette = 0;
+    entete_dib.nb_couleurs_palette = NB_VALEURS_OCTET;
     entete_dib.nb_couleurs_importantes = 0;
     
     // Ouvrir le fichier en criture binaire.
     no_fichier = fopen(nom_fichier, "wb");
     if(no_fichier != NULL)
     {
+        INSTRUMENTER_DEBUT(ETAPE_ECRIRE_FICHIER);
     
         // crire les deux enttes.
         fwrite(&entete_bmp, sizeof(entete_bmp), 1, no_fichier);
         fwrite(&entete_dib, sizeof(entete_dib), 1, no_fichier);
+        fwrite(palette, TAILLE_PALETTE, 1, no_fichier);
     
         // crire l'image.
         fwrite(image_1D, entete_dib.taille, 1, no_fichier);
     
         // Fermer le fichier.
         fclose(no_fichier);
+
+        INSTRUMENTER_FIN(ETAPE_ECRIRE_FICHIER);
+        INSTRUMENTER_COMPTER(COMPTEUR_OCTETS_ECRITS, entete_bmp.taille);
     }
+
+    // L'image 1D n'est plus ncessaire.
+    LIBERER(image_1D);
+
+    INSTRUMENTER_FIN(ETAPE_ECRIRE);
 }
 
 
@@ -325,11 +648,18 @@ void detruire(void* image, int nb_lignes, int nb_colonnes)
     // On doit librer le tableau reprsentant chaque ligne
     for(i=0; i<nb_lignes; i++)
     {
-        free(image2D[i]);
+        LIBERER(image2D[i]);
     }
 
     //On peut maintenant librer le tableau de ligne.
-    free(image2D);
+    LIBERER(image2D);
+}
+
+
+
+void detruire_gris(unsigned char* image)
+{
+    LIBERER(image);
 }
 
 /****************************************************************************************
@@ -362,7 +692,477 @@ static int est_bitmap(t_entete_bmp entete)
 }
 
 
-static void* conversion_2D_a_1D(void* image, int nb_lignes, int nb_colonnes)
+static long taille_ligne_fichier(int nb_bits_pixel, int nb_colonnes)
+{
+    // On arrondit le nombre de bits d'une ligne au multiple de 32 suivant.
+    return (((long) nb_colonnes * nb_bits_pixel + 31) / 32) * MULTIPLE_TAILLE_COLONNE;
+}
+
+
+static byte* lire_pixels(char* nom_fichier, t_format_pixels* format, byte* palette,
+                         t_region* region, int facteur)
+{
+    FILE*           no_fichier;     // Le numro du fichier.
+    t_entete_bmp    entete_bmp;     // L'entte du fichier bitmap.
+    t_entete_dib    entete_dib;     // L'entte qui contient l'information sur l'image.
+    byte*           image_1D;       // Les pixels lus.
+    byte*           donnees;        // Les pixels compresss.
+    long            taille;         // La taille des pixels  lire en octets.
+    long            debut;          // La position des pixels  lire dans le fichier.
+    long            taille_ligne;   // La taille d'une ligne du fichier (ou dcompresse).
+    int             hauteur;        // Le nombre de lignes de l'image.
+    int             premiere_ligne; // La premire ligne de la rgion dans le fichier.
+    int             est_valide;     // Vrai si les enttes sont supportes.
+    int             est_compresse;  // Vrai si l'image est en RLE4 ou RLE8.
+    int             nb_couleurs;    // Le nombre de couleurs de la palette.
+    unsigned int    masques[NB_COULEURS_RGB];   // Les masques lus, dans l'ordre du fichier.
+
+    // Ouvrir l'image reu en lecture binaire.
+    no_fichier = fopen(nom_fichier, "rb");
+    if(no_fichier == NULL)
+        return NULL;
+
+    // Lire les enttes du fichier.
+    est_valide = fread(&entete_bmp, sizeof(entete_bmp), 1, no_fichier) == 1 &&
+                 fread(&entete_dib, sizeof(entete_dib), 1, no_fichier) == 1;
+
+    // Vrifier si le fichier respecte le format bitmap. Une hauteur ngative
+    // indique que les lignes sont ranges  partir du haut.
+    est_valide = est_valide && est_bitmap(entete_bmp) &&
+                 entete_dib.taille_entete >= (int) sizeof(entete_dib) &&
+                 entete_dib.largeur > 0 && entete_dib.hauteur != 0 &&
+                 entete_dib.hauteur != INT_MIN &&
+                 (long long) entete_dib.largeur * abs(entete_dib.hauteur) <= NB_PIXELS_MAX;
+
+    // Les combinaisons de compression et de nombre de bits supportes. Les
+    // images compresses sont toujours ranges  partir du bas.
+    est_compresse = entete_dib.type_compression == COMPRESSION_RLE8 ||
+                    entete_dib.type_compression == COMPRESSION_RLE4;
+    switch(entete_dib.type_compression)
+    {
+        case SANS_COMPRESSION:
+            est_valide = est_valide && (entete_dib.nb_bits_pixel == NB_BITS_MONOCHROME ||
+                                        entete_dib.nb_bits_pixel == NB_BITS_16_COULEURS ||
+                                        entete_dib.nb_bits_pixel == NB_BITS_GRIS ||
+                                        entete_dib.nb_bits_pixel == NB_BITS_3_COULEURS ||
+                                        entete_dib.nb_bits_pixel == NB_BITS_BGRA);
+            break;
+
+        case COMPRESSION_RLE8:
+            est_valide = est_valide && entete_dib.nb_bits_pixel == NB_BITS_GRIS &&
+                                       entete_dib.hauteur > 0;
+            break;
+
+        case COMPRESSION_RLE4:
+            est_valide = est_valide && entete_dib.nb_bits_pixel == NB_BITS_16_COULEURS &&
+                                       entete_dib.hauteur > 0;
+            break;
+
+        case COMPRESSION_BITFIELDS:
+            est_valide = est_valide && entete_dib.nb_bits_pixel == NB_BITS_BGRA;
+            break;
+
+        default:
+            est_valide = FAUX;
+    }
+
+    if(est_valide)
+    {
+        hauteur = entete_dib.hauteur > 0 ? entete_dib.hauteur : -entete_dib.hauteur;
+
+        // Une rgion vide dsigne toute l'image, moins les dernires lignes
+        // et colonnes qui ne forment pas un bloc complet lors d'une rduction;
+        // sinon, elle doit y tre entirement contenue.
+        if(region->nb_lignes <= 0)
+        {
+            region->ligne       = 0;
+            region->colonne     = 0;
+            region->nb_lignes   = hauteur            - hauteur            % facteur;
+            region->nb_colonnes = entete_dib.largeur - entete_dib.largeur % facteur;
+        }
+        est_valide = region->ligne >= 0 && region->colonne >= 0 &&
+                     region->nb_lignes > 0 && region->nb_colonnes > 0 &&
+                     region->ligne   <= hauteur            - region->nb_lignes &&
+                     region->colonne <= entete_dib.largeur - region->nb_colonnes;
+
+        format->nb_bits_pixel    = entete_dib.nb_bits_pixel;
+        format->de_haut_en_bas   = entete_dib.hauteur < 0;
+        format->largeur_fichier  = entete_dib.largeur;
+        format->premiere_colonne = region->colonne;
+        format->masques[ROUGE]   = MASQUE_ROUGE;
+        format->masques[VERT]    = MASQUE_VERT;
+        format->masques[BLEU]    = MASQUE_BLEU;
+        format->palette          = palette;
+
+        // Dans le fichier, la rgion commence  sa ligne du haut si les lignes
+        // sont ranges  partir du haut, et  sa ligne du bas sinon.
+        premiere_ligne = format->de_haut_en_bas ? region->ligne :
+                         hauteur - region->ligne - region->nb_lignes;
+    }
+
+    // La palette suit l'entte DIB, dont la taille varie selon la version du
+    // format. Une palette de 0 couleur les a toutes.
+    if(est_valide && entete_dib.nb_bits_pixel <= NB_BITS_GRIS)
+    {
+        nb_couleurs = entete_dib.nb_couleurs_palette;
+        if(nb_couleurs <= 0 || nb_couleurs > (1 << entete_dib.nb_bits_pixel))
+            nb_couleurs = 1 << entete_dib.nb_bits_pixel;
+
+        memset(palette, 0, TAILLE_PALETTE);
+        est_valide = fseek(no_fichier, sizeof(entete_bmp) + entete_dib.taille_entete,
+                           SEEK_SET) == 0 &&
+                     fread(palette, TAILLE_COULEUR, nb_couleurs, no_fichier) ==
+                           (size_t) nb_couleurs;
+    }
+
+    // Les masques suivent les 40 premiers octets de l'entte DIB, qu'ils 
+    // fassent partie d'une entte plus longue ou non.
+    if(est_valide && entete_dib.type_compression == COMPRESSION_BITFIELDS)
+    {
+        est_valide = fread(masques, sizeof(masques), 1, no_fichier) == 1;
+
+        format->masques[ROUGE] = masques[0];
+        format->masques[VERT]  = masques[1];
+        format->masques[BLEU]  = masques[2];
+    }
+
+    image_1D = NULL;
+    if(est_valide)
+    {
+        // Sans compression, la taille de l'entte peut valoir 0: on calcule
+        // plutt la position et la taille des lignes de la rgion  partir
+        // des dimensions. Avec compression, elle est obligatoire et tous les
+        // pixels sont lus.
+        taille_ligne = taille_ligne_fichier(entete_dib.nb_bits_pixel, entete_dib.largeur);
+        if(est_compresse)
+        {
+            debut  = entete_bmp.debut_image;
+            taille = entete_dib.taille;
+        }
+        else
+        {
+            debut  = entete_bmp.debut_image + premiere_ligne * taille_ligne;
+            taille = region->nb_lignes * taille_ligne;
+        }
+
+        // Des dimensions corrompues ne doivent pas provoquer une allocation
+        // plus grande que le fichier lui-mme.
+        if(fseek(no_fichier, 0, SEEK_END) != 0 || taille > ftell(no_fichier) - debut)
+            taille = 0;
+
+        donnees = taille > 0 ? (byte*) ALLOUER(taille * sizeof(byte)) : NULL;
+        INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 1);
+
+        INSTRUMENTER_DEBUT(ETAPE_LIRE_FICHIER);
+
+        // Les pixels commencent  debut_image, qui n'est pas toujours 
+        // immdiatement aprs les enttes.
+        if(donnees != NULL &&
+           (fseek(no_fichier, debut, SEEK_SET) != 0 ||
+            fread(donnees, sizeof(byte), taille, no_fichier) != (size_t) taille))
+        {
+            LIBERER(donnees);
+            donnees = NULL;
+        }
+
+        INSTRUMENTER_FIN(ETAPE_LIRE_FICHIER);
+        INSTRUMENTER_COMPTER(COMPTEUR_OCTETS_LUS, entete_bmp.debut_image + taille);
+
+        // Une image compresse devient une image de 8 bits sans compression,
+        // dont on ne garde que les lignes de la rgion.
+        if(donnees != NULL && est_compresse)
+        {
+            image_1D = decompresser_rle(donnees, taille, hauteur, entete_dib.largeur,
+                                        entete_dib.nb_bits_pixel);
+            format->nb_bits_pixel = NB_BITS_GRIS;
+            LIBERER(donnees);
+
+            taille_ligne = taille_ligne_fichier(NB_BITS_GRIS, entete_dib.largeur);
+            if(image_1D != NULL && premiere_ligne > 0)
+                memmove(image_1D, image_1D + premiere_ligne * taille_ligne,
+                        region->nb_lignes * taille_ligne);
+        }
+        else
+        {
+            image_1D = donnees;
+        }
+    }
+
+    // Fermer le fichier.
+    fclose(no_fichier);
+
+    return image_1D;
+}
+
+
+static byte* decompresser_rle(const byte* donnees, long taille, int nb_lignes,
+                                                              int nb_colonnes,
+                                                              int nb_bits_pixel)
+{
+    byte* image;            // Les index dcompresss.
+    byte* ligne_1D;         // La ligne en cours de dcompression.
+    long  taille_ligne;     // La taille d'une ligne dcompresse.
+    long  i;                // La position dans les donnes compresses.
+    int   ligne;            // La position en cours dans l'image.
+    int   colonne;
+    int   nombre;           // Les deux octets d'une commande.
+    int   valeur;
+    int   nb_octets;        // Le nombre d'octets d'une suite de pixels absolus.
+    int   k;                // Itrateur sur les pixels d'une commande.
+
+    taille_ligne = taille_ligne_fichier(NB_BITS_GRIS, nb_colonnes);
+
+    image = (byte*) ALLOUER(nb_lignes * taille_ligne);
+    INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 1);
+    if(image == NULL)
+        return NULL;
+    memset(image, 0, nb_lignes * taille_ligne);
+
+    i       = 0;
+    ligne   = 0;
+    colonne = 0;
+    while(i + 1 < taille && ligne < nb_lignes)
+    {
+        nombre = donnees[i];
+        valeur = donnees[i + 1];
+        i += 2;
+
+        ligne_1D = image + ligne * taille_ligne;
+
+        if(nombre > 0)
+        {
+            // Mode encod: 'nombre' pixels de la mme valeur (en RLE4, les 
+            // deux moitis de l'octet en alternance).
+            if(nombre > nb_colonnes - colonne)
+                nombre = nb_colonnes - colonne;
+
+            if(nb_bits_pixel == NB_BITS_GRIS)
+            {
+                memset(ligne_1D + colonne, valeur, nombre);
+            }
+            else
+            {
+                for(k = 0; k < nombre; k++)
+                    ligne_1D[colonne + k] = (k & 1) ? valeur & 0x0F : valeur >> 4;
+            }
+            colonne += nombre;
+        }
+        else if(valeur == RLE_FIN_LIGNE)
+        {
+            ligne++;
+            colonne = 0;
+        }
+        else if(valeur == RLE_FIN_IMAGE)
+        {
+            break;
+        }
+        else if(valeur == RLE_DEPLACEMENT)
+        {
+            if(i + 1 >= taille)
+                break;
+
+            colonne += donnees[i];
+            ligne   += donnees[i + 1];
+            i += 2;
+
+            if(colonne > nb_colonnes)
+                colonne = nb_colonnes;
+        }
+        else
+        {
+            // Mode absolu: 'valeur' pixels littraux, complts  un nombre
+            // pair d'octets.
+            nb_octets = nb_bits_pixel == NB_BITS_GRIS ? valeur : (valeur + 1) / 2;
+            if(i + nb_octets > taille)
+                break;
+
+            if(valeur > nb_colonnes - colonne)
+                valeur = nb_colonnes - colonne;
+
+            if(nb_bits_pixel == NB_BITS_GRIS)
+            {
+                memcpy(ligne_1D + colonne, donnees + i, valeur);
+            }
+            else
+            {
+                for(k = 0; k < valeur; k++)
+                    ligne_1D[colonne + k] = (k & 1) ? donnees[i + k / 2] & 0x0F
+                                                    : donnees[i + k / 2] >> 4;
+            }
+            colonne += valeur;
+            i += nb_octets + (nb_octets & 1);
+        }
+    }
+
+    return image;
+}
+
+
+static int preparer_canaux(const t_format_pixels* format, t_canal canaux[NB_COULEURS_RGB])
+{
+    int          couleur;   // Itrateur sur les couleurs.
+    int          bas;       // Le premier bit du masque.
+    int          largeur;   // Le nombre de bits du masque.
+    unsigned int masque;    // Le masque de la couleur.
+    unsigned int maximum;   // La plus grande valeur de la couleur.
+    unsigned int valeur;    // Itrateur sur les valeurs de la couleur.
+
+    if(format->masques[ROUGE] == MASQUE_ROUGE &&
+       format->masques[VERT]  == MASQUE_VERT  &&
+       format->masques[BLEU]  == MASQUE_BLEU)
+        return FAUX;
+
+    for(couleur = 0; couleur < NB_COULEURS_RGB; couleur++)
+    {
+        masque = format->masques[couleur];
+
+        // On repre la position et la largeur du masque.
+        bas = 0;
+        while(bas < 32 && !(masque & (1u << bas)))
+            bas++;
+        largeur = 0;
+        while(bas + largeur < 32 && (masque & (1u << (bas + largeur))))
+            largeur++;
+
+        // On ne garde que les 8 bits de poids fort, et une couleur de moins de
+        // 8 bits est tire sur 0  255  l'aide de la table.
+        canaux[couleur].masque   = masque;
+        canaux[couleur].decalage = largeur > BITS_PAR_OCTET ? bas + largeur - BITS_PAR_OCTET : bas;
+        if(largeur > BITS_PAR_OCTET)
+            largeur = BITS_PAR_OCTET;
+
+        maximum = largeur > 0 ? (1u << largeur) - 1 : 0;
+        for(valeur = 0; valeur < NB_VALEURS_OCTET; valeur++)
+            canaux[couleur].table[valeur] = maximum == 0 || valeur > maximum ? 0 :
+                                            (byte) ((valeur * 255 + maximum / 2) / maximum);
+    }
+
+    return VRAI;
+}
+
+
+static const byte* ligne_canonique(const byte* ligne_1D, int premiere_colonne,
+                                   int nb_colonnes, const t_format_pixels* format,
+                                   const t_canal* canaux, byte* tampon)
+{
+    int          colonne;   // Itrateur sur les pixels.
+    int          octet;     // Itrateur sur les octets de la ligne.
+    int          nb_octets; // Le nombre d'octets complets de la ligne.
+    int          x;         // La colonne d'un pixel dans la ligne du fichier.
+    unsigned int valeur;    // Un octet ou un pixel de 32 bits.
+    const byte*  pixel;     // Le pixel de 32 bits en cours.
+
+    switch(format->nb_bits_pixel)
+    {
+        case NB_BITS_MONOCHROME:
+
+            // Une rgion qui ne commence pas sur un octet est dpaquete un
+            // pixel  la fois.
+            if(premiere_colonne % BITS_PAR_OCTET != 0)
+            {
+                for(colonne = 0; colonne < nb_colonnes; colonne++)
+                {
+                    x = premiere_colonne + colonne;
+                    tampon[colonne] = (ligne_1D[x / BITS_PAR_OCTET] >> (7 - x % BITS_PAR_OCTET)) & 1;
+                }
+                return tampon;
+            }
+
+            // Huit pixels par octet, le bit de poids fort en premier.
+            ligne_1D += premiere_colonne / BITS_PAR_OCTET;
+            nb_octets = nb_colonnes / BITS_PAR_OCTET;
+            for(octet = 0; octet < nb_octets; octet++)
+            {
+                valeur = ligne_1D[octet];
+                for(colonne = 0; colonne < BITS_PAR_OCTET; colonne++)
+                    tampon[octet * BITS_PAR_OCTET + colonne] = (valeur >> (7 - colonne)) & 1;
+            }
+            for(colonne = nb_octets * BITS_PAR_OCTET; colonne < nb_colonnes; colonne++)
+                tampon[colonne] = (ligne_1D[colonne / BITS_PAR_OCTET] >> (7 - colonne % BITS_PAR_OCTET)) & 1;
+            return tampon;
+
+        case NB_BITS_16_COULEURS:
+
+            if(premiere_colonne % 2 != 0)
+            {
+                for(colonne = 0; colonne < nb_colonnes; colonne++)
+                {
+                    x = premiere_colonne + colonne;
+                    tampon[colonne] = (x & 1) ? ligne_1D[x / 2] & 0x0F : ligne_1D[x / 2] >> 4;
+                }
+                return tampon;
+            }
+
+            // Deux pixels par octet, la moiti de poids fort en premier.
+            ligne_1D += premiere_colonne / 2;
+            nb_octets = nb_colonnes / 2;
+            for(octet = 0; octet < nb_octets; octet++)
+            {
+                tampon[2 * octet]     = ligne_1D[octet] >> 4;
+                tampon[2 * octet + 1] = ligne_1D[octet] & 0x0F;
+            }
+            if(nb_colonnes & 1)
+                tampon[nb_colonnes - 1] = ligne_1D[nb_octets] >> 4;
+            return tampon;
+
+        case NB_BITS_BGRA:
+
+            ligne_1D += premiere_colonne * TAILLE_COULEUR;
+            if(canaux == NULL)
+                return ligne_1D;
+
+            // Des masques quelconques: on extrait chaque couleur en BGRA.
+            for(colonne = 0, pixel = ligne_1D; colonne < nb_colonnes; colonne++, pixel += TAILLE_COULEUR)
+            {
+                valeur = (unsigned int) pixel[0]       | (unsigned int) pixel[1] << 8 |
+                         (unsigned int) pixel[2] << 16 | (unsigned int) pixel[3] << 24;
+
+                tampon[colonne * TAILLE_COULEUR + OCTET_BLEU ] = 
+                    canaux[BLEU ].table[((valeur & canaux[BLEU ].masque) >> canaux[BLEU ].decalage) & 0xFF];
+                tampon[colonne * TAILLE_COULEUR + OCTET_VERT ] = 
+                    canaux[VERT ].table[((valeur & canaux[VERT ].masque) >> canaux[VERT ].decalage) & 0xFF];
+                tampon[colonne * TAILLE_COULEUR + OCTET_ROUGE] = 
+                    canaux[ROUGE].table[((valeur & canaux[ROUGE].masque) >> canaux[ROUGE].decalage) & 0xFF];
+            }
+            return tampon;
+
+        default:
+
+            // 8 et 24 bits: la ligne du fichier est dj sous sa forme canonique.
+            return ligne_1D + premiere_colonne * (format->nb_bits_pixel / BITS_PAR_OCTET);
+    }
+}
+
+
+static int construire_tables_luminance(int luminance,
+                                       unsigned int tables[NB_COULEURS_RGB][NB_VALEURS_OCTET])
+{
+    // Les pondrations de chaque norme, dans l'ordre ROUGE, VERT, BLEU.
+    static const double POIDS[][NB_COULEURS_RGB] =
+    {
+        { 1.0 / 3.0, 1.0 / 3.0, 1.0 / 3.0 },    // LUMINANCE_MOYENNE
+        { 0.299,     0.587,     0.114     },    // LUMINANCE_BT601
+        { 0.2126,    0.7152,    0.0722    },    // LUMINANCE_BT709
+    };
+
+    int couleur;    // Itrateurs sur les couleurs et les valeurs.
+    int valeur;
+
+    if(luminance < LUMINANCE_MOYENNE || luminance > LUMINANCE_BT709)
+        return FAUX;
+
+    // Chaque somme de trois entres arrondies reste sous 256 en Q16: le
+    // rsultat tient donc toujours dans un octet sans borner.
+    for(couleur = 0; couleur < NB_COULEURS_RGB; couleur++)
+        for(valeur = 0; valeur < NB_VALEURS_OCTET; valeur++)
+            tables[couleur][valeur] = (unsigned int) 
+                (POIDS[luminance][couleur] * valeur * UN_VIRGULE_FIXE + 0.5);
+
+    return VRAI;
+}
+
+
+void* conversion_2D_a_1D(void* image, int nb_lignes, int nb_colonnes, int nb_bits_pixel)
 {
     byte* image1D;          // L'image  retourner.
     double** image2D;       // L'image  convertir.
@@ -371,82 +1171,368 @@ static void* conversion_2D_a_1D(void* image, int nb_lignes, int nb_colonnes)
     int couleur;
     long n;                 // Itrateurs pour parcourir l'image 1D.
     int octets_tampon;      // Le nombre d'octet  ignorer sur chaque colonne.
+    int octets_pixel;       // Le nombre d'octets par pixel (3 en RGB, 1 en 8 bits).
     long taille1D;          // La taille de l'image vectoris.
+    byte valeur;            // Le niveau de gris d'un pixel, sur 8 bits.
     
+    INSTRUMENTER_DEBUT(ETAPE_CONVERSION_2D_A_1D);
+
     // On convertie l'image  traiter dans le bon type.
     image2D = (double**) image;
     
     // Calculer le nombre d'octets  ignorer sur chaque colonne.
-    octets_tampon = octets_a_sauter(NB_BITS_3_COULEURS, nb_colonnes);
+    octets_tampon = octets_a_sauter(nb_bits_pixel, nb_colonnes);
+    octets_pixel  = nb_bits_pixel / BITS_PAR_OCTET;
     
     // Ajuster l'image de retour.
-    taille1D = (nb_lignes*(nb_colonnes * NB_COULEURS_RGB + octets_tampon)*sizeof(byte));
-    image1D  = (byte*) malloc(taille1D);
+    taille1D = (nb_lignes*(nb_colonnes * octets_pixel + octets_tampon)*sizeof(byte));
+    image1D  = (byte*) ALLOUER(taille1D);
+    INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 1);
 
-    // Copier l'information de l'image 3D vers l'image 1D.
+    // Copier l'information de l'image 3D vers l'image 1D. En 8 bits, le 
+    // niveau de gris est directement l'index de la palette de gris.
     n = 0;
     for (ligne = nb_lignes-1; ligne >= 0; ligne--)
     {
         for (colonne = 0; colonne < nb_colonnes; colonne++)
         {
-            for (couleur = NB_COULEURS_RGB-1; couleur>=0; couleur--)
+            valeur = (byte) clamp(image2D[ligne][colonne] * 255, 0, 255);
+            for (couleur = octets_pixel-1; couleur>=0; couleur--)
             {
-                image1D[n] = (byte) clamp(image2D[ligne][colonne] * 255, 0, 255);
+                image1D[n] = valeur;
                 n++;
             }
         }
         
-        // Aprs chaque colonne, on saut des octets.
-        n += octets_tampon;
+        // Aprs chaque colonne, on saut des octets, mis  zro pour ne pas
+        // crire de mmoire non initialise dans le fichier.
+        for (couleur = 0; couleur < octets_tampon; couleur++, n++)
+            image1D[n] = 0;
     }
     
+    INSTRUMENTER_FIN(ETAPE_CONVERSION_2D_A_1D);
+    INSTRUMENTER_COMPTER(COMPTEUR_PIXELS_CONVERTIS, (long long) nb_lignes * nb_colonnes);
+
     // Retourner l'image 1D.
     return (void*) image1D;
 }
 
-static void* conversion_1D_a_2D(void* image_1D, int nb_lignes,
-                                                int nb_colonnes,
-                                                int nb_bits_pixel)
+void* conversion_1D_a_2D(void* image_1D, int nb_lignes,
+                                         int nb_colonnes,
+                                         const t_format_pixels* format)
 {
     double** image;        // L'image  retourner.
     byte* image1D;          // L'image  convertir.
-    int ligne;              // Itrateurs pour les lignes, colonnes et les 
-    int colonne;            // couleurs de l'image.
-    int couleur;
+    const byte* pixels;     // La ligne en cours, sous sa forme canonique.
+    byte* tampon;           // La ligne dpaquete, au besoin.
+    double* ligne_2D;       // La ligne de l'image 2D en cours.
+    int ligne_fichier;      // Itrateurs pour les lignes (dans l'ordre du fichier
+    int ligne;              // et dans l'image) et les colonnes de l'image.
+    int colonne;
     int pixel_gris;         // La conversion d'un pixel RGB en gris.
-    long n;                 // Itrateurs pour parcourir l'image 1D.
-    int octets_tampon;      // Le nombre d'octet  ignorer sur chaque colonne.
+    long taille_ligne;      // Le nombre d'octets d'une ligne du fichier.
+    int doit_extraire;      // Vrai si les couleurs de 32 bits doivent tre extraites.
+    t_canal canaux[NB_COULEURS_RGB];        // L'extraction des couleurs en 32 bits.
+    double table_gris[SOMME_MAX_RGB + 1];   // Le niveau de gris de chaque somme RGB.
+    double table_palette[NB_VALEURS_OCTET]; // Le niveau de gris de chaque index de palette.
+    const byte* couleur_palette;            // Une entre de la palette (BGR + rserv).
     
+    INSTRUMENTER_DEBUT(ETAPE_CONVERSION_1D_A_2D);
+
+    // On divise une fois par somme possible plutt qu'une fois par pixel.
+    for(pixel_gris = 0; pixel_gris <= SOMME_MAX_RGB; pixel_gris++)
+        table_gris[pixel_gris] = ((double) pixel_gris) / SOMME_MAX_RGB;
+
+    // Le niveau de gris de chaque couleur de la palette est prcalcul.
+    if(format->nb_bits_pixel <= NB_BITS_GRIS)
+    {
+        for(colonne = 0; colonne < NB_VALEURS_OCTET; colonne++)
+        {
+            couleur_palette = format->palette + colonne * TAILLE_COULEUR;
+            table_palette[colonne] = table_gris[couleur_palette[OCTET_BLEU] +
+                                                couleur_palette[OCTET_VERT] +
+                                                couleur_palette[OCTET_ROUGE]];
+        }
+    }
+
     // On typecast l'image reu
     image1D = (byte*) image_1D;
 
     // On calculue le nombre d'octet
-    octets_tampon = octets_a_sauter(nb_bits_pixel, nb_colonnes);
+    taille_ligne  = taille_ligne_fichier(format->nb_bits_pixel, format->largeur_fichier > 0 ?
+                                                                format->largeur_fichier : nb_colonnes);
+    doit_extraire = format->nb_bits_pixel == NB_BITS_BGRA && preparer_canaux(format, canaux);
     
     // Ajuster l'image de retour.
-    image = creer_image_2D(nb_lignes, nb_colonnes);
-
-    // Copier l'information de l'image 1D vers l'image 2D.
-    n = 0;
-    for(ligne = nb_lignes-1; ligne >= 0; ligne--)
+    image  = creer_image_2D(nb_lignes, nb_colonnes);
+    tampon = (byte*) ALLOUER((size_t) nb_colonnes * TAILLE_COULEUR);
+    if(tampon != NULL)
+        INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 1);
+
+    // Copier l'information de l'image 1D vers l'image 2D, une ligne du 
+    // fichier  la fois.
+    for(ligne_fichier = 0; ligne_fichier < nb_lignes && image != NULL && tampon != NULL;
+        ligne_fichier++)
     {
-        for(colonne = 0; colonne < nb_colonnes; colonne++)
+        ligne    = format->de_haut_en_bas ? ligne_fichier : nb_lignes - 1 - ligne_fichier;
+        ligne_2D = image[ligne];
+        pixels   = ligne_canonique(image1D + ligne_fichier * taille_ligne, format->premiere_colonne,
+                                   nb_colonnes, format, doit_extraire ? canaux : NULL, tampon);
+
+        if(format->nb_bits_pixel <= NB_BITS_GRIS)
+        {
+            // Un index de palette par pixel.
+            for(colonne = 0; colonne < nb_colonnes; colonne++)
+                ligne_2D[colonne] = table_palette[pixels[colonne]];
+        }
+        else if(format->nb_bits_pixel == NB_BITS_3_COULEURS)
         {
             // On converti un pixel RGB en niveau de gris.
-            pixel_gris = 0;
-            for(couleur = NB_COULEURS_RGB -1; couleur >= 0; couleur--, n++)
+            for(colonne = 0; colonne < nb_colonnes; colonne++, pixels += NB_COULEURS_RGB)
+                ligne_2D[colonne] = table_gris[pixels[0] + pixels[1] + pixels[2]];
+        }
+        else
+        {
+            // En BGRA, la 4e couleur (alpha) est ignore.
+            for(colonne = 0; colonne < nb_colonnes; colonne++, pixels += TAILLE_COULEUR)
+                ligne_2D[colonne] = table_gris[pixels[OCTET_BLEU] + pixels[OCTET_VERT] +
+                                               pixels[OCTET_ROUGE]];
+        }
+    }
+
+    // Sans image ou sans tampon, l'image n'a pas pu tre convertie.
+    if(image == NULL || tampon == NULL)
+    {
+        if(image != NULL)
+            detruire(image, nb_lignes, nb_colonnes);
+        image = NULL;
+    }
+    LIBERER(tampon);
+    
+    INSTRUMENTER_FIN(ETAPE_CONVERSION_1D_A_2D);
+    INSTRUMENTER_COMPTER(COMPTEUR_PIXELS_CONVERTIS, (long long) nb_lignes * nb_colonnes);
+
+    // Retourner l'image 2D.
+    return (void*) image;
+}
+
+
+void* conversion_1D_a_gris(void* image_1D, int nb_lignes,
+                                           int nb_colonnes,
+                                           const t_format_pixels* format,
+                                           int luminance)
+{
+    unsigned int   tables[NB_COULEURS_RGB][NB_VALEURS_OCTET];  // Les contributions Q16.
+    unsigned char  table_palette[NB_VALEURS_OCTET];    // Le gris de chaque index de palette.
+    const byte*    couleur_palette;                     // Une entre de la palette.
+    t_canal        canaux[NB_COULEURS_RGB];             // L'extraction des couleurs en 32 bits.
+    unsigned char* image;       // L'image  retourner.
+    unsigned char* ligne_gris;  // La ligne de l'image en cours de conversion.
+    const byte*    pixels;      // La ligne en cours, sous sa forme canonique.
+    byte*          tampon;      // La ligne dpaquete, au besoin.
+    int            ligne_fichier;   // Itrateurs pour les lignes (dans l'ordre du
+    int            ligne;           // fichier et dans l'image) et les colonnes.
+    int            colonne;
+    long           taille_ligne;    // Le nombre d'octets d'une ligne du fichier.
+    int            doit_extraire;   // Vrai si les couleurs de 32 bits doivent tre extraites.
+
+    if(!construire_tables_luminance(luminance, tables))
+        return NULL;
+
+    INSTRUMENTER_DEBUT(ETAPE_CONVERSION_GRIS);
+
+    // Pour les images  palette, une seule table indexe par la couleur.
+    if(format->nb_bits_pixel <= NB_BITS_GRIS)
+    {
+        for(colonne = 0; colonne < NB_VALEURS_OCTET; colonne++)
+        {
+            couleur_palette = format->palette + colonne * TAILLE_COULEUR;
+            table_palette[colonne] = (unsigned char) ((tables[BLEU ][couleur_palette[OCTET_BLEU ]] +
+                                                       tables[VERT ][couleur_palette[OCTET_VERT ]] +
+                                                       tables[ROUGE][couleur_palette[OCTET_ROUGE]] +
+                                                       UN_VIRGULE_FIXE / 2) >> BITS_VIRGULE_FIXE);
+        }
+    }
+
+    taille_ligne  = taille_ligne_fichier(format->nb_bits_pixel, format->largeur_fichier > 0 ?
+                                                                format->largeur_fichier : nb_colonnes);
+    doit_extraire = format->nb_bits_pixel == NB_BITS_BGRA && preparer_canaux(format, canaux);
+
+    // L'image est contigu, une ligne aprs l'autre  partir du haut.
+    image  = (unsigned char*) ALLOUER((size_t) nb_lignes * nb_colonnes);
+    tampon = (byte*) ALLOUER((size_t) nb_colonnes * TAILLE_COULEUR);
+    INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 2);
+
+    for(ligne_fichier = 0; image != NULL && tampon != NULL && ligne_fichier < nb_lignes; ligne_fichier++)
+    {
+        ligne      = format->de_haut_en_bas ? ligne_fichier : nb_lignes - 1 - ligne_fichier;
+        ligne_gris = image + (size_t) ligne * nb_colonnes;
+        pixels     = ligne_canonique((byte*) image_1D + ligne_fichier * taille_ligne,
+                                     format->premiere_colonne, nb_colonnes, format,
+                                     doit_extraire ? canaux : NULL, tampon);
+
+        if(format->nb_bits_pixel <= NB_BITS_GRIS)
+        {
+            for(colonne = 0; colonne < nb_colonnes; colonne++)
+                ligne_gris[colonne] = table_palette[pixels[colonne]];
+        }
+        else if(format->nb_bits_pixel == NB_BITS_3_COULEURS)
+        {
+            for(colonne = 0; colonne < nb_colonnes; colonne++, pixels += NB_COULEURS_RGB)
+            {
+                ligne_gris[colonne] = (unsigned char) ((tables[BLEU ][pixels[OCTET_BLEU ]] +
+                                                        tables[VERT ][pixels[OCTET_VERT ]] +
+                                                        tables[ROUGE][pixels[OCTET_ROUGE]] +
+                                                        UN_VIRGULE_FIXE / 2) >> BITS_VIRGULE_FIXE);
+            }
+        }
+        else
+        {
+            for(colonne = 0; colonne < nb_colonnes; colonne++, pixels += TAILLE_COULEUR)
             {
-                pixel_gris += image1D[n];
+                ligne_gris[colonne] = (unsigned char) ((tables[BLEU ][pixels[OCTET_BLEU ]] +
+                                                        tables[VERT ][pixels[OCTET_VERT ]] +
+                                                        tables[ROUGE][pixels[OCTET_ROUGE]] +
+                                                        UN_VIRGULE_FIXE / 2) >> BITS_VIRGULE_FIXE);
             }
+        }
+    }
+
+    // Sans tampon, l'image n'a pas pu tre convertie.
+    if(tampon == NULL)
+    {
+        LIBERER(image);
+        image = NULL;
+    }
+    LIBERER(tampon);
+
+    INSTRUMENTER_FIN(ETAPE_CONVERSION_GRIS);
+    INSTRUMENTER_COMPTER(COMPTEUR_PIXELS_CONVERTIS, (long long) nb_lignes * nb_colonnes);
+
+    return (void*) image;
+}
+
+
+void* conversion_1D_a_2D_reduite(void* image_1D, int nb_lignes,
+                                                 int nb_colonnes,
+                                                 const t_format_pixels* format,
+                                                 int facteur)
+{
+    double** image;         // L'image rduite  retourner.
+    byte* image1D;          // L'image  convertir.
+    const byte* pixels;     // La ligne en cours, sous sa forme canonique.
+    byte* tampon;           // La ligne dpaquete, au besoin.
+    unsigned int* sommes;   // La somme BGR de chaque bloc de la range en cours.
+    unsigned int somme;     // La somme BGR d'une ligne d'un bloc.
+    double* ligne_2D;       // La ligne de l'image rduite en cours.
+    int bloc_fichier;       // Itrateurs pour les ranges de blocs (dans l'ordre du
+    int ligne;              // fichier et dans l'image), les lignes d'un bloc, les
+    int k;                  // colonnes de l'image rduite et les colonnes d'un bloc.
+    int colonne;
+    int j;
+    int largeur;            // Le nombre de colonnes converties du fichier.
+    long taille_ligne;      // Le nombre d'octets d'une ligne du fichier.
+    int doit_extraire;      // Vrai si les couleurs de 32 bits doivent tre extraites.
+    double echelle;         // Ramne la somme d'un bloc  un niveau de gris.
+    t_canal canaux[NB_COULEURS_RGB];            // L'extraction des couleurs en 32 bits.
+    unsigned int table_palette[NB_VALEURS_OCTET]; // La somme BGR de chaque index de palette.
+    const byte* couleur_palette;                // Une entre de la palette (BGR + rserv).
+    
+    INSTRUMENTER_DEBUT(ETAPE_CONVERSION_REDUITE);
+
+    // La moyenne des facteur x facteur pixels d'un bloc est leur somme BGR,
+    // divise une seule fois par bloc.
+    echelle = 1.0 / ((double) SOMME_MAX_RGB * facteur * facteur);
 
-            image[ligne][colonne] =  ((double) pixel_gris) / (NB_COULEURS_RGB * 255);
+    // La somme BGR de chaque couleur de la palette est prcalcule.
+    if(format->nb_bits_pixel <= NB_BITS_GRIS)
+    {
+        for(colonne = 0; colonne < NB_VALEURS_OCTET; colonne++)
+        {
+            couleur_palette = format->palette + colonne * TAILLE_COULEUR;
+            table_palette[colonne] = couleur_palette[OCTET_BLEU] + couleur_palette[OCTET_VERT] +
+                                     couleur_palette[OCTET_ROUGE];
         }
+    }
 
-        // Aprs chaque colonne, on saut des octets.
-        n += octets_tampon;
+    image1D = (byte*) image_1D;
+
+    largeur       = nb_colonnes * facteur;
+    taille_ligne  = taille_ligne_fichier(format->nb_bits_pixel, format->largeur_fichier > 0 ?
+                                                                format->largeur_fichier : largeur);
+    doit_extraire = format->nb_bits_pixel == NB_BITS_BGRA && preparer_canaux(format, canaux);
+    
+    image  = creer_image_2D(nb_lignes, nb_colonnes);
+    tampon = (byte*) ALLOUER((size_t) largeur * TAILLE_COULEUR);
+    sommes = (unsigned int*) ALLOUER((size_t) nb_colonnes * sizeof(unsigned int));
+    INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 2);
+
+    // Chaque range de blocs couvre 'facteur' lignes conscutives du fichier,
+    // qui sont accumules dans les sommes avant d'crire une seule ligne 
+    // de l'image rduite.
+    for(bloc_fichier = 0; bloc_fichier < nb_lignes && image != NULL && tampon != NULL &&
+                          sommes != NULL; bloc_fichier++)
+    {
+        memset(sommes, 0, (size_t) nb_colonnes * sizeof(unsigned int));
+
+        for(k = 0; k < facteur; k++)
+        {
+            pixels = ligne_canonique(image1D + ((long) bloc_fichier * facteur + k) * taille_ligne,
+                                     format->premiere_colonne, largeur, format,
+                                     doit_extraire ? canaux : NULL, tampon);
+
+            if(format->nb_bits_pixel <= NB_BITS_GRIS)
+            {
+                for(colonne = 0; colonne < nb_colonnes; colonne++)
+                {
+                    somme = 0;
+                    for(j = 0; j < facteur; j++, pixels++)
+                        somme += table_palette[*pixels];
+                    sommes[colonne] += somme;
+                }
+            }
+            else if(format->nb_bits_pixel == NB_BITS_3_COULEURS)
+            {
+                for(colonne = 0; colonne < nb_colonnes; colonne++)
+                {
+                    somme = 0;
+                    for(j = 0; j < facteur; j++, pixels += NB_COULEURS_RGB)
+                        somme += pixels[0] + pixels[1] + pixels[2];
+                    sommes[colonne] += somme;
+                }
+            }
+            else
+            {
+                // En BGRA, la 4e couleur (alpha) est ignore.
+                for(colonne = 0; colonne < nb_colonnes; colonne++)
+                {
+                    somme = 0;
+                    for(j = 0; j < facteur; j++, pixels += TAILLE_COULEUR)
+                        somme += pixels[OCTET_BLEU] + pixels[OCTET_VERT] + pixels[OCTET_ROUGE];
+                    sommes[colonne] += somme;
+                }
+            }
+        }
+
+        ligne    = format->de_haut_en_bas ? bloc_fichier : nb_lignes - 1 - bloc_fichier;
+        ligne_2D = image[ligne];
+        for(colonne = 0; colonne < nb_colonnes; colonne++)
+            ligne_2D[colonne] = sommes[colonne] * echelle;
+    }
+
+    // Sans image ou sans tampon, l'image n'a pas pu tre convertie.
+    if(image == NULL || tampon == NULL || sommes == NULL)
+    {
+        if(image != NULL)
+            detruire(image, nb_lignes, nb_colonnes);
+        image = NULL;
     }
+    LIBERER(sommes);
+    LIBERER(tampon);
     
-    // Retourner l'image 2D.
+    INSTRUMENTER_FIN(ETAPE_CONVERSION_REDUITE);
+    INSTRUMENTER_COMPTER(COMPTEUR_PIXELS_CONVERTIS, (long long) nb_lignes * facteur * largeur);
+
     return (void*) image;
 }
 
@@ -457,13 +1543,23 @@ static double** creer_image_2D(int nb_lignes, int nb_colonnes)
     double** image;     // L'image  crer.
 
     // On cre un tableau qui contiendra chaque ligne de l'image.
-    image = (double**) malloc(nb_lignes * sizeof(double*));
+    image = (double**) ALLOUER(nb_lignes * sizeof(double*));
+    if(image == NULL)
+        return NULL;
     
     // Pour chaque ligne, on lui ajoute le nombre ncessaire de colonnes.
     for(i=0; i<nb_lignes; i++)
     {
-        image[i] = (double*) malloc(nb_colonnes * sizeof(double));
+        image[i] = (double*) ALLOUER(nb_colonnes * sizeof(double));
+
+        // Si la mmoire manque, on libre les lignes dj cres.
+        if(image[i] == NULL)
+        {
+            detruire(image, i, nb_colonnes);
+            return NULL;
+        }
     }
+    INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, nb_lignes + 1);
 
     // On retourne l'addresse de l'image.
     return image;
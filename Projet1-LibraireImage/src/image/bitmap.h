@@ -15,12 +15,22 @@
     rouge, vert et bleu.
     
     Les types d'images supportes sont:
-      - RGB 24 bits sans compression.
+      - RGB 24 bits et BGRA 32 bits, sans compression ou avec masques 
+        (BITFIELDS);
+      - 1, 4 et 8 bits avec palette, sans compression (8 bits est le format
+        crit par ecrire) ou compresss en RLE4 et RLE8;
+      - les lignes ranges  partir du bas ou, si la hauteur est ngative,
+         partir du haut.
+    Les images lues ont au plus 16384 x 16384 pixels.
     
     Liste des sous-programmes publiques:
       - lire     : Permet de lire une image contenu dans un fichier .bmp;
+      - lire_gris: Permet de lire une image en niveaux de gris sur 8 bits;
+      - lire_region : Permet de lire un rectangle d'une image sans lire le reste;
+      - lire_reduite: Permet de lire une image rduite de moiti, au quart, etc.;
       - ecrire   : Permet d'crire une image dans un fichier .bmp.
       - detruire : Permet de librer la mmoire alloue lors du chargement d'une image. 
+      - detruire_gris : Permet de librer une image charge par lire_gris.
     
 *****************************************************************************************/
 
@@ -40,6 +50,18 @@
 #define BLEU                2
 #define NB_COULEURS_RGB     3
 
+//
+// Les pondrations des couleurs pour le calcul de la luminance (lire_gris).
+//
+#define LUMINANCE_MOYENNE   0   // (R + V + B) / 3, comme lire.
+#define LUMINANCE_BT601     1   // 0.299 R + 0.587 V + 0.114 B
+#define LUMINANCE_BT709     2   // 0.2126 R + 0.7152 V + 0.0722 B
+
+//
+// Le plus grand facteur de rduction de lire_reduite.
+//
+#define FACTEUR_REDUCTION_MAX   8
+
 
 /****************************************************************************************
 *                       DCLARATION DES FONCTIONS PUBLIQUES                             *
@@ -85,11 +107,138 @@ int lire(char* nom_fichier, void** image, int* nb_lignes, int* nb_colonnes);
 
 
 
+/*
+    LIRE_GRIS
+
+    Cette fonction permet de lire le contenu d'un fichier bitmap et d'obtenir
+    l'image en niveaux de gris sur 8 bits (0  255), dans un seul bloc 
+    contigu: le pixel (ligne, colonne) est image[ligne * nb_colonnes + colonne].
+    
+    La conversion se fait entirement en entiers,  l'aide de tables 
+    prcalcules pour chaque couleur. Elle est plus rapide que LIRE et
+    l'image occupe 8 fois moins de mmoire.
+    
+    Paramtre:
+        - [char*          ] nom_fichier : Le chemin du fichier  ouvrir.
+        - [unsigned char**] image       : L'addresse d'un pointeur qui recevra l'image.
+        - [int*           ] nb_lignes   : Le nombre de lignes dans l'image lue.
+        - [int*           ] nb_colonnes : Le nombre de colonnes dans l'image lue.
+        - [int            ] luminance   : LUMINANCE_MOYENNE, LUMINANCE_BT601 ou
+                                          LUMINANCE_BT709.
+
+    Retour: 
+        1 si l'image est lu correctement, 0 sinon.
+    
+    Exemple d'utilisation:
+    
+        unsigned char* image;
+        int            nb_lignes;
+        int            nb_colonnes;
+
+        if(lire_gris("plaque.bmp", &image, &nb_lignes, &nb_colonnes, LUMINANCE_BT601))
+        {
+            [...]
+
+            detruire_gris(image);
+        }
+*/    
+int lire_gris(char* nom_fichier, unsigned char** image, int* nb_lignes,
+                                                         int* nb_colonnes,
+                                                         int luminance);
+
+
+
+/*
+    LIRE_REGION
+
+    Cette fonction permet de lire un rectangle d'une image contenue dans un
+    fichier bitmap, par exemple une plaque dj localise. Les lignes d'un
+    bitmap tant  des positions fixes, seules les lignes du rectangle sont
+    lues et seules ses colonnes sont converties: le cot est proportionnel 
+    au rectangle, pas au fichier. Les images compresses (RLE) doivent 
+    toutefois tre dcompresses au complet.
+    
+    L'image obtenue est la mme que la partie correspondante de l'image 
+    retourne par LIRE, et se libre avec DETRUIRE.
+    
+    Paramtre:
+        - [char* ] nom_fichier : Le chemin du fichier  ouvrir.
+        - [void**] image       : L'addresse d'un pointeur qui recevra l'image.
+        - [int   ] ligne       : La ligne du coin en haut  gauche du rectangle.
+        - [int   ] colonne     : La colonne du coin en haut  gauche du rectangle.
+        - [int   ] nb_lignes   : Le nombre de lignes du rectangle.
+        - [int   ] nb_colonnes : Le nombre de colonnes du rectangle.
+
+    Retour: 
+        1 si l'image est lu correctement, 0 sinon (ou si le rectangle dpasse
+        de l'image).
+    
+    Exemple d'utilisation:
+    
+        void* plaque;
+
+        if(lire_region("auto.bmp", &plaque, 310, 120, 48, 160))
+        {
+            [...]
+
+            detruire(plaque, 48, 160);
+        }
+*/    
+int lire_region(char* nom_fichier, void** image, int ligne, int colonne,
+                                                 int nb_lignes, int nb_colonnes);
+
+
+
+/*
+    LIRE_REDUITE
+
+    Cette fonction permet de lire une image directement  une plus petite 
+    chelle (1/2, 1/4, 1/8, ...), par exemple pour une recherche grossire 
+    des plaques. Chaque pixel est la moyenne des niveaux de gris d'un bloc 
+    de facteur x facteur pixels du fichier; la moyenne est calcule pendant 
+    la conversion, sans jamais crer l'image  pleine rsolution.
+    
+    Les dernires lignes et colonnes qui ne forment pas un bloc complet sont
+    ignores: ces lignes ne sont pas lues du fichier. L'image obtenue a donc
+    nb_lignes / facteur lignes et nb_colonnes / facteur colonnes (arrondis 
+    vers le bas), et se libre avec DETRUIRE.
+    
+    Paramtre:
+        - [char* ] nom_fichier : Le chemin du fichier  ouvrir.
+        - [void**] image       : L'addresse d'un pointeur qui recevra l'image.
+        - [int*  ] nb_lignes   : Le nombre de lignes de l'image rduite.
+        - [int*  ] nb_colonnes : Le nombre de colonnes de l'image rduite.
+        - [int   ] facteur     : Le facteur de rduction, de 1 (comme LIRE)  
+                                 FACTEUR_REDUCTION_MAX.
+
+    Retour: 
+        1 si l'image est lu correctement, 0 sinon (ou si l'image est plus 
+        petite qu'un bloc).
+    
+    Exemple d'utilisation:
+    
+        void* image;
+        int   nb_lignes;
+        int   nb_colonnes;
+
+        if(lire_reduite("auto.bmp", &image, &nb_lignes, &nb_colonnes, 4))
+        {
+            [ ... chercher les plaques  basse rsolution ... ]
+
+            detruire(image, nb_lignes, nb_colonnes);
+        }
+*/    
+int lire_reduite(char* nom_fichier, void** image, int* nb_lignes, int* nb_colonnes,
+                                                  int facteur);
+
+
+
 /*
     ECRIRE
 
     Cette procdure permet de crer un fichier .bmp qui contient une image
-    reu en paramtre.
+    reu en paramtre. L'image peut aussi tre une vue sur une partie d'une
+    autre image (voir vue.h).
     
     Paramtres:
         - [char* ] nom_fichier : Le nom du fichier  crer.
@@ -138,4 +287,19 @@ void ecrire(char* nom_fichier, void* image, int nb_lignes, int nb_colonnes);
 void detruire(void* image, int nb_lignes, int nb_colonnes);
 
 
+
+/*
+    DETRUIRE_GRIS
+
+    Cette procdure permet de librer une image charge avec LIRE_GRIS.
+    
+    Paramtres:
+        - [unsigned char*] image : L'image  librer.
+    
+    Retour: 
+        Aucun.
+*/    
+void detruire_gris(unsigned char* image);
+
+
 #endif
\ No newline at end of file
@@ -0,0 +1,140 @@
+/****************************************************************************************
+    BITMAP_INTERNE.H
+
+    Ce module dclare les sous-programmes de conversion utiliss par lire et
+    ecrire. Ils ne font pas partie de l'interface publique de bitmap.h: ils sont
+    exposs ici pour que le banc d'essai puisse les mesurer sparment des
+    entres/sorties.
+
+*****************************************************************************************/
+
+#ifndef ETS_INF_BITMAP_INTERNE
+#define ETS_INF_BITMAP_INTERNE
+
+#include "bitmap.h"
+
+
+/****************************************************************************************
+*                               DFINTION DES CONSTANTES                                *
+****************************************************************************************/
+
+/*
+    T_FORMAT_PIXELS
+
+    La description des pixels d'une image 1D, telle que lue d'un fichier. Les
+    images compresses (RLE4 et RLE8) sont dcompresses en index de 8 bits 
+    avant d'tre converties.
+*/
+typedef struct
+{
+    int                  nb_bits_pixel;             // 1, 4, 8, 24 ou 32 bits par pixel.
+    int                  de_haut_en_bas;            // Vrai si la premire ligne est celle
+                                                    // du haut (hauteur ngative).
+    int                  largeur_fichier;           // Le nombre de colonnes d'une ligne
+                                                    // de l'image 1D, ou 0 si l'image
+                                                    // est convertie au complet.
+    int                  premiere_colonne;          // La premire colonne  convertir.
+    unsigned int         masques[NB_COULEURS_RGB];  // En 32 bits: les masques des couleurs,
+                                                    // dans l'ordre ROUGE, VERT, BLEU.
+    const unsigned char* palette;                   // En 1, 4 et 8 bits: 256 couleurs 
+                                                    // (BGR + rserv).
+
+}t_format_pixels;
+
+
+/****************************************************************************************
+*                       DCLARATION DES FONCTIONS INTERNES                              *
+****************************************************************************************/
+
+
+/*
+    CONVERSION_2D_A_1D
+
+    Cette fonction permet de convertir une image (tableau 3D) en un
+    tableau 1D sous le format du standard bitmap.
+    
+    Paramtre:
+      - [void *] image: L'image  convertir.
+      - [int   ] nb_lignes      : Le nombre de lignes de l'image finale.
+      - [int   ] nb_colonnes    : Le nombre de colonnes de l'image finale.
+      - [int   ] nb_bits_pixel  : 24 pour du RGB, 8 pour des index dans une
+                                  palette de gris (couleur i = (i, i, i)).
+    
+    Retour: L'image sous la forme d'un tableau 1D.
+*/
+void* conversion_2D_a_1D(void* image, int nb_lignes, int nb_colonnes, int nb_bits_pixel);
+
+
+
+/*
+    CONVERSION_1D_A_2D
+    Cette fonction converti une image qui a t vectorise (1D) en tableau
+    2D.
+    
+    Paramtres:
+      - [void* ] image_1D       : L'image 1D  modifier.
+      - [int   ] nb_lignes      : Le nombre de lignes de l'image finale.
+      - [int   ] nb_colonnes    : Le nombre de colonnes de l'image finale.
+      - [t_format_pixels*] format : Le format des pixels de l'image 1D.
+    
+    Seules les colonnes premiere_colonne  premiere_colonne + nb_colonnes - 1
+    de chaque ligne sont converties (toutes si largeur_fichier vaut 0).
+    
+    Retour: L'image reu en paramtre, mais organise en tableau 2D, ou NULL 
+            si la mmoire manque.
+*/    
+void* conversion_1D_a_2D(void* image_1D, int nb_lignes,
+                                         int nb_colonnes,
+                                         const t_format_pixels* format);
+
+
+
+/*
+    CONVERSION_1D_A_GRIS
+    Cette fonction converti une image qui a t vectorise (1D) en niveaux de
+    gris sur 8 bits, sans virgule flottante: chaque couleur passe par une
+    table de 256 entres en virgule fixe Q16.
+    
+    Paramtres:
+      - [void* ] image_1D       : L'image 1D  convertir.
+      - [int   ] nb_lignes      : Le nombre de lignes de l'image finale.
+      - [int   ] nb_colonnes    : Le nombre de colonnes de l'image finale.
+      - [t_format_pixels*] format : Le format des pixels de l'image 1D.
+      - [int   ] luminance      : La pondration (LUMINANCE_MOYENNE, 
+                                  LUMINANCE_BT601 ou LUMINANCE_BT709).
+    
+    Retour: L'image contigu de nb_lignes x nb_colonnes octets, la ligne du
+            haut en premier, ou NULL si la pondration est inconnue.
+*/    
+void* conversion_1D_a_gris(void* image_1D, int nb_lignes,
+                                           int nb_colonnes,
+                                           const t_format_pixels* format,
+                                           int luminance);
+
+
+
+/*
+    CONVERSION_1D_A_2D_REDUITE
+    Cette fonction converti une image qui a t vectorise (1D) en tableau
+    2D rduit d'un facteur entier: chaque pixel de l'image finale est la 
+    moyenne des niveaux de gris d'un bloc de facteur x facteur pixels. La 
+    moyenne est faite pendant la conversion, sans image intermdiaire.
+    
+    Paramtres:
+      - [void* ] image_1D       : L'image 1D  convertir, dont les lignes sont
+                                  celles de nb_lignes x facteur lignes.
+      - [int   ] nb_lignes      : Le nombre de lignes de l'image finale.
+      - [int   ] nb_colonnes    : Le nombre de colonnes de l'image finale.
+      - [t_format_pixels*] format : Le format des pixels de l'image 1D.
+      - [int   ] facteur        : Le ct d'un bloc, de 1  FACTEUR_REDUCTION_MAX.
+    
+    Retour: L'image rduite,  librer avec DETRUIRE, ou NULL si la mmoire 
+            manque.
+*/    
+void* conversion_1D_a_2D_reduite(void* image_1D, int nb_lignes,
+                                                 int nb_colonnes,
+                                                 const t_format_pixels* format,
+                                                 int facteur);
+
+
+#endif
@@ -0,0 +1,43 @@
+/****************************************************************************************
+    VUE.C
+
+    Ce module contient les vues sur un rectangle d'une image. Une vue n'est
+    qu'un tableau de pointeurs vers les lignes du parent.
+****************************************************************************************/
+#include "vue.h"
+#include "../outils/instrumentation.h"
+#include "../outils/memoire.h"
+
+#include <stdlib.h>
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PUBLIQUES                            *
+****************************************************************************************/
+double** creer_vue(double** image, int ligne, int colonne, int nb_lignes, int nb_colonnes)
+{
+    double** vue;   // Les pointeurs vers les lignes du rectangle.
+    int      i;     // Iterateur sur les lignes de la vue.
+
+    if(image == NULL || ligne < 0 || colonne < 0 || nb_lignes <= 0 || nb_colonnes <= 0)
+        return NULL;
+
+    vue = (double**) ALLOUER((size_t) nb_lignes * sizeof(double*));
+    INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 1);
+    if(vue == NULL)
+        return NULL;
+
+    // Chaque ligne de la vue commence a la colonne du rectangle dans la ligne
+    // correspondante du parent.
+    for(i = 0; i < nb_lignes; i++)
+        vue[i] = image[ligne + i] + colonne;
+
+    return vue;
+}
+
+
+
+void detruire_vue(double** vue)
+{
+    LIBERER(vue);
+}
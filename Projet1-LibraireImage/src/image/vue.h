@@ -0,0 +1,88 @@
+/****************************************************************************************
+    VUE.H
+
+    Ce module contient des sous-programmes qui permettent de travailler sur un
+    rectangle d'une image (par exemple une plaque) sans en copier les pixels.
+
+    Une image (lire, creer_tableau2d) est un tableau de pointeurs de lignes. Une
+    vue est un autre tableau de pointeurs, dont chaque ligne pointe au milieu
+    d'une ligne de l'image parent: le pixel (i, j) de la vue est le pixel
+    (ligne + i, colonne + j) du parent. Une vue a donc le meme type qu'une
+    image (double**) et s'utilise partout ou une image est attendue: ecrire,
+    afficher_tableau2d, initialiser_tableau2d, les solveurs, etc. Modifier un
+    pixel de la vue modifie le pixel du parent.
+
+    Seul le tableau de pointeurs est alloue (nb_lignes pointeurs), peu importe
+    la largeur de la vue. Une vue peut elle-meme servir de parent.
+
+    La vue ne possede pas les pixels: elle doit etre liberee avec detruire_vue
+    (jamais avec detruire ou detruire_tableau2d), et avant son parent.
+
+    Liste des sous-programmes publiques:
+      - creer_vue    : Cree une vue sur un rectangle d'une image;
+      - detruire_vue : Libere une vue, sans toucher aux pixels du parent.
+
+*****************************************************************************************/
+#ifndef VUE_IMAGE
+#define VUE_IMAGE
+
+
+/****************************************************************************************
+*                       DECLARATION DES FONCTIONS PUBLIQUES                             *
+****************************************************************************************/
+
+
+/*
+    CREER_VUE
+
+    Cette fonction cree une vue sur le rectangle d'une image dont le coin en
+    haut a gauche est (ligne, colonne). Le rectangle doit etre entierement
+    contenu dans l'image.
+
+    Parametres:
+        - [double**] image       : L'image parent (ou une autre vue).
+        - [int     ] ligne       : La ligne du coin en haut a gauche du rectangle.
+        - [int     ] colonne     : La colonne du coin en haut a gauche du rectangle.
+        - [int     ] nb_lignes   : Le nombre de lignes du rectangle.
+        - [int     ] nb_colonnes : Le nombre de colonnes du rectangle.
+
+    Retour:
+        La vue, ou NULL si le rectangle est vide ou si la memoire manque.
+
+    Exemple d'utilisation:
+
+        void*    image;
+        double** plaque;
+
+        [ ... Charger l'image et localiser la plaque ... ]
+
+        plaque = creer_vue((double**) image, 310, 120, 48, 160);
+        if(plaque != NULL)
+        {
+            ecrire("plaque.bmp", plaque, 48, 160);
+
+            detruire_vue(plaque);
+        }
+
+        detruire(image, nb_lignes, nb_colonnes);
+*/
+double** creer_vue(double** image, int ligne, int colonne, int nb_lignes, int nb_colonnes);
+
+
+
+/*
+    DETRUIRE_VUE
+
+    Cette procedure libere une vue creee par creer_vue. Les pixels, qui
+    appartiennent au parent, ne sont pas touches.
+
+    Parametres:
+        - [double**] vue : La vue a liberer (NULL est accepte).
+
+    Retour:
+        Aucun.
+*/
+void detruire_vue(double** vue);
+
+
+#endif
@@ -103,14 +103,12 @@ void tester_tableau1d(){
 
     nb_element = 5;
     printf("T1 : ");
-    creer_tableau1d(nb_element);
-    double* pointeur_01 = tableau;
+    double* pointeur_01 = creer_tableau1d(nb_element);
 
 
     nb_element = 3;
     printf("T2 : ");
-    creer_tableau1d(nb_element);
-    double* pointeur_02 = tableau;
+    double* pointeur_02 = creer_tableau1d(nb_element);
 
     printf("\n");
     printf("FONCTION DETRUIRE TABLEAU\n");
@@ -207,10 +205,13 @@ void tester_tableau2d(){
 
     printf("FONCTION INITIALISER_TABLEAU2D\n");
 
-    tableau = tableau1;
     lignes = 3;
+    colonnes = 2;
+    tableau4 = creer_tableau2d(lignes, colonnes);
 
-    printf("T1 : ");
-    detruire_tableau2d(tableau, lignes);
+    printf("T1 :\n");
+    initialiser_tableau2d(tableau4, lignes, colonnes, 0.5);
+    afficher_tableau2d(tableau4, lignes, colonnes);
+    detruire_tableau2d(tableau4, lignes);
 
 }
\ No newline at end of file
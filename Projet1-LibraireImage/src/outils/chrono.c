@@ -0,0 +1,52 @@
+/****************************************************************************************
+    CHRONO.C
+
+    Ce module contient des sous-programmes qui permettent de mesurer le temps
+    ecoule.
+****************************************************************************************/
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include "chrono.h"
+
+#include <time.h>
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PUBLIQUES                            *
+****************************************************************************************/
+double chrono_mur(void)
+{
+    struct timespec instant;    // L'instant courant.
+
+#ifdef CLOCK_MONOTONIC
+    clock_gettime(CLOCK_MONOTONIC, &instant);
+#else
+    timespec_get(&instant, TIME_UTC);
+#endif
+
+    return instant.tv_sec + instant.tv_nsec * 1e-9;
+}
+
+
+
+double chrono_cpu(void)
+{
+    return (double) clock() / CLOCKS_PER_SEC;
+}
+
+
+
+double chrono_cpu_fil(void)
+{
+#ifdef CLOCK_THREAD_CPUTIME_ID
+    struct timespec instant;    // Le temps consomme par le fil.
+
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &instant);
+
+    return instant.tv_sec + instant.tv_nsec * 1e-9;
+#else
+    return chrono_cpu();
+#endif
+}
@@ -0,0 +1,69 @@
+/****************************************************************************************
+    CHRONO.H
+
+    Ce module contient des sous-programmes qui permettent de mesurer le temps
+    ecoule, pour le banc d'essai et l'instrumentation.
+
+    Liste des sous-programmes publiques:
+      - chrono_mur     : Le temps reel (horloge monotone), en secondes;
+      - chrono_cpu     : Le temps processeur consomme par le processus, en secondes;
+      - chrono_cpu_fil : Le temps processeur consomme par le fil courant, en secondes.
+
+*****************************************************************************************/
+#ifndef CHRONO
+#define CHRONO
+
+
+/****************************************************************************************
+*                       DECLARATION DES FONCTIONS PUBLIQUES                             *
+****************************************************************************************/
+
+
+/*
+    CHRONO_MUR
+
+    Cette fonction retourne le temps reel ecoule depuis un instant de reference
+    arbitraire. Seule la difference entre deux appels a un sens.
+
+    Retour:
+        Le temps en secondes.
+
+    Exemple d'utilisation:
+
+        double debut = chrono_mur();
+
+        [ ... Travail a mesurer ... ]
+
+        printf("%f s\n", chrono_mur() - debut);
+*/
+double chrono_mur(void);
+
+
+
+/*
+    CHRONO_CPU
+
+    Cette fonction retourne le temps processeur consomme par le processus.
+    Seule la difference entre deux appels a un sens.
+
+    Retour:
+        Le temps en secondes.
+*/
+double chrono_cpu(void);
+
+
+
+/*
+    CHRONO_CPU_FIL
+
+    Cette fonction retourne le temps processeur consomme par le fil
+    d'execution courant. Lorsque le systeme ne l'offre pas, c'est le temps du
+    processus qui est retourne.
+
+    Retour:
+        Le temps en secondes.
+*/
+double chrono_cpu_fil(void);
+
+
+#endif
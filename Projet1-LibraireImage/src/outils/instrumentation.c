@@ -0,0 +1,378 @@
+/****************************************************************************************
+    INSTRUMENTATION.C
+
+    Ce module contient les minuteries et les compteurs de la librairie. Chaque
+    fil accumule dans son propre bloc; les blocs sont chaines dans une liste
+    sans verrou et ne sont jamais liberes.
+****************************************************************************************/
+#include "instrumentation.h"
+
+
+#ifdef INSTRUMENTATION
+
+#include "chrono.h"
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/****************************************************************************************
+*                               DEFINTION DES CONSTANTES                                *
+****************************************************************************************/
+
+// Le nombre d'evenements conserves par fil pour la trace. Au-dela, les plus
+// anciens sont remplaces.
+#define CAPACITE_EVENEMENTS     65536
+
+// Le nombre de microsecondes dans une seconde.
+#define MICROSECONDES           1e6
+
+// Les noms des etapes, dans l'ordre de t_etape.
+static const char* NOMS_ETAPES[NB_ETAPES] =
+{
+    "lire",
+    "lire.fichier",
+    "conversion_1D_a_2D",
+    "lire_gris",
+    "lire_region",
+    "lire_reduite",
+    "conversion_1D_a_gris",
+    "conversion_1D_a_2D_reduite",
+    "ecrire",
+    "ecrire.fichier",
+    "conversion_2D_a_1D",
+    "creer_pyramide",
+    "redimensionner",
+    "transformer",
+    "detecter_droites",
+    "calculer_distances",
+    "trouver_contours",
+    "localiser_plaques",
+    "classer_glyphe",
+    "correler",
+    "calculer_hog",
+    "detecter_objets",
+    "trouver_coins",
+    "egaliser_contraste",
+    "filtrer_bilateral",
+    "resoudre_systeme",
+    "resoudre_moindres_carres",
+    "resoudre_lot",
+};
+
+// Les noms des compteurs, dans l'ordre de t_compteur.
+static const char* NOMS_COMPTEURS[NB_COMPTEURS] =
+{
+    "octets_lus",
+    "octets_ecrits",
+    "pixels_convertis",
+    "allocations",
+    "systemes_resolus",
+};
+
+
+/*
+    T_EVENEMENT
+
+    Une execution d'une etape, pour la trace.
+*/
+typedef struct
+{
+    t_etape etape;      // L'etape executee.
+    double  debut;      // Le temps reel au debut de l'etape.
+    double  duree;      // La duree reelle de l'etape.
+
+}t_evenement;
+
+
+/*
+    T_BLOC_FIL
+
+    Les statistiques accumulees par un fil d'execution. Seul ce fil y ecrit.
+*/
+typedef struct t_bloc_fil
+{
+    int                 identifiant;                // Le numero du fil dans la trace.
+    long long           nb_appels[NB_ETAPES];       // Les statistiques des etapes.
+    double              temps_mur[NB_ETAPES];
+    double              temps_cpu[NB_ETAPES];
+    long long           compteurs[NB_COMPTEURS];    // La valeur des compteurs.
+    t_evenement*        evenements;                 // Un tampon circulaire d'evenements.
+    long long           nb_evenements;              // Le nombre total d'evenements.
+    struct t_bloc_fil*  suivant;                    // Le bloc du fil suivant.
+
+}t_bloc_fil;
+
+
+// La liste des blocs de tous les fils.
+static _Atomic(t_bloc_fil*) premier_bloc = NULL;
+
+// Le prochain numero de fil.
+static atomic_int prochain_identifiant = 1;
+
+// Le bloc du fil courant.
+static _Thread_local t_bloc_fil* bloc_courant = NULL;
+
+
+/****************************************************************************************
+*                           DECLARATION DES FONCTIONS PRIVEES                           *
+****************************************************************************************/
+
+
+/*
+    OBTENIR_BLOC
+
+    Cette fonction retourne le bloc du fil courant. A la premiere utilisation,
+    le bloc est cree et ajoute a la liste.
+
+    Retour: Le bloc du fil, ou NULL si la memoire manque.
+*/
+static t_bloc_fil* obtenir_bloc(void);
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PUBLIQUES                            *
+****************************************************************************************/
+t_minuterie instrumentation_debut(t_etape etape)
+{
+    t_minuterie minuterie;  // La minuterie a retourner.
+
+    minuterie.etape = etape;
+    minuterie.cpu   = chrono_cpu_fil();
+    minuterie.mur   = chrono_mur();
+
+    return minuterie;
+}
+
+
+
+void instrumentation_fin(t_minuterie* minuterie)
+{
+    t_bloc_fil*  bloc;      // Le bloc du fil courant.
+    t_evenement* evenement; // La place de l'evenement dans le tampon.
+    double       mur;       // Le temps reel a la fin de l'etape.
+    double       cpu;       // Le temps processeur a la fin de l'etape.
+
+    mur = chrono_mur();
+    cpu = chrono_cpu_fil();
+
+    bloc = obtenir_bloc();
+    if(bloc == NULL)
+        return;
+
+    bloc->nb_appels[minuterie->etape]++;
+    bloc->temps_mur[minuterie->etape] += mur - minuterie->mur;
+    bloc->temps_cpu[minuterie->etape] += cpu - minuterie->cpu;
+
+    evenement = &bloc->evenements[bloc->nb_evenements % CAPACITE_EVENEMENTS];
+    evenement->etape = minuterie->etape;
+    evenement->debut = minuterie->mur;
+    evenement->duree = mur - minuterie->mur;
+    bloc->nb_evenements++;
+}
+
+
+
+void instrumentation_compter(t_compteur compteur, long long valeur)
+{
+    t_bloc_fil* bloc;       // Le bloc du fil courant.
+
+    bloc = obtenir_bloc();
+    if(bloc != NULL)
+        bloc->compteurs[compteur] += valeur;
+}
+
+
+
+void instrumentation_afficher(FILE* fichier)
+{
+    long long   nb_appels[NB_ETAPES];       // Les totaux de tous les fils.
+    double      temps_mur[NB_ETAPES];
+    double      temps_cpu[NB_ETAPES];
+    long long   compteurs[NB_COMPTEURS];
+    t_bloc_fil* bloc;                       // Iterateur sur les blocs.
+    int         i;                          // Iterateur sur les etapes et compteurs.
+
+    memset(nb_appels, 0, sizeof(nb_appels));
+    memset(temps_mur, 0, sizeof(temps_mur));
+    memset(temps_cpu, 0, sizeof(temps_cpu));
+    memset(compteurs, 0, sizeof(compteurs));
+
+    for(bloc = atomic_load(&premier_bloc); bloc != NULL; bloc = bloc->suivant)
+    {
+        for(i = 0; i < NB_ETAPES; i++)
+        {
+            nb_appels[i] += bloc->nb_appels[i];
+            temps_mur[i] += bloc->temps_mur[i];
+            temps_cpu[i] += bloc->temps_cpu[i];
+        }
+        for(i = 0; i < NB_COMPTEURS; i++)
+            compteurs[i] += bloc->compteurs[i];
+    }
+
+    fprintf(fichier, "%-28s %10s %14s %14s %14s\n", "Etape", "Appels", "Reel (s)",
+                                                    "CPU (s)", "Moyenne (ms)");
+    for(i = 0; i < NB_ETAPES; i++)
+    {
+        if(nb_appels[i] == 0)
+            continue;
+
+        fprintf(fichier, "%-28s %10lld %14.6f %14.6f %14.4f\n", NOMS_ETAPES[i],
+                nb_appels[i], temps_mur[i], temps_cpu[i],
+                temps_mur[i] * 1000.0 / nb_appels[i]);
+    }
+
+    fprintf(fichier, "\n%-28s %20s\n", "Compteur", "Valeur");
+    for(i = 0; i < NB_COMPTEURS; i++)
+        fprintf(fichier, "%-28s %20lld\n", NOMS_COMPTEURS[i], compteurs[i]);
+}
+
+
+
+int instrumentation_ecrire_trace(const char* nom_fichier)
+{
+    FILE*        fichier;       // Le fichier de trace.
+    t_bloc_fil*  bloc;          // Iterateur sur les blocs.
+    t_evenement* evenement;     // L'evenement a ecrire.
+    long long    premier;       // Le premier evenement conserve d'un bloc.
+    long long    n;             // Iterateur sur les evenements.
+    double       origine;       // Le debut du plus ancien evenement.
+    int          virgule;       // Vrai si un evenement a deja ete ecrit.
+
+    fichier = fopen(nom_fichier, "w");
+    if(fichier == NULL)
+        return 0;
+
+    // Les temps de la trace sont relatifs au plus ancien evenement.
+    origine = -1;
+    for(bloc = atomic_load(&premier_bloc); bloc != NULL; bloc = bloc->suivant)
+    {
+        premier = bloc->nb_evenements > CAPACITE_EVENEMENTS ?
+                  bloc->nb_evenements - CAPACITE_EVENEMENTS : 0;
+        for(n = premier; n < bloc->nb_evenements; n++)
+        {
+            evenement = &bloc->evenements[n % CAPACITE_EVENEMENTS];
+            if(origine < 0 || evenement->debut < origine)
+                origine = evenement->debut;
+        }
+    }
+
+    fprintf(fichier, "{\"traceEvents\": [");
+    virgule = 0;
+
+    for(bloc = atomic_load(&premier_bloc); bloc != NULL; bloc = bloc->suivant)
+    {
+        premier = bloc->nb_evenements > CAPACITE_EVENEMENTS ?
+                  bloc->nb_evenements - CAPACITE_EVENEMENTS : 0;
+        for(n = premier; n < bloc->nb_evenements; n++)
+        {
+            evenement = &bloc->evenements[n % CAPACITE_EVENEMENTS];
+            fprintf(fichier, "%s\n  {\"name\": \"%s\", \"ph\": \"X\", \"ts\": %.3f, "
+                             "\"dur\": %.3f, \"pid\": 1, \"tid\": %d}",
+                    virgule ? "," : "", NOMS_ETAPES[evenement->etape],
+                    (evenement->debut - origine) * MICROSECONDES,
+                    evenement->duree * MICROSECONDES, bloc->identifiant);
+            virgule = 1;
+        }
+    }
+
+    fprintf(fichier, "\n]}\n");
+    fclose(fichier);
+
+    return 1;
+}
+
+
+
+void instrumentation_reinitialiser(void)
+{
+    t_bloc_fil* bloc;   // Iterateur sur les blocs.
+
+    for(bloc = atomic_load(&premier_bloc); bloc != NULL; bloc = bloc->suivant)
+    {
+        memset(bloc->nb_appels, 0, sizeof(bloc->nb_appels));
+        memset(bloc->temps_mur, 0, sizeof(bloc->temps_mur));
+        memset(bloc->temps_cpu, 0, sizeof(bloc->temps_cpu));
+        memset(bloc->compteurs, 0, sizeof(bloc->compteurs));
+        bloc->nb_evenements = 0;
+    }
+}
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PRIVEES                            *
+****************************************************************************************/
+
+
+static t_bloc_fil* obtenir_bloc(void)
+{
+    t_bloc_fil* bloc;       // Le bloc cree pour le fil courant.
+
+    if(bloc_courant != NULL)
+        return bloc_courant;
+
+    bloc = (t_bloc_fil*) calloc(1, sizeof(t_bloc_fil));
+    if(bloc == NULL)
+        return NULL;
+
+    bloc->evenements = (t_evenement*) malloc(CAPACITE_EVENEMENTS * sizeof(t_evenement));
+    if(bloc->evenements == NULL)
+    {
+        free(bloc);
+        return NULL;
+    }
+
+    bloc->identifiant = atomic_fetch_add(&prochain_identifiant, 1);
+
+    // Ajouter le bloc au debut de la liste, sans verrou.
+    bloc->suivant = atomic_load(&premier_bloc);
+    while(!atomic_compare_exchange_weak(&premier_bloc, &bloc->suivant, bloc))
+        ;
+
+    bloc_courant = bloc;
+    return bloc;
+}
+
+
+#else
+
+
+/****************************************************************************************
+*                       VERSION SANS INSTRUMENTATION                                    *
+****************************************************************************************/
+t_minuterie instrumentation_debut(t_etape etape)
+{
+    t_minuterie minuterie = { etape, 0, 0 };
+
+    return minuterie;
+}
+
+void instrumentation_fin(t_minuterie* minuterie)
+{
+    (void) minuterie;
+}
+
+void instrumentation_compter(t_compteur compteur, long long valeur)
+{
+    (void) compteur;
+    (void) valeur;
+}
+
+void instrumentation_afficher(FILE* fichier)
+{
+    (void) fichier;
+}
+
+int instrumentation_ecrire_trace(const char* nom_fichier)
+{
+    (void) nom_fichier;
+    return 0;
+}
+
+void instrumentation_reinitialiser(void)
+{
+}
+
+
+#endif
@@ -0,0 +1,202 @@
+/****************************************************************************************
+    INSTRUMENTATION.H
+
+    Ce module contient des minuteries et des compteurs legers places dans les
+    chemins critiques de la librairie (lire, ecrire, les conversions et les
+    calculs). Chaque etape accumule son nombre d'appels, son temps reel et son
+    temps processeur; chaque compteur accumule une quantite (octets lus,
+    pixels convertis, allocations, etc.).
+
+    L'instrumentation n'est compilee que si INSTRUMENTATION est defini (option
+    CMake LIBRAIRIE_INSTRUMENTATION). Sinon, les macros INSTRUMENTER_* ne
+    produisent aucun code et les fonctions de rapport ne font rien.
+
+    Chaque fil d'execution accumule dans son propre bloc de statistiques, sans
+    verrou. Les blocs sont chaines a leur premiere utilisation et additionnes
+    par les fonctions de rapport, qui doivent etre appelees lorsque les fils
+    instrumentes sont au repos.
+
+    Une minuterie est une paire INSTRUMENTER_DEBUT / INSTRUMENTER_FIN qui
+    encadre un bloc de code; les deux doivent etre dans la meme portee.
+
+    Liste des sous-programmes publiques:
+      - instrumentation_afficher      : Ecrit un resume des etapes et compteurs;
+      - instrumentation_ecrire_trace  : Ecrit un fichier de trace (Chrome trace-event);
+      - instrumentation_reinitialiser : Remet les etapes et compteurs a zero.
+
+*****************************************************************************************/
+#ifndef INSTRUMENTATION_LIBRAIRIE
+#define INSTRUMENTATION_LIBRAIRIE
+
+#include <stdio.h>
+
+
+/****************************************************************************************
+*                               DEFINTION DES CONSTANTES                                *
+****************************************************************************************/
+
+/*
+    T_ETAPE
+
+    Les etapes chronometrees. Une nouvelle etape doit aussi etre nommee dans
+    NOMS_ETAPES (instrumentation.c).
+*/
+typedef enum
+{
+    ETAPE_LIRE,                     // lire au complet.
+    ETAPE_LIRE_FICHIER,             // La lecture des octets du fichier.
+    ETAPE_CONVERSION_1D_A_2D,       // La conversion BGR vers niveaux de gris.
+    ETAPE_LIRE_GRIS,                // lire_gris au complet.
+    ETAPE_LIRE_REGION,              // lire_region au complet.
+    ETAPE_LIRE_REDUITE,             // lire_reduite au complet.
+    ETAPE_CONVERSION_GRIS,          // La conversion BGR vers gris 8 bits.
+    ETAPE_CONVERSION_REDUITE,       // La conversion BGR vers gris, avec reduction.
+    ETAPE_ECRIRE,                   // ecrire au complet.
+    ETAPE_ECRIRE_FICHIER,           // L'ecriture des octets du fichier.
+    ETAPE_CONVERSION_2D_A_1D,       // La conversion niveaux de gris vers BGR.
+    ETAPE_PYRAMIDE,                 // La construction d'une pyramide.
+    ETAPE_REDIMENSIONNER,           // Le redimensionnement d'une image.
+    ETAPE_TRANSFORMER,              // Les transformations affines et perspectives.
+    ETAPE_HOUGH,                    // La transformee de Hough des droites.
+    ETAPE_DISTANCES,                // La transformee en distance euclidienne.
+    ETAPE_CONTOURS,                 // Le suivi des bordures.
+    ETAPE_LOCALISER,                // La chaine de localisation des plaques.
+    ETAPE_CLASSER,                  // Le classement d'un glyphe par gabarits.
+    ETAPE_CORRELER,                 // La correlation normalisee d'un gabarit.
+    ETAPE_HOG,                      // Les histogrammes de gradients orientes.
+    ETAPE_CASCADE,                  // Les cascades de classifieurs faibles.
+    ETAPE_COINS,                    // Les detecteurs de coins.
+    ETAPE_CONTRASTE,                // L'egalisation du contraste par tuiles.
+    ETAPE_BILATERAL,                // Le filtre bilateral par grille.
+    ETAPE_RESOUDRE_SYSTEME,         // Les solveurs lineaires.
+    ETAPE_MOINDRES_CARRES,
+    ETAPE_RESOUDRE_LOT,
+
+    NB_ETAPES
+
+}t_etape;
+
+
+/*
+    T_COMPTEUR
+
+    Les quantites comptees. Un nouveau compteur doit aussi etre nomme dans
+    NOMS_COMPTEURS (instrumentation.c).
+*/
+typedef enum
+{
+    COMPTEUR_OCTETS_LUS,            // Les octets lus des fichiers.
+    COMPTEUR_OCTETS_ECRITS,         // Les octets ecrits dans les fichiers.
+    COMPTEUR_PIXELS_CONVERTIS,      // Les pixels convertis (dans les deux sens).
+    COMPTEUR_ALLOCATIONS,           // Les allocations faites par la librairie.
+    COMPTEUR_SYSTEMES_RESOLUS,      // Les systemes lineaires resolus.
+
+    NB_COMPTEURS
+
+}t_compteur;
+
+
+/*
+    T_MINUTERIE
+
+    Le debut d'une etape en cours de mesure.
+*/
+typedef struct
+{
+    t_etape etape;      // L'etape mesuree.
+    double  mur;        // Le temps reel au debut de l'etape.
+    double  cpu;        // Le temps processeur du fil au debut de l'etape.
+
+}t_minuterie;
+
+
+#ifdef INSTRUMENTATION
+
+#define INSTRUMENTER_DEBUT(etape) \
+    t_minuterie minuterie_##etape = instrumentation_debut(etape)
+
+#define INSTRUMENTER_FIN(etape) \
+    instrumentation_fin(&minuterie_##etape)
+
+#define INSTRUMENTER_COMPTER(compteur, valeur) \
+    instrumentation_compter(compteur, (long long) (valeur))
+
+#else
+
+#define INSTRUMENTER_DEBUT(etape)               ((void) 0)
+#define INSTRUMENTER_FIN(etape)                 ((void) 0)
+#define INSTRUMENTER_COMPTER(compteur, valeur)  ((void) 0)
+
+#endif
+
+
+/****************************************************************************************
+*                       DECLARATION DES FONCTIONS PUBLIQUES                             *
+****************************************************************************************/
+
+
+/*
+    INSTRUMENTATION_DEBUT / INSTRUMENTATION_FIN / INSTRUMENTATION_COMPTER
+
+    Ces sous-programmes sont appeles par les macros INSTRUMENTER_* et ne
+    devraient pas etre utilises directement.
+*/
+t_minuterie instrumentation_debut(t_etape etape);
+void        instrumentation_fin(t_minuterie* minuterie);
+void        instrumentation_compter(t_compteur compteur, long long valeur);
+
+
+
+/*
+    INSTRUMENTATION_AFFICHER
+
+    Cette procedure ecrit, pour chaque etape, le nombre d'appels et les temps
+    reel et processeur cumules de tous les fils, puis la valeur de chaque
+    compteur.
+
+    Parametres:
+        - [FILE*] fichier : Le fichier (ou flux) ou ecrire le resume.
+
+    Retour:
+        Aucun.
+
+    Exemple d'utilisation:
+
+        [ ... lire, traiter et ecrire des images ... ]
+
+        instrumentation_afficher(stderr);
+*/
+void instrumentation_afficher(FILE* fichier);
+
+
+
+/*
+    INSTRUMENTATION_ECRIRE_TRACE
+
+    Cette fonction ecrit les derniers evenements de chaque fil au format
+    Chrome trace-event (JSON), lisible par chrome://tracing ou Perfetto.
+
+    Parametres:
+        - [char*] nom_fichier : Le fichier a creer.
+
+    Retour:
+        1 si le fichier a ete ecrit, 0 sinon (ou si l'instrumentation est
+        desactivee).
+*/
+int instrumentation_ecrire_trace(const char* nom_fichier);
+
+
+
+/*
+    INSTRUMENTATION_REINITIALISER
+
+    Cette procedure remet a zero les statistiques et les evenements de tous
+    les fils.
+
+    Retour:
+        Aucun.
+*/
+void instrumentation_reinitialiser(void);
+
+
+#endif
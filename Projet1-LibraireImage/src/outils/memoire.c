@@ -0,0 +1,470 @@
+/****************************************************************************************
+    MEMOIRE.C
+
+    Ce module contient la couche d'allocation suivie de la librairie. Chaque
+    bloc est precede d'une entete qui donne sa taille et son site d'appel; les
+    blocs vivants sont chaines afin de rapporter les fuites.
+****************************************************************************************/
+#include "memoire.h"
+
+
+#ifdef MEMOIRE_SUIVIE
+
+#include <stdatomic.h>
+#include <stddef.h>
+
+
+/****************************************************************************************
+*                               DEFINTION DES CONSTANTES                                *
+****************************************************************************************/
+
+// Le nombre maximal de sites d'appel differents. La derniere place regroupe les
+// sites qui ne trouvent plus de place libre.
+#define NB_SITES_MAX    1024
+
+// Le nombre maximal de blocs rapportes par site lors du rapport des fuites.
+#define NB_FUITES_AFFICHEES_PAR_SITE    4
+
+
+/*
+    T_SITE
+
+    Les statistiques d'un site d'appel (une ligne d'un fichier source).
+*/
+typedef struct
+{
+    const char* fichier;            // Le fichier source, NULL si la place est libre.
+    int         ligne;              // La ligne de l'appel.
+    long        nb_allocations;     // Le nombre d'allocations faites a ce site.
+    size_t      octets_alloues;     // Le total des octets alloues a ce site.
+    long        blocs_vivants;      // Les blocs de ce site qui ne sont pas liberes.
+    size_t      octets_vivants;
+
+}t_site;
+
+
+/*
+    T_ENTETE_BLOC
+
+    L'entete placee devant chaque bloc retourne. L'union garantit que le bloc
+    qui suit est aligne pour n'importe quel type.
+*/
+typedef union t_entete_bloc
+{
+    struct
+    {
+        size_t                taille;       // La taille demandee.
+        int                   site;         // L'indice du site d'appel.
+        union t_entete_bloc*  precedent;    // La liste des blocs vivants.
+        union t_entete_bloc*  suivant;
+    }info;
+
+    max_align_t alignement;
+
+}t_entete_bloc;
+
+
+// Les statistiques globales, protegees par le verrou.
+static atomic_flag    verrou             = ATOMIC_FLAG_INIT;
+static t_site         sites[NB_SITES_MAX];
+static t_entete_bloc* blocs_vivants      = NULL;
+static size_t         octets_vivants     = 0;
+static size_t         octets_max         = 0;
+static long           nb_allocations     = 0;
+static int            rapport_enregistre = 0;
+
+
+/****************************************************************************************
+*                           DECLARATION DES FONCTIONS PRIVEES                           *
+****************************************************************************************/
+
+
+/*
+    VERROUILLER / DEVERROUILLER
+
+    Ces procedures protegent les statistiques globales.
+*/
+static void verrouiller(void);
+static void deverrouiller(void);
+
+
+
+/*
+    TROUVER_SITE
+
+    Cette fonction retourne l'indice du site d'appel (fichier, ligne) et le
+    cree au besoin. Le verrou doit etre tenu.
+
+    Parametres:
+      - [char*] fichier : Le fichier source.
+      - [int  ] ligne   : La ligne de l'appel.
+
+    Retour: L'indice du site. Lorsque la table est pleine, le dernier site
+            sert a toutes les nouvelles lignes.
+*/
+static int trouver_site(const char* fichier, int ligne);
+
+
+
+/*
+    AJOUTER_BLOC / RETIRER_BLOC
+
+    Ces procedures ajoutent (ou retirent) un bloc de la liste des blocs vivants
+    et mettent a jour les statistiques. Le verrou doit etre tenu.
+*/
+static void ajouter_bloc(t_entete_bloc* entete, size_t taille, int site);
+static void retirer_bloc(t_entete_bloc* entete);
+
+
+
+/*
+    RAPPORTER_FUITES_FIN
+
+    Cette procedure est appelee a la fin du programme et ecrit les fuites sur
+    la sortie d'erreur.
+*/
+static void rapporter_fuites_fin(void);
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PUBLIQUES                            *
+****************************************************************************************/
+void* memoire_allouer(size_t taille, const char* fichier, int ligne)
+{
+    t_entete_bloc* entete;      // L'entete du bloc alloue.
+
+    entete = (t_entete_bloc*) malloc(sizeof(t_entete_bloc) + taille);
+    if(entete == NULL)
+        return NULL;
+
+    verrouiller();
+    ajouter_bloc(entete, taille, trouver_site(fichier, ligne));
+    deverrouiller();
+
+    return entete + 1;
+}
+
+
+
+void* memoire_reallouer(void* pointeur, size_t taille, const char* fichier, int ligne)
+{
+    t_entete_bloc* entete;      // L'entete du bloc d'origine.
+    t_entete_bloc* nouveau;     // L'entete du bloc realloue.
+
+    if(pointeur == NULL)
+        return memoire_allouer(taille, fichier, ligne);
+
+    entete = (t_entete_bloc*) pointeur - 1;
+
+    // Le bloc est retire de la liste avant d'etre deplace par realloc.
+    verrouiller();
+    retirer_bloc(entete);
+    deverrouiller();
+
+    nouveau = (t_entete_bloc*) realloc(entete, sizeof(t_entete_bloc) + taille);
+
+    verrouiller();
+    if(nouveau != NULL)
+        ajouter_bloc(nouveau, taille, trouver_site(fichier, ligne));
+    else
+        ajouter_bloc(entete, entete->info.taille, entete->info.site);
+    deverrouiller();
+
+    return nouveau != NULL ? (void*) (nouveau + 1) : NULL;
+}
+
+
+
+void memoire_liberer(void* pointeur)
+{
+    t_entete_bloc* entete;      // L'entete du bloc a liberer.
+
+    if(pointeur == NULL)
+        return;
+
+    entete = (t_entete_bloc*) pointeur - 1;
+
+    verrouiller();
+    retirer_bloc(entete);
+    deverrouiller();
+
+    free(entete);
+}
+
+
+
+size_t memoire_octets_vivants(void)
+{
+    size_t octets;  // La valeur lue sous le verrou.
+
+    verrouiller();
+    octets = octets_vivants;
+    deverrouiller();
+
+    return octets;
+}
+
+
+
+size_t memoire_octets_max(void)
+{
+    size_t octets;  // La valeur lue sous le verrou.
+
+    verrouiller();
+    octets = octets_max;
+    deverrouiller();
+
+    return octets;
+}
+
+
+
+long memoire_nb_allocations(void)
+{
+    long nombre;    // La valeur lue sous le verrou.
+
+    verrouiller();
+    nombre = nb_allocations;
+    deverrouiller();
+
+    return nombre;
+}
+
+
+
+void memoire_reinitialiser_max(void)
+{
+    verrouiller();
+    octets_max = octets_vivants;
+    deverrouiller();
+}
+
+
+
+void memoire_afficher(FILE* fichier)
+{
+    int  i;         // Iterateur sur les sites.
+    char site[256]; // Le site sous la forme fichier:ligne.
+
+    verrouiller();
+
+    fprintf(fichier, "Octets vivants : %zu\n", octets_vivants);
+    fprintf(fichier, "Octets maximum : %zu\n", octets_max);
+    fprintf(fichier, "Allocations    : %ld\n\n", nb_allocations);
+
+    fprintf(fichier, "%-40s %12s %16s %12s %16s\n", "Site", "Allocations", "Octets",
+                                                    "Vivants", "Octets vivants");
+    for(i = 0; i < NB_SITES_MAX; i++)
+    {
+        if(sites[i].fichier == NULL)
+            continue;
+
+        snprintf(site, sizeof(site), "%s:%d", sites[i].fichier, sites[i].ligne);
+        fprintf(fichier, "%-40s %12ld %16zu %12ld %16zu\n", site,
+                sites[i].nb_allocations, sites[i].octets_alloues,
+                sites[i].blocs_vivants, sites[i].octets_vivants);
+    }
+
+    deverrouiller();
+}
+
+
+
+long memoire_afficher_fuites(FILE* fichier)
+{
+    long           nb_fuites;   // Le nombre de blocs non liberes.
+    int            i;           // Iterateur sur les sites.
+    int            nb_affiches; // Les blocs deja ecrits pour un site.
+    t_entete_bloc* bloc;        // Iterateur sur les blocs vivants.
+
+    verrouiller();
+
+    nb_fuites = 0;
+    for(i = 0; i < NB_SITES_MAX; i++)
+    {
+        if(sites[i].fichier == NULL || sites[i].blocs_vivants == 0)
+            continue;
+
+        fprintf(fichier, "Fuite: %s:%d, %ld bloc(s), %zu octets\n", sites[i].fichier,
+                sites[i].ligne, sites[i].blocs_vivants, sites[i].octets_vivants);
+        nb_fuites += sites[i].blocs_vivants;
+
+        // Quelques blocs de ce site, pour aider a les retrouver.
+        nb_affiches = 0;
+        for(bloc = blocs_vivants;
+            bloc != NULL && nb_affiches < NB_FUITES_AFFICHEES_PAR_SITE;
+            bloc = bloc->info.suivant)
+        {
+            if(bloc->info.site == i)
+            {
+                fprintf(fichier, "    %p (%zu octets)\n", (void*) (bloc + 1),
+                                                          bloc->info.taille);
+                nb_affiches++;
+            }
+        }
+    }
+
+    deverrouiller();
+
+    return nb_fuites;
+}
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PRIVEES                            *
+****************************************************************************************/
+
+
+static void verrouiller(void)
+{
+    while(atomic_flag_test_and_set_explicit(&verrou, memory_order_acquire))
+        ;
+}
+
+
+static void deverrouiller(void)
+{
+    atomic_flag_clear_explicit(&verrou, memory_order_release);
+}
+
+
+static int trouver_site(const char* fichier, int ligne)
+{
+    size_t cle;     // Le hachage du site.
+    int    i;       // La place examinee.
+    int    essai;   // Le nombre de places examinees.
+
+    cle = ((size_t) fichier >> 4) * 31 + (size_t) ligne;
+
+    for(essai = 0; essai < NB_SITES_MAX - 1; essai++)
+    {
+        i = (int) ((cle + essai) % (NB_SITES_MAX - 1));
+
+        if(sites[i].fichier == NULL)
+        {
+            sites[i].fichier = fichier;
+            sites[i].ligne   = ligne;
+            return i;
+        }
+
+        if(sites[i].fichier == fichier && sites[i].ligne == ligne)
+            return i;
+    }
+
+    // La table est pleine.
+    sites[NB_SITES_MAX - 1].fichier = "(autres sites)";
+    return NB_SITES_MAX - 1;
+}
+
+
+static void ajouter_bloc(t_entete_bloc* entete, size_t taille, int site)
+{
+    entete->info.taille    = taille;
+    entete->info.site      = site;
+    entete->info.precedent = NULL;
+    entete->info.suivant   = blocs_vivants;
+    if(blocs_vivants != NULL)
+        blocs_vivants->info.precedent = entete;
+    blocs_vivants = entete;
+
+    sites[site].nb_allocations++;
+    sites[site].octets_alloues += taille;
+    sites[site].blocs_vivants++;
+    sites[site].octets_vivants += taille;
+
+    nb_allocations++;
+    octets_vivants += taille;
+    if(octets_vivants > octets_max)
+        octets_max = octets_vivants;
+
+    if(!rapport_enregistre)
+    {
+        rapport_enregistre = 1;
+        atexit(rapporter_fuites_fin);
+    }
+}
+
+
+static void retirer_bloc(t_entete_bloc* entete)
+{
+    if(entete->info.precedent != NULL)
+        entete->info.precedent->info.suivant = entete->info.suivant;
+    else
+        blocs_vivants = entete->info.suivant;
+
+    if(entete->info.suivant != NULL)
+        entete->info.suivant->info.precedent = entete->info.precedent;
+
+    sites[entete->info.site].blocs_vivants--;
+    sites[entete->info.site].octets_vivants -= entete->info.taille;
+    octets_vivants -= entete->info.taille;
+}
+
+
+static void rapporter_fuites_fin(void)
+{
+    long nb_fuites;     // Le nombre de blocs non liberes.
+
+    nb_fuites = memoire_afficher_fuites(stderr);
+    if(nb_fuites > 0)
+        fprintf(stderr, "%ld bloc(s) non libere(s) a la fin du programme.\n", nb_fuites);
+}
+
+
+#else
+
+
+/****************************************************************************************
+*                       VERSION SANS SUIVI DE LA MEMOIRE                                *
+****************************************************************************************/
+void* memoire_allouer(size_t taille, const char* fichier, int ligne)
+{
+    (void) fichier;
+    (void) ligne;
+    return malloc(taille);
+}
+
+void* memoire_reallouer(void* pointeur, size_t taille, const char* fichier, int ligne)
+{
+    (void) fichier;
+    (void) ligne;
+    return realloc(pointeur, taille);
+}
+
+void memoire_liberer(void* pointeur)
+{
+    free(pointeur);
+}
+
+size_t memoire_octets_vivants(void)
+{
+    return 0;
+}
+
+size_t memoire_octets_max(void)
+{
+    return 0;
+}
+
+long memoire_nb_allocations(void)
+{
+    return 0;
+}
+
+void memoire_reinitialiser_max(void)
+{
+}
+
+void memoire_afficher(FILE* fichier)
+{
+    (void) fichier;
+}
+
+long memoire_afficher_fuites(FILE* fichier)
+{
+    (void) fichier;
+    return 0;
+}
+
+
+#endif
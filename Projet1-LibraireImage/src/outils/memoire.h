@@ -0,0 +1,164 @@
+/****************************************************************************************
+    MEMOIRE.H
+
+    Ce module contient la couche d'allocation de la librairie. Toutes les
+    allocations des images et des tableaux passent par les macros ALLOUER,
+    REALLOUER et LIBERER.
+
+    Par defaut, ces macros appellent directement malloc, realloc et free. Si
+    MEMOIRE_SUIVIE est defini (option CMake LIBRAIRIE_SUIVI_MEMOIRE), chaque
+    bloc est plutot suivi: la couche connait alors les octets vivants, le
+    maximum atteint, le nombre d'allocations par site d'appel (fichier et
+    ligne) et les blocs qui n'ont pas ete liberes. Les fuites sont rapportees
+    sur la sortie d'erreur a la fin du programme.
+
+    Un bloc alloue avec ALLOUER doit etre libere avec LIBERER, et jamais avec
+    free directement (et inversement).
+
+    Liste des sous-programmes publiques:
+      - memoire_octets_vivants    : Les octets presentement alloues;
+      - memoire_octets_max        : Le maximum d'octets alloues en meme temps;
+      - memoire_nb_allocations    : Le nombre total d'allocations;
+      - memoire_reinitialiser_max : Ramene le maximum aux octets vivants;
+      - memoire_afficher          : Ecrit un resume par site d'appel;
+      - memoire_afficher_fuites   : Ecrit les blocs qui n'ont pas ete liberes.
+
+*****************************************************************************************/
+#ifndef MEMOIRE
+#define MEMOIRE
+
+#include <stdio.h>
+#include <stdlib.h>
+
+
+/****************************************************************************************
+*                               DEFINTION DES CONSTANTES                                *
+****************************************************************************************/
+
+#ifdef MEMOIRE_SUIVIE
+
+#define ALLOUER(taille) \
+    memoire_allouer((taille), __FILE__, __LINE__)
+
+#define REALLOUER(pointeur, taille) \
+    memoire_reallouer((pointeur), (taille), __FILE__, __LINE__)
+
+#define LIBERER(pointeur) \
+    memoire_liberer(pointeur)
+
+#else
+
+#define ALLOUER(taille)             malloc(taille)
+#define REALLOUER(pointeur, taille) realloc((pointeur), (taille))
+#define LIBERER(pointeur)           free(pointeur)
+
+#endif
+
+
+/****************************************************************************************
+*                       DECLARATION DES FONCTIONS PUBLIQUES                             *
+****************************************************************************************/
+
+
+/*
+    MEMOIRE_ALLOUER / MEMOIRE_REALLOUER / MEMOIRE_LIBERER
+
+    Ces sous-programmes sont appeles par les macros ALLOUER, REALLOUER et
+    LIBERER lorsque la memoire est suivie, et ne devraient pas etre utilises
+    directement.
+*/
+void* memoire_allouer(size_t taille, const char* fichier, int ligne);
+void* memoire_reallouer(void* pointeur, size_t taille, const char* fichier, int ligne);
+void  memoire_liberer(void* pointeur);
+
+
+
+/*
+    MEMOIRE_OCTETS_VIVANTS
+
+    Retour:
+        Le nombre d'octets presentement alloues par la librairie, ou 0 si la
+        memoire n'est pas suivie.
+*/
+size_t memoire_octets_vivants(void);
+
+
+
+/*
+    MEMOIRE_OCTETS_MAX
+
+    Retour:
+        Le plus grand nombre d'octets alloues en meme temps depuis le debut
+        (ou depuis memoire_reinitialiser_max), ou 0 si la memoire n'est pas
+        suivie.
+*/
+size_t memoire_octets_max(void);
+
+
+
+/*
+    MEMOIRE_NB_ALLOCATIONS
+
+    Retour:
+        Le nombre total d'allocations (et de reallocations) faites par la
+        librairie, ou 0 si la memoire n'est pas suivie.
+*/
+long memoire_nb_allocations(void);
+
+
+
+/*
+    MEMOIRE_REINITIALISER_MAX
+
+    Cette procedure ramene le maximum aux octets presentement alloues, afin de
+    mesurer le maximum atteint par une seule operation.
+
+    Retour:
+        Aucun.
+
+    Exemple d'utilisation:
+
+        memoire_reinitialiser_max();
+        avant = memoire_octets_vivants();
+
+        lire(nom_fichier, &image, &nb_lignes, &nb_colonnes);
+
+        printf("%zu octets au maximum\n", memoire_octets_max() - avant);
+*/
+void memoire_reinitialiser_max(void);
+
+
+
+/*
+    MEMOIRE_AFFICHER
+
+    Cette procedure ecrit les octets vivants, le maximum atteint et, pour
+    chaque site d'appel, le nombre d'allocations et d'octets alloues.
+
+    Parametres:
+        - [FILE*] fichier : Le fichier (ou flux) ou ecrire le resume.
+
+    Retour:
+        Aucun.
+*/
+void memoire_afficher(FILE* fichier);
+
+
+
+/*
+    MEMOIRE_AFFICHER_FUITES
+
+    Cette fonction ecrit, pour chaque site d'appel, les blocs qui n'ont pas
+    encore ete liberes. Elle est appelee automatiquement a la fin du programme
+    lorsque la memoire est suivie.
+
+    Parametres:
+        - [FILE*] fichier : Le fichier (ou flux) ou ecrire les fuites.
+
+    Retour:
+        Le nombre de blocs qui n'ont pas ete liberes.
+*/
+long memoire_afficher_fuites(FILE* fichier);
+
+
+#endif
@@ -0,0 +1,187 @@
+/****************************************************************************************
+    PARALLELE.C
+
+    Ce module contient la repartition des boucles sur plusieurs fils. Les fils
+    sont crees a chaque boucle et se partagent un compteur atomique qui donne
+    le prochain paquet a traiter.
+****************************************************************************************/
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "parallele.h"
+
+
+#ifdef PARALLELE_PTHREADS
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+
+
+/*
+    T_BOUCLE
+
+    Une boucle en cours, partagee par tous ses fils.
+*/
+typedef struct
+{
+    t_tache     tache;          // Le traitement d'un paquet.
+    void*       donnees;        // Les donnees de la tache.
+    int         nb_elements;    // Le nombre d'elements de la boucle.
+    int         taille_paquet;  // Le nombre d'elements d'un paquet.
+    atomic_int  prochain;       // Le premier element du prochain paquet libre.
+
+}t_boucle;
+
+
+// Le nombre de fils choisi, ou 0 pour le nombre de processeurs.
+static int nb_fils_choisi = 0;
+
+
+/****************************************************************************************
+*                           DECLARATION DES FONCTIONS PRIVEES                           *
+****************************************************************************************/
+
+
+/*
+    EXECUTER_PAQUETS
+
+    Cette fonction traite des paquets de la boucle jusqu'a ce qu'il n'en reste
+    plus. Elle est executee par chaque fil, dont le fil appelant.
+
+    Parametres:
+        - [void*] argument : La boucle (t_boucle*).
+
+    Retour: NULL.
+*/
+static void* executer_paquets(void* argument);
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PUBLIQUES                            *
+****************************************************************************************/
+void parallele_pour(int nb_elements, int taille_paquet, t_tache tache, void* donnees)
+{
+    t_boucle  boucle;               // La boucle partagee par les fils.
+    pthread_t fils[NB_FILS_MAX];    // Les fils crees, en plus du fil appelant.
+    int       nb_fils;              // Le nombre de fils utilises.
+    int       nb_crees;             // Le nombre de fils effectivement crees.
+    int       i;                    // Iterateur sur les fils.
+
+    if(taille_paquet < 1)
+        taille_paquet = 1;
+
+    // Il est inutile de creer plus de fils que de paquets.
+    nb_fils = parallele_nb_fils();
+    if(nb_fils > (nb_elements + taille_paquet - 1) / taille_paquet)
+        nb_fils = (nb_elements + taille_paquet - 1) / taille_paquet;
+
+    if(nb_fils <= 1)
+    {
+        if(nb_elements > 0)
+            tache(donnees, 0, nb_elements);
+        return;
+    }
+
+    boucle.tache         = tache;
+    boucle.donnees       = donnees;
+    boucle.nb_elements   = nb_elements;
+    boucle.taille_paquet = taille_paquet;
+    atomic_init(&boucle.prochain, 0);
+
+    // Un fil qui ne peut etre cree laisse simplement son travail aux autres.
+    nb_crees = 0;
+    for(i = 0; i < nb_fils - 1; i++)
+    {
+        if(pthread_create(&fils[nb_crees], NULL, executer_paquets, &boucle) == 0)
+            nb_crees++;
+    }
+
+    executer_paquets(&boucle);
+
+    for(i = 0; i < nb_crees; i++)
+        pthread_join(fils[i], NULL);
+}
+
+
+
+int parallele_nb_fils(void)
+{
+    long nb_processeurs;    // Le nombre de processeurs en ligne.
+
+    if(nb_fils_choisi > 0)
+        return nb_fils_choisi;
+
+    nb_processeurs = sysconf(_SC_NPROCESSORS_ONLN);
+    if(nb_processeurs < 1)
+        return 1;
+
+    return nb_processeurs < NB_FILS_MAX ? (int) nb_processeurs : NB_FILS_MAX;
+}
+
+
+
+void parallele_definir_nb_fils(int nb_fils)
+{
+    if(nb_fils < 0)
+        nb_fils = 0;
+
+    nb_fils_choisi = nb_fils < NB_FILS_MAX ? nb_fils : NB_FILS_MAX;
+}
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PRIVEES                            *
+****************************************************************************************/
+
+
+static void* executer_paquets(void* argument)
+{
+    t_boucle* boucle;   // La boucle partagee.
+    int       debut;    // Le premier element du paquet pris.
+    int       fin;      // La fin (exclue) du paquet pris.
+
+    boucle = (t_boucle*) argument;
+
+    for(;;)
+    {
+        debut = atomic_fetch_add(&boucle->prochain, boucle->taille_paquet);
+        if(debut >= boucle->nb_elements)
+            break;
+
+        fin = boucle->nb_elements - debut < boucle->taille_paquet ?
+              boucle->nb_elements : debut + boucle->taille_paquet;
+        boucle->tache(boucle->donnees, debut, fin);
+    }
+
+    return NULL;
+}
+
+
+#else
+
+
+/****************************************************************************************
+*                       VERSION SANS FILS D'EXECUTION                                   *
+****************************************************************************************/
+void parallele_pour(int nb_elements, int taille_paquet, t_tache tache, void* donnees)
+{
+    (void) taille_paquet;
+
+    if(nb_elements > 0)
+        tache(donnees, 0, nb_elements);
+}
+
+int parallele_nb_fils(void)
+{
+    return 1;
+}
+
+void parallele_definir_nb_fils(int nb_fils)
+{
+    (void) nb_fils;
+}
+
+
+#endif
@@ -0,0 +1,108 @@
+/****************************************************************************************
+    PARALLELE.H
+
+    Ce module contient un sous-programme qui repartit une boucle sur plusieurs
+    fils d'execution. Les elements de la boucle (par exemple les lignes d'une
+    image) sont distribues par paquets: chaque fil prend le prochain paquet
+    libre des qu'il a termine le precedent, de sorte qu'un fil ralenti ne
+    retarde pas les autres.
+
+    Les fils ne sont utilises que si PARALLELE_PTHREADS est defini (option
+    CMake LIBRAIRIE_PARALLELE, avec pthreads). Sinon, la boucle s'execute au
+    complet dans le fil appelant.
+
+    Liste des sous-programmes publiques:
+      - parallele_pour            : Execute une tache sur des paquets d'elements;
+      - parallele_nb_fils         : Le nombre de fils utilises;
+      - parallele_definir_nb_fils : Change le nombre de fils utilises.
+
+*****************************************************************************************/
+#ifndef PARALLELE
+#define PARALLELE
+
+
+/****************************************************************************************
+*                               DEFINTION DES CONSTANTES                                *
+****************************************************************************************/
+
+// Le nombre maximal de fils d'une boucle.
+#define NB_FILS_MAX     64
+
+
+/*
+    T_TACHE
+
+    Le traitement des elements debut a fin - 1 d'une boucle. La tache peut
+    etre appelee en meme temps par plusieurs fils, sur des paquets disjoints.
+*/
+typedef void (*t_tache)(void* donnees, int debut, int fin);
+
+
+/****************************************************************************************
+*                       DECLARATION DES FONCTIONS PUBLIQUES                             *
+****************************************************************************************/
+
+
+/*
+    PARALLELE_POUR
+
+    Cette procedure execute la tache sur les elements 0 a nb_elements - 1, par
+    paquets d'au plus taille_paquet elements, et retourne lorsque tous les
+    paquets sont termines. Le fil appelant participe au travail. Une boucle
+    d'un seul paquet s'execute sans creer de fil.
+
+    Parametres:
+        - [int    ] nb_elements  : Le nombre d'elements de la boucle.
+        - [int    ] taille_paquet: Le nombre d'elements d'un paquet (au moins 1).
+        - [t_tache] tache        : Le traitement d'un paquet.
+        - [void*  ] donnees      : Les donnees passees a chaque appel de la tache.
+
+    Retour:
+        Aucun.
+
+    Exemple d'utilisation:
+
+        static void doubler(void* donnees, int debut, int fin)
+        {
+            double* tableau = (double*) donnees;
+
+            for(int i = debut; i < fin; i++)
+                tableau[i] *= 2;
+        }
+
+        [ ... ]
+
+        parallele_pour(nb_elements, 4096, doubler, tableau);
+*/
+void parallele_pour(int nb_elements, int taille_paquet, t_tache tache, void* donnees);
+
+
+
+/*
+    PARALLELE_NB_FILS
+
+    Retour:
+        Le nombre de fils utilises par parallele_pour, fil appelant compris.
+        Par defaut, c'est le nombre de processeurs (1 sans PARALLELE_PTHREADS).
+*/
+int parallele_nb_fils(void);
+
+
+
+/*
+    PARALLELE_DEFINIR_NB_FILS
+
+    Cette procedure change le nombre de fils utilises par les prochains appels
+    de parallele_pour. Elle ne doit pas etre appelee pendant une boucle.
+
+    Parametres:
+        - [int] nb_fils : Le nombre de fils (ramene entre 1 et NB_FILS_MAX), ou 0
+                          pour revenir au nombre de processeurs.
+
+    Retour:
+        Aucun.
+*/
+void parallele_definir_nb_fils(int nb_fils);
+
+
+#endif
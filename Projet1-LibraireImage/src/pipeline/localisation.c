@@ -0,0 +1,580 @@
+/****************************************************************************************
+    LOCALISATION.C
+
+    Ce module contient la chaine de localisation des plaques. Les trois images
+    de travail (le gradient, l'image binaire et une image temporaire) sont
+    taillees dans un seul bloc de pixels, refait seulement lorsqu'une image
+    plus grande arrive. La morphologie est faite sur des images binaires: une
+    dilatation (ou une erosion) par un segment se ramene a compter les pixels
+    allumes d'une fenetre glissante, en temps constant par pixel quel que soit
+    le rayon.
+****************************************************************************************/
+#include "localisation.h"
+#include "../image/bitmap.h"
+#include "../outils/chrono.h"
+#include "../outils/instrumentation.h"
+#include "../outils/memoire.h"
+#include "../outils/parallele.h"
+
+#include <math.h>
+#include <stdatomic.h>
+#include <string.h>
+
+
+/****************************************************************************************
+*                               DEFINTION DES CONSTANTES                                *
+****************************************************************************************/
+
+#define VRAI    1
+#define FAUX    0
+
+#define PI      3.14159265358979323846
+
+// Le nombre de lignes (ou de colonnes) traitees par un fil a la fois.
+#define ELEMENTS_PAR_PAQUET     32
+
+// Les points de contour sont la fraction FRACTION_CONTOURS des pixels qui ont
+// le plus fort gradient, trouvee dans un histogramme de NB_CLASSES classes
+// (le gradient est entre 0 et 1).
+#define FRACTION_CONTOURS       0.06
+#define NB_CLASSES              1024
+
+// Le rayon horizontal de la fermeture est la largeur de l'image divisee par
+// DIVISEUR_FERMETURE (l'ecart entre deux caracteres d'une plaque qui occupe
+// le quart de l'image, environ); le rayon vertical en est le quart.
+#define DIVISEUR_FERMETURE      48
+
+// L'ouverture retire les blocs plus minces que 2 * rayon + 1 pixels, ou le
+// rayon est la hauteur de l'image divisee par DIVISEUR_OUVERTURE.
+#define DIVISEUR_OUVERTURE      100
+
+// Les proportions permises du rectangle minimal d'une plaque.
+#define RAPPORT_MIN             1.5
+#define RAPPORT_MAX             8.0
+#define LARGEUR_MIN             8
+#define ANGLE_MAX               (30.0 * PI / 180.0)
+
+// Le nombre d'images de travail.
+#define NB_IMAGES_TRAVAIL       3
+
+
+/*
+    T_CHAINE
+
+    Une image en cours de traitement, partagee par les fils.
+*/
+typedef struct
+{
+    double** image;         // L'image d'entree.
+    int      nb_lignes;
+    int      nb_colonnes;
+    double** gradient;      // Le gradient horizontal.
+    atomic_int histogramme[NB_CLASSES];     // L'histogramme du gradient.
+    double   seuil;         // Le seuil du gradient.
+    double** source;        // L'image lue par une passe morphologique.
+    double** destination;   // L'image ecrite par une passe morphologique.
+    int      rayon;         // Le rayon de la passe.
+    int      est_erosion;   // Vrai pour une erosion, faux pour une dilatation.
+
+}t_chaine;
+
+
+/****************************************************************************************
+*                           DECLARATION DES FONCTIONS PRIVEES                           *
+****************************************************************************************/
+
+
+/*
+    RESERVER_TRAVAIL
+
+    Cette fonction agrandit au besoin les images de travail et place leurs
+    pointeurs de lignes pour une image de la taille donnee.
+
+    Retour: 1 si l'espace est pret, 0 si la memoire manque.
+*/
+static int reserver_travail(t_localisateur* localisateur, int nb_lignes, int nb_colonnes);
+
+
+
+/*
+    TACHE_GRADIENT / TACHE_SEUIL
+
+    Ces procedures (de type t_tache) calculent le gradient horizontal (Sobel)
+    et son histogramme, ou l'image binaire des points de contour, pour les
+    lignes debut a fin - 1.
+*/
+static void tache_gradient(void* donnees, int debut, int fin);
+static void tache_seuil(void* donnees, int debut, int fin);
+
+
+
+/*
+    TACHE_HORIZONTALE / TACHE_VERTICALE
+
+    Ces procedures (de type t_tache) font une dilatation ou une erosion par un
+    segment horizontal (lignes debut a fin - 1) ou vertical (colonnes debut a
+    fin - 1). La fenetre est coupee aux bords de l'image.
+*/
+static void tache_horizontale(void* donnees, int debut, int fin);
+static void tache_verticale(void* donnees, int debut, int fin);
+
+
+
+/*
+    MORPHOLOGIE
+
+    Cette procedure fait une dilatation (ou une erosion) par un rectangle,
+    en deux passes: de source vers temporaire, puis de temporaire vers source.
+*/
+static void morphologie(t_chaine* chaine, double** source, double** temporaire,
+                        int rayon_lignes, int rayon_colonnes, int est_erosion);
+
+
+
+/*
+    EVALUER_CANDIDATES
+
+    Cette procedure retient les composantes qui ont les proportions d'une
+    plaque et range les meilleures dans le localisateur.
+*/
+static void evaluer_candidates(t_localisateur* localisateur, t_chaine* chaine,
+                               double** binaire);
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PUBLIQUES                            *
+****************************************************************************************/
+t_localisateur* creer_localisateur(void)
+{
+    t_localisateur* localisateur;   // Le localisateur cree.
+
+    localisateur = (t_localisateur*) ALLOUER(sizeof(t_localisateur));
+    if(localisateur == NULL)
+        return NULL;
+    INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 1);
+
+    memset(localisateur, 0, sizeof(t_localisateur));
+
+    localisateur->contours = creer_contours();
+    if(localisateur->contours == NULL)
+    {
+        LIBERER(localisateur);
+        return NULL;
+    }
+
+    return localisateur;
+}
+
+
+
+void detruire_localisateur(t_localisateur* localisateur)
+{
+    if(localisateur == NULL)
+        return;
+
+    detruire_contours(localisateur->contours);
+    LIBERER(localisateur->pixels);
+    LIBERER(localisateur->lignes);
+    LIBERER(localisateur);
+}
+
+
+
+int localiser_plaques(t_localisateur* localisateur, double** image, int nb_lignes,
+                      int nb_colonnes)
+{
+    t_chaine chaine;            // L'image en cours, partagee par les fils.
+    double** binaire;           // L'image binaire.
+    double** temporaire;        // L'image temporaire de la morphologie.
+    int      nb_pixels;         // Les pixels au-dessus de la classe courante.
+    int      classe;            // La classe du seuil.
+    double   temps;             // Le debut de l'etape courante.
+    int      rayon_fermeture;   // Les rayons de la morphologie.
+    int      rayon_ouverture;
+    int      i;                 // Iterateur sur les classes.
+
+    if(localisateur == NULL || image == NULL || nb_lignes <= 0 || nb_colonnes <= 0)
+        return -1;
+
+    if(!reserver_travail(localisateur, nb_lignes, nb_colonnes))
+        return -1;
+
+    INSTRUMENTER_DEBUT(ETAPE_LOCALISER);
+
+    memset(localisateur->durees, 0, sizeof(localisateur->durees));
+    localisateur->nb_plaques = 0;
+
+    chaine.image       = image;
+    chaine.nb_lignes   = nb_lignes;
+    chaine.nb_colonnes = nb_colonnes;
+    chaine.gradient    = localisateur->lignes;
+    binaire            = localisateur->lignes + nb_lignes;
+    temporaire         = localisateur->lignes + 2 * nb_lignes;
+
+    // Le gradient horizontal: les caracteres sont surtout faits de traits
+    // verticaux.
+    temps = chrono_mur();
+    for(i = 0; i < NB_CLASSES; i++)
+        atomic_init(&chaine.histogramme[i], 0);
+    parallele_pour(nb_lignes, ELEMENTS_PAR_PAQUET, tache_gradient, &chaine);
+    localisateur->durees[LOCALISATION_GRADIENT] = chrono_mur() - temps;
+
+    // Le seuil garde une fraction fixe des pixels, ce qui le rend independant
+    // du contraste et du bruit de l'image.
+    temps = chrono_mur();
+    nb_pixels = 0;
+    for(classe = NB_CLASSES - 1; classe > 0; classe--)
+    {
+        nb_pixels += atomic_load(&chaine.histogramme[classe]);
+        if(nb_pixels > FRACTION_CONTOURS * nb_lignes * nb_colonnes)
+            break;
+    }
+    chaine.seuil       = (double) classe / NB_CLASSES;
+    chaine.destination = binaire;
+    parallele_pour(nb_lignes, ELEMENTS_PAR_PAQUET, tache_seuil, &chaine);
+    localisateur->durees[LOCALISATION_SEUIL] = chrono_mur() - temps;
+
+    // La fermeture soude les caracteres; l'ouverture retire les traits isoles.
+    temps = chrono_mur();
+    rayon_fermeture = nb_colonnes / DIVISEUR_FERMETURE;
+    if(rayon_fermeture < 1)
+        rayon_fermeture = 1;
+    rayon_ouverture = nb_lignes / DIVISEUR_OUVERTURE;
+    if(rayon_ouverture < 1)
+        rayon_ouverture = 1;
+
+    morphologie(&chaine, binaire, temporaire, (rayon_fermeture + 3) / 4, rayon_fermeture, FAUX);
+    morphologie(&chaine, binaire, temporaire, (rayon_fermeture + 3) / 4, rayon_fermeture, VRAI);
+    morphologie(&chaine, binaire, temporaire, rayon_ouverture, rayon_ouverture, VRAI);
+    morphologie(&chaine, binaire, temporaire, rayon_ouverture, rayon_ouverture, FAUX);
+    localisateur->durees[LOCALISATION_MORPHOLOGIE] = chrono_mur() - temps;
+
+    temps = chrono_mur();
+    if(trouver_contours(binaire, nb_lignes, nb_colonnes, 0.5, localisateur->contours) < 0)
+    {
+        INSTRUMENTER_FIN(ETAPE_LOCALISER);
+        return -1;
+    }
+    localisateur->durees[LOCALISATION_COMPOSANTES] = chrono_mur() - temps;
+
+    temps = chrono_mur();
+    evaluer_candidates(localisateur, &chaine, binaire);
+    localisateur->durees[LOCALISATION_EVALUATION] = chrono_mur() - temps;
+
+    INSTRUMENTER_FIN(ETAPE_LOCALISER);
+
+    return localisateur->nb_plaques;
+}
+
+
+
+int localiser_fichier(t_localisateur* localisateur, char* nom_fichier)
+{
+    void*  image;           // L'image lue.
+    int    nb_lignes;       // La taille de l'image.
+    int    nb_colonnes;
+    double temps;           // Le debut de la lecture.
+    double lecture;         // La duree de la lecture.
+    int    nb_plaques;      // Le nombre de plaques trouvees.
+
+    if(localisateur == NULL || nom_fichier == NULL)
+        return -1;
+
+    temps = chrono_mur();
+    if(!lire(nom_fichier, &image, &nb_lignes, &nb_colonnes))
+        return -1;
+    lecture = chrono_mur() - temps;
+
+    nb_plaques = localiser_plaques(localisateur, (double**) image, nb_lignes, nb_colonnes);
+    localisateur->durees[LOCALISATION_LECTURE] = lecture;
+
+    detruire(image, nb_lignes, nb_colonnes);
+
+    return nb_plaques;
+}
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PRIVEES                            *
+****************************************************************************************/
+
+
+static int reserver_travail(t_localisateur* localisateur, int nb_lignes, int nb_colonnes)
+{
+    size_t nb_pixels;       // Le nombre de pixels d'une image.
+    int    i;               // Iterateur sur les lignes.
+
+    nb_pixels = (size_t) nb_lignes * nb_colonnes;
+
+    if(NB_IMAGES_TRAVAIL * nb_pixels > localisateur->capacite_pixels)
+    {
+        LIBERER(localisateur->pixels);
+        localisateur->pixels = (double*) ALLOUER(NB_IMAGES_TRAVAIL * nb_pixels * sizeof(double));
+        localisateur->capacite_pixels = localisateur->pixels != NULL ?
+                                        NB_IMAGES_TRAVAIL * nb_pixels : 0;
+        if(localisateur->pixels == NULL)
+            return FAUX;
+        INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 1);
+    }
+
+    if(nb_lignes > localisateur->capacite_lignes)
+    {
+        LIBERER(localisateur->lignes);
+        localisateur->lignes = (double**) ALLOUER(NB_IMAGES_TRAVAIL * (size_t) nb_lignes *
+                                                  sizeof(double*));
+        localisateur->capacite_lignes = localisateur->lignes != NULL ? nb_lignes : 0;
+        if(localisateur->lignes == NULL)
+            return FAUX;
+        INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 1);
+    }
+
+    // Les lignes des trois images se suivent dans le bloc de pixels.
+    for(i = 0; i < NB_IMAGES_TRAVAIL * nb_lignes; i++)
+        localisateur->lignes[i] = localisateur->pixels + (size_t) i * nb_colonnes;
+
+    return VRAI;
+}
+
+
+
+static void tache_gradient(void* donnees, int debut, int fin)
+{
+    t_chaine*     chaine = (t_chaine*) donnees;
+    int           nc     = chaine->nb_colonnes;
+    const double* haut;         // Les lignes i - 1, i et i + 1 de l'image.
+    const double* milieu;
+    const double* bas;
+    double*       gradient;     // La ligne i du gradient.
+    int           histogramme[NB_CLASSES];  // L'histogramme du paquet.
+    int           classe;       // La classe d'un pixel.
+    int           i, j;         // Iterateurs sur les lignes et les colonnes.
+
+    memset(histogramme, 0, sizeof(histogramme));
+
+    for(i = debut; i < fin; i++)
+    {
+        gradient = chaine->gradient[i];
+        memset(gradient, 0, (size_t) nc * sizeof(double));
+
+        // Les pixels du bord n'ont pas de gradient.
+        if(i > 0 && i < chaine->nb_lignes - 1)
+        {
+            haut   = chaine->image[i - 1];
+            milieu = chaine->image[i];
+            bas    = chaine->image[i + 1];
+
+            for(j = 1; j < nc - 1; j++)
+            {
+                gradient[j] = fabs((haut[j + 1] + 2 * milieu[j + 1] + bas[j + 1]) -
+                                   (haut[j - 1] + 2 * milieu[j - 1] + bas[j - 1])) * 0.25;
+
+                classe = (int) (gradient[j] * NB_CLASSES);
+                histogramme[classe < NB_CLASSES ? classe : NB_CLASSES - 1]++;
+            }
+        }
+    }
+
+    // Les pixels du bord (gradient nul) ne sont pas comptes: ils ne changent
+    // que la classe 0, qui n'est jamais un seuil.
+    for(classe = 0; classe < NB_CLASSES; classe++)
+        if(histogramme[classe] != 0)
+            atomic_fetch_add(&chaine->histogramme[classe], histogramme[classe]);
+}
+
+
+
+static void tache_seuil(void* donnees, int debut, int fin)
+{
+    t_chaine* chaine = (t_chaine*) donnees;
+    int       i, j;         // Iterateurs sur les lignes et les colonnes.
+
+    for(i = debut; i < fin; i++)
+        for(j = 0; j < chaine->nb_colonnes; j++)
+            chaine->destination[i][j] = chaine->gradient[i][j] > chaine->seuil ? 1.0 : 0.0;
+}
+
+
+
+static void tache_horizontale(void* donnees, int debut, int fin)
+{
+    t_chaine*     chaine = (t_chaine*) donnees;
+    int           nc     = chaine->nb_colonnes;
+    int           r      = chaine->rayon;
+    const double* source;       // La ligne lue.
+    double*       destination;  // La ligne ecrite.
+    int           compte;       // Les pixels allumes de la fenetre [j - r, j + r].
+    int           taille;       // Les pixels de la fenetre dans l'image.
+    int           i, j;         // Iterateurs sur les lignes et les colonnes.
+
+    for(i = debut; i < fin; i++)
+    {
+        source      = chaine->source[i];
+        destination = chaine->destination[i];
+
+        compte = 0;
+        for(j = 0; j < r && j < nc; j++)
+            compte += source[j] > 0.5;
+
+        for(j = 0; j < nc; j++)
+        {
+            if(j + r < nc)
+                compte += source[j + r] > 0.5;
+            if(j - r - 1 >= 0)
+                compte -= source[j - r - 1] > 0.5;
+
+            taille = (j + r < nc ? j + r : nc - 1) - (j - r > 0 ? j - r : 0) + 1;
+            destination[j] = (chaine->est_erosion ? compte == taille : compte > 0) ? 1.0 : 0.0;
+        }
+    }
+}
+
+
+
+static void tache_verticale(void* donnees, int debut, int fin)
+{
+    t_chaine*     chaine = (t_chaine*) donnees;
+    int           nl     = chaine->nb_lignes;
+    int           r      = chaine->rayon;
+    int           compte[ELEMENTS_PAR_PAQUET];  // Les pixels allumes de la fenetre
+                                                // [i - r, i + r] de chaque colonne.
+    int           taille;       // Les pixels de la fenetre dans l'image.
+    const double* entre;        // La ligne qui entre dans la fenetre.
+    const double* sort;         // La ligne qui sort de la fenetre.
+    double*       destination;  // La ligne ecrite.
+    int           premiere;     // La premiere colonne du groupe.
+    int           derniere;     // La colonne qui suit la derniere du groupe.
+    int           i, j;         // Iterateurs sur les lignes et les colonnes.
+
+    // Les colonnes avancent ensemble par groupes de ELEMENTS_PAR_PAQUET, ligne
+    // par ligne, pour lire la memoire dans l'ordre.
+    for(premiere = debut; premiere < fin; premiere = derniere)
+    {
+        derniere = premiere + ELEMENTS_PAR_PAQUET < fin ? premiere + ELEMENTS_PAR_PAQUET : fin;
+
+        for(j = premiere; j < derniere; j++)
+            compte[j - premiere] = 0;
+        for(i = 0; i < r && i < nl; i++)
+            for(j = premiere; j < derniere; j++)
+                compte[j - premiere] += chaine->source[i][j] > 0.5;
+
+        for(i = 0; i < nl; i++)
+        {
+            entre       = i + r < nl     ? chaine->source[i + r]     : NULL;
+            sort        = i - r - 1 >= 0 ? chaine->source[i - r - 1] : NULL;
+            destination = chaine->destination[i];
+            taille      = (i + r < nl ? i + r : nl - 1) - (i - r > 0 ? i - r : 0) + 1;
+
+            for(j = premiere; j < derniere; j++)
+            {
+                if(entre != NULL)
+                    compte[j - premiere] += entre[j] > 0.5;
+                if(sort != NULL)
+                    compte[j - premiere] -= sort[j] > 0.5;
+
+                destination[j] = (chaine->est_erosion ? compte[j - premiere] == taille :
+                                                        compte[j - premiere] > 0) ? 1.0 : 0.0;
+            }
+        }
+    }
+}
+
+
+
+static void morphologie(t_chaine* chaine, double** source, double** temporaire,
+                        int rayon_lignes, int rayon_colonnes, int est_erosion)
+{
+    chaine->est_erosion = est_erosion;
+
+    chaine->source      = source;
+    chaine->destination = temporaire;
+    chaine->rayon       = rayon_colonnes;
+    parallele_pour(chaine->nb_lignes, ELEMENTS_PAR_PAQUET, tache_horizontale, chaine);
+
+    chaine->source      = temporaire;
+    chaine->destination = source;
+    chaine->rayon       = rayon_lignes;
+    parallele_pour(chaine->nb_colonnes, ELEMENTS_PAR_PAQUET, tache_verticale, chaine);
+}
+
+
+
+static void evaluer_candidates(t_localisateur* localisateur, t_chaine* chaine,
+                               double** binaire)
+{
+    t_contours* contours = localisateur->contours;
+    t_contour*  contour;        // La composante evaluee.
+    t_plaque    plaque;         // La candidate.
+    t_point*    point;          // Iterateur sur les points du contour.
+    int         fin_ligne;      // La boite englobante (bornes incluses).
+    int         fin_colonne;
+    int         nb_contours;    // Les pixels de contour dans la boite.
+    int         nb_allumes;     // Les pixels du bloc dans la boite.
+    double      aire;           // L'aire de la boite.
+    int         c, q;           // Iterateurs sur les contours et les points.
+    int         i, j;           // Iterateurs sur les pixels de la boite.
+    int         k;              // La place de la candidate dans le classement.
+
+    for(c = 0; c < contours->nb_contours; c++)
+    {
+        contour = &contours->contours[c];
+        if(contour->est_trou)
+            continue;
+
+        if(!rectangle_minimal(contours, c, &plaque.rectangle) ||
+           plaque.rectangle.largeur < LARGEUR_MIN ||
+           plaque.rectangle.longueur < RAPPORT_MIN * plaque.rectangle.largeur ||
+           plaque.rectangle.longueur > RAPPORT_MAX * plaque.rectangle.largeur ||
+           fabs(plaque.rectangle.angle) > ANGLE_MAX)
+            continue;
+
+        // La boite englobante.
+        point = contours->points + contour->debut;
+        plaque.ligne   = fin_ligne   = point->ligne;
+        plaque.colonne = fin_colonne = point->colonne;
+        for(q = 1; q < contour->nb_points; q++)
+        {
+            point++;
+            if(point->ligne < plaque.ligne)
+                plaque.ligne = point->ligne;
+            if(point->ligne > fin_ligne)
+                fin_ligne = point->ligne;
+            if(point->colonne < plaque.colonne)
+                plaque.colonne = point->colonne;
+            if(point->colonne > fin_colonne)
+                fin_colonne = point->colonne;
+        }
+        plaque.nb_lignes   = fin_ligne   - plaque.ligne   + 1;
+        plaque.nb_colonnes = fin_colonne - plaque.colonne + 1;
+
+        // Une plaque est une boite remplie par le bloc et dense en contours.
+        nb_contours = 0;
+        nb_allumes  = 0;
+        for(i = plaque.ligne; i <= fin_ligne; i++)
+            for(j = plaque.colonne; j <= fin_colonne; j++)
+            {
+                nb_contours += chaine->gradient[i][j] > chaine->seuil;
+                nb_allumes  += binaire[i][j] > 0.5;
+            }
+
+        aire = (double) plaque.nb_lignes * plaque.nb_colonnes;
+        plaque.score = (nb_contours / aire) * (nb_allumes / aire);
+
+        // L'insertion dans le classement, par score decroissant.
+        k = localisateur->nb_plaques;
+        if(k == NB_PLAQUES_MAX)
+        {
+            if(plaque.score <= localisateur->plaques[k - 1].score)
+                continue;
+            k--;
+        }
+        else
+            localisateur->nb_plaques++;
+
+        while(k > 0 && localisateur->plaques[k - 1].score < plaque.score)
+        {
+            localisateur->plaques[k] = localisateur->plaques[k - 1];
+            k--;
+        }
+        localisateur->plaques[k] = plaque;
+    }
+}
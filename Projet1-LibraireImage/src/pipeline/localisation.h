@@ -0,0 +1,184 @@
+/****************************************************************************************
+    LOCALISATION.H
+
+    Ce module contient la chaine de localisation des plaques d'immatriculation:
+    lecture de l'image (lire), gradient horizontal, seuil, fermeture et
+    ouverture morphologiques, composantes (contours) et evaluation des
+    candidates. Les caracteres d'une plaque donnent une bande dense de
+    contours verticaux; la fermeture la soude en un seul bloc, dont le
+    rectangle minimal doit avoir les proportions d'une plaque.
+
+    Toutes les images intermediaires et les contours sont gardes dans un
+    t_localisateur, reutilise d'une image a l'autre: apres la premiere image
+    (ou apres une image plus grande), la chaine ne fait plus d'allocation. Un
+    localisateur ne doit etre utilise que par un fil a la fois; chaque fil qui
+    traite des images a le sien. Les etapes elles-memes sont reparties sur
+    plusieurs fils (voir parallele.h).
+
+    Le localisateur donne aussi la duree de chaque etape de la derniere image
+    traitee.
+
+    Liste des sous-programmes publiques:
+      - creer_localisateur    : Cree un localisateur et son espace de travail;
+      - detruire_localisateur : Libere un localisateur;
+      - localiser_plaques     : Localise les plaques d'une image en memoire;
+      - localiser_fichier     : Lit un fichier .bmp et localise ses plaques.
+
+*****************************************************************************************/
+#ifndef LOCALISATION
+#define LOCALISATION
+
+#include "../traitement/contours.h"
+
+
+/****************************************************************************************
+*                               DEFINTION DES CONSTANTES                                *
+****************************************************************************************/
+
+// Le nombre maximal de plaques retournees pour une image.
+#define NB_PLAQUES_MAX  8
+
+
+/*
+    T_ETAPE_LOCALISATION
+
+    Les etapes de la chaine, dans l'ordre.
+*/
+typedef enum
+{
+    LOCALISATION_LECTURE,           // lire (seulement pour localiser_fichier).
+    LOCALISATION_GRADIENT,          // Le gradient horizontal (Sobel).
+    LOCALISATION_SEUIL,             // Le seuil du gradient.
+    LOCALISATION_MORPHOLOGIE,       // La fermeture puis l'ouverture.
+    LOCALISATION_COMPOSANTES,       // Les contours des composantes.
+    LOCALISATION_EVALUATION,        // Le tri et l'evaluation des candidates.
+
+    NB_ETAPES_LOCALISATION
+
+}t_etape_localisation;
+
+
+/*
+    T_PLAQUE
+
+    Une plaque trouvee.
+*/
+typedef struct
+{
+    int         ligne;          // La boite englobante, en pixels.
+    int         colonne;
+    int         nb_lignes;
+    int         nb_colonnes;
+    t_rectangle rectangle;      // Le rectangle oriente d'aire minimale.
+    double      score;          // Entre 0 et 1: la densite des contours dans la
+                                // boite fois son remplissage par le bloc.
+
+}t_plaque;
+
+
+/*
+    T_LOCALISATEUR
+
+    Un localisateur. Les champs plaques, nb_plaques et durees donnent le
+    resultat de la derniere image; les autres ne servent qu'au module.
+*/
+typedef struct
+{
+    t_plaque    plaques[NB_PLAQUES_MAX];            // Les plaques, par score decroissant.
+    int         nb_plaques;
+    double      durees[NB_ETAPES_LOCALISATION];     // La duree de chaque etape, en secondes.
+
+    double*     pixels;             // Les pixels des trois images de travail.
+    size_t      capacite_pixels;
+    double**    lignes;             // Les pointeurs de lignes des trois images.
+    int         capacite_lignes;
+    t_contours* contours;           // Les contours des composantes.
+
+}t_localisateur;
+
+
+/****************************************************************************************
+*                       DECLARATION DES FONCTIONS PUBLIQUES                             *
+****************************************************************************************/
+
+
+/*
+    CREER_LOCALISATEUR
+
+    Cette fonction cree un localisateur. Son espace de travail est alloue a
+    la premiere image.
+
+    Retour:
+        Le localisateur, ou NULL si la memoire manque.
+*/
+t_localisateur* creer_localisateur(void);
+
+
+
+/*
+    DETRUIRE_LOCALISATEUR
+
+    Cette procedure libere un localisateur et son espace de travail.
+
+    Parametres:
+        - [t_localisateur*] localisateur : Le localisateur (NULL est accepte).
+*/
+void detruire_localisateur(t_localisateur* localisateur);
+
+
+
+/*
+    LOCALISER_PLAQUES
+
+    Cette fonction localise les plaques d'une image en niveaux de gris. Les
+    plaques et les durees des etapes sont rangees dans le localisateur (la
+    duree de la lecture est mise a 0).
+
+    Parametres:
+        - [t_localisateur*] localisateur : Le localisateur.
+        - [double**       ] image        : L'image, comme retournee par lire.
+        - [int            ] nb_lignes    : Le nombre de lignes de l'image.
+        - [int            ] nb_colonnes  : Le nombre de colonnes de l'image.
+
+    Retour:
+        Le nombre de plaques trouvees (au plus NB_PLAQUES_MAX), ou -1 si les
+        parametres sont invalides ou si la memoire manque.
+
+    Exemple d'utilisation:
+
+        t_localisateur* localisateur = creer_localisateur();
+        int             i, n;
+
+        n = localiser_plaques(localisateur, image, nb_lignes, nb_colonnes);
+        for(i = 0; i < n; i++)
+            printf("%d %d %d %d\n", localisateur->plaques[i].ligne,
+                                    localisateur->plaques[i].colonne,
+                                    localisateur->plaques[i].nb_lignes,
+                                    localisateur->plaques[i].nb_colonnes);
+
+        detruire_localisateur(localisateur);
+*/
+int localiser_plaques(t_localisateur* localisateur, double** image, int nb_lignes,
+                      int nb_colonnes);
+
+
+
+/*
+    LOCALISER_FICHIER
+
+    Cette fonction lit un fichier .bmp avec lire et localise ses plaques,
+    comme localiser_plaques. La duree de la lecture est comprise dans les
+    durees.
+
+    Parametres:
+        - [t_localisateur*] localisateur : Le localisateur.
+        - [char*          ] nom_fichier  : Le fichier a lire.
+
+    Retour:
+        Le nombre de plaques trouvees, ou -1 si le fichier ne peut pas etre lu
+        ou si la memoire manque.
+*/
+int localiser_fichier(t_localisateur* localisateur, char* nom_fichier);
+
+
+#endif
@@ -0,0 +1,208 @@
+/****************************************************************************************
+    PIPELINE.C
+
+    Ce programme localise les plaques d'immatriculation de fichiers .bmp avec
+    la chaine de localisation.h. Pour chaque fichier, il affiche les boites
+    englobantes des plaques trouvees (par score decroissant), puis la duree
+    de chaque etape de la chaine.
+
+    Le meme localisateur sert a tous les fichiers et a toutes les repetitions:
+    seule la premiere image (ou une image plus grande que les precedentes)
+    alloue l'espace de travail. Avec plusieurs repetitions, les durees
+    rapportees sont la mediane et le minimum de chaque etape.
+
+    Utilisation:
+        Projet1_Pipeline [-r repetitions] [-f nb_fils] [fichier.bmp ...]
+
+      -r : Le nombre de fois que chaque fichier est traite. Defaut: 1.
+      -f : Le nombre de fils des etapes. Defaut: le nombre de processeurs.
+
+    Sans fichier, les images du repertoire data du projet sont traitees.
+
+****************************************************************************************/
+#include "pipeline/localisation.h"
+#include "outils/instrumentation.h"
+#include "outils/parallele.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/****************************************************************************************
+*                               DEFINTION DES CONSTANTES                                *
+****************************************************************************************/
+
+// Le repertoire des images de test, fourni par CMake.
+#ifndef DOSSIER_DONNEES
+#define DOSSIER_DONNEES     "data"
+#endif
+
+// Les images traitees lorsqu'aucun fichier n'est donne.
+static const char* FICHIERS_DEFAUT[] =
+{
+    DOSSIER_DONNEES "/plaque_test_1.bmp",
+    DOSSIER_DONNEES "/plaque_test_2.bmp",
+};
+#define NB_FICHIERS_DEFAUT  ((int) (sizeof(FICHIERS_DEFAUT) / sizeof(FICHIERS_DEFAUT[0])))
+
+// Le nombre maximal de repetitions par fichier.
+#define REPETITIONS_MAX     1000
+
+#define PI                  3.14159265358979323846
+
+// Les noms des etapes, dans l'ordre de t_etape_localisation.
+static const char* NOMS_ETAPES[NB_ETAPES_LOCALISATION] =
+{
+    "lecture",
+    "gradient",
+    "seuil",
+    "morphologie",
+    "composantes",
+    "evaluation",
+};
+
+
+/****************************************************************************************
+*                           DECLARATION DES FONCTIONS PRIVEES                           *
+****************************************************************************************/
+
+
+/*
+    TRAITER_FICHIER
+
+    Cette fonction localise les plaques d'un fichier 'repetitions' fois et
+    affiche les plaques et les durees des etapes.
+
+    Retour: 1 si le fichier a ete traite, 0 sinon.
+*/
+static int traiter_fichier(t_localisateur* localisateur, char* nom_fichier, int repetitions);
+
+
+
+/*
+    COMPARER_DOUBLES
+
+    Cette fonction (pour qsort) ordonne des reels en ordre croissant.
+*/
+static int comparer_doubles(const void* a, const void* b);
+
+
+/****************************************************************************************
+*                                   PROGRAMME PRINCIPAL                                 *
+****************************************************************************************/
+int main(int argc, char* argv[])
+{
+    t_localisateur* localisateur;   // L'espace de travail, reutilise.
+    int             repetitions;    // Les options de la ligne de commande.
+    int             nb_fils;
+    int             nb_traites;     // Le nombre de fichiers traites.
+    int             nb_fichiers;    // Le nombre de fichiers donnes.
+    int             i;              // Iterateur sur les arguments.
+
+    repetitions = 1;
+    nb_fils     = 0;
+    nb_fichiers = 0;
+    nb_traites  = 0;
+
+    localisateur = creer_localisateur();
+    if(localisateur == NULL)
+    {
+        fprintf(stderr, "Memoire insuffisante\n");
+        return EXIT_FAILURE;
+    }
+
+    // Les options d'abord, puis les fichiers.
+    for(i = 1; i + 1 < argc; i += 2)
+    {
+        if(strcmp(argv[i], "-r") == 0)
+            repetitions = atoi(argv[i + 1]);
+        else if(strcmp(argv[i], "-f") == 0)
+            nb_fils = atoi(argv[i + 1]);
+        else
+            break;
+    }
+
+    if(repetitions < 1)
+        repetitions = 1;
+    else if(repetitions > REPETITIONS_MAX)
+        repetitions = REPETITIONS_MAX;
+    if(nb_fils > 0)
+        parallele_definir_nb_fils(nb_fils);
+
+    for(; i < argc; i++, nb_fichiers++)
+        nb_traites += traiter_fichier(localisateur, argv[i], repetitions);
+
+    if(nb_fichiers == 0)
+        for(i = 0; i < NB_FICHIERS_DEFAUT; i++, nb_fichiers++)
+            nb_traites += traiter_fichier(localisateur, (char*) FICHIERS_DEFAUT[i],
+                                          repetitions);
+
+    detruire_localisateur(localisateur);
+
+    // Le detail par etape de la librairie, si elle est instrumentee.
+    instrumentation_afficher(stderr);
+
+    return nb_traites == nb_fichiers ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PRIVEES                            *
+****************************************************************************************/
+
+
+static int traiter_fichier(t_localisateur* localisateur, char* nom_fichier, int repetitions)
+{
+    static double durees[NB_ETAPES_LOCALISATION][REPETITIONS_MAX];  // Les durees mesurees.
+    double        total_median;     // La somme des medianes des etapes.
+    t_plaque*     plaque;           // La plaque affichee.
+    int           nb_plaques;       // Le nombre de plaques trouvees.
+    int           n, e, p;          // Iterateurs sur les repetitions, etapes et plaques.
+
+    nb_plaques = -1;
+    for(n = 0; n < repetitions; n++)
+    {
+        nb_plaques = localiser_fichier(localisateur, nom_fichier);
+        if(nb_plaques < 0)
+        {
+            fprintf(stderr, "Impossible de traiter %s\n", nom_fichier);
+            return 0;
+        }
+
+        for(e = 0; e < NB_ETAPES_LOCALISATION; e++)
+            durees[e][n] = localisateur->durees[e];
+    }
+
+    printf("%s: %d plaque(s)\n", nom_fichier, nb_plaques);
+    for(p = 0; p < nb_plaques; p++)
+    {
+        plaque = &localisateur->plaques[p];
+        printf("  %d: ligne %d, colonne %d, %d x %d, angle %.1f deg, score %.3f\n", p + 1,
+               plaque->ligne, plaque->colonne, plaque->nb_lignes, plaque->nb_colonnes,
+               plaque->rectangle.angle * 180.0 / PI, plaque->score);
+    }
+
+    printf("  %-14s %14s %14s\n", "Etape", "Mediane (ms)", "Minimum (ms)");
+    total_median = 0;
+    for(e = 0; e < NB_ETAPES_LOCALISATION; e++)
+    {
+        qsort(durees[e], repetitions, sizeof(double), comparer_doubles);
+        total_median += durees[e][repetitions / 2];
+        printf("  %-14s %14.3f %14.3f\n", NOMS_ETAPES[e], durees[e][repetitions / 2] * 1000.0,
+                                          durees[e][0] * 1000.0);
+    }
+    printf("  %-14s %14.3f\n\n", "total", total_median * 1000.0);
+
+    return 1;
+}
+
+
+
+static int comparer_doubles(const void* a, const void* b)
+{
+    double x = *(const double*) a;
+    double y = *(const double*) b;
+
+    return (x > y) - (x < y);
+}
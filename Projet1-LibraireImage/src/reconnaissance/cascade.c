@@ -0,0 +1,753 @@
+/****************************************************************************************
+    CASCADE.C
+
+    Ce module contient l'evaluation des cascades. Avec L la largeur de
+    l'image integrale, la fenetre dont le coin est au pixel (y, x) commence
+    a l'indice y * L + x; le coin d'un rectangle agrandi est a un decalage
+    fixe de cet indice, calcule une fois par echelle.
+****************************************************************************************/
+#include "cascade.h"
+#include "../outils/instrumentation.h"
+#include "../outils/memoire.h"
+#include "../outils/parallele.h"
+
+#include <math.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/****************************************************************************************
+*                               DEFINTION DES CONSTANTES                                *
+****************************************************************************************/
+
+#define VRAI    1
+#define FAUX    0
+
+// Les coins d'un rectangle dans l'image integrale.
+#define NB_COINS_RECTANGLE      4
+
+// Le nombre de rangees de fenetres d'une tuile.
+#define RANGEES_PAR_TUILE       8
+
+// Le nombre de detections gardees par un fil avant de les ranger.
+#define DETECTIONS_LOCALES      64
+
+// La variance sous laquelle une fenetre est consideree uniforme.
+#define VARIANCE_MIN            1e-8
+
+// Le nombre de classifieurs ou d'etages alloues a la creation d'une cascade.
+#define CAPACITE_INITIALE       16
+
+
+/*
+    T_ECHELLE
+
+    La cascade agrandie pour une echelle.
+*/
+typedef struct
+{
+    double echelle;
+    int    nb_lignes;           // La taille de la fenetre.
+    int    nb_colonnes;
+    int    pas;                 // Le decalage des fenetres.
+    int    nb_rangees;          // Le nombre de fenetres en hauteur et en largeur.
+    int    nb_positions;
+    double inverse_aire;        // 1 / l'aire de la fenetre.
+    int    fenetre[NB_COINS_RECTANGLE];     // Les coins de la fenetre.
+    size_t debut;               // Le premier classifieur dans decalages et poids.
+
+}t_echelle;
+
+
+/*
+    T_TUILE
+
+    Les rangees de fenetres premiere a fin - 1 d'une echelle.
+*/
+typedef struct
+{
+    int       echelle;
+    int       premiere;
+    int       fin;
+    long long cout;             // Le nombre de fenetres.
+
+}t_tuile;
+
+
+/*
+    T_BALAYAGE
+
+    Un balayage en cours, partage par les fils.
+*/
+typedef struct
+{
+    t_detecteur*     detecteur;
+    const t_cascade* cascade;
+    const double*    somme1;            // Les images integrales.
+    const double*    somme2;
+    int              largeur;           // La largeur des images integrales.
+    atomic_int       nb_detections;     // Le nombre de detections trouvees (meme
+                                        // au-dela de la capacite).
+    atomic_llong     nb_fenetres;
+    atomic_llong     nb_etages_evalues;
+
+}t_balayage;
+
+
+/****************************************************************************************
+*                           DECLARATION DES FONCTIONS PRIVEES                           *
+****************************************************************************************/
+
+
+/*
+    TACHE_TUILES
+
+    Cette procedure (de type t_tache) evalue les fenetres des tuiles debut
+    a fin - 1 de la file.
+
+    Parametres:
+        - [void*] donnees : Le balayage (t_balayage*).
+        - [int  ] debut   : La premiere tuile.
+        - [int  ] fin     : La tuile qui suit la derniere.
+*/
+static void tache_tuiles(void* donnees, int debut, int fin);
+
+
+
+/*
+    RANGER_DETECTIONS
+
+    Cette procedure reserve des places dans le tableau des detections et y
+    copie les detections d'un fil. Celles qui depassent la capacite sont
+    seulement comptees.
+*/
+static void ranger_detections(t_balayage* balayage, const t_detection* detections, int n);
+
+
+
+/*
+    PREPARER_ECHELLES
+
+    Cette fonction agrandit la cascade pour chaque echelle et remplit la
+    file des tuiles, des plus cheres aux moins cheres.
+
+    Retour: Le nombre de tuiles, ou -1 si la memoire manque.
+*/
+static int preparer_echelles(t_detecteur* detecteur, const t_cascade* cascade,
+                             int nb_lignes, int nb_colonnes, double facteur, double pas);
+
+
+
+/*
+    CALCULER_INTEGRALES
+
+    Cette fonction calcule les images integrales des pixels et de leurs
+    carres.
+
+    Retour: 1 si le calcul a ete fait, 0 si la memoire manque.
+*/
+static int calculer_integrales(t_detecteur* detecteur, double** image, int nb_lignes,
+                               int nb_colonnes);
+
+
+
+/*
+    RESERVER
+
+    Cette fonction agrandit un tableau a au moins 'voulu' elements de
+    'taille' octets.
+
+    Retour: 1 si le tableau a la capacite voulue, 0 si la memoire manque.
+*/
+static int reserver(void** tableau, size_t* capacite, size_t voulu, size_t taille);
+
+
+
+/*
+    COMPARER_TUILES / COMPARER_DETECTIONS
+
+    Ces fonctions (pour qsort) ordonnent les tuiles par cout decroissant et
+    les detections par echelle, ligne et colonne.
+*/
+static int comparer_tuiles(const void* a, const void* b);
+static int comparer_detections(const void* a, const void* b);
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PUBLIQUES                            *
+****************************************************************************************/
+t_cascade* creer_cascade(int nb_lignes, int nb_colonnes)
+{
+    t_cascade* cascade;     // La cascade creee.
+
+    if(nb_lignes < 1 || nb_colonnes < 1)
+        return NULL;
+
+    cascade = (t_cascade*) ALLOUER(sizeof(t_cascade));
+    if(cascade == NULL)
+        return NULL;
+    INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 1);
+
+    memset(cascade, 0, sizeof(t_cascade));
+    cascade->nb_lignes   = nb_lignes;
+    cascade->nb_colonnes = nb_colonnes;
+
+    return cascade;
+}
+
+
+
+void detruire_cascade(t_cascade* cascade)
+{
+    if(cascade == NULL)
+        return;
+
+    LIBERER(cascade->classifieurs);
+    LIBERER(cascade->etages);
+    LIBERER(cascade);
+}
+
+
+
+int ajouter_etage(t_cascade* cascade, double seuil)
+{
+    t_etage* etages;    // Le tableau agrandi.
+    int      capacite;
+
+    if(cascade == NULL)
+        return -1;
+
+    if(cascade->nb_etages == cascade->capacite_etages)
+    {
+        capacite = cascade->capacite_etages > 0 ? 2 * cascade->capacite_etages :
+                                                  CAPACITE_INITIALE;
+        etages = (t_etage*) REALLOUER(cascade->etages, capacite * sizeof(t_etage));
+        if(etages == NULL)
+            return -1;
+        INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 1);
+
+        cascade->etages          = etages;
+        cascade->capacite_etages = capacite;
+    }
+
+    cascade->etages[cascade->nb_etages].premier         = cascade->nb_classifieurs;
+    cascade->etages[cascade->nb_etages].nb_classifieurs = 0;
+    cascade->etages[cascade->nb_etages].seuil           = seuil;
+
+    return cascade->nb_etages++;
+}
+
+
+
+int ajouter_classifieur(t_cascade* cascade, const t_classifieur_faible* classifieur)
+{
+    const t_rectangle_haar* rectangle;      // Un rectangle du classifieur.
+    t_classifieur_faible*   classifieurs;   // Le tableau agrandi.
+    int                     capacite;
+    int                     r;              // Iterateur sur les rectangles.
+
+    if(cascade == NULL || classifieur == NULL || cascade->nb_etages == 0 ||
+       classifieur->nb_rectangles < 1 ||
+       classifieur->nb_rectangles > RECTANGLES_PAR_CARACTERISTIQUE)
+        return FAUX;
+
+    for(r = 0; r < classifieur->nb_rectangles; r++)
+    {
+        rectangle = &classifieur->rectangles[r];
+        if(rectangle->ligne < 0 || rectangle->colonne < 0 ||
+           rectangle->nb_lignes < 1 || rectangle->nb_colonnes < 1 ||
+           rectangle->ligne   + rectangle->nb_lignes   > cascade->nb_lignes ||
+           rectangle->colonne + rectangle->nb_colonnes > cascade->nb_colonnes)
+            return FAUX;
+    }
+
+    if(cascade->nb_classifieurs == cascade->capacite_classifieurs)
+    {
+        capacite = cascade->capacite_classifieurs > 0 ? 2 * cascade->capacite_classifieurs :
+                                                        CAPACITE_INITIALE;
+        classifieurs = (t_classifieur_faible*) REALLOUER(cascade->classifieurs,
+                                                         capacite * sizeof(t_classifieur_faible));
+        if(classifieurs == NULL)
+            return FAUX;
+        INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 1);
+
+        cascade->classifieurs          = classifieurs;
+        cascade->capacite_classifieurs = capacite;
+    }
+
+    cascade->classifieurs[cascade->nb_classifieurs++] = *classifieur;
+    cascade->etages[cascade->nb_etages - 1].nb_classifieurs++;
+
+    return VRAI;
+}
+
+
+
+t_detecteur* creer_detecteur(void)
+{
+    t_detecteur* detecteur;     // Le detecteur cree.
+
+    detecteur = (t_detecteur*) ALLOUER(sizeof(t_detecteur));
+    if(detecteur == NULL)
+        return NULL;
+    INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 1);
+
+    memset(detecteur, 0, sizeof(t_detecteur));
+
+    return detecteur;
+}
+
+
+
+void detruire_detecteur(t_detecteur* detecteur)
+{
+    if(detecteur == NULL)
+        return;
+
+    LIBERER(detecteur->detections);
+    LIBERER(detecteur->integrales);
+    LIBERER(detecteur->echelles);
+    LIBERER(detecteur->decalages);
+    LIBERER(detecteur->poids);
+    LIBERER(detecteur->tuiles);
+    LIBERER(detecteur);
+}
+
+
+
+int detecter_objets(t_detecteur* detecteur, const t_cascade* cascade, double** image,
+                    int nb_lignes, int nb_colonnes, double facteur, double pas)
+{
+    t_balayage balayage;        // Le balayage partage par les fils.
+    size_t     capacite;        // La capacite des detections.
+    int        nb_tuiles;       // Le nombre de tuiles de la file.
+    int        nb_detections;   // Le nombre de detections trouvees.
+
+    if(detecteur == NULL || cascade == NULL || image == NULL || nb_lignes < 1 ||
+       nb_colonnes < 1 || cascade->nb_etages == 0 || facteur <= 1 || pas <= 0)
+        return -1;
+
+    detecteur->nb_detections     = 0;
+    detecteur->nb_fenetres       = 0;
+    detecteur->nb_etages_evalues = 0;
+
+    // La fenetre de base n'entre pas dans l'image.
+    if(cascade->nb_lignes > nb_lignes || cascade->nb_colonnes > nb_colonnes)
+        return 0;
+
+    INSTRUMENTER_DEBUT(ETAPE_CASCADE);
+
+    nb_tuiles = preparer_echelles(detecteur, cascade, nb_lignes, nb_colonnes, facteur, pas);
+    if(nb_tuiles < 0 || !calculer_integrales(detecteur, image, nb_lignes, nb_colonnes))
+    {
+        INSTRUMENTER_FIN(ETAPE_CASCADE);
+        return -1;
+    }
+
+    balayage.detecteur = detecteur;
+    balayage.cascade   = cascade;
+    balayage.largeur   = nb_colonnes + 1;
+    balayage.somme1    = detecteur->integrales;
+    balayage.somme2    = detecteur->integrales + (size_t) (nb_lignes + 1) * balayage.largeur;
+
+    // Une image qui a plus de detections que la capacite est balayee de
+    // nouveau, avec un tableau assez grand.
+    do
+    {
+        atomic_init(&balayage.nb_detections, 0);
+        atomic_init(&balayage.nb_fenetres, 0);
+        atomic_init(&balayage.nb_etages_evalues, 0);
+
+        parallele_pour(nb_tuiles, 1, tache_tuiles, &balayage);
+
+        nb_detections = atomic_load(&balayage.nb_detections);
+        if(nb_detections <= detecteur->capacite_detections)
+            break;
+
+        capacite = (size_t) detecteur->capacite_detections;
+        if(!reserver((void**) &detecteur->detections, &capacite, nb_detections,
+                     sizeof(t_detection)))
+        {
+            INSTRUMENTER_FIN(ETAPE_CASCADE);
+            return -1;
+        }
+        detecteur->capacite_detections = (int) capacite;
+    }
+    while(VRAI);
+
+    detecteur->nb_detections     = nb_detections;
+    detecteur->nb_fenetres       = atomic_load(&balayage.nb_fenetres);
+    detecteur->nb_etages_evalues = atomic_load(&balayage.nb_etages_evalues);
+
+    // L'ordre de la file depend des fils; celui des detections, non.
+    qsort(detecteur->detections, nb_detections, sizeof(t_detection), comparer_detections);
+
+    INSTRUMENTER_FIN(ETAPE_CASCADE);
+
+    return nb_detections;
+}
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PRIVEES                            *
+****************************************************************************************/
+
+
+static void tache_tuiles(void* donnees, int debut, int fin)
+{
+    t_balayage*             balayage = (t_balayage*) donnees;
+    const t_cascade*        cascade  = balayage->cascade;
+    const t_echelle*        echelle;        // L'echelle de la tuile.
+    const t_tuile*          tuile;          // La tuile evaluee.
+    const t_etage*          etage;          // L'etage evalue.
+    const t_classifieur_faible* classifieur;
+    const int*              decalages;      // Les coins des rectangles d'un classifieur.
+    const double*           poids;          // Les poids de ses rectangles.
+    const double*           s1;             // Les integrales, au coin de la fenetre.
+    const double*           s2;
+    t_detection             detections[DETECTIONS_LOCALES];     // Les detections du fil.
+    long long               nb_fenetres;    // Les compteurs du fil.
+    long long               nb_etages;
+    double                  moyenne;        // La moyenne et la variance de la fenetre.
+    double                  variance;
+    double                  normalisation;  // L'ecart type fois l'aire de la fenetre.
+    double                  valeur;         // La caracteristique, non normalisee.
+    double                  votes;          // La somme des votes de l'etage.
+    size_t                  indice;         // L'indice du classifieur agrandi.
+    int                     nb_locales;     // Le nombre de detections du fil.
+    int                     acceptee;       // Vrai si tous les etages acceptent.
+    int                     t;              // Iterateur sur les tuiles.
+    int                     rangee;         // Iterateur sur les rangees de fenetres.
+    int                     position;       // Iterateur sur les fenetres d'une rangee.
+    int                     e, c, r;        // Iterateurs sur les etages, les classifieurs
+                                            // et les rectangles.
+
+    nb_fenetres = 0;
+    nb_etages   = 0;
+    nb_locales  = 0;
+
+    for(t = debut; t < fin; t++)
+    {
+        tuile   = &((const t_tuile*) balayage->detecteur->tuiles)[t];
+        echelle = &((const t_echelle*) balayage->detecteur->echelles)[tuile->echelle];
+
+        for(rangee = tuile->premiere; rangee < tuile->fin; rangee++)
+        {
+            for(position = 0; position < echelle->nb_positions; position++)
+            {
+                s1 = balayage->somme1 + (size_t) rangee * echelle->pas * balayage->largeur +
+                     (size_t) position * echelle->pas;
+                s2 = balayage->somme2 + (s1 - balayage->somme1);
+                nb_fenetres++;
+
+                // Une fenetre uniforme n'a aucun contour a classer.
+                moyenne  = (s1[echelle->fenetre[3]] - s1[echelle->fenetre[1]] -
+                            s1[echelle->fenetre[2]] + s1[echelle->fenetre[0]]) *
+                           echelle->inverse_aire;
+                variance = (s2[echelle->fenetre[3]] - s2[echelle->fenetre[1]] -
+                            s2[echelle->fenetre[2]] + s2[echelle->fenetre[0]]) *
+                           echelle->inverse_aire - moyenne * moyenne;
+                if(variance < VARIANCE_MIN)
+                    continue;
+                normalisation = sqrt(variance) / echelle->inverse_aire;
+
+                acceptee = VRAI;
+                for(e = 0; e < cascade->nb_etages && acceptee; e++)
+                {
+                    etage = &cascade->etages[e];
+                    votes = 0;
+                    for(c = etage->premier; c < etage->premier + etage->nb_classifieurs; c++)
+                    {
+                        classifieur = &cascade->classifieurs[c];
+                        indice      = echelle->debut + c;
+                        decalages   = balayage->detecteur->decalages +
+                                      indice * RECTANGLES_PAR_CARACTERISTIQUE * NB_COINS_RECTANGLE;
+                        poids       = balayage->detecteur->poids +
+                                      indice * RECTANGLES_PAR_CARACTERISTIQUE;
+
+                        // Les rectangles absents ont un poids nul.
+                        valeur = 0;
+                        for(r = 0; r < RECTANGLES_PAR_CARACTERISTIQUE; r++, decalages += 4)
+                            valeur += poids[r] * (s1[decalages[3]] - s1[decalages[1]] -
+                                                  s1[decalages[2]] + s1[decalages[0]]);
+
+                        votes += valeur < classifieur->seuil * normalisation ?
+                                 classifieur->gauche : classifieur->droite;
+                    }
+
+                    nb_etages++;
+                    acceptee = votes >= etage->seuil;
+                }
+
+                if(!acceptee)
+                    continue;
+
+                detections[nb_locales].ligne       = rangee * echelle->pas;
+                detections[nb_locales].colonne     = position * echelle->pas;
+                detections[nb_locales].nb_lignes   = echelle->nb_lignes;
+                detections[nb_locales].nb_colonnes = echelle->nb_colonnes;
+                detections[nb_locales].echelle     = echelle->echelle;
+                if(++nb_locales == DETECTIONS_LOCALES)
+                {
+                    ranger_detections(balayage, detections, nb_locales);
+                    nb_locales = 0;
+                }
+            }
+        }
+    }
+
+    ranger_detections(balayage, detections, nb_locales);
+    atomic_fetch_add(&balayage->nb_fenetres, nb_fenetres);
+    atomic_fetch_add(&balayage->nb_etages_evalues, nb_etages);
+}
+
+
+
+static void ranger_detections(t_balayage* balayage, const t_detection* detections, int n)
+{
+    t_detecteur* detecteur = balayage->detecteur;
+    int          premiere;      // La premiere place reservee.
+    int          i;             // Iterateur sur les detections.
+
+    if(n == 0)
+        return;
+
+    premiere = atomic_fetch_add(&balayage->nb_detections, n);
+    for(i = 0; i < n && premiere + i < detecteur->capacite_detections; i++)
+        detecteur->detections[premiere + i] = detections[i];
+}
+
+
+
+static int preparer_echelles(t_detecteur* detecteur, const t_cascade* cascade,
+                             int nb_lignes, int nb_colonnes, double facteur, double pas)
+{
+    const t_rectangle_haar* rectangle;  // Un rectangle de la fenetre de base.
+    t_echelle*              echelles;   // Les echelles.
+    t_echelle*              echelle;
+    t_tuile*                tuiles;     // La file des tuiles.
+    int*                    coins;      // Les coins d'un rectangle agrandi.
+    double*                 poids;      // Les poids d'un classifieur agrandi.
+    double                  s;          // L'echelle courante.
+    double                  equilibre;  // La somme des poids fois les aires, de base.
+    double                  autres;     // La meme somme agrandie, sauf le premier rectangle.
+    int                     aires[RECTANGLES_PAR_CARACTERISTIQUE];  // Les aires agrandies.
+    int                     y, x;       // Le rectangle agrandi.
+    int                     h, w;
+    int                     nb_echelles;
+    int                     nb_tuiles;
+    int                     largeur;    // La largeur des images integrales.
+    int                     n, c, r, k; // Iterateurs.
+    size_t                  capacite;
+
+    largeur = nb_colonnes + 1;
+
+    // Le nombre d'echelles.
+    nb_echelles = 0;
+    for(s = 1; (int) lround(cascade->nb_lignes   * s) <= nb_lignes &&
+               (int) lround(cascade->nb_colonnes * s) <= nb_colonnes; s *= facteur)
+        nb_echelles++;
+
+    capacite = (size_t) detecteur->capacite_echelles;
+    if(!reserver(&detecteur->echelles, &capacite, nb_echelles, sizeof(t_echelle)))
+        return -1;
+    detecteur->capacite_echelles = (int) capacite;
+
+    if(!reserver((void**) &detecteur->decalages, &detecteur->capacite_decalages,
+                 (size_t) nb_echelles * cascade->nb_classifieurs *
+                 RECTANGLES_PAR_CARACTERISTIQUE * NB_COINS_RECTANGLE, sizeof(int)) ||
+       !reserver((void**) &detecteur->poids, &detecteur->capacite_poids,
+                 (size_t) nb_echelles * cascade->nb_classifieurs *
+                 RECTANGLES_PAR_CARACTERISTIQUE, sizeof(double)))
+        return -1;
+
+    echelles  = (t_echelle*) detecteur->echelles;
+    nb_tuiles = 0;
+    s         = 1;
+    for(n = 0; n < nb_echelles; n++, s *= facteur)
+    {
+        echelle = &echelles[n];
+        echelle->echelle      = s;
+        echelle->nb_lignes    = (int) lround(cascade->nb_lignes   * s);
+        echelle->nb_colonnes  = (int) lround(cascade->nb_colonnes * s);
+        echelle->pas          = (int) lround(pas * s) > 1 ? (int) lround(pas * s) : 1;
+        echelle->nb_rangees   = (nb_lignes   - echelle->nb_lignes)   / echelle->pas + 1;
+        echelle->nb_positions = (nb_colonnes - echelle->nb_colonnes) / echelle->pas + 1;
+        echelle->inverse_aire = 1.0 / ((double) echelle->nb_lignes * echelle->nb_colonnes);
+        echelle->fenetre[0]   = 0;
+        echelle->fenetre[1]   = echelle->nb_colonnes;
+        echelle->fenetre[2]   = echelle->nb_lignes * largeur;
+        echelle->fenetre[3]   = echelle->nb_lignes * largeur + echelle->nb_colonnes;
+        echelle->debut        = (size_t) n * cascade->nb_classifieurs;
+
+        nb_tuiles += (echelle->nb_rangees + RANGEES_PAR_TUILE - 1) / RANGEES_PAR_TUILE;
+
+        for(c = 0; c < cascade->nb_classifieurs; c++)
+        {
+            coins = detecteur->decalages + (echelle->debut + c) *
+                    RECTANGLES_PAR_CARACTERISTIQUE * NB_COINS_RECTANGLE;
+            poids = detecteur->poids + (echelle->debut + c) * RECTANGLES_PAR_CARACTERISTIQUE;
+
+            equilibre = 0;
+            autres    = 0;
+            for(r = 0; r < RECTANGLES_PAR_CARACTERISTIQUE; r++)
+            {
+                if(r >= cascade->classifieurs[c].nb_rectangles)
+                {
+                    for(k = 0; k < NB_COINS_RECTANGLE; k++)
+                        coins[r * NB_COINS_RECTANGLE + k] = 0;
+                    poids[r] = 0;
+                    aires[r] = 0;
+                    continue;
+                }
+
+                // Le rectangle agrandi reste dans la fenetre agrandie.
+                rectangle = &cascade->classifieurs[c].rectangles[r];
+                y = (int) lround(rectangle->ligne   * s);
+                x = (int) lround(rectangle->colonne * s);
+                h = (int) lround(rectangle->nb_lignes   * s);
+                w = (int) lround(rectangle->nb_colonnes * s);
+                if(y + h > echelle->nb_lignes)
+                    h = echelle->nb_lignes - y;
+                if(x + w > echelle->nb_colonnes)
+                    w = echelle->nb_colonnes - x;
+
+                coins[r * NB_COINS_RECTANGLE]     = y * largeur + x;
+                coins[r * NB_COINS_RECTANGLE + 1] = y * largeur + x + w;
+                coins[r * NB_COINS_RECTANGLE + 2] = (y + h) * largeur + x;
+                coins[r * NB_COINS_RECTANGLE + 3] = (y + h) * largeur + x + w;
+                poids[r] = rectangle->poids;
+                aires[r] = h * w;
+
+                equilibre += rectangle->poids * rectangle->nb_lignes * rectangle->nb_colonnes;
+                if(r > 0)
+                    autres += rectangle->poids * h * w;
+            }
+
+            // Une caracteristique de somme nulle (insensible a la luminosite)
+            // le reste malgre l'arrondi des rectangles.
+            if(fabs(equilibre) < 1e-9 && aires[0] > 0)
+                poids[0] = -autres / aires[0];
+        }
+    }
+
+    capacite = (size_t) detecteur->capacite_tuiles;
+    if(!reserver(&detecteur->tuiles, &capacite, nb_tuiles, sizeof(t_tuile)))
+        return -1;
+    detecteur->capacite_tuiles = (int) capacite;
+
+    tuiles = (t_tuile*) detecteur->tuiles;
+    k      = 0;
+    for(n = 0; n < nb_echelles; n++)
+    {
+        for(r = 0; r < echelles[n].nb_rangees; r += RANGEES_PAR_TUILE)
+        {
+            tuiles[k].echelle  = n;
+            tuiles[k].premiere = r;
+            tuiles[k].fin      = r + RANGEES_PAR_TUILE < echelles[n].nb_rangees ?
+                                 r + RANGEES_PAR_TUILE : echelles[n].nb_rangees;
+            tuiles[k].cout     = (long long) (tuiles[k].fin - r) * echelles[n].nb_positions;
+            k++;
+        }
+    }
+
+    // Les tuiles cheres d'abord: les dernieres prises sont courtes, et les
+    // fils finissent ensemble.
+    qsort(tuiles, nb_tuiles, sizeof(t_tuile), comparer_tuiles);
+
+    return nb_tuiles;
+}
+
+
+
+static int calculer_integrales(t_detecteur* detecteur, double** image, int nb_lignes,
+                               int nb_colonnes)
+{
+    double* haut1;          // Les lignes i et i + 1 des images integrales.
+    double* bas1;
+    double* haut2;
+    double* bas2;
+    double  ligne1;         // Les sommes de la ligne courante.
+    double  ligne2;
+    size_t  taille;         // Le nombre d'elements d'une image integrale.
+    int     largeur;        // La largeur d'une image integrale.
+    int     i, j;           // Iterateurs sur l'image.
+
+    largeur = nb_colonnes + 1;
+    taille  = (size_t) (nb_lignes + 1) * largeur;
+    if(!reserver((void**) &detecteur->integrales, &detecteur->capacite_integrales,
+                 2 * taille, sizeof(double)))
+        return FAUX;
+
+    haut1 = detecteur->integrales;
+    haut2 = haut1 + taille;
+    memset(haut1, 0, largeur * sizeof(double));
+    memset(haut2, 0, largeur * sizeof(double));
+
+    for(i = 0; i < nb_lignes; i++, haut1 = bas1, haut2 = bas2)
+    {
+        bas1    = haut1 + largeur;
+        bas2    = haut2 + largeur;
+        bas1[0] = 0;
+        bas2[0] = 0;
+        ligne1  = 0;
+        ligne2  = 0;
+        for(j = 0; j < nb_colonnes; j++)
+        {
+            ligne1 += image[i][j];
+            ligne2 += image[i][j] * image[i][j];
+            bas1[j + 1] = haut1[j + 1] + ligne1;
+            bas2[j + 1] = haut2[j + 1] + ligne2;
+        }
+    }
+
+    return VRAI;
+}
+
+
+
+static int reserver(void** tableau, size_t* capacite, size_t voulu, size_t taille)
+{
+    void* agrandi;      // Le tableau agrandi.
+
+    if(voulu <= *capacite)
+        return VRAI;
+
+    // Le contenu n'a pas a etre garde.
+    agrandi = ALLOUER(voulu * taille);
+    if(agrandi == NULL)
+        return FAUX;
+    INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 1);
+
+    LIBERER(*tableau);
+    *tableau  = agrandi;
+    *capacite = voulu;
+
+    return VRAI;
+}
+
+
+
+static int comparer_tuiles(const void* a, const void* b)
+{
+    long long x = ((const t_tuile*) a)->cout;
+    long long y = ((const t_tuile*) b)->cout;
+
+    return (x < y) - (x > y);
+}
+
+
+
+static int comparer_detections(const void* a, const void* b)
+{
+    const t_detection* x = (const t_detection*) a;
+    const t_detection* y = (const t_detection*) b;
+
+    if(x->echelle != y->echelle)
+        return (x->echelle > y->echelle) - (x->echelle < y->echelle);
+    if(x->ligne != y->ligne)
+        return (x->ligne > y->ligne) - (x->ligne < y->ligne);
+
+    return (x->colonne > y->colonne) - (x->colonne < y->colonne);
+}
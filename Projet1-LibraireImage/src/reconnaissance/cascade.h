@@ -0,0 +1,302 @@
+/****************************************************************************************
+    CASCADE.H
+
+    Ce module contient un detecteur a fenetre glissante de Viola et Jones.
+    Une cascade est une suite d'etages; chaque etage additionne les votes de
+    classifieurs faibles (des caracteristiques de Haar: sommes ponderees de
+    deux ou trois rectangles, comparees a un seuil) et rejette la fenetre si
+    la somme n'atteint pas son seuil. Presque toutes les fenetres d'une image
+    sont rejetees par les premiers etages, qui n'ont que quelques
+    classifieurs.
+
+    Les sommes des rectangles viennent d'une image integrale: quatre
+    lectures par rectangle, quelle que soit sa taille. Les caracteristiques
+    sont normalisees par l'ecart type de la fenetre (d'une seconde image
+    integrale, des carres), ce qui les rend insensibles au contraste. Pour
+    chaque echelle, la cascade est agrandie une fois (les rectangles sont
+    convertis en decalages dans l'image integrale) plutot que l'image
+    reduite.
+
+    Le travail est decoupe en tuiles: une bande de rangees de fenetres
+    d'une echelle. Les tuiles de toutes les echelles forment une seule file,
+    des plus cheres aux moins cheres; chaque fil prend la suivante des qu'il
+    a fini la sienne (voir parallele.h), ce qui equilibre les echelles fines,
+    qui ont beaucoup de fenetres, et les grandes, qui en ont peu.
+
+    Les integrales, les cascades agrandies, les tuiles et les detections
+    sont gardees dans un t_detecteur, reutilise d'une image a l'autre.
+
+    Liste des sous-programmes publiques:
+      - creer_cascade           : Cree une cascade vide;
+      - detruire_cascade        : Libere une cascade;
+      - ajouter_etage           : Ajoute un etage a la cascade;
+      - ajouter_classifieur     : Ajoute un classifieur faible au dernier etage;
+      - creer_detecteur         : Cree un detecteur et son espace de travail;
+      - detruire_detecteur      : Libere un detecteur;
+      - detecter_objets         : Les fenetres acceptees par la cascade.
+
+*****************************************************************************************/
+#ifndef CASCADE
+#define CASCADE
+
+#include <stddef.h>
+
+
+/****************************************************************************************
+*                               DEFINTION DES CONSTANTES                                *
+****************************************************************************************/
+
+// Le nombre maximal de rectangles d'une caracteristique.
+#define RECTANGLES_PAR_CARACTERISTIQUE  3
+
+
+/*
+    T_RECTANGLE_HAAR
+
+    Un rectangle d'une caracteristique, dans la fenetre de base.
+*/
+typedef struct
+{
+    int    ligne;           // Le coin superieur gauche.
+    int    colonne;
+    int    nb_lignes;       // La taille.
+    int    nb_colonnes;
+    double poids;           // Le poids de la somme de ses pixels.
+
+}t_rectangle_haar;
+
+
+/*
+    T_CLASSIFIEUR_FAIBLE
+
+    Un classifieur faible: il vote 'gauche' si la caracteristique (la somme
+    ponderee des rectangles, divisee par l'aire de la fenetre et par son
+    ecart type) est inferieure au seuil, 'droite' sinon.
+*/
+typedef struct
+{
+    t_rectangle_haar rectangles[RECTANGLES_PAR_CARACTERISTIQUE];
+    int              nb_rectangles;
+    double           seuil;
+    double           gauche;
+    double           droite;
+
+}t_classifieur_faible;
+
+
+/*
+    T_ETAGE
+
+    Un etage: les classifieurs premier a premier + nb_classifieurs - 1.
+*/
+typedef struct
+{
+    int    premier;
+    int    nb_classifieurs;
+    double seuil;           // La somme des votes minimale d'une fenetre acceptee.
+
+}t_etage;
+
+
+/*
+    T_CASCADE
+
+    Une cascade. Les champs ne servent qu'au module.
+*/
+typedef struct
+{
+    int                   nb_lignes;        // La taille de la fenetre de base.
+    int                   nb_colonnes;
+    t_classifieur_faible* classifieurs;     // Les classifieurs, etage par etage.
+    int                   nb_classifieurs;
+    int                   capacite_classifieurs;
+    t_etage*              etages;
+    int                   nb_etages;
+    int                   capacite_etages;
+
+}t_cascade;
+
+
+/*
+    T_DETECTION
+
+    Une fenetre acceptee par tous les etages.
+*/
+typedef struct
+{
+    int    ligne;           // Le coin superieur gauche, en pixels.
+    int    colonne;
+    int    nb_lignes;       // La taille de la fenetre a cette echelle.
+    int    nb_colonnes;
+    double echelle;         // Le facteur d'agrandissement de la fenetre de base.
+
+}t_detection;
+
+
+/*
+    T_DETECTEUR
+
+    Un detecteur. Les champs detections, nb_detections, nb_fenetres et
+    nb_etages_evalues donnent le resultat de la derniere image; les autres
+    ne servent qu'au module.
+*/
+typedef struct
+{
+    t_detection* detections;        // Les detections, par echelle, ligne et colonne.
+    int          nb_detections;
+    int          capacite_detections;
+    long long    nb_fenetres;       // Le nombre de fenetres evaluees.
+    long long    nb_etages_evalues; // Le nombre d'etages evalues, toutes fenetres
+                                    // confondues.
+
+    double*      integrales;        // Les images integrales des pixels et des carres.
+    size_t       capacite_integrales;
+    void*        echelles;          // Les cascades agrandies.
+    int          capacite_echelles;
+    int*         decalages;         // Leurs rectangles, en decalages.
+    size_t       capacite_decalages;
+    double*      poids;             // Leurs poids.
+    size_t       capacite_poids;
+    void*        tuiles;            // La file des tuiles.
+    int          capacite_tuiles;
+
+}t_detecteur;
+
+
+/****************************************************************************************
+*                       DECLARATION DES FONCTIONS PUBLIQUES                             *
+****************************************************************************************/
+
+
+/*
+    CREER_CASCADE
+
+    Cette fonction cree une cascade sans etage.
+
+    Parametres:
+        - [int] nb_lignes   : La taille de la fenetre de base.
+        - [int] nb_colonnes
+
+    Retour:
+        La cascade, ou NULL si la taille est invalide ou si la memoire manque.
+*/
+t_cascade* creer_cascade(int nb_lignes, int nb_colonnes);
+
+
+
+/*
+    DETRUIRE_CASCADE
+
+    Cette procedure libere une cascade.
+
+    Parametres:
+        - [t_cascade*] cascade : La cascade (NULL est accepte).
+*/
+void detruire_cascade(t_cascade* cascade);
+
+
+
+/*
+    AJOUTER_ETAGE
+
+    Cette fonction ajoute un etage vide a la fin de la cascade.
+
+    Parametres:
+        - [t_cascade*] cascade : La cascade.
+        - [double    ] seuil   : Le seuil de l'etage.
+
+    Retour:
+        L'indice de l'etage, ou -1 si la memoire manque.
+*/
+int ajouter_etage(t_cascade* cascade, double seuil);
+
+
+
+/*
+    AJOUTER_CLASSIFIEUR
+
+    Cette fonction ajoute un classifieur faible au dernier etage.
+
+    Parametres:
+        - [t_cascade*           ] cascade     : La cascade.
+        - [t_classifieur_faible*] classifieur : Le classifieur (copie).
+
+    Retour:
+        1 si le classifieur a ete ajoute, 0 si la cascade n'a pas d'etage, si
+        un rectangle sort de la fenetre de base ou si la memoire manque.
+
+    Exemple d'utilisation (un etage d'un classifieur: le haut plus sombre
+    que le bas):
+
+        t_cascade*           cascade = creer_cascade(24, 24);
+        t_classifieur_faible c = { { {  0, 0, 12, 24, -1.0 },
+                                     { 12, 0, 12, 24,  1.0 } }, 2, 0.1, -1.0, 1.0 };
+
+        ajouter_etage(cascade, 0.0);
+        ajouter_classifieur(cascade, &c);
+*/
+int ajouter_classifieur(t_cascade* cascade, const t_classifieur_faible* classifieur);
+
+
+
+/*
+    CREER_DETECTEUR
+
+    Cette fonction cree un detecteur. Son espace de travail est alloue a la
+    premiere image.
+
+    Retour:
+        Le detecteur, ou NULL si la memoire manque.
+*/
+t_detecteur* creer_detecteur(void);
+
+
+
+/*
+    DETRUIRE_DETECTEUR
+
+    Cette procedure libere un detecteur et son espace de travail.
+
+    Parametres:
+        - [t_detecteur*] detecteur : Le detecteur (NULL est accepte).
+*/
+void detruire_detecteur(t_detecteur* detecteur);
+
+
+
+/*
+    DETECTER_OBJETS
+
+    Cette fonction evalue la cascade sur toutes les fenetres d'une image: a
+    chaque echelle (1, facteur, facteur^2, ... tant que la fenetre entre
+    dans l'image), les fenetres sont decalees de pas * echelle pixels (au
+    moins 1). Une fenetre uniforme est rejetee sans evaluer la cascade. Les
+    detections ne sont pas regroupees. Un detecteur ne doit etre utilise que
+    par un fil a la fois; plusieurs detecteurs peuvent partager une cascade.
+
+    Parametres:
+        - [t_detecteur*] detecteur   : Le detecteur.
+        - [t_cascade*  ] cascade     : La cascade.
+        - [double**    ] image       : L'image, comme retournee par lire.
+        - [int         ] nb_lignes   : Le nombre de lignes de l'image.
+        - [int         ] nb_colonnes : Le nombre de colonnes de l'image.
+        - [double      ] facteur     : Le rapport de deux echelles (plus de 1).
+        - [double      ] pas         : Le decalage des fenetres a l'echelle 1.
+
+    Retour:
+        Le nombre de detections (rangees dans detecteur->detections), ou -1
+        si les parametres sont invalides ou si la memoire manque.
+
+    Exemple d'utilisation:
+
+        n = detecter_objets(detecteur, cascade, image, nl, nc, 1.25, 2.0);
+        for(i = 0; i < n; i++)
+            printf("%d %d %d\n", detecteur->detections[i].ligne,
+                                 detecteur->detections[i].colonne,
+                                 detecteur->detections[i].nb_lignes);
+*/
+int detecter_objets(t_detecteur* detecteur, const t_cascade* cascade, double** image,
+                    int nb_lignes, int nb_colonnes, double facteur, double pas);
+
+
+#endif
@@ -0,0 +1,394 @@
+/****************************************************************************************
+    GABARITS.C
+
+    Ce module contient la banque de gabarits et le classement des glyphes.
+    Dans un groupe, la caracteristique k du gabarit t est a la place
+    k * LARGEUR_GROUPE + t; les normes restantes du gabarit t au debut du
+    bloc b sont a la place b * LARGEUR_GROUPE + t.
+****************************************************************************************/
+#include "gabarits.h"
+#include "../outils/instrumentation.h"
+#include "../outils/memoire.h"
+
+#include <math.h>
+#include <string.h>
+
+
+/****************************************************************************************
+*                               DEFINTION DES CONSTANTES                                *
+****************************************************************************************/
+
+#define VRAI    1
+#define FAUX    0
+
+// Le nombre de caracteristiques d'un bloc, entre deux verifications de
+// l'abandon d'un groupe.
+#define CARACTERISTIQUES_PAR_BLOC   32
+
+// Le nombre maximal de blocs d'un glyphe.
+#define NB_BLOCS_MAX    ((DIMENSION_MAX + CARACTERISTIQUES_PAR_BLOC - 1) / CARACTERISTIQUES_PAR_BLOC)
+
+// Le nombre de groupes alloues a la creation d'une banque.
+#define NB_GROUPES_INITIAL          4
+
+
+/****************************************************************************************
+*                           DECLARATION DES FONCTIONS PRIVEES                           *
+****************************************************************************************/
+
+
+/*
+    ACCUMULER_DISTANCES
+
+    Cette procedure ajoute aux distances partielles des gabarits d'un groupe
+    les carres des ecarts sur nb caracteristiques consecutives. La boucle
+    interne porte sur les LARGEUR_GROUPE gabarits, contigus en memoire.
+
+    Parametres:
+        - [float*] glyphe   : Les caracteristiques du glyphe.
+        - [float*] valeurs  : Les memes caracteristiques des gabarits du groupe.
+        - [int   ] nb       : Le nombre de caracteristiques.
+        - [float*] partiel  : Les LARGEUR_GROUPE distances partielles.
+*/
+static void accumuler_distances(const float* restrict glyphe, const float* restrict valeurs,
+                                int nb, float* restrict partiel);
+
+
+
+/*
+    AGRANDIR_BANQUE
+
+    Cette fonction double le nombre de groupes d'une banque.
+
+    Retour: 1 si la banque a ete agrandie, 0 si la memoire manque.
+*/
+static int agrandir_banque(t_banque* banque);
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PUBLIQUES                            *
+****************************************************************************************/
+t_banque* creer_banque(int nb_lignes, int nb_colonnes)
+{
+    t_banque* banque;   // La banque creee.
+
+    if(nb_lignes < 1 || nb_lignes > LIGNES_GLYPHE_MAX ||
+       nb_colonnes < 1 || nb_colonnes > COLONNES_GLYPHE_MAX)
+        return NULL;
+
+    banque = (t_banque*) ALLOUER(sizeof(t_banque));
+    if(banque == NULL)
+        return NULL;
+    INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 1);
+
+    memset(banque, 0, sizeof(t_banque));
+    banque->nb_lignes   = nb_lignes;
+    banque->nb_colonnes = nb_colonnes;
+    banque->dimension   = nb_lignes * nb_colonnes;
+    banque->nb_blocs    = (banque->dimension + CARACTERISTIQUES_PAR_BLOC - 1) /
+                          CARACTERISTIQUES_PAR_BLOC;
+
+    return banque;
+}
+
+
+
+void detruire_banque(t_banque* banque)
+{
+    if(banque == NULL)
+        return;
+
+    LIBERER(banque->valeurs);
+    LIBERER(banque->normes);
+    LIBERER(banque->caracteres);
+    LIBERER(banque);
+}
+
+
+
+int normaliser_glyphe(const t_banque* banque, double** image, int ligne, int colonne,
+                      int nb_lignes, int nb_colonnes, float* glyphe)
+{
+    double moyennes[DIMENSION_MAX];     // Les moyennes des blocs de pixels.
+    double somme;           // La somme d'un bloc, puis de tous les blocs.
+    double moyenne;         // La moyenne des caracteristiques.
+    double norme;           // La norme des caracteristiques centrees.
+    int    debut_ligne;     // Le bloc de pixels d'une caracteristique.
+    int    fin_ligne;
+    int    debut_colonne;
+    int    fin_colonne;
+    int    y, x;            // La caracteristique.
+    int    i, j;            // Iterateurs sur les pixels du bloc.
+    int    k;               // L'indice de la caracteristique.
+
+    if(banque == NULL || image == NULL || glyphe == NULL || nb_lignes <= 0 ||
+       nb_colonnes <= 0 || ligne < 0 || colonne < 0)
+        return FAUX;
+
+    // Chaque caracteristique est la moyenne de son bloc de pixels (au moins
+    // un pixel, lorsque le rectangle est plus petit que le glyphe).
+    somme = 0;
+    for(y = 0; y < banque->nb_lignes; y++)
+    {
+        debut_ligne = ligne + y * nb_lignes / banque->nb_lignes;
+        fin_ligne   = ligne + (y + 1) * nb_lignes / banque->nb_lignes;
+        if(fin_ligne == debut_ligne)
+            fin_ligne++;
+
+        for(x = 0; x < banque->nb_colonnes; x++)
+        {
+            debut_colonne = colonne + x * nb_colonnes / banque->nb_colonnes;
+            fin_colonne   = colonne + (x + 1) * nb_colonnes / banque->nb_colonnes;
+            if(fin_colonne == debut_colonne)
+                fin_colonne++;
+
+            k = y * banque->nb_colonnes + x;
+            moyennes[k] = 0;
+            for(i = debut_ligne; i < fin_ligne; i++)
+                for(j = debut_colonne; j < fin_colonne; j++)
+                    moyennes[k] += image[i][j];
+            moyennes[k] /= (double) (fin_ligne - debut_ligne) * (fin_colonne - debut_colonne);
+            somme += moyennes[k];
+        }
+    }
+
+    // Centrer et reduire.
+    moyenne = somme / banque->dimension;
+    norme   = 0;
+    for(k = 0; k < banque->dimension; k++)
+    {
+        moyennes[k] -= moyenne;
+        norme += moyennes[k] * moyennes[k];
+    }
+    norme = sqrt(norme);
+
+    for(k = 0; k < banque->dimension; k++)
+        glyphe[k] = norme > 0 ? (float) (moyennes[k] / norme) : 0.0f;
+
+    return VRAI;
+}
+
+
+
+int ajouter_gabarit(t_banque* banque, double** image, int ligne, int colonne,
+                    int nb_lignes, int nb_colonnes, char caractere)
+{
+    float  glyphe[DIMENSION_MAX];   // Le glyphe normalise.
+    float* valeurs;         // Les caracteristiques du groupe du gabarit.
+    float* normes;          // Les normes restantes du groupe du gabarit.
+    double reste;           // La norme des caracteristiques restantes, au carre.
+    int    groupe;          // Le groupe du gabarit.
+    int    t;               // La place du gabarit dans son groupe.
+    int    b, k;            // Iterateurs sur les blocs et les caracteristiques.
+
+    if(!normaliser_glyphe(banque, image, ligne, colonne, nb_lignes, nb_colonnes, glyphe))
+        return -1;
+
+    if(banque->nb_gabarits == banque->nb_groupes * LARGEUR_GROUPE && !agrandir_banque(banque))
+        return -1;
+
+    groupe  = banque->nb_gabarits / LARGEUR_GROUPE;
+    t       = banque->nb_gabarits % LARGEUR_GROUPE;
+    valeurs = banque->valeurs + (size_t) groupe * banque->dimension * LARGEUR_GROUPE;
+    normes  = banque->normes  + (size_t) groupe * (banque->nb_blocs + 1) * LARGEUR_GROUPE;
+
+    for(k = 0; k < banque->dimension; k++)
+        valeurs[k * LARGEUR_GROUPE + t] = glyphe[k];
+
+    // Les normes restantes, du dernier bloc vers le premier.
+    reste = 0;
+    normes[banque->nb_blocs * LARGEUR_GROUPE + t] = 0;
+    for(b = banque->nb_blocs - 1; b >= 0; b--)
+    {
+        for(k = b * CARACTERISTIQUES_PAR_BLOC;
+            k < (b + 1) * CARACTERISTIQUES_PAR_BLOC && k < banque->dimension; k++)
+            reste += (double) glyphe[k] * glyphe[k];
+        normes[b * LARGEUR_GROUPE + t] = (float) sqrt(reste);
+    }
+
+    banque->caracteres[banque->nb_gabarits] = caractere;
+
+    return banque->nb_gabarits++;
+}
+
+
+
+int classer_glyphe(const t_banque* banque, const float* glyphe,
+                   t_correspondance* meilleures, int k)
+{
+    float        restes[NB_BLOCS_MAX + 1];      // Les normes restantes du glyphe.
+    float        partiel[LARGEUR_GROUPE];       // Les distances partielles du groupe.
+    const float* valeurs;       // Les caracteristiques du groupe.
+    const float* normes;        // Les normes restantes du groupe.
+    float        ecart;         // L'ecart des normes restantes d'un gabarit.
+    float        borne;         // La plus petite distance possible du groupe.
+    float        pire;          // La distance du k-ieme gabarit retenu.
+    double       reste;         // La norme restante du glyphe, au carre.
+    int          nb_retenus;    // Le nombre de gabarits retenus.
+    int          abandonne;     // Vrai si le groupe ne peut plus rien apporter.
+    int          debut;         // Le bloc de caracteristiques courant.
+    int          nb;
+    int          groupe;        // Iterateur sur les groupes.
+    int          b, t, q;       // Iterateurs sur les blocs, les gabarits et les retenus.
+
+    if(banque == NULL || glyphe == NULL || meilleures == NULL || k < 1)
+        return -1;
+
+    INSTRUMENTER_DEBUT(ETAPE_CLASSER);
+
+    reste = 0;
+    restes[banque->nb_blocs] = 0;
+    for(b = banque->nb_blocs - 1; b >= 0; b--)
+    {
+        for(q = b * CARACTERISTIQUES_PAR_BLOC;
+            q < (b + 1) * CARACTERISTIQUES_PAR_BLOC && q < banque->dimension; q++)
+            reste += (double) glyphe[q] * glyphe[q];
+        restes[b] = (float) sqrt(reste);
+    }
+
+    // Les distances des gabarits retenus sont gardees dans le champ correlation
+    // jusqu'a la fin.
+    nb_retenus = 0;
+    pire       = INFINITY;
+
+    for(groupe = 0; groupe * LARGEUR_GROUPE < banque->nb_gabarits; groupe++)
+    {
+        valeurs = banque->valeurs + (size_t) groupe * banque->dimension * LARGEUR_GROUPE;
+        normes  = banque->normes  + (size_t) groupe * (banque->nb_blocs + 1) * LARGEUR_GROUPE;
+
+        for(t = 0; t < LARGEUR_GROUPE; t++)
+            partiel[t] = 0;
+
+        abandonne = FAUX;
+        for(b = 0; b < banque->nb_blocs && !abandonne; b++)
+        {
+            debut = b * CARACTERISTIQUES_PAR_BLOC;
+            nb    = banque->dimension - debut < CARACTERISTIQUES_PAR_BLOC ?
+                    banque->dimension - debut : CARACTERISTIQUES_PAR_BLOC;
+            accumuler_distances(glyphe + debut, valeurs + (size_t) debut * LARGEUR_GROUPE,
+                                nb, partiel);
+
+            // Le reste de la distance d'un gabarit est au moins le carre de
+            // l'ecart des normes restantes.
+            if(nb_retenus == k && b + 1 < banque->nb_blocs)
+            {
+                borne = INFINITY;
+                for(t = 0; t < LARGEUR_GROUPE; t++)
+                {
+                    ecart = restes[b + 1] - normes[(b + 1) * LARGEUR_GROUPE + t];
+                    if(partiel[t] + ecart * ecart < borne)
+                        borne = partiel[t] + ecart * ecart;
+                }
+                abandonne = borne > pire;
+            }
+        }
+
+        if(abandonne)
+            continue;
+
+        // L'insertion des gabarits du groupe parmi les retenus.
+        for(t = 0; t < LARGEUR_GROUPE && groupe * LARGEUR_GROUPE + t < banque->nb_gabarits; t++)
+        {
+            if(nb_retenus == k && partiel[t] >= pire)
+                continue;
+
+            q = nb_retenus < k ? nb_retenus++ : k - 1;
+            while(q > 0 && meilleures[q - 1].correlation > partiel[t])
+            {
+                meilleures[q] = meilleures[q - 1];
+                q--;
+            }
+            meilleures[q].gabarit     = groupe * LARGEUR_GROUPE + t;
+            meilleures[q].caractere   = banque->caracteres[groupe * LARGEUR_GROUPE + t];
+            meilleures[q].correlation = partiel[t];
+
+            if(nb_retenus == k)
+                pire = (float) meilleures[k - 1].correlation;
+        }
+    }
+
+    // La distance au carre de deux glyphes normalises vaut 2 - 2 c.
+    for(q = 0; q < nb_retenus; q++)
+        meilleures[q].correlation = 1.0 - meilleures[q].correlation / 2.0;
+
+    INSTRUMENTER_FIN(ETAPE_CLASSER);
+
+    return nb_retenus;
+}
+
+
+
+int reconnaitre_caractere(const t_banque* banque, double** image, int ligne, int colonne,
+                          int nb_lignes, int nb_colonnes, t_correspondance* meilleures,
+                          int k)
+{
+    float glyphe[DIMENSION_MAX];    // Le glyphe normalise.
+
+    if(!normaliser_glyphe(banque, image, ligne, colonne, nb_lignes, nb_colonnes, glyphe))
+        return -1;
+
+    return classer_glyphe(banque, glyphe, meilleures, k);
+}
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PRIVEES                            *
+****************************************************************************************/
+
+
+static void accumuler_distances(const float* restrict glyphe, const float* restrict valeurs,
+                                int nb, float* restrict partiel)
+{
+    float ecart;    // L'ecart d'une caracteristique.
+    int   k, t;     // Iterateurs sur les caracteristiques et les gabarits.
+
+    for(k = 0; k < nb; k++)
+    {
+        for(t = 0; t < LARGEUR_GROUPE; t++)
+        {
+            ecart       = glyphe[k] - valeurs[k * LARGEUR_GROUPE + t];
+            partiel[t] += ecart * ecart;
+        }
+    }
+}
+
+
+
+static int agrandir_banque(t_banque* banque)
+{
+    int    nb_groupes;      // Le nouveau nombre de groupes.
+    size_t par_groupe;      // Les caracteristiques d'un groupe.
+    size_t normes_groupe;   // Les normes d'un groupe.
+    void*  agrandi;         // Un tableau agrandi.
+
+    nb_groupes    = banque->nb_groupes > 0 ? 2 * banque->nb_groupes : NB_GROUPES_INITIAL;
+    par_groupe    = (size_t) banque->dimension * LARGEUR_GROUPE;
+    normes_groupe = (size_t) (banque->nb_blocs + 1) * LARGEUR_GROUPE;
+
+    // Chaque tableau agrandi est garde, meme si un suivant ne peut l'etre.
+    agrandi = REALLOUER(banque->valeurs, nb_groupes * par_groupe * sizeof(float));
+    if(agrandi == NULL)
+        return FAUX;
+    banque->valeurs = (float*) agrandi;
+
+    agrandi = REALLOUER(banque->normes, nb_groupes * normes_groupe * sizeof(float));
+    if(agrandi == NULL)
+        return FAUX;
+    banque->normes = (float*) agrandi;
+
+    agrandi = REALLOUER(banque->caracteres, (size_t) nb_groupes * LARGEUR_GROUPE);
+    if(agrandi == NULL)
+        return FAUX;
+    banque->caracteres = (char*) agrandi;
+    INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 3);
+
+    // Les places libres des groupes ajoutes sont nulles.
+    memset(banque->valeurs + banque->nb_groupes * par_groupe, 0,
+           (nb_groupes - banque->nb_groupes) * par_groupe * sizeof(float));
+    memset(banque->normes + banque->nb_groupes * normes_groupe, 0,
+           (nb_groupes - banque->nb_groupes) * normes_groupe * sizeof(float));
+
+    banque->nb_groupes = nb_groupes;
+
+    return VRAI;
+}
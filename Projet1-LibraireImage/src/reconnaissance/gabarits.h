@@ -0,0 +1,216 @@
+/****************************************************************************************
+    GABARITS.H
+
+    Ce module contient la reconnaissance des caracteres par le plus proche
+    voisin dans une banque de gabarits. Un glyphe (le rectangle d'un
+    caractere dans une image) est normalise: ramene a la taille des gabarits
+    par moyenne de blocs, centre (moyenne nulle) et reduit (norme 1). La
+    distance au carre entre deux glyphes normalises vaut alors 2 - 2 c, ou c
+    est leur correlation: le plus proche gabarit est le plus correle.
+
+    Les gabarits sont ranges par groupes de LARGEUR_GROUPE, en structure de
+    tableaux a l'interieur d'un groupe: la caracteristique k des gabarits du
+    groupe est contigue. Le noyau de distance avance donc sur LARGEUR_GROUPE
+    gabarits a la fois, une boucle que le compilateur vectorise.
+
+    Les caracteristiques sont parcourues par blocs. Apres chaque bloc, la
+    distance partielle de chaque gabarit, plus une borne du reste (par
+    Cauchy-Schwarz, a partir des normes des caracteristiques restantes),
+    donne une borne inferieure de sa distance; un groupe dont aucun gabarit
+    ne peut plus entrer parmi les k meilleurs est abandonne.
+
+    Liste des sous-programmes publiques:
+      - creer_banque          : Cree une banque de gabarits vide;
+      - detruire_banque       : Libere une banque;
+      - normaliser_glyphe     : Normalise un glyphe d'une image;
+      - ajouter_gabarit       : Ajoute un glyphe d'une image a la banque;
+      - classer_glyphe        : Les k gabarits les plus proches d'un glyphe normalise;
+      - reconnaitre_caractere : Normalise puis classe un glyphe d'une image.
+
+*****************************************************************************************/
+#ifndef GABARITS
+#define GABARITS
+
+
+/****************************************************************************************
+*                               DEFINTION DES CONSTANTES                                *
+****************************************************************************************/
+
+// La plus grande taille des glyphes normalises.
+#define LIGNES_GLYPHE_MAX       32
+#define COLONNES_GLYPHE_MAX     32
+#define DIMENSION_MAX           (LIGNES_GLYPHE_MAX * COLONNES_GLYPHE_MAX)
+
+// Le nombre de gabarits d'un groupe (la largeur du noyau de distance).
+#define LARGEUR_GROUPE          16
+
+
+/*
+    T_BANQUE
+
+    Une banque de gabarits. Les champs ne servent qu'au module.
+*/
+typedef struct
+{
+    int    nb_lignes;       // La taille des glyphes normalises.
+    int    nb_colonnes;
+    int    dimension;       // nb_lignes * nb_colonnes.
+    int    nb_blocs;        // Le nombre de blocs de caracteristiques.
+    int    nb_gabarits;     // Le nombre de gabarits.
+    int    nb_groupes;      // Le nombre de groupes alloues.
+    float* valeurs;         // Les caracteristiques, groupe par groupe.
+    float* normes;          // La norme des caracteristiques restantes au debut de
+                            // chaque bloc, groupe par groupe.
+    char*  caracteres;      // Le caractere de chaque gabarit.
+
+}t_banque;
+
+
+/*
+    T_CORRESPONDANCE
+
+    Un gabarit retenu pour un glyphe.
+*/
+typedef struct
+{
+    int    gabarit;         // L'indice du gabarit dans la banque.
+    char   caractere;       // Son caractere.
+    double correlation;     // La correlation avec le glyphe, entre -1 et 1.
+
+}t_correspondance;
+
+
+/****************************************************************************************
+*                       DECLARATION DES FONCTIONS PUBLIQUES                             *
+****************************************************************************************/
+
+
+/*
+    CREER_BANQUE
+
+    Cette fonction cree une banque vide pour des glyphes normalises de la
+    taille donnee.
+
+    Parametres:
+        - [int] nb_lignes   : La hauteur des glyphes (1 a LIGNES_GLYPHE_MAX).
+        - [int] nb_colonnes : La largeur des glyphes (1 a COLONNES_GLYPHE_MAX).
+
+    Retour:
+        La banque, ou NULL si la taille est invalide ou si la memoire manque.
+*/
+t_banque* creer_banque(int nb_lignes, int nb_colonnes);
+
+
+
+/*
+    DETRUIRE_BANQUE
+
+    Cette procedure libere une banque.
+
+    Parametres:
+        - [t_banque*] banque : La banque a liberer (NULL est accepte).
+*/
+void detruire_banque(t_banque* banque);
+
+
+
+/*
+    NORMALISER_GLYPHE
+
+    Cette fonction ramene le rectangle d'une image a la taille des glyphes de
+    la banque (chaque caracteristique est la moyenne d'un bloc de pixels),
+    puis le centre et le reduit. Un rectangle uniforme donne un glyphe nul.
+
+    Parametres:
+        - [t_banque*] banque      : La banque (pour la taille des glyphes).
+        - [double** ] image       : L'image.
+        - [int      ] ligne       : Le coin superieur gauche du rectangle.
+        - [int      ] colonne
+        - [int      ] nb_lignes   : La taille du rectangle.
+        - [int      ] nb_colonnes
+        - [float*   ] glyphe      : Recoit les banque->dimension caracteristiques.
+
+    Retour:
+        1 si le glyphe a ete normalise, 0 si le rectangle est vide.
+*/
+int normaliser_glyphe(const t_banque* banque, double** image, int ligne, int colonne,
+                      int nb_lignes, int nb_colonnes, float* glyphe);
+
+
+
+/*
+    AJOUTER_GABARIT
+
+    Cette fonction normalise le rectangle d'une image et l'ajoute a la banque.
+
+    Parametres:
+        - [t_banque*] banque      : La banque.
+        - [double** ] image       : L'image qui contient le caractere.
+        - [int      ] ligne       : Le rectangle du caractere dans l'image.
+        - [int      ] colonne
+        - [int      ] nb_lignes
+        - [int      ] nb_colonnes
+        - [char     ] caractere   : Le caractere represente.
+
+    Retour:
+        L'indice du gabarit, ou -1 si le rectangle est vide ou si la memoire
+        manque.
+
+    Exemple d'utilisation:
+
+        t_banque* banque = creer_banque(16, 12);
+
+        for(i = 0; i < nb_caracteres; i++)
+            ajouter_gabarit(banque, police, 0, i * 20, 32, 20, caracteres[i]);
+*/
+int ajouter_gabarit(t_banque* banque, double** image, int ligne, int colonne,
+                    int nb_lignes, int nb_colonnes, char caractere);
+
+
+
+/*
+    CLASSER_GLYPHE
+
+    Cette fonction trouve les k gabarits les plus proches d'un glyphe
+    normalise. La banque n'est pas modifiee: plusieurs fils peuvent classer
+    des glyphes en meme temps.
+
+    Parametres:
+        - [t_banque*        ] banque      : La banque.
+        - [float*           ] glyphe      : Le glyphe, donne par normaliser_glyphe.
+        - [t_correspondance*] meilleures  : Recoit les gabarits, par correlation
+                                            decroissante.
+        - [int              ] k           : Le nombre de gabarits voulus.
+
+    Retour:
+        Le nombre de gabarits retournes (au plus k et au plus le nombre de
+        gabarits de la banque), ou -1 si les parametres sont invalides.
+*/
+int classer_glyphe(const t_banque* banque, const float* glyphe,
+                   t_correspondance* meilleures, int k);
+
+
+
+/*
+    RECONNAITRE_CARACTERE
+
+    Cette fonction normalise le rectangle d'une image et le classe, comme
+    normaliser_glyphe puis classer_glyphe.
+
+    Retour:
+        Le nombre de gabarits retournes, ou -1 si les parametres sont invalides
+        ou si le rectangle est vide.
+
+    Exemple d'utilisation:
+
+        t_correspondance meilleures[3];
+
+        if(reconnaitre_caractere(banque, plaque, 4, x, 24, 14, meilleures, 3) > 0)
+            printf("%c (%.2f)\n", meilleures[0].caractere, meilleures[0].correlation);
+*/
+int reconnaitre_caractere(const t_banque* banque, double** image, int ligne, int colonne,
+                          int nb_lignes, int nb_colonnes, t_correspondance* meilleures,
+                          int k);
+
+
+#endif
@@ -0,0 +1,531 @@
+/****************************************************************************************
+    HOG.C
+
+    Ce module contient l'extraction des HOG. Une premiere passe, repartie
+    par rangees de cellules, calcule les histogrammes et normalise les
+    rangees de blocs dont les deux rangees de cellules sont dans le meme
+    paquet, aussitot la seconde completee. Une seconde passe normalise les
+    rangees de blocs a cheval sur deux paquets.
+****************************************************************************************/
+#include "hog.h"
+#include "../outils/instrumentation.h"
+#include "../outils/memoire.h"
+#include "../outils/parallele.h"
+
+#include <math.h>
+#include <string.h>
+
+
+/****************************************************************************************
+*                               DEFINTION DES CONSTANTES                                *
+****************************************************************************************/
+
+#define VRAI    1
+#define FAUX    0
+
+#define PI      3.14159265358979323846
+
+// Le nombre de rangees de cellules (ou de fenetres) traitees par un fil a la fois.
+#define ELEMENTS_PAR_PAQUET     4
+
+// Le terme ajoute a la norme d'un bloc, pour les blocs sans contour.
+#define EPSILON_NORME           1e-3
+
+// Les coefficients de l'arc tangente sur [-1, 1] (Abramowitz et Stegun,
+// 4.4.49: erreur d'au plus 1e-5 radian, soit 0.0006 degre).
+#define ATAN_1      0.9998660
+#define ATAN_3      (-0.3302995)
+#define ATAN_5      0.1801410
+#define ATAN_7      (-0.0851330)
+#define ATAN_9      0.0208351
+
+
+/*
+    T_EXTRACTION
+
+    Une extraction en cours, partagee par les fils.
+*/
+typedef struct
+{
+    t_hog*   hog;
+    double** image;
+    int      nb_lignes;
+    int      nb_colonnes;
+
+}t_extraction;
+
+
+/*
+    T_EVALUATION
+
+    Une evaluation des fenetres en cours, partagee par les fils.
+*/
+typedef struct
+{
+    const t_hog*  hog;
+    int           nb_lignes_blocs;      // La taille des fenetres, en blocs.
+    int           nb_colonnes_blocs;
+    const double* poids;
+    double        biais;
+    int           nb_colonnes_scores;
+    double**      scores;
+
+}t_evaluation;
+
+
+/****************************************************************************************
+*                           DECLARATION DES FONCTIONS PRIVEES                           *
+****************************************************************************************/
+
+
+/*
+    TACHE_HISTOGRAMMES
+
+    Cette procedure (de type t_tache) calcule les histogrammes des rangees
+    de cellules debut a fin - 1, et normalise les rangees de blocs qui n'ont
+    besoin que de ces rangees de cellules.
+
+    Parametres:
+        - [void*] donnees : L'extraction (t_extraction*).
+        - [int  ] debut   : La premiere rangee de cellules.
+        - [int  ] fin     : La rangee qui suit la derniere.
+*/
+static void tache_histogrammes(void* donnees, int debut, int fin);
+
+
+
+/*
+    TACHE_BLOCS
+
+    Cette procedure (de type t_tache) normalise les rangees de blocs debut
+    a fin - 1 qui ne l'ont pas encore ete.
+*/
+static void tache_blocs(void* donnees, int debut, int fin);
+
+
+
+/*
+    TACHE_FENETRES
+
+    Cette procedure (de type t_tache) calcule les scores des rangees de
+    fenetres debut a fin - 1.
+*/
+static void tache_fenetres(void* donnees, int debut, int fin);
+
+
+
+/*
+    NORMALISER_RANGEE
+
+    Cette procedure copie les histogrammes des cellules de chaque bloc d'une
+    rangee dans le bloc, puis le normalise (L2-Hys).
+
+    Parametres:
+        - [t_hog*] hog    : L'extracteur.
+        - [int   ] rangee : La rangee de blocs.
+*/
+static void normaliser_rangee(t_hog* hog, int rangee);
+
+
+
+/*
+    ORIENTATION_GRADIENT
+
+    Cette fonction donne l'orientation non signee d'un gradient, entre 0 et
+    pi, par un polynome plutot que par atan2 (qui prendrait la plus grande
+    partie du temps de l'extraction).
+
+    Parametres:
+        - [double] gx, gy : Le gradient (non nul).
+
+    Retour: L'orientation, en radians.
+*/
+static double orientation_gradient(double gx, double gy);
+
+
+
+/*
+    PRODUIT_SCALAIRE
+
+    Cette fonction calcule le produit scalaire de deux suites, avec quatre
+    sommes partielles independantes.
+*/
+static double produit_scalaire(const double* restrict a, const double* restrict b, int n);
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PUBLIQUES                            *
+****************************************************************************************/
+t_hog* creer_hog(void)
+{
+    t_hog* hog;     // L'extracteur cree.
+
+    hog = (t_hog*) ALLOUER(sizeof(t_hog));
+    if(hog == NULL)
+        return NULL;
+    INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 1);
+
+    memset(hog, 0, sizeof(t_hog));
+
+    return hog;
+}
+
+
+
+void detruire_hog(t_hog* hog)
+{
+    if(hog == NULL)
+        return;
+
+    LIBERER(hog->blocs);
+    LIBERER(hog->histogrammes);
+    LIBERER(hog->normalisees);
+    LIBERER(hog);
+}
+
+
+
+int calculer_hog(t_hog* hog, double** image, int nb_lignes, int nb_colonnes)
+{
+    t_extraction extraction;    // L'extraction partagee par les fils.
+    size_t       nb_cellules;   // Le nombre de cellules et de blocs.
+    size_t       nb_blocs;
+
+    if(hog == NULL || image == NULL ||
+       nb_lignes < CELLULES_PAR_BLOC * TAILLE_CELLULE ||
+       nb_colonnes < CELLULES_PAR_BLOC * TAILLE_CELLULE)
+        return FAUX;
+
+    hog->nb_lignes_cellules   = nb_lignes   / TAILLE_CELLULE;
+    hog->nb_colonnes_cellules = nb_colonnes / TAILLE_CELLULE;
+    hog->nb_lignes_blocs      = hog->nb_lignes_cellules   - CELLULES_PAR_BLOC + 1;
+    hog->nb_colonnes_blocs    = hog->nb_colonnes_cellules - CELLULES_PAR_BLOC + 1;
+
+    // L'espace de travail ne grandit que pour une image plus grande.
+    nb_cellules = (size_t) hog->nb_lignes_cellules * hog->nb_colonnes_cellules;
+    nb_blocs    = (size_t) hog->nb_lignes_blocs * hog->nb_colonnes_blocs;
+
+    if(nb_cellules * NB_ORIENTATIONS > hog->capacite_histogrammes)
+    {
+        LIBERER(hog->histogrammes);
+        hog->histogrammes = (double*) ALLOUER(nb_cellules * NB_ORIENTATIONS * sizeof(double));
+        hog->capacite_histogrammes = hog->histogrammes != NULL ? nb_cellules * NB_ORIENTATIONS : 0;
+        if(hog->histogrammes == NULL)
+            return FAUX;
+        INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 1);
+    }
+
+    if(nb_blocs * TAILLE_BLOC > hog->capacite_blocs)
+    {
+        LIBERER(hog->blocs);
+        hog->blocs = (double*) ALLOUER(nb_blocs * TAILLE_BLOC * sizeof(double));
+        hog->capacite_blocs = hog->blocs != NULL ? nb_blocs * TAILLE_BLOC : 0;
+        if(hog->blocs == NULL)
+            return FAUX;
+        INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 1);
+    }
+
+    if(hog->nb_lignes_blocs > hog->capacite_normalisees)
+    {
+        LIBERER(hog->normalisees);
+        hog->normalisees = (unsigned char*) ALLOUER(hog->nb_lignes_blocs);
+        hog->capacite_normalisees = hog->normalisees != NULL ? hog->nb_lignes_blocs : 0;
+        if(hog->normalisees == NULL)
+            return FAUX;
+        INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 1);
+    }
+
+    INSTRUMENTER_DEBUT(ETAPE_HOG);
+
+    extraction.hog         = hog;
+    extraction.image       = image;
+    extraction.nb_lignes   = nb_lignes;
+    extraction.nb_colonnes = nb_colonnes;
+
+    memset(hog->normalisees, FAUX, hog->nb_lignes_blocs);
+    parallele_pour(hog->nb_lignes_cellules, ELEMENTS_PAR_PAQUET, tache_histogrammes,
+                   &extraction);
+    parallele_pour(hog->nb_lignes_blocs, ELEMENTS_PAR_PAQUET, tache_blocs, hog);
+
+    INSTRUMENTER_FIN(ETAPE_HOG);
+
+    return VRAI;
+}
+
+
+
+int taille_descripteur(int nb_lignes_cellules, int nb_colonnes_cellules)
+{
+    if(nb_lignes_cellules < CELLULES_PAR_BLOC || nb_colonnes_cellules < CELLULES_PAR_BLOC)
+        return -1;
+
+    return (nb_lignes_cellules   - CELLULES_PAR_BLOC + 1) *
+           (nb_colonnes_cellules - CELLULES_PAR_BLOC + 1) * TAILLE_BLOC;
+}
+
+
+
+int descripteur_fenetre(const t_hog* hog, int ligne, int colonne, int nb_lignes_cellules,
+                        int nb_colonnes_cellules, double* descripteur)
+{
+    size_t segment;     // Le nombre de valeurs d'une rangee de blocs de la fenetre.
+    int    rangee;      // Iterateur sur les rangees de blocs de la fenetre.
+
+    if(hog == NULL || descripteur == NULL ||
+       taille_descripteur(nb_lignes_cellules, nb_colonnes_cellules) < 0 ||
+       ligne < 0 || colonne < 0 ||
+       ligne   + nb_lignes_cellules   > hog->nb_lignes_cellules ||
+       colonne + nb_colonnes_cellules > hog->nb_colonnes_cellules)
+        return -1;
+
+    segment = (size_t) (nb_colonnes_cellules - CELLULES_PAR_BLOC + 1) * TAILLE_BLOC;
+    for(rangee = 0; rangee < nb_lignes_cellules - CELLULES_PAR_BLOC + 1; rangee++)
+        memcpy(descripteur + rangee * segment,
+               hog->blocs + ((size_t) (ligne + rangee) * hog->nb_colonnes_blocs + colonne) *
+                            TAILLE_BLOC,
+               segment * sizeof(double));
+
+    return taille_descripteur(nb_lignes_cellules, nb_colonnes_cellules);
+}
+
+
+
+int evaluer_fenetres(const t_hog* hog, int nb_lignes_cellules, int nb_colonnes_cellules,
+                     const double* poids, double biais, double** scores)
+{
+    t_evaluation evaluation;    // L'evaluation partagee par les fils.
+
+    if(hog == NULL || poids == NULL || scores == NULL ||
+       taille_descripteur(nb_lignes_cellules, nb_colonnes_cellules) < 0 ||
+       nb_lignes_cellules   > hog->nb_lignes_cellules ||
+       nb_colonnes_cellules > hog->nb_colonnes_cellules)
+        return FAUX;
+
+    evaluation.hog                = hog;
+    evaluation.nb_lignes_blocs    = nb_lignes_cellules   - CELLULES_PAR_BLOC + 1;
+    evaluation.nb_colonnes_blocs  = nb_colonnes_cellules - CELLULES_PAR_BLOC + 1;
+    evaluation.poids              = poids;
+    evaluation.biais              = biais;
+    evaluation.nb_colonnes_scores = hog->nb_colonnes_cellules - nb_colonnes_cellules + 1;
+    evaluation.scores             = scores;
+
+    parallele_pour(hog->nb_lignes_cellules - nb_lignes_cellules + 1, ELEMENTS_PAR_PAQUET,
+                   tache_fenetres, &evaluation);
+
+    return VRAI;
+}
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PRIVEES                            *
+****************************************************************************************/
+
+
+static void tache_histogrammes(void* donnees, int debut, int fin)
+{
+    t_extraction* extraction = (t_extraction*) donnees;
+    t_hog*        hog        = extraction->hog;
+    const double* haut;         // Les lignes y - 1, y et y + 1 de l'image.
+    const double* milieu;
+    const double* bas;
+    double*       histogramme;  // L'histogramme de la cellule.
+    double        gx, gy;       // Le gradient du pixel.
+    double        norme;        // Sa norme.
+    double        position;     // Son orientation, en orientations, a partir du
+                                // centre de la premiere.
+    double        fraction;     // La part du vote pour l'orientation suivante.
+    int           orientation;  // L'orientation precedente.
+    int           rangee;       // Iterateur sur les rangees de cellules.
+    int           y;            // Iterateur sur les lignes de la rangee.
+    int           cellule;      // Iterateur sur les cellules de la rangee.
+    int           x;            // La colonne du pixel.
+    int           gauche;       // Ses voisins (repetes au bord de l'image).
+    int           droite;
+
+    for(rangee = debut; rangee < fin; rangee++)
+    {
+        memset(hog->histogrammes + (size_t) rangee * hog->nb_colonnes_cellules * NB_ORIENTATIONS,
+               0, (size_t) hog->nb_colonnes_cellules * NB_ORIENTATIONS * sizeof(double));
+
+        for(y = rangee * TAILLE_CELLULE; y < (rangee + 1) * TAILLE_CELLULE; y++)
+        {
+            haut   = extraction->image[y > 0 ? y - 1 : 0];
+            milieu = extraction->image[y];
+            bas    = extraction->image[y + 1 < extraction->nb_lignes ? y + 1 : y];
+
+            for(cellule = 0; cellule < hog->nb_colonnes_cellules; cellule++)
+            {
+                histogramme = hog->histogrammes +
+                              ((size_t) rangee * hog->nb_colonnes_cellules + cellule) *
+                              NB_ORIENTATIONS;
+
+                for(x = cellule * TAILLE_CELLULE; x < (cellule + 1) * TAILLE_CELLULE; x++)
+                {
+                    gauche = x > 0 ? x - 1 : 0;
+                    droite = x + 1 < extraction->nb_colonnes ? x + 1 : x;
+                    gx     = milieu[droite] - milieu[gauche];
+                    gy     = bas[x] - haut[x];
+                    norme  = sqrt(gx * gx + gy * gy);
+                    if(norme == 0)
+                        continue;
+
+                    // Le vote est partage entre les deux orientations dont
+                    // les centres encadrent celle du gradient.
+                    position    = orientation_gradient(gx, gy) * NB_ORIENTATIONS / PI - 0.5;
+                    orientation = (int) floor(position);
+                    fraction    = position - orientation;
+                    orientation = (orientation + NB_ORIENTATIONS) % NB_ORIENTATIONS;
+
+                    histogramme[orientation] += norme * (1 - fraction);
+                    histogramme[(orientation + 1) % NB_ORIENTATIONS] += norme * fraction;
+                }
+            }
+        }
+
+        // Les blocs de la rangee precedente sont complets.
+        if(rangee > debut)
+        {
+            normaliser_rangee(hog, rangee - 1);
+            hog->normalisees[rangee - 1] = VRAI;
+        }
+    }
+}
+
+
+
+static void tache_blocs(void* donnees, int debut, int fin)
+{
+    t_hog* hog = (t_hog*) donnees;
+    int    rangee;      // Iterateur sur les rangees de blocs.
+
+    for(rangee = debut; rangee < fin; rangee++)
+        if(!hog->normalisees[rangee])
+            normaliser_rangee(hog, rangee);
+}
+
+
+
+static void tache_fenetres(void* donnees, int debut, int fin)
+{
+    t_evaluation* evaluation = (t_evaluation*) donnees;
+    const t_hog*  hog        = evaluation->hog;
+    const double* blocs;        // Le premier bloc d'une rangee de la fenetre.
+    double        score;        // Le score de la fenetre.
+    int           segment;      // Le nombre de valeurs d'une rangee de blocs.
+    int           y, x;         // Iterateurs sur les fenetres.
+    int           rangee;       // Iterateur sur les rangees de blocs de la fenetre.
+
+    segment = evaluation->nb_colonnes_blocs * TAILLE_BLOC;
+
+    for(y = debut; y < fin; y++)
+    {
+        for(x = 0; x < evaluation->nb_colonnes_scores; x++)
+        {
+            score = evaluation->biais;
+            for(rangee = 0; rangee < evaluation->nb_lignes_blocs; rangee++)
+            {
+                blocs  = hog->blocs + ((size_t) (y + rangee) * hog->nb_colonnes_blocs + x) *
+                                      TAILLE_BLOC;
+                score += produit_scalaire(evaluation->poids + (size_t) rangee * segment,
+                                          blocs, segment);
+            }
+            evaluation->scores[y][x] = score;
+        }
+    }
+}
+
+
+
+static void normaliser_rangee(t_hog* hog, int rangee)
+{
+    double*       bloc;         // Le bloc normalise.
+    const double* histogramme;  // L'histogramme d'une cellule du bloc.
+    double        norme;        // La norme du bloc.
+    int           colonne;      // Iterateur sur les blocs de la rangee.
+    int           i, j;         // Iterateurs sur les cellules du bloc.
+    int           k;            // Iterateur sur les valeurs.
+
+    for(colonne = 0; colonne < hog->nb_colonnes_blocs; colonne++)
+    {
+        bloc = hog->blocs + ((size_t) rangee * hog->nb_colonnes_blocs + colonne) * TAILLE_BLOC;
+
+        // Les cellules du bloc, ligne par ligne.
+        for(i = 0; i < CELLULES_PAR_BLOC; i++)
+        {
+            for(j = 0; j < CELLULES_PAR_BLOC; j++)
+            {
+                histogramme = hog->histogrammes +
+                              ((size_t) (rangee + i) * hog->nb_colonnes_cellules + colonne + j) *
+                              NB_ORIENTATIONS;
+                memcpy(bloc + (i * CELLULES_PAR_BLOC + j) * NB_ORIENTATIONS, histogramme,
+                       NB_ORIENTATIONS * sizeof(double));
+            }
+        }
+
+        // L2, plafond, puis L2 de nouveau.
+        norme = EPSILON_NORME * EPSILON_NORME;
+        for(k = 0; k < TAILLE_BLOC; k++)
+            norme += bloc[k] * bloc[k];
+        norme = sqrt(norme);
+
+        for(k = 0; k < TAILLE_BLOC; k++)
+        {
+            bloc[k] /= norme;
+            if(bloc[k] > SEUIL_HYS)
+                bloc[k] = SEUIL_HYS;
+        }
+
+        norme = EPSILON_NORME * EPSILON_NORME;
+        for(k = 0; k < TAILLE_BLOC; k++)
+            norme += bloc[k] * bloc[k];
+        norme = sqrt(norme);
+
+        for(k = 0; k < TAILLE_BLOC; k++)
+            bloc[k] /= norme;
+    }
+}
+
+
+
+static double orientation_gradient(double gx, double gy)
+{
+    double ax;          // |gx|, apres le repli de gy sur les positifs.
+    double z, z2;       // Le rapport des composantes, dans [0, 1], et son carre.
+    double angle;       // L'angle du premier quadrant.
+
+    // L'orientation non signee ne change pas si le gradient change de signe.
+    if(gy < 0)
+    {
+        gx = -gx;
+        gy = -gy;
+    }
+    ax = fabs(gx);
+
+    z     = gy <= ax ? gy / ax : ax / gy;
+    z2    = z * z;
+    angle = z * (ATAN_1 + z2 * (ATAN_3 + z2 * (ATAN_5 + z2 * (ATAN_7 + z2 * ATAN_9))));
+    if(gy > ax)
+        angle = PI / 2 - angle;
+
+    return gx < 0 ? PI - angle : angle;
+}
+
+
+
+static double produit_scalaire(const double* restrict a, const double* restrict b, int n)
+{
+    double sommes[4] = { 0, 0, 0, 0 };     // Les sommes partielles.
+    int    k;                               // Iterateur sur les elements.
+
+    for(k = 0; k + 4 <= n; k += 4)
+    {
+        sommes[0] += a[k]     * b[k];
+        sommes[1] += a[k + 1] * b[k + 1];
+        sommes[2] += a[k + 2] * b[k + 2];
+        sommes[3] += a[k + 3] * b[k + 3];
+    }
+    for(; k < n; k++)
+        sommes[0] += a[k] * b[k];
+
+    return (sommes[0] + sommes[1]) + (sommes[2] + sommes[3]);
+}
@@ -0,0 +1,214 @@
+/****************************************************************************************
+    HOG.H
+
+    Ce module contient les histogrammes de gradients orientes (HOG) de Dalal
+    et Triggs. L'image est decoupee en cellules de TAILLE_CELLULE pixels de
+    cote; chaque pixel vote, avec la norme de son gradient, pour les deux
+    orientations (non signees, entre 0 et 180 degres) les plus proches de la
+    sienne. Les cellules sont groupees en blocs de CELLULES_PAR_BLOC cellules
+    de cote, qui se chevauchent d'une cellule, et chaque bloc est normalise
+    (L2-Hys: norme 1, valeurs plafonnees a SEUIL_HYS, puis de nouveau norme
+    1). Le descripteur d'une fenetre est la suite de ses blocs.
+
+    Le gradient n'est jamais range dans une image: il est calcule et verse
+    dans les histogrammes pixel par pixel, et les blocs d'une rangee sont
+    normalises des que les cellules dont ils dependent sont completes. Les
+    rangees de cellules sont reparties sur plusieurs fils (voir parallele.h).
+
+    Les blocs sont ranges ligne par ligne dans un seul tableau de reels: le
+    descripteur d'une fenetre est fait de quelques segments contigus (un par
+    rangee de blocs), que des noyaux comme produit_scalaire1d lisent
+    directement. Pour un balayage de fenetres, les histogrammes et les blocs
+    sont calcules une seule fois et partages par toutes les fenetres qui se
+    chevauchent (voir evaluer_fenetres).
+
+    Liste des sous-programmes publiques:
+      - creer_hog             : Cree un extracteur et son espace de travail;
+      - detruire_hog          : Libere un extracteur;
+      - calculer_hog          : Les blocs normalises d'une image;
+      - taille_descripteur    : Le nombre de valeurs du descripteur d'une fenetre;
+      - descripteur_fenetre   : Copie le descripteur d'une fenetre;
+      - evaluer_fenetres      : Le score d'un classifieur lineaire pour toutes les
+                                fenetres.
+
+*****************************************************************************************/
+#ifndef HOG
+#define HOG
+
+#include <stddef.h>
+
+
+/****************************************************************************************
+*                               DEFINTION DES CONSTANTES                                *
+****************************************************************************************/
+
+// Le cote d'une cellule, en pixels.
+#define TAILLE_CELLULE          8
+
+// Le nombre d'orientations d'un histogramme (de 20 degres chacune).
+#define NB_ORIENTATIONS         9
+
+// Le cote d'un bloc, en cellules, et le nombre de valeurs d'un bloc.
+#define CELLULES_PAR_BLOC       2
+#define TAILLE_BLOC             (CELLULES_PAR_BLOC * CELLULES_PAR_BLOC * NB_ORIENTATIONS)
+
+// Le plafond des valeurs d'un bloc normalise (L2-Hys).
+#define SEUIL_HYS               0.2
+
+
+/*
+    T_HOG
+
+    Un extracteur et les blocs de la derniere image. Les champs nb_* et
+    blocs peuvent etre lus; les autres ne servent qu'au module.
+*/
+typedef struct
+{
+    int            nb_lignes_cellules;      // Les cellules completes de l'image.
+    int            nb_colonnes_cellules;
+    int            nb_lignes_blocs;         // nb_*_cellules - CELLULES_PAR_BLOC + 1.
+    int            nb_colonnes_blocs;
+    double*        blocs;                   // Les blocs normalises, ligne par ligne:
+                                            // le bloc (i, j) commence a
+                                            // (i * nb_colonnes_blocs + j) * TAILLE_BLOC.
+    size_t         capacite_blocs;
+    double*        histogrammes;            // Les histogrammes des cellules.
+    size_t         capacite_histogrammes;
+    unsigned char* normalisees;             // Les rangees de blocs deja normalisees.
+    int            capacite_normalisees;
+
+}t_hog;
+
+
+/****************************************************************************************
+*                       DECLARATION DES FONCTIONS PUBLIQUES                             *
+****************************************************************************************/
+
+
+/*
+    CREER_HOG
+
+    Cette fonction cree un extracteur. Son espace de travail est alloue a la
+    premiere image.
+
+    Retour:
+        L'extracteur, ou NULL si la memoire manque.
+*/
+t_hog* creer_hog(void);
+
+
+
+/*
+    DETRUIRE_HOG
+
+    Cette procedure libere un extracteur et son espace de travail.
+
+    Parametres:
+        - [t_hog*] hog : L'extracteur (NULL est accepte).
+*/
+void detruire_hog(t_hog* hog);
+
+
+
+/*
+    CALCULER_HOG
+
+    Cette fonction calcule les histogrammes des cellules d'une image et les
+    blocs normalises. Les pixels qui ne forment pas une cellule complete (a
+    droite et en bas) sont ignores. Un extracteur ne doit etre utilise que
+    par un fil a la fois.
+
+    Parametres:
+        - [t_hog*  ] hog         : L'extracteur.
+        - [double**] image       : L'image, comme retournee par lire.
+        - [int     ] nb_lignes   : Le nombre de lignes de l'image.
+        - [int     ] nb_colonnes : Le nombre de colonnes de l'image.
+
+    Retour:
+        1 si les blocs ont ete calcules, 0 si les parametres sont invalides,
+        si l'image n'a pas un bloc complet ou si la memoire manque.
+*/
+int calculer_hog(t_hog* hog, double** image, int nb_lignes, int nb_colonnes);
+
+
+
+/*
+    TAILLE_DESCRIPTEUR
+
+    Cette fonction donne le nombre de valeurs du descripteur d'une fenetre.
+
+    Parametres:
+        - [int] nb_lignes_cellules   : La hauteur de la fenetre, en cellules.
+        - [int] nb_colonnes_cellules : La largeur de la fenetre, en cellules.
+
+    Retour:
+        Le nombre de valeurs (3780 pour la fenetre de 8 x 16 cellules de
+        Dalal et Triggs), ou -1 si la fenetre n'a pas un bloc complet.
+*/
+int taille_descripteur(int nb_lignes_cellules, int nb_colonnes_cellules);
+
+
+
+/*
+    DESCRIPTEUR_FENETRE
+
+    Cette fonction copie le descripteur d'une fenetre de la derniere image:
+    ses blocs, rangee par rangee.
+
+    Parametres:
+        - [t_hog* ] hog                  : L'extracteur.
+        - [int    ] ligne                : Le coin superieur gauche de la fenetre,
+        - [int    ] colonne                en cellules.
+        - [int    ] nb_lignes_cellules   : La taille de la fenetre, en cellules.
+        - [int    ] nb_colonnes_cellules
+        - [double*] descripteur          : Recoit taille_descripteur(...) valeurs.
+
+    Retour:
+        Le nombre de valeurs copiees, ou -1 si la fenetre sort de l'image.
+*/
+int descripteur_fenetre(const t_hog* hog, int ligne, int colonne, int nb_lignes_cellules,
+                        int nb_colonnes_cellules, double* descripteur);
+
+
+
+/*
+    EVALUER_FENETRES
+
+    Cette fonction calcule le score d'un classifieur lineaire (poids . x +
+    biais) pour toutes les fenetres de la derniere image, decalees d'une
+    cellule. Les descripteurs ne sont pas copies: le produit est fait sur
+    les segments contigus des blocs partages. Les rangees de fenetres sont
+    reparties sur plusieurs fils.
+
+    Parametres:
+        - [t_hog*  ] hog                  : L'extracteur.
+        - [int     ] nb_lignes_cellules   : La taille des fenetres, en cellules.
+        - [int     ] nb_colonnes_cellules
+        - [double* ] poids                : Les poids, dans l'ordre du descripteur.
+        - [double  ] biais                : Le biais.
+        - [double**] scores               : Recoit les scores (deja allouee):
+                                            hog->nb_lignes_cellules -
+                                            nb_lignes_cellules + 1 lignes de
+                                            hog->nb_colonnes_cellules -
+                                            nb_colonnes_cellules + 1 valeurs.
+
+    Retour:
+        1 si les scores ont ete calcules, 0 si les fenetres ne tiennent pas
+        dans l'image.
+
+    Exemple d'utilisation (des fenetres de 64 x 128 pixels):
+
+        t_hog* hog = creer_hog();
+
+        if(calculer_hog(hog, image, nb_lignes, nb_colonnes))
+            evaluer_fenetres(hog, 16, 8, poids, biais, scores);
+
+        [ ... les scores positifs sont des detections ... ]
+
+        detruire_hog(hog);
+*/
+int evaluer_fenetres(const t_hog* hog, int nb_lignes_cellules, int nb_colonnes_cellules,
+                     const double* poids, double biais, double** scores);
+
+
+#endif
@@ -3,6 +3,7 @@
 
 *****************************************************************************************/
 #include "tableau1d.h"
+#include "../outils/memoire.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -95,7 +96,7 @@ double produit_scalaire1d(double* tableau1, double* tableau2, int nb_element) {
 double* creer_tableau1d(int nb_element){
 
     //Cre un tableau
-    double* tableau = (double*) malloc(nb_element * sizeof(double));
+    double* tableau = (double*) ALLOUER(nb_element * sizeof(double));
 
     //Affiche l'ensemble du tableau
     for (int i = 0; i < nb_element; i++){
@@ -112,7 +113,8 @@ double* creer_tableau1d(int nb_element){
 //Affiche le pointeur dtruit (devrait tre 0).
 void detruire_tableau1d(double* pointeur){
 
-    //Dtruit pointeur
+    //Libre le tableau et dtruit pointeur
+    LIBERER(pointeur);
     pointeur = NULL;
     printf("%0.1p", pointeur);
     printf("\n");
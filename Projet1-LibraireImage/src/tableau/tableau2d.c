@@ -3,6 +3,7 @@
 
 *****************************************************************************************/
 #include "tableau2d.h"
+#include "../outils/memoire.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -23,9 +24,20 @@
 *                           DEFINTION DES FONCTIONS PUBLIQUES                            *
 ****************************************************************************************/
 double** creer_tableau2d(int lignes, int colonnes){
-    double** tableau = (double**)malloc(lignes * sizeof(double*));
+    double** tableau = (double**)ALLOUER(lignes * sizeof(double*));
+    if (tableau == NULL) {
+        return NULL;
+    }
     for (int i = 0; i < lignes; i++) {
-        tableau[i] = (double*)malloc(colonnes * sizeof(double));
+        tableau[i] = (double*)ALLOUER(colonnes * sizeof(double));
+        // Si la memoire manque, les lignes deja creees sont liberees.
+        if (tableau[i] == NULL) {
+            while (i > 0) {
+                LIBERER(tableau[--i]);
+            }
+            LIBERER(tableau);
+            return NULL;
+        }
     }
 
     return tableau;
@@ -43,9 +55,9 @@ void afficher_tableau2d(double** tableau, int lignes, int colonnes){
 
 void detruire_tableau2d(double** tableau, int lignes){
     for (int i = 0; i < lignes; i++) {
-        free(tableau[i]);
+        LIBERER(tableau[i]);
     }
-    free(tableau);
+    LIBERER(tableau);
     tableau = NULL;
 
     printf("%0.1p", tableau);
@@ -53,10 +65,8 @@ void detruire_tableau2d(double** tableau, int lignes){
 }
 
 void initialiser_tableau2d(double** tableau, int lignes, int colonnes, double valeur){
-    tableau = (double**)realloc(tableau, lignes * sizeof(double*));
     for (int i = 0; i < lignes; i++){
-        tableau[i] = (double*)realloc(tableau, colonnes * sizeof(double));
-        for (int j = 0; j < colonnes; i++){
+        for (int j = 0; j < colonnes; j++){
             tableau[i][j] = valeur;
         }
     }
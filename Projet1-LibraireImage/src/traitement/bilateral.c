@@ -0,0 +1,461 @@
+/****************************************************************************************
+    BILATERAL.C
+
+    Ce module contient le filtre bilateral approche. Une cellule de la grille
+    est une paire (somme des niveaux, somme des poids); les cellules d'une
+    meme ligne et d'une meme colonne de la grille sont contigues, par niveau
+    croissant. Le pixel (i, j) de niveau v est a la position
+    (i / sigma_espace, j / sigma_espace, (v - minimum) / sigma_intensite) de
+    la grille, decalee de MARGE cellules sur chaque axe: le flou deborde des
+    cellules ou les pixels sont projetes, mais reste dans la grille.
+****************************************************************************************/
+#include "bilateral.h"
+#include "../outils/instrumentation.h"
+#include "../outils/memoire.h"
+#include "../outils/parallele.h"
+
+#include <math.h>
+#include <string.h>
+
+
+/****************************************************************************************
+*                               DEFINTION DES CONSTANTES                                *
+****************************************************************************************/
+
+#define VRAI    1
+#define FAUX    0
+
+// Les cellules ajoutees de chaque cote de chaque axe: le rayon du noyau.
+#define MARGE               2
+
+// Le nombre de reels d'une cellule.
+#define TAILLE_CELLULE_GRILLE   2
+
+// Le nombre de lignes (de la grille ou de l'image) traitees par un fil a la fois.
+#define ELEMENTS_PAR_PAQUET     4
+
+// Les axes du flou.
+#define AXE_NIVEAUX     0
+#define AXE_COLONNES    1
+#define AXE_LIGNES      2
+
+
+/*
+    T_BILATERAL
+
+    Un filtrage en cours, partage par les fils.
+*/
+typedef struct
+{
+    double**      image;
+    double**      resultat;
+    int           nb_lignes;
+    int           nb_colonnes;
+    double        sigma_espace;
+    double        sigma_intensite;
+    double        minimum;              // Le plus petit niveau de l'image.
+    int           lignes_grille;        // La taille de la grille.
+    int           colonnes_grille;
+    int           niveaux_grille;
+    size_t        taille_ligne;         // Le nombre de reels d'une ligne de la grille.
+    const double* entree;               // La grille lue et la grille ecrite par une
+    double*       sortie;               // etape.
+    int           axe;                  // L'axe flou par l'etape.
+    const int*    colonnes;
+    const double* poids;
+
+}t_bilateral;
+
+
+/****************************************************************************************
+*                           DECLARATION DES FONCTIONS PRIVEES                           *
+****************************************************************************************/
+
+
+/*
+    TACHE_PROJETER
+
+    Cette procedure (de type t_tache) projette dans les lignes debut a
+    fin - 1 de la grille les pixels dont elles sont les plus proches.
+*/
+static void tache_projeter(void* donnees, int debut, int fin);
+
+
+
+/*
+    TACHE_FLOUTER
+
+    Cette procedure (de type t_tache) ecrit les lignes debut a fin - 1 de la
+    grille de sortie: celles de la grille d'entree, floues sur un axe.
+*/
+static void tache_flouter(void* donnees, int debut, int fin);
+
+
+
+/*
+    FLOUTER_AXE
+
+    Cette procedure floue les blocs premier a dernier - 1 d'un axe de
+    nb_blocs blocs consecutifs de taille_bloc reels: chaque reel de la
+    sortie est la somme ponderee par le noyau des reels de meme rang des
+    blocs voisins de l'entree.
+*/
+static void flouter_axe(const double* entree, double* sortie, int nb_blocs,
+                        size_t taille_bloc, int premier, int dernier);
+
+
+
+/*
+    TACHE_LIRE
+
+    Cette procedure (de type t_tache) calcule les lignes debut a fin - 1 du
+    resultat par interpolation trilineaire de la grille.
+*/
+static void tache_lire(void* donnees, int debut, int fin);
+
+
+
+/*
+    CELLULE_PROCHE
+
+    Cette fonction donne la cellule la plus proche d'une position en
+    cellules (positive).
+*/
+static int cellule_proche(double position);
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PUBLIQUES                            *
+****************************************************************************************/
+t_filtre_bilateral* creer_filtre_bilateral(void)
+{
+    t_filtre_bilateral* filtre;     // Le filtre cree.
+
+    filtre = (t_filtre_bilateral*) ALLOUER(sizeof(t_filtre_bilateral));
+    if(filtre == NULL)
+        return NULL;
+    INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 1);
+
+    memset(filtre, 0, sizeof(t_filtre_bilateral));
+
+    return filtre;
+}
+
+
+
+void detruire_filtre_bilateral(t_filtre_bilateral* filtre)
+{
+    if(filtre == NULL)
+        return;
+
+    LIBERER(filtre->grilles);
+    LIBERER(filtre->colonnes);
+    LIBERER(filtre->poids);
+    LIBERER(filtre);
+}
+
+
+
+int filtrer_bilateral(t_filtre_bilateral* filtre, double** image, int nb_lignes,
+                      int nb_colonnes, double sigma_espace, double sigma_intensite,
+                      double** resultat)
+{
+    t_bilateral bilateral;      // Le filtrage partage par les fils.
+    double*     grilles[2];     // Les deux grilles.
+    double      maximum;        // Le plus grand niveau de l'image.
+    double      position;       // La position d'une colonne, en cellules.
+    size_t      taille;         // Le nombre de reels d'une grille.
+    int         i, j;           // Iterateurs sur l'image.
+
+    if(filtre == NULL || image == NULL || resultat == NULL || nb_lignes < 1 ||
+       nb_colonnes < 1 || !(sigma_espace >= 1) || !(sigma_intensite > 0))
+        return FAUX;
+
+    INSTRUMENTER_DEBUT(ETAPE_BILATERAL);
+
+    // L'axe des niveaux ne couvre que ceux de l'image.
+    bilateral.minimum = image[0][0];
+    maximum           = image[0][0];
+    for(i = 0; i < nb_lignes; i++)
+    {
+        for(j = 0; j < nb_colonnes; j++)
+        {
+            bilateral.minimum = image[i][j] < bilateral.minimum ? image[i][j] : bilateral.minimum;
+            maximum           = image[i][j] > maximum           ? image[i][j] : maximum;
+        }
+    }
+
+    bilateral.image           = image;
+    bilateral.resultat        = resultat;
+    bilateral.nb_lignes       = nb_lignes;
+    bilateral.nb_colonnes     = nb_colonnes;
+    bilateral.sigma_espace    = sigma_espace;
+    bilateral.sigma_intensite = sigma_intensite;
+    bilateral.lignes_grille   = cellule_proche((nb_lignes - 1) / sigma_espace) + 1 + 2 * MARGE;
+    bilateral.colonnes_grille = cellule_proche((nb_colonnes - 1) / sigma_espace) + 1 + 2 * MARGE;
+    bilateral.niveaux_grille  = cellule_proche((maximum - bilateral.minimum) / sigma_intensite) +
+                                1 + 2 * MARGE;
+    bilateral.taille_ligne    = (size_t) bilateral.colonnes_grille * bilateral.niveaux_grille *
+                                TAILLE_CELLULE_GRILLE;
+    taille                    = bilateral.taille_ligne * bilateral.lignes_grille;
+
+    // Les grilles et les colonnes ne grandissent qu'au besoin.
+    if(2 * taille > filtre->capacite_grilles)
+    {
+        LIBERER(filtre->grilles);
+        filtre->capacite_grilles = 0;
+        filtre->grilles = (double*) ALLOUER(2 * taille * sizeof(double));
+        if(filtre->grilles == NULL)
+        {
+            INSTRUMENTER_FIN(ETAPE_BILATERAL);
+            return FAUX;
+        }
+        INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 1);
+        filtre->capacite_grilles = 2 * taille;
+    }
+
+    if(nb_colonnes > filtre->capacite_colonnes)
+    {
+        LIBERER(filtre->colonnes);
+        LIBERER(filtre->poids);
+        filtre->capacite_colonnes = 0;
+        filtre->colonnes = (int*) ALLOUER(2 * (size_t) nb_colonnes * sizeof(int));
+        filtre->poids    = (double*) ALLOUER((size_t) nb_colonnes * sizeof(double));
+        if(filtre->colonnes == NULL || filtre->poids == NULL)
+        {
+            INSTRUMENTER_FIN(ETAPE_BILATERAL);
+            return FAUX;
+        }
+        INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 2);
+        filtre->capacite_colonnes = nb_colonnes;
+    }
+
+    // Les cellules de chaque colonne (projection, puis lecture), donnees par
+    // leur premier reel dans une ligne de la grille.
+    for(j = 0; j < nb_colonnes; j++)
+    {
+        position                  = j / sigma_espace;
+        filtre->colonnes[2 * j]   = (cellule_proche(position) + MARGE) *
+                                    bilateral.niveaux_grille * TAILLE_CELLULE_GRILLE;
+        filtre->colonnes[2 * j + 1] = ((int) position + MARGE) *
+                                      bilateral.niveaux_grille * TAILLE_CELLULE_GRILLE;
+        filtre->poids[j]          = position - (int) position;
+    }
+    bilateral.colonnes = filtre->colonnes;
+    bilateral.poids    = filtre->poids;
+
+    grilles[0] = filtre->grilles;
+    grilles[1] = filtre->grilles + taille;
+
+    // La projection, puis le flou de chaque axe, d'une grille a l'autre.
+    // L'image est lue au complet avant la lecture: le resultat peut etre
+    // l'image.
+    bilateral.sortie = grilles[0];
+    parallele_pour(bilateral.lignes_grille, ELEMENTS_PAR_PAQUET, tache_projeter, &bilateral);
+
+    for(bilateral.axe = AXE_NIVEAUX; bilateral.axe <= AXE_LIGNES; bilateral.axe++)
+    {
+        bilateral.entree = grilles[bilateral.axe % 2];
+        bilateral.sortie = grilles[(bilateral.axe + 1) % 2];
+        parallele_pour(bilateral.lignes_grille, ELEMENTS_PAR_PAQUET, tache_flouter, &bilateral);
+    }
+
+    bilateral.entree = bilateral.sortie;
+    parallele_pour(nb_lignes, ELEMENTS_PAR_PAQUET, tache_lire, &bilateral);
+
+    INSTRUMENTER_FIN(ETAPE_BILATERAL);
+
+    return VRAI;
+}
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PRIVEES                            *
+****************************************************************************************/
+
+
+static void tache_projeter(void* donnees, int debut, int fin)
+{
+    const t_bilateral* bilateral = (const t_bilateral*) donnees;
+    double*            ligne_grille;    // La ligne de la grille.
+    double*            cellule;         // La cellule d'un pixel.
+    const double*      ligne;           // Une ligne de l'image.
+    int                premiere;        // Les lignes de l'image les plus proches
+    int                derniere;        // de la ligne de la grille.
+    int                g;               // Iterateur sur les lignes de la grille.
+    int                i, j;            // Iterateurs sur l'image.
+
+    for(g = debut; g < fin; g++)
+    {
+        ligne_grille = bilateral->sortie + (size_t) g * bilateral->taille_ligne;
+        memset(ligne_grille, 0, bilateral->taille_ligne * sizeof(double));
+
+        // Les lignes i telles que i / sigma_espace est a moins d'une demie
+        // cellule de g - MARGE, avec une ligne de plus de chaque cote contre
+        // l'arrondi.
+        premiere = (int) ceil((g - MARGE - 0.5) * bilateral->sigma_espace) - 1;
+        derniere = (int) ceil((g - MARGE + 0.5) * bilateral->sigma_espace);
+        premiere = premiere > 0 ? premiere : 0;
+        derniere = derniere < bilateral->nb_lignes - 1 ? derniere : bilateral->nb_lignes - 1;
+
+        for(i = premiere; i <= derniere; i++)
+        {
+            if(cellule_proche(i / bilateral->sigma_espace) + MARGE != g)
+                continue;
+
+            ligne = bilateral->image[i];
+            for(j = 0; j < bilateral->nb_colonnes; j++)
+            {
+                cellule = ligne_grille + bilateral->colonnes[2 * j] +
+                          (cellule_proche((ligne[j] - bilateral->minimum) /
+                                          bilateral->sigma_intensite) + MARGE) *
+                          TAILLE_CELLULE_GRILLE;
+                cellule[0] += ligne[j];
+                cellule[1] += 1;
+            }
+        }
+    }
+}
+
+
+
+static void tache_flouter(void* donnees, int debut, int fin)
+{
+    const t_bilateral* bilateral = (const t_bilateral*) donnees;
+    size_t             longueur;    // Le nombre de reels d'une colonne de niveaux.
+    size_t             decalage;    // Le premier reel d'une ligne de la grille.
+    int                g;           // Iterateur sur les lignes de la grille.
+    int                c;           // Iterateur sur les colonnes de la grille.
+
+    longueur = (size_t) bilateral->niveaux_grille * TAILLE_CELLULE_GRILLE;
+
+    // Les lignes voisines sont des blocs d'une ligne de la grille, les
+    // colonnes voisines des blocs d'une colonne de niveaux, et les niveaux
+    // voisins des blocs d'une cellule.
+    if(bilateral->axe == AXE_LIGNES)
+    {
+        flouter_axe(bilateral->entree, bilateral->sortie, bilateral->lignes_grille,
+                    bilateral->taille_ligne, debut, fin);
+        return;
+    }
+
+    for(g = debut; g < fin; g++)
+    {
+        decalage = (size_t) g * bilateral->taille_ligne;
+        if(bilateral->axe == AXE_COLONNES)
+        {
+            flouter_axe(bilateral->entree + decalage, bilateral->sortie + decalage,
+                        bilateral->colonnes_grille, longueur, 0, bilateral->colonnes_grille);
+            continue;
+        }
+
+        for(c = 0; c < bilateral->colonnes_grille; c++, decalage += longueur)
+            flouter_axe(bilateral->entree + decalage, bilateral->sortie + decalage,
+                        bilateral->niveaux_grille, TAILLE_CELLULE_GRILLE, 0,
+                        bilateral->niveaux_grille);
+    }
+}
+
+
+
+static void flouter_axe(const double* entree, double* sortie, int nb_blocs,
+                        size_t taille_bloc, int premier, int dernier)
+{
+    const double* restrict voisin;      // Un bloc voisin.
+    const double* restrict centre;      // Le bloc lu au centre du noyau.
+    double* restrict       flou;        // Le bloc ecrit.
+    size_t                 k;           // Iterateur sur les reels d'un bloc.
+    int                    b;           // Iterateur sur les blocs.
+    int                    d;           // Iterateur sur les voisins.
+
+    // Le noyau (1 4 6 4 1) / 16; les blocs hors de l'axe sont nuls.
+    static const double NOYAU[2 * MARGE + 1] = { 1.0 / 16, 4.0 / 16, 6.0 / 16,
+                                                 4.0 / 16, 1.0 / 16 };
+
+    for(b = premier; b < dernier; b++)
+    {
+        centre = entree + (size_t) b * taille_bloc;
+        flou   = sortie + (size_t) b * taille_bloc;
+        for(k = 0; k < taille_bloc; k++)
+            flou[k] = NOYAU[MARGE] * centre[k];
+
+        for(d = -MARGE; d <= MARGE; d++)
+        {
+            if(d == 0 || b + d < 0 || b + d >= nb_blocs)
+                continue;
+
+            voisin = centre + d * (ptrdiff_t) taille_bloc;
+            for(k = 0; k < taille_bloc; k++)
+                flou[k] += NOYAU[MARGE + d] * voisin[k];
+        }
+    }
+}
+
+
+
+static void tache_lire(void* donnees, int debut, int fin)
+{
+    const t_bilateral* bilateral = (const t_bilateral*) donnees;
+    const double*      haut;        // Les deux lignes de la grille qui entourent
+    const double*      bas;         // la ligne de l'image.
+    const double*      cellules[4]; // Les quatre colonnes de niveaux autour du pixel.
+    const double*      ligne;       // La ligne de l'image.
+    double*            lissee;      // La ligne du resultat.
+    double             position;    // La position de la ligne, en cellules.
+    double             poids_bas;   // Le poids de la ligne du bas.
+    double             poids[4];    // Les poids des quatre colonnes de niveaux.
+    double             niveau;      // La position du pixel sur l'axe des niveaux.
+    double             poids_haut;  // Le poids du niveau superieur.
+    double             somme;       // L'interpolation des niveaux et des poids.
+    double             total;
+    int                z;           // Le premier reel du niveau inferieur.
+    int                n;           // Iterateur sur les colonnes de niveaux.
+    int                i, j;        // Iterateurs sur l'image.
+
+    for(i = debut; i < fin; i++)
+    {
+        position  = i / bilateral->sigma_espace;
+        poids_bas = position - (int) position;
+        haut      = bilateral->entree + (size_t) ((int) position + MARGE) * bilateral->taille_ligne;
+        bas       = haut + bilateral->taille_ligne;
+        ligne     = bilateral->image[i];
+        lissee    = bilateral->resultat[i];
+
+        for(j = 0; j < bilateral->nb_colonnes; j++)
+        {
+            niveau     = (ligne[j] - bilateral->minimum) / bilateral->sigma_intensite;
+            poids_haut = niveau - (int) niveau;
+            z          = ((int) niveau + MARGE) * TAILLE_CELLULE_GRILLE;
+
+            cellules[0] = haut + bilateral->colonnes[2 * j + 1] + z;
+            cellules[1] = cellules[0] + (size_t) bilateral->niveaux_grille * TAILLE_CELLULE_GRILLE;
+            cellules[2] = bas  + bilateral->colonnes[2 * j + 1] + z;
+            cellules[3] = cellules[2] + (size_t) bilateral->niveaux_grille * TAILLE_CELLULE_GRILLE;
+            poids[0]    = (1 - poids_bas) * (1 - bilateral->poids[j]);
+            poids[1]    = (1 - poids_bas) * bilateral->poids[j];
+            poids[2]    = poids_bas * (1 - bilateral->poids[j]);
+            poids[3]    = poids_bas * bilateral->poids[j];
+
+            somme = 0;
+            total = 0;
+            for(n = 0; n < 4; n++)
+            {
+                somme += poids[n] * ((1 - poids_haut) * cellules[n][0] +
+                                     poids_haut * cellules[n][TAILLE_CELLULE_GRILLE]);
+                total += poids[n] * ((1 - poids_haut) * cellules[n][1] +
+                                     poids_haut * cellules[n][TAILLE_CELLULE_GRILLE + 1]);
+            }
+
+            // Le pixel a ete projete pres de sa position: le poids n'est nul
+            // que par arrondi.
+            lissee[j] = total > 0 ? somme / total : ligne[j];
+        }
+    }
+}
+
+
+
+static int cellule_proche(double position)
+{
+    return (int) (position + 0.5);
+}
@@ -0,0 +1,126 @@
+/****************************************************************************************
+    BILATERAL.H
+
+    Ce module contient un filtre bilateral approche, par la grille bilaterale
+    de Paris et Durand (et Chen et al.). Le filtre bilateral remplace chaque
+    pixel par la moyenne de ses voisins, ponderee par leur distance et par
+    leur difference de niveau: il lisse le bruit sans traverser les
+    contours. Calcule directement, il coute une fenetre par pixel, soit des
+    centaines de voisins pour un ecart type spatial de quelques pixels.
+
+    La grille est une image a trois dimensions (ligne, colonne, niveau) dont
+    les cellules ont sigma_espace pixels de cote et sigma_intensite de
+    hauteur, dans les unites de l'image (entre 0 et 1 pour une image lue par
+    lire). Le filtre se fait en trois etapes:
+      - la projection: chaque pixel ajoute son niveau et un poids de 1 a la
+        cellule la plus proche;
+      - le flou: un noyau binomial (1 4 6 4 1) / 16 de chaque axe de la
+        grille, soit une gaussienne d'un ecart type d'environ une cellule;
+      - la lecture: chaque pixel recoit l'interpolation trilineaire de la
+        grille a sa position et a son niveau, divisee par celle des poids.
+    La grille a environ nb_lignes * nb_colonnes / sigma_espace^2 *
+    (max - min) / sigma_intensite cellules, ou min et max sont les niveaux
+    extremes de l'image; le cout de la projection et de la
+    lecture est proportionnel au nombre de pixels, quel que soit
+    sigma_espace.
+
+    Les lignes de la grille sont reparties sur plusieurs fils a chaque
+    etape, puis les lignes de l'image a la lecture (voir parallele.h). La
+    grille est gardee dans un t_filtre_bilateral, reutilise d'une image a
+    l'autre.
+
+    Liste des sous-programmes publiques:
+      - creer_filtre_bilateral    : Cree un filtre et son espace de travail;
+      - detruire_filtre_bilateral : Libere un filtre;
+      - filtrer_bilateral         : Lisse une image sans traverser les contours.
+
+*****************************************************************************************/
+#ifndef BILATERAL
+#define BILATERAL
+
+#include <stddef.h>
+
+
+/*
+    T_FILTRE_BILATERAL
+
+    L'espace de travail du filtre. Les champs ne servent qu'au module.
+*/
+typedef struct
+{
+    double* grilles;                // Deux grilles: chaque passe du flou lit
+    size_t  capacite_grilles;       // l'une et ecrit l'autre.
+    int*    colonnes;               // Pour chaque colonne, sa cellule et celle
+    double* poids;                  // de la lecture, et le poids de la lecture.
+    int     capacite_colonnes;
+
+}t_filtre_bilateral;
+
+
+/****************************************************************************************
+*                       DECLARATION DES FONCTIONS PUBLIQUES                             *
+****************************************************************************************/
+
+
+/*
+    CREER_FILTRE_BILATERAL
+
+    Cette fonction cree un filtre. Son espace de travail est alloue a la
+    premiere image.
+
+    Retour:
+        Le filtre, ou NULL si la memoire manque.
+*/
+t_filtre_bilateral* creer_filtre_bilateral(void);
+
+
+
+/*
+    DETRUIRE_FILTRE_BILATERAL
+
+    Cette procedure libere un filtre et son espace de travail.
+
+    Parametres:
+        - [t_filtre_bilateral*] filtre : Le filtre (NULL est accepte).
+*/
+void detruire_filtre_bilateral(t_filtre_bilateral* filtre);
+
+
+
+/*
+    FILTRER_BILATERAL
+
+    Cette fonction applique le filtre bilateral approche a une image. Un
+    filtre ne doit etre utilise que par un fil a la fois.
+
+    Parametres:
+        - [t_filtre_bilateral*] filtre          : Le filtre.
+        - [double**           ] image           : L'image, comme retournee par lire.
+        - [int                ] nb_lignes       : Le nombre de lignes de l'image.
+        - [int                ] nb_colonnes     : Le nombre de colonnes de l'image.
+        - [double             ] sigma_espace    : L'ecart type spatial, en pixels
+                                                  (au moins 1).
+        - [double             ] sigma_intensite : L'ecart type des niveaux, dans les
+                                                  unites de l'image (plus de 0).
+        - [double**           ] resultat        : Recoit l'image lissee (deja
+                                                  allouee). Ce peut etre l'image
+                                                  elle-meme.
+
+    Retour:
+        1 si l'image a ete lissee, 0 si les parametres sont invalides ou si
+        la memoire manque.
+
+    Exemple d'utilisation (avant la reconnaissance des caracteres):
+
+        t_filtre_bilateral* filtre = creer_filtre_bilateral();
+
+        filtrer_bilateral(filtre, plaque, nl, nc, 8.0, 0.08, plaque);
+
+        detruire_filtre_bilateral(filtre);
+*/
+int filtrer_bilateral(t_filtre_bilateral* filtre, double** image, int nb_lignes,
+                      int nb_colonnes, double sigma_espace, double sigma_intensite,
+                      double** resultat);
+
+
+#endif
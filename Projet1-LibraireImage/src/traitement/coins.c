@@ -0,0 +1,570 @@
+/****************************************************************************************
+    COINS.C
+
+    Ce module contient les detecteurs de coins. L'espace de travail d'une
+    bande est fait, dans l'ordre, des sommes par colonne, de l'anneau des
+    2 * rayon + 1 dernieres lignes sommees horizontalement, des produits de
+    la ligne en cours et de leurs sommes cumulees. Chacun range ses trois
+    canaux (Ix^2, Iy^2 et Ix Iy) l'un apres l'autre.
+****************************************************************************************/
+#include "coins.h"
+#include "../outils/instrumentation.h"
+#include "../outils/memoire.h"
+#include "../outils/parallele.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/****************************************************************************************
+*                               DEFINTION DES CONSTANTES                                *
+****************************************************************************************/
+
+#define VRAI    1
+#define FAUX    0
+
+// Les canaux du tenseur de structure.
+#define NB_CANAUX       3
+#define CANAL_XX        0
+#define CANAL_YY        1
+#define CANAL_XY        2
+
+// Le nombre de rangees de cellules traitees par un fil a la fois.
+#define CELLULES_PAR_PAQUET     4
+
+
+/*
+    T_TENSEUR
+
+    Une detection en cours, partagee par les fils.
+*/
+typedef struct
+{
+    double** image;
+    int      nb_lignes;
+    int      nb_colonnes;
+    int      methode;
+    double   k;
+    int      rayon;
+    int      bord;                      // Les pixels ignores pres du bord.
+    int      nb_bandes;                 // Le nombre de bandes de lignes (une par fil).
+    size_t   taille_tampon;             // Le nombre de reels du tampon d'une bande.
+    double*  tampons;
+    double*  reponses;
+    double   maximums[NB_FILS_MAX];     // La plus grande reponse de chaque bande.
+    int      cellule;
+    int      nb_lignes_cellules;        // La grille.
+    int      nb_colonnes_cellules;
+    double   seuil;                     // La reponse minimale d'un coin.
+    int      sous_pixel;
+    t_coin*  candidats;                 // Le coin de chaque cellule.
+
+}t_tenseur;
+
+
+/****************************************************************************************
+*                           DECLARATION DES FONCTIONS PRIVEES                           *
+****************************************************************************************/
+
+
+/*
+    TACHE_REPONSES
+
+    Cette procedure (de type t_tache) calcule la reponse des pixels des
+    bandes debut a fin - 1 et la plus grande reponse de chaque bande.
+*/
+static void tache_reponses(void* donnees, int debut, int fin);
+
+
+
+/*
+    SOMMER_LIGNE
+
+    Cette procedure calcule les produits des derivees de la ligne i et leurs
+    sommes sur 2 * rayon + 1 colonnes.
+
+    Parametres:
+        - [t_tenseur*] tenseur  : La detection.
+        - [int       ] i        : La ligne.
+        - [double*   ] produits : Recoit les produits (NB_CANAUX * nb_colonnes).
+        - [double*   ] cumuls   : Recoit leurs sommes cumulees
+                                  (NB_CANAUX * (nb_colonnes + 1)).
+        - [double*   ] sommes   : Recoit les sommes (NB_CANAUX * nb_colonnes).
+*/
+static void sommer_ligne(const t_tenseur* tenseur, int i, double* restrict produits,
+                         double* restrict cumuls, double* restrict sommes);
+
+
+
+/*
+    TACHE_CELLULES
+
+    Cette procedure (de type t_tache) choisit le coin des cellules des
+    rangees debut a fin - 1 de la grille.
+*/
+static void tache_cellules(void* donnees, int debut, int fin);
+
+
+
+/*
+    RAFFINER
+
+    Cette procedure deplace un coin au sommet de la quadrique ajustee aux
+    reponses de ses 8 voisins, d'au plus un demi-pixel dans chaque direction.
+*/
+static void raffiner(const t_tenseur* tenseur, t_coin* coin);
+
+
+
+/*
+    RESERVER
+
+    Cette fonction agrandit un tableau a au moins 'voulu' elements de
+    'taille' octets; le contenu n'est pas garde.
+
+    Retour: 1 si le tableau a la capacite voulue, 0 si la memoire manque.
+*/
+static int reserver(void** tableau, size_t* capacite, size_t voulu, size_t taille);
+
+
+
+/*
+    COMPARER_COINS
+
+    Cette fonction (pour qsort) ordonne les coins par reponse decroissante,
+    puis par ligne et par colonne.
+*/
+static int comparer_coins(const void* a, const void* b);
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PUBLIQUES                            *
+****************************************************************************************/
+t_coins* creer_coins(void)
+{
+    t_coins* coins;     // L'ensemble cree.
+
+    coins = (t_coins*) ALLOUER(sizeof(t_coins));
+    if(coins == NULL)
+        return NULL;
+    INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 1);
+
+    memset(coins, 0, sizeof(t_coins));
+
+    return coins;
+}
+
+
+
+void detruire_coins(t_coins* coins)
+{
+    if(coins == NULL)
+        return;
+
+    LIBERER(coins->coins);
+    LIBERER(coins->reponses);
+    LIBERER(coins->tampons);
+    LIBERER(coins);
+}
+
+
+
+int trouver_coins(t_coins* coins, double** image, int nb_lignes, int nb_colonnes,
+                  int methode, double k, int rayon, int cellule, double seuil,
+                  int sous_pixel)
+{
+    t_tenseur tenseur;          // La detection partagee par les fils.
+    size_t    capacite;         // La capacite des coins.
+    double    maximum;          // La plus grande reponse de l'image.
+    int       nb_cellules;      // Le nombre de cellules de la grille.
+    int       nb_coins;         // Le nombre de coins retenus.
+    int       n;                // Iterateur sur les bandes et les cellules.
+
+    if(coins == NULL || image == NULL || nb_lignes < 1 || nb_colonnes < 1 || rayon < 0 ||
+       cellule < 1 || (methode != COINS_HARRIS && methode != COINS_SHI_TOMASI))
+        return -1;
+
+    coins->nb_coins = 0;
+
+    // Aucun pixel n'a sa fenetre dans l'image.
+    tenseur.bord = rayon + 1;
+    if(nb_lignes <= 2 * tenseur.bord || nb_colonnes <= 2 * tenseur.bord)
+        return 0;
+
+    INSTRUMENTER_DEBUT(ETAPE_COINS);
+
+    tenseur.image                = image;
+    tenseur.nb_lignes            = nb_lignes;
+    tenseur.nb_colonnes          = nb_colonnes;
+    tenseur.methode              = methode;
+    tenseur.k                    = k;
+    tenseur.rayon                = rayon;
+    tenseur.nb_bandes            = parallele_nb_fils() < nb_lignes ? parallele_nb_fils() :
+                                                                     nb_lignes;
+    tenseur.taille_tampon        = (size_t) NB_CANAUX * nb_colonnes * (2 * rayon + 3) +
+                                   (size_t) NB_CANAUX * (nb_colonnes + 1);
+    tenseur.cellule              = cellule;
+    tenseur.nb_lignes_cellules   = (nb_lignes   + cellule - 1) / cellule;
+    tenseur.nb_colonnes_cellules = (nb_colonnes + cellule - 1) / cellule;
+    tenseur.sous_pixel           = sous_pixel;
+    nb_cellules                  = tenseur.nb_lignes_cellules * tenseur.nb_colonnes_cellules;
+
+    capacite = (size_t) coins->capacite_coins;
+    if(!reserver((void**) &coins->reponses, &coins->capacite_reponses,
+                 (size_t) nb_lignes * nb_colonnes, sizeof(double)) ||
+       !reserver((void**) &coins->tampons, &coins->capacite_tampons,
+                 tenseur.nb_bandes * tenseur.taille_tampon, sizeof(double)) ||
+       !reserver((void**) &coins->coins, &capacite, nb_cellules, sizeof(t_coin)))
+    {
+        INSTRUMENTER_FIN(ETAPE_COINS);
+        return -1;
+    }
+    coins->capacite_coins = (int) capacite;
+
+    tenseur.tampons   = coins->tampons;
+    tenseur.reponses  = coins->reponses;
+    tenseur.candidats = coins->coins;
+
+    parallele_pour(tenseur.nb_bandes, 1, tache_reponses, &tenseur);
+
+    maximum = tenseur.maximums[0];
+    for(n = 1; n < tenseur.nb_bandes; n++)
+        if(tenseur.maximums[n] > maximum)
+            maximum = tenseur.maximums[n];
+
+    // Une image sans coin (uniforme, ou faite de contours droits) n'a pas de
+    // reponse positive.
+    if(!(maximum > 0))
+    {
+        INSTRUMENTER_FIN(ETAPE_COINS);
+        return 0;
+    }
+    tenseur.seuil = seuil * maximum;
+
+    parallele_pour(tenseur.nb_lignes_cellules, CELLULES_PAR_PAQUET, tache_cellules, &tenseur);
+
+    // Les cellules sans coin sont retirees.
+    nb_coins = 0;
+    for(n = 0; n < nb_cellules; n++)
+        if(coins->coins[n].reponse > 0)
+            coins->coins[nb_coins++] = coins->coins[n];
+
+    qsort(coins->coins, nb_coins, sizeof(t_coin), comparer_coins);
+    coins->nb_coins = nb_coins;
+
+    INSTRUMENTER_FIN(ETAPE_COINS);
+
+    return nb_coins;
+}
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PRIVEES                            *
+****************************************************************************************/
+
+
+static void tache_reponses(void* donnees, int debut, int fin)
+{
+    t_tenseur*             tenseur = (t_tenseur*) donnees;
+    double*                colonnes;    // Les sommes par colonne de la fenetre.
+    double*                anneau;      // Les lignes sommees horizontalement.
+    double*                produits;    // Les produits de la ligne en cours.
+    double*                cumuls;      // Leurs sommes cumulees.
+    double*                entrante;    // La ligne qui entre dans la fenetre.
+    const double*          sortante;    // La ligne qui en sort.
+    const double*          xx;          // Les canaux des sommes par colonne.
+    const double*          yy;
+    const double*          xy;
+    double* restrict       reponse;     // La ligne de reponses calculee.
+    double                 maximum;     // La plus grande reponse de la bande.
+    int                    nc;          // Le nombre de colonnes.
+    int                    hauteur;     // Le nombre de lignes de l'anneau.
+    int                    ligne_min;   // Les lignes de la bande.
+    int                    ligne_max;
+    int                    bande;       // Iterateur sur les bandes.
+    int                    i, j;        // Iterateurs sur l'image.
+
+    nc      = tenseur->nb_colonnes;
+    hauteur = 2 * tenseur->rayon + 1;
+
+    for(bande = debut; bande < fin; bande++)
+    {
+        ligne_min = (int) ((long long) tenseur->nb_lignes * bande / tenseur->nb_bandes);
+        ligne_max = (int) ((long long) tenseur->nb_lignes * (bande + 1) / tenseur->nb_bandes);
+        colonnes  = tenseur->tampons + bande * tenseur->taille_tampon;
+        anneau    = colonnes + (size_t) NB_CANAUX * nc;
+        produits  = anneau   + (size_t) NB_CANAUX * nc * hauteur;
+        cumuls    = produits + (size_t) NB_CANAUX * nc;
+        xx        = colonnes + CANAL_XX * nc;
+        yy        = colonnes + CANAL_YY * nc;
+        xy        = colonnes + CANAL_XY * nc;
+        maximum   = 0;
+
+        memset(colonnes, 0, (size_t) NB_CANAUX * nc * sizeof(double));
+
+        // La ligne i entre dans la fenetre; la ligne i - rayon est complete;
+        // la ligne i - 2 * rayon sort de la fenetre. Les lignes hors de
+        // l'image sont nulles.
+        for(i = ligne_min - tenseur->rayon; i < ligne_max + tenseur->rayon; i++)
+        {
+            entrante = anneau + (size_t) ((i - ligne_min + tenseur->rayon) % hauteur) *
+                                NB_CANAUX * nc;
+            if(i >= 0 && i < tenseur->nb_lignes)
+                sommer_ligne(tenseur, i, produits, cumuls, entrante);
+            else
+                memset(entrante, 0, (size_t) NB_CANAUX * nc * sizeof(double));
+
+            for(j = 0; j < NB_CANAUX * nc; j++)
+                colonnes[j] += entrante[j];
+
+            if(i - tenseur->rayon < ligne_min)
+                continue;
+
+            reponse = tenseur->reponses + (size_t) (i - tenseur->rayon) * nc;
+            if(tenseur->methode == COINS_HARRIS)
+            {
+                for(j = 0; j < nc; j++)
+                    reponse[j] = xx[j] * yy[j] - xy[j] * xy[j] -
+                                 tenseur->k * (xx[j] + yy[j]) * (xx[j] + yy[j]);
+            }
+            else
+            {
+                for(j = 0; j < nc; j++)
+                    reponse[j] = 0.5 * (xx[j] + yy[j]) -
+                                 sqrt(0.25 * (xx[j] - yy[j]) * (xx[j] - yy[j]) +
+                                      xy[j] * xy[j]);
+            }
+
+            if(i - tenseur->rayon >= tenseur->bord &&
+               i - tenseur->rayon <  tenseur->nb_lignes - tenseur->bord)
+                for(j = tenseur->bord; j < nc - tenseur->bord; j++)
+                    maximum = reponse[j] > maximum ? reponse[j] : maximum;
+
+            sortante = anneau + (size_t) ((i - tenseur->rayon - ligne_min) % hauteur) *
+                                NB_CANAUX * nc;
+            for(j = 0; j < NB_CANAUX * nc; j++)
+                colonnes[j] -= sortante[j];
+        }
+
+        tenseur->maximums[bande] = maximum;
+    }
+}
+
+
+
+static void sommer_ligne(const t_tenseur* tenseur, int i, double* restrict produits,
+                         double* restrict cumuls, double* restrict sommes)
+{
+    const double* restrict haut;        // Les lignes voisines (la ligne elle-meme au bord).
+    const double* restrict bas;
+    const double* restrict ligne;
+    double                 ix, iy;      // Les derivees d'un pixel.
+    double                 sxx;         // Les sommes cumulees.
+    double                 syy;
+    double                 sxy;
+    const double*          cumul;       // Les sommes cumulees d'un canal.
+    double*                somme;       // Les sommes d'un canal.
+    int                    nc;          // Le nombre de colonnes.
+    int                    r;           // Le rayon.
+    int                    c;           // Iterateur sur les canaux.
+    int                    j;           // Iterateur sur les colonnes.
+
+    nc    = tenseur->nb_colonnes;
+    r     = tenseur->rayon;
+    ligne = tenseur->image[i];
+    haut  = tenseur->image[i > 0 ? i - 1 : i];
+    bas   = tenseur->image[i < tenseur->nb_lignes - 1 ? i + 1 : i];
+
+    // Les derivees centrees. Les colonnes du bord, qui ne servent qu'a des
+    // pixels ignores, ont des derivees d'un seul cote.
+    for(j = 0; j < nc; j++)
+    {
+        ix = 0.5 * (ligne[j < nc - 1 ? j + 1 : j] - ligne[j > 0 ? j - 1 : j]);
+        iy = 0.5 * (bas[j] - haut[j]);
+        produits[CANAL_XX * nc + j] = ix * ix;
+        produits[CANAL_YY * nc + j] = iy * iy;
+        produits[CANAL_XY * nc + j] = ix * iy;
+    }
+
+    // Les trois sommes cumulees avancent ensemble.
+    sxx = 0;
+    syy = 0;
+    sxy = 0;
+    cumuls[CANAL_XX * (nc + 1)] = 0;
+    cumuls[CANAL_YY * (nc + 1)] = 0;
+    cumuls[CANAL_XY * (nc + 1)] = 0;
+    for(j = 0; j < nc; j++)
+    {
+        sxx += produits[CANAL_XX * nc + j];
+        syy += produits[CANAL_YY * nc + j];
+        sxy += produits[CANAL_XY * nc + j];
+        cumuls[CANAL_XX * (nc + 1) + j + 1] = sxx;
+        cumuls[CANAL_YY * (nc + 1) + j + 1] = syy;
+        cumuls[CANAL_XY * (nc + 1) + j + 1] = sxy;
+    }
+
+    // Les fenetres coupees par le bord, puis les fenetres completes.
+    for(c = 0; c < NB_CANAUX; c++)
+    {
+        cumul = cumuls + c * (nc + 1);
+        somme = sommes + c * nc;
+        for(j = 0; j < nc && j < r; j++)
+            somme[j] = cumul[j + r + 1 < nc ? j + r + 1 : nc] - cumul[0];
+        for(j = nc - r - 1 > r ? nc - r - 1 : r; j < nc; j++)
+            somme[j] = cumul[nc] - cumul[j - r > 0 ? j - r : 0];
+        for(j = r; j < nc - r - 1; j++)
+            somme[j] = cumul[j + r + 1] - cumul[j - r];
+    }
+}
+
+
+
+static void tache_cellules(void* donnees, int debut, int fin)
+{
+    const t_tenseur* tenseur = (const t_tenseur*) donnees;
+    const double*    reponses;      // Les reponses d'une ligne.
+    const double*    haut;          // Les reponses des lignes voisines.
+    const double*    bas;
+    t_coin*          candidat;      // Le coin de la cellule.
+    double           meilleure;     // La plus grande reponse de la cellule.
+    int              ligne;         // Sa position.
+    int              colonne;
+    int              ligne_min;     // Les pixels de la cellule, sans le bord.
+    int              ligne_max;
+    int              colonne_min;
+    int              colonne_max;
+    int              nc;            // Le nombre de colonnes.
+    int              ci, cj;        // Iterateurs sur les cellules.
+    int              i, j;          // Iterateurs sur les pixels.
+
+    nc = tenseur->nb_colonnes;
+
+    for(ci = debut; ci < fin; ci++)
+    {
+        ligne_min = ci * tenseur->cellule > tenseur->bord ? ci * tenseur->cellule :
+                                                            tenseur->bord;
+        ligne_max = (ci + 1) * tenseur->cellule < tenseur->nb_lignes - tenseur->bord ?
+                    (ci + 1) * tenseur->cellule : tenseur->nb_lignes - tenseur->bord;
+
+        for(cj = 0; cj < tenseur->nb_colonnes_cellules; cj++)
+        {
+            candidat    = &tenseur->candidats[ci * tenseur->nb_colonnes_cellules + cj];
+            colonne_min = cj * tenseur->cellule > tenseur->bord ? cj * tenseur->cellule :
+                                                                  tenseur->bord;
+            colonne_max = (cj + 1) * tenseur->cellule < nc - tenseur->bord ?
+                          (cj + 1) * tenseur->cellule : nc - tenseur->bord;
+
+            candidat->reponse = 0;
+            meilleure         = 0;
+            ligne             = -1;
+            colonne           = -1;
+            for(i = ligne_min; i < ligne_max; i++)
+            {
+                reponses = tenseur->reponses + (size_t) i * nc;
+                for(j = colonne_min; j < colonne_max; j++)
+                {
+                    if(reponses[j] > meilleure)
+                    {
+                        meilleure = reponses[j];
+                        ligne     = i;
+                        colonne   = j;
+                    }
+                }
+            }
+
+            if(ligne < 0 || meilleure < tenseur->seuil)
+                continue;
+
+            // Un maximum local: plus grand que les voisins qui le precedent,
+            // au moins aussi grand que ceux qui le suivent, pour qu'un plateau
+            // a cheval sur deux cellules ne donne qu'un coin.
+            reponses = tenseur->reponses + (size_t) ligne * nc;
+            haut     = reponses - nc;
+            bas      = reponses + nc;
+            if(!(meilleure > haut[colonne - 1] && meilleure > haut[colonne] &&
+                 meilleure > haut[colonne + 1] && meilleure > reponses[colonne - 1] &&
+                 meilleure >= reponses[colonne + 1] && meilleure >= bas[colonne - 1] &&
+                 meilleure >= bas[colonne] && meilleure >= bas[colonne + 1]))
+                continue;
+
+            candidat->ligne   = ligne;
+            candidat->colonne = colonne;
+            candidat->reponse = meilleure;
+            if(tenseur->sous_pixel)
+                raffiner(tenseur, candidat);
+        }
+    }
+}
+
+
+
+static void raffiner(const t_tenseur* tenseur, t_coin* coin)
+{
+    const double* centre;       // La reponse du coin.
+    int           nc;           // Le nombre de colonnes.
+    double        dx, dy;       // Le gradient de la quadrique.
+    double        dxx, dyy;     // Sa hessienne.
+    double        dxy;
+    double        determinant;
+    double        ox, oy;       // Le deplacement du sommet.
+
+    nc     = tenseur->nb_colonnes;
+    centre = tenseur->reponses + (size_t) coin->ligne * nc + (int) coin->colonne;
+
+    dx  = 0.5 * (centre[1] - centre[-1]);
+    dy  = 0.5 * (centre[nc] - centre[-nc]);
+    dxx = centre[1]  - 2 * centre[0] + centre[-1];
+    dyy = centre[nc] - 2 * centre[0] + centre[-nc];
+    dxy = 0.25 * (centre[nc + 1] - centre[nc - 1] - centre[-nc + 1] + centre[-nc - 1]);
+
+    // Le sommet n'est un maximum que si la hessienne est definie negative.
+    determinant = dxx * dyy - dxy * dxy;
+    if(!(determinant > 0 && dxx < 0))
+        return;
+
+    ox = (dxy * dy - dyy * dx) / determinant;
+    oy = (dxy * dx - dxx * dy) / determinant;
+    ox = ox > 0.5 ? 0.5 : (ox < -0.5 ? -0.5 : ox);
+    oy = oy > 0.5 ? 0.5 : (oy < -0.5 ? -0.5 : oy);
+
+    coin->colonne += ox;
+    coin->ligne   += oy;
+    coin->reponse += 0.5 * (dx * ox + dy * oy);
+}
+
+
+
+static int reserver(void** tableau, size_t* capacite, size_t voulu, size_t taille)
+{
+    void* agrandi;      // Le tableau agrandi.
+
+    if(voulu <= *capacite)
+        return VRAI;
+
+    agrandi = ALLOUER(voulu * taille);
+    if(agrandi == NULL)
+        return FAUX;
+    INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 1);
+
+    LIBERER(*tableau);
+    *tableau  = agrandi;
+    *capacite = voulu;
+
+    return VRAI;
+}
+
+
+
+static int comparer_coins(const void* a, const void* b)
+{
+    const t_coin* x = (const t_coin*) a;
+    const t_coin* y = (const t_coin*) b;
+
+    if(x->reponse != y->reponse)
+        return (x->reponse < y->reponse) - (x->reponse > y->reponse);
+    if(x->ligne != y->ligne)
+        return (x->ligne > y->ligne) - (x->ligne < y->ligne);
+
+    return (x->colonne > y->colonne) - (x->colonne < y->colonne);
+}
@@ -0,0 +1,153 @@
+/****************************************************************************************
+    COINS.H
+
+    Ce module contient les detecteurs de coins de Harris et de Shi et Tomasi.
+    Les deux reposent sur le tenseur de structure: les sommes de Ix^2, Iy^2
+    et Ix Iy (les produits des derivees de l'image) sur une fenetre carree
+    autour de chaque pixel. Harris garde det - k trace^2, Shi et Tomasi la
+    plus petite valeur propre; les deux sont grandes seulement si l'image
+    varie dans deux directions.
+
+    Les derivees, leurs produits et les sommes des fenetres sont calcules
+    en une seule passe: une ligne de produits est sommee horizontalement des
+    qu'elle est calculee, puis ajoutee (et, 2 * rayon + 1 lignes plus tard,
+    retiree) a des sommes par colonne. Aucune image de derivees n'est
+    rangee, et le cout ne depend pas du rayon. L'image est decoupee en
+    bandes de lignes reparties sur plusieurs fils (voir parallele.h).
+
+    Les coins sont les maximums locaux de la reponse, au plus un par
+    cellule d'une grille, ce qui les repartit sur toute l'image. Leur
+    position peut etre raffinee a une fraction de pixel par une quadrique
+    ajustee a la reponse autour du maximum.
+
+    Liste des sous-programmes publiques:
+      - creer_coins        : Cree un ensemble de coins vide;
+      - detruire_coins     : Libere un ensemble de coins;
+      - trouver_coins      : Trouve les coins d'une image.
+
+*****************************************************************************************/
+#ifndef COINS
+#define COINS
+
+#include <stddef.h>
+
+
+/****************************************************************************************
+*                               DEFINTION DES CONSTANTES                                *
+****************************************************************************************/
+
+// Les reponses.
+#define COINS_HARRIS            0   // det - k trace^2.
+#define COINS_SHI_TOMASI        1   // La plus petite valeur propre.
+
+// La valeur habituelle de k pour Harris.
+#define K_HARRIS                0.04
+
+
+/*
+    T_COIN
+
+    Un coin. La position est en pixels, fractionnaire si elle est raffinee.
+*/
+typedef struct
+{
+    double ligne;
+    double colonne;
+    double reponse;
+
+}t_coin;
+
+
+/*
+    T_COINS
+
+    Les coins d'une image. Les champs coins et nb_coins peuvent etre lus
+    directement; les autres ne servent qu'au module.
+*/
+typedef struct
+{
+    t_coin* coins;                  // Les coins, par reponse decroissante.
+    int     nb_coins;
+    int     capacite_coins;
+    double* reponses;               // La reponse de chaque pixel.
+    size_t  capacite_reponses;
+    double* tampons;                // Les sommes de chaque bande.
+    size_t  capacite_tampons;
+
+}t_coins;
+
+
+/****************************************************************************************
+*                       DECLARATION DES FONCTIONS PUBLIQUES                             *
+****************************************************************************************/
+
+
+/*
+    CREER_COINS
+
+    Cette fonction cree un ensemble de coins vide. Les tableaux sont alloues
+    au premier appel de trouver_coins.
+
+    Retour:
+        L'ensemble cree, ou NULL si la memoire manque.
+*/
+t_coins* creer_coins(void);
+
+
+
+/*
+    DETRUIRE_COINS
+
+    Cette procedure libere un ensemble de coins et tous ses tableaux.
+
+    Parametres:
+        - [t_coins*] coins : L'ensemble a liberer (NULL est accepte).
+*/
+void detruire_coins(t_coins* coins);
+
+
+
+/*
+    TROUVER_COINS
+
+    Cette fonction trouve les coins d'une image: dans chaque cellule de la
+    grille, le pixel de plus grande reponse, s'il est un maximum local (sur
+    ses 8 voisins) et si sa reponse atteint seuil fois la plus grande
+    reponse de l'image. Les pixels a moins de rayon + 1 du bord, dont la
+    fenetre sort de l'image, sont ignores. Les coins precedents de
+    l'ensemble sont remplaces. Un ensemble ne doit etre utilise que par un
+    fil a la fois.
+
+    Parametres:
+        - [t_coins*] coins       : L'ensemble qui recoit les coins.
+        - [double**] image       : L'image, comme retournee par lire.
+        - [int     ] nb_lignes   : Le nombre de lignes de l'image.
+        - [int     ] nb_colonnes : Le nombre de colonnes de l'image.
+        - [int     ] methode     : COINS_HARRIS ou COINS_SHI_TOMASI.
+        - [double  ] k           : Le k de Harris (ignore par Shi et Tomasi).
+        - [int     ] rayon       : La fenetre a 2 * rayon + 1 pixels de cote.
+        - [int     ] cellule     : Le cote d'une cellule de la grille, en pixels.
+        - [double  ] seuil       : La reponse minimale, relative a la plus grande
+                                   (entre 0 et 1).
+        - [int     ] sous_pixel  : 1 pour raffiner les positions, 0 sinon.
+
+    Retour:
+        Le nombre de coins (ranges dans coins->coins), ou -1 si les
+        parametres sont invalides ou si la memoire manque.
+
+    Exemple d'utilisation (les quatre coins d'une plaque):
+
+        t_coins* coins = creer_coins();
+
+        n = trouver_coins(coins, plaque, nl, nc, COINS_SHI_TOMASI, 0, 2, 16, 0.1, 1);
+        for(i = 0; i < n && i < 4; i++)
+            printf("%.1f %.1f\n", coins->coins[i].ligne, coins->coins[i].colonne);
+
+        detruire_coins(coins);
+*/
+int trouver_coins(t_coins* coins, double** image, int nb_lignes, int nb_colonnes,
+                  int methode, double k, int rayon, int cellule, double seuil,
+                  int sous_pixel);
+
+
+#endif
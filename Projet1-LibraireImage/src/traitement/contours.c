@@ -0,0 +1,854 @@
+/****************************************************************************************
+    CONTOURS.C
+
+    Ce module contient le suivi des bordures de Suzuki et Abe et les mesures
+    des contours. L'image des etiquettes a une marge d'un pixel eteint tout
+    autour, ce qui evite de verifier les bords pendant le suivi; le cadre de
+    l'image porte le numero de bordure 1 et est traite comme un trou.
+****************************************************************************************/
+#include "contours.h"
+#include "../outils/instrumentation.h"
+#include "../outils/memoire.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/****************************************************************************************
+*                               DEFINTION DES CONSTANTES                                *
+****************************************************************************************/
+
+#define VRAI    1
+#define FAUX    0
+
+#define PI      3.14159265358979323846
+
+// Le nombre de voisins d'un pixel.
+#define NB_VOISINS          8
+
+// Le numero de bordure du cadre de l'image; les contours sont numerotes a
+// partir de NUMERO_CADRE + 1.
+#define NUMERO_CADRE        1
+
+// Les capacites initiales de l'arene et du tableau des contours.
+#define CAPACITE_POINTS     4096
+#define CAPACITE_CONTOURS   256
+
+// Les voisins d'un pixel, dans le sens horaire (les lignes vont vers le bas) a
+// partir de l'est.
+static const int VOISIN_LIGNE[NB_VOISINS]   = { 0, 1, 1,  1,  0, -1, -1, -1 };
+static const int VOISIN_COLONNE[NB_VOISINS] = { 1, 1, 0, -1, -1, -1,  0,  1 };
+
+
+/****************************************************************************************
+*                           DECLARATION DES FONCTIONS PRIVEES                           *
+****************************************************************************************/
+
+
+/*
+    RESERVER
+
+    Cette fonction agrandit un tableau (en doublant sa capacite) pour qu'il
+    puisse contenir au moins 'nombre' elements.
+
+    Parametres:
+        - [void** ] tableau   : Le tableau, remplace s'il est deplace.
+        - [int*   ] capacite  : La capacite du tableau, en elements.
+        - [int    ] nombre    : Le nombre d'elements voulu.
+        - [size_t ] taille    : La taille d'un element.
+        - [int    ] initiale  : La capacite d'un tableau encore vide.
+
+    Retour: 1 si le tableau est assez grand, 0 si la memoire manque.
+*/
+static int reserver(void** tableau, int* capacite, int nombre, size_t taille, int initiale);
+
+
+
+/*
+    RESERVER_TRAVAIL
+
+    Cette fonction retourne l'espace de travail des mesures, agrandi au besoin.
+
+    Parametres:
+        - [t_contours*] contours : Les contours.
+        - [size_t     ] taille   : La taille voulue, en octets.
+
+    Retour: L'espace de travail, ou NULL si la memoire manque.
+*/
+static void* reserver_travail(t_contours* contours, size_t taille);
+
+
+
+/*
+    SUIVRE_BORDURE
+
+    Cette fonction suit une bordure a partir de son premier pixel (etape 3 de
+    Suzuki et Abe), marque ses pixels et ajoute ses points a l'arene.
+
+    Parametres:
+        - [t_contours*] contours : Les contours (etiquettes et arene).
+        - [int        ] largeur  : La largeur de l'image des etiquettes.
+        - [int        ] depart   : Le premier pixel de la bordure.
+        - [int        ] voisin   : La direction du pixel eteint voisin de depart.
+        - [int        ] numero   : Le numero de la bordure.
+
+    Retour: Le nombre de points de la bordure, ou -1 si la memoire manque.
+*/
+static int suivre_bordure(t_contours* contours, int largeur, int depart, int voisin,
+                          int numero);
+
+
+
+/*
+    COMPARER_POINTS
+
+    Cette fonction (pour qsort) ordonne les points par colonne, puis par ligne.
+*/
+static int comparer_points(const void* a, const void* b);
+
+
+
+/*
+    ENVELOPPE_CONVEXE
+
+    Cette fonction calcule l'enveloppe convexe d'un ensemble de points par la
+    chaine monotone d'Andrew. Les points alignes sont retires.
+
+    Parametres:
+        - [t_point*] points    : Les points, tries par comparer_points.
+        - [int     ] nb_points : Le nombre de points.
+        - [t_point*] enveloppe : Recoit les sommets (nb_points + 1 places).
+
+    Retour: Le nombre de sommets de l'enveloppe.
+*/
+static int enveloppe_convexe(const t_point* points, int nb_points, t_point* enveloppe);
+
+
+
+/*
+    PRODUIT_VECTORIEL
+
+    Retour: Le produit vectoriel (a - o) x (b - o), en coordonnees (x, y) =
+            (colonne, ligne).
+*/
+static double produit_vectoriel(t_point o, t_point a, t_point b);
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PUBLIQUES                            *
+****************************************************************************************/
+t_contours* creer_contours(void)
+{
+    t_contours* contours;   // L'ensemble cree.
+
+    contours = (t_contours*) ALLOUER(sizeof(t_contours));
+    if(contours == NULL)
+        return NULL;
+    INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 1);
+
+    memset(contours, 0, sizeof(t_contours));
+
+    return contours;
+}
+
+
+
+void detruire_contours(t_contours* contours)
+{
+    if(contours == NULL)
+        return;
+
+    LIBERER(contours->points);
+    LIBERER(contours->contours);
+    LIBERER(contours->etiquettes);
+    LIBERER(contours->travail);
+    LIBERER(contours);
+}
+
+
+
+int trouver_contours(double** image, int nb_lignes, int nb_colonnes, double seuil,
+                     t_contours* contours)
+{
+    int        largeur;         // La largeur de l'image des etiquettes (avec la marge).
+    size_t     taille;          // Le nombre de pixels de l'image des etiquettes.
+    int*       etiquettes;      // L'image des etiquettes.
+    int        derniere;        // Le numero de la derniere bordure rencontree (LNBD).
+    int        numero;          // Le numero de la nouvelle bordure (NBD).
+    int        est_trou;        // Vrai si la nouvelle bordure est celle d'un trou.
+    int        voisin;          // La direction du pixel eteint voisin du depart.
+    int        parent;          // L'indice de la bordure derniere.
+    int        nb_points;       // Le nombre de points d'une bordure.
+    int        p;               // Le pixel courant.
+    int        i, j;            // Iterateurs sur les lignes et les colonnes.
+    t_contour* contour;         // Le contour ajoute.
+
+    if(image == NULL || contours == NULL || nb_lignes <= 0 || nb_colonnes <= 0)
+        return -1;
+
+    INSTRUMENTER_DEBUT(ETAPE_CONTOURS);
+
+    contours->nb_points   = 0;
+    contours->nb_contours = 0;
+
+    // L'image des etiquettes: 1 pour les pixels allumes, 0 pour les autres et
+    // pour la marge.
+    largeur = nb_colonnes + 2;
+    taille  = (size_t) (nb_lignes + 2) * largeur;
+    if(taille > contours->taille_etiquettes)
+    {
+        LIBERER(contours->etiquettes);
+        contours->etiquettes = (int*) ALLOUER(taille * sizeof(int));
+        contours->taille_etiquettes = contours->etiquettes != NULL ? taille : 0;
+        if(contours->etiquettes == NULL)
+        {
+            INSTRUMENTER_FIN(ETAPE_CONTOURS);
+            return -1;
+        }
+        INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 1);
+    }
+    etiquettes = contours->etiquettes;
+
+    memset(etiquettes, 0, (size_t) largeur * sizeof(int));
+    memset(etiquettes + (size_t) (nb_lignes + 1) * largeur, 0, (size_t) largeur * sizeof(int));
+    for(i = 0; i < nb_lignes; i++)
+    {
+        p = (i + 1) * largeur;
+        etiquettes[p]               = 0;
+        etiquettes[p + largeur - 1] = 0;
+        for(j = 0; j < nb_colonnes; j++)
+            etiquettes[p + 1 + j] = image[i][j] > seuil;
+    }
+
+    numero = NUMERO_CADRE;
+
+    // Le balayage (etapes 1 et 4 de Suzuki et Abe).
+    for(i = 1; i <= nb_lignes; i++)
+    {
+        derniere = NUMERO_CADRE;
+
+        for(p = i * largeur + 1; p <= i * largeur + nb_colonnes; p++)
+        {
+            if(etiquettes[p] == 0)
+                continue;
+
+            // Le depart d'une bordure exterieure, ou d'une bordure de trou.
+            if(etiquettes[p] == 1 && etiquettes[p - 1] == 0)
+            {
+                est_trou = FAUX;
+                voisin   = 4;
+            }
+            else if(etiquettes[p] >= 1 && etiquettes[p + 1] == 0)
+            {
+                est_trou = VRAI;
+                voisin   = 0;
+                if(etiquettes[p] > 1)
+                    derniere = etiquettes[p];
+            }
+            else
+            {
+                if(etiquettes[p] != 1)
+                    derniere = abs(etiquettes[p]);
+                continue;
+            }
+
+            // Le parent de la nouvelle bordure depend du type de la derniere
+            // bordure rencontree sur la ligne.
+            if(derniere == NUMERO_CADRE)
+                parent = -1;
+            else
+            {
+                parent = derniere - NUMERO_CADRE - 1;
+                if(contours->contours[parent].est_trou == est_trou)
+                    parent = contours->contours[parent].parent;
+            }
+
+            if(!reserver((void**) &contours->contours, &contours->capacite_contours,
+                         contours->nb_contours + 1, sizeof(t_contour), CAPACITE_CONTOURS))
+            {
+                INSTRUMENTER_FIN(ETAPE_CONTOURS);
+                return -1;
+            }
+
+            numero++;
+            contour = &contours->contours[contours->nb_contours];
+            contour->debut    = contours->nb_points;
+            contour->parent   = parent;
+            contour->est_trou = est_trou;
+
+            nb_points = suivre_bordure(contours, largeur, p, voisin, numero);
+            if(nb_points < 0)
+            {
+                INSTRUMENTER_FIN(ETAPE_CONTOURS);
+                return -1;
+            }
+
+            contour->nb_points = nb_points;
+            contours->nb_contours++;
+
+            if(etiquettes[p] != 1)
+                derniere = abs(etiquettes[p]);
+        }
+    }
+
+    INSTRUMENTER_FIN(ETAPE_CONTOURS);
+
+    return contours->nb_contours;
+}
+
+
+
+int simplifier_contours(t_contours* contours, double tolerance)
+{
+    int*       garde;           // Vrai pour les points retenus d'un contour.
+    int*       pile;            // Les intervalles a examiner (paires d'indices).
+    int        nb_pile;         // Le nombre d'entiers sur la pile.
+    int        plus_long;       // Le nombre de points du plus long contour.
+    int        ecriture;        // La prochaine place libre de l'arene.
+    int        n;               // Le nombre de points du contour.
+    int        a, b;            // L'intervalle examine (b == n designe le point 0).
+    int        loin;            // Le point le plus eloigne.
+    double     ecart;           // L'ecart du point le plus eloigne.
+    double     d;               // L'ecart d'un point.
+    double     dx, dy;          // La corde de l'intervalle.
+    double     longueur;        // La longueur de la corde, au carre.
+    double     t;               // La projection d'un point sur la corde.
+    double     px, py;          // Un point, relatif au debut de la corde.
+    int        c, k, q;         // Iterateurs sur les contours et les points.
+    t_point*   points;          // Les points du contour.
+    t_point    fin;             // La fin de la corde.
+
+    if(contours == NULL || tolerance < 0)
+        return FAUX;
+
+    plus_long = 0;
+    for(c = 0; c < contours->nb_contours; c++)
+        if(contours->contours[c].nb_points > plus_long)
+            plus_long = contours->contours[c].nb_points;
+
+    // La pile contient au plus un intervalle par point.
+    garde = (int*) reserver_travail(contours, 3 * ((size_t) plus_long + 1) * sizeof(int));
+    if(garde == NULL)
+        return FAUX;
+    pile = garde + plus_long + 1;
+
+    // Les contours raccourcis sont tasses au debut de l'arene; un point n'est
+    // jamais ecrit avant d'avoir ete lu.
+    ecriture = 0;
+    for(c = 0; c < contours->nb_contours; c++)
+    {
+        points = contours->points + contours->contours[c].debut;
+        n      = contours->contours[c].nb_points;
+
+        if(n <= 2)
+        {
+            for(q = 0; q < n; q++)
+                garde[q] = VRAI;
+        }
+        else
+        {
+            // Le contour est ferme: il est coupe au point 0 et au point le plus
+            // eloigne du point 0.
+            loin  = 0;
+            ecart = -1;
+            for(q = 1; q < n; q++)
+            {
+                dx = points[q].colonne - points[0].colonne;
+                dy = points[q].ligne   - points[0].ligne;
+                if(dx * dx + dy * dy > ecart)
+                {
+                    ecart = dx * dx + dy * dy;
+                    loin  = q;
+                }
+            }
+
+            memset(garde, 0, (size_t) n * sizeof(int));
+            garde[0]    = VRAI;
+            garde[loin] = VRAI;
+
+            nb_pile = 0;
+            pile[nb_pile++] = 0;
+            pile[nb_pile++] = loin;
+            pile[nb_pile++] = loin;
+            pile[nb_pile++] = n;
+
+            while(nb_pile > 0)
+            {
+                b = pile[--nb_pile];
+                a = pile[--nb_pile];
+                if(b - a < 2)
+                    continue;
+
+                fin      = points[b % n];
+                dx       = fin.colonne - points[a].colonne;
+                dy       = fin.ligne   - points[a].ligne;
+                longueur = dx * dx + dy * dy;
+
+                // L'ecart au segment [a, b] (la distance au point a si la
+                // corde est nulle, ce qui arrive sur les parties minces).
+                loin  = a;
+                ecart = -1;
+                for(q = a + 1; q < b; q++)
+                {
+                    px = points[q].colonne - points[a].colonne;
+                    py = points[q].ligne   - points[a].ligne;
+                    t  = longueur > 0 ? (px * dx + py * dy) / longueur : 0;
+                    if(t < 0)
+                        t = 0;
+                    else if(t > 1)
+                        t = 1;
+                    d = (px - t * dx) * (px - t * dx) + (py - t * dy) * (py - t * dy);
+                    if(d > ecart)
+                    {
+                        ecart = d;
+                        loin  = q;
+                    }
+                }
+
+                if(ecart > tolerance * tolerance)
+                {
+                    garde[loin] = VRAI;
+                    pile[nb_pile++] = a;
+                    pile[nb_pile++] = loin;
+                    pile[nb_pile++] = loin;
+                    pile[nb_pile++] = b;
+                }
+            }
+        }
+
+        contours->contours[c].debut = ecriture;
+        k = 0;
+        for(q = 0; q < n; q++)
+            if(garde[q])
+                contours->points[ecriture + k++] = points[q];
+
+        contours->contours[c].nb_points = k;
+        ecriture += k;
+    }
+
+    contours->nb_points = ecriture;
+
+    return VRAI;
+}
+
+
+
+int rectangle_minimal(t_contours* contours, int indice, t_rectangle* rectangle)
+{
+    t_point* tries;             // Les points du contour, tries.
+    t_point* enveloppe;         // Les sommets de l'enveloppe convexe.
+    int      n;                 // Le nombre de points du contour.
+    int      h;                 // Le nombre de sommets de l'enveloppe.
+    int      i, j, k, m;        // L'arete, et les sommets extremes pour cette arete.
+    int      meilleur[4] = {0}; // Les indices i, j, k, m du meilleur rectangle.
+    double   aire;              // L'aire d'un rectangle, en pixels.
+    double   meilleure_aire;    // L'aire du meilleur rectangle, en pixels.
+    double   ex, ey;            // L'arete e (non normalisee).
+    double   norme;             // La longueur de l'arete.
+    double   ux, uy;            // L'arete normalisee.
+    double   vx, vy;            // La normale de l'arete, vers l'interieur.
+    double   s_min, s_max;      // L'etendue le long de l'arete.
+    double   hauteur;           // L'etendue le long de la normale.
+    double   x0, y0;            // Le premier sommet de l'arete.
+    int      q;                 // Iterateur sur les coins.
+
+    if(contours == NULL || rectangle == NULL || indice < 0 ||
+       indice >= contours->nb_contours || contours->contours[indice].nb_points == 0)
+        return FAUX;
+
+    n = contours->contours[indice].nb_points;
+
+    tries = (t_point*) reserver_travail(contours, (2 * (size_t) n + 1) * sizeof(t_point));
+    if(tries == NULL)
+        return FAUX;
+    enveloppe = tries + n;
+
+    memcpy(tries, contours->points + contours->contours[indice].debut,
+           (size_t) n * sizeof(t_point));
+    qsort(tries, n, sizeof(t_point), comparer_points);
+
+    h = enveloppe_convexe(tries, n, enveloppe);
+
+    if(h == 1)
+    {
+        for(q = 0; q < NB_COINS; q++)
+        {
+            rectangle->coins[q][0] = enveloppe[0].colonne;
+            rectangle->coins[q][1] = enveloppe[0].ligne;
+        }
+        rectangle->longueur = 0;
+        rectangle->largeur  = 0;
+        rectangle->angle    = 0;
+        rectangle->aire     = 0;
+        return VRAI;
+    }
+
+    // Les pieds a coulisse: pour chaque arete i de l'enveloppe, j et m sont
+    // les sommets extremes le long de l'arete et k le plus eloigne de l'arete.
+    // Ils ne font qu'avancer lorsque i avance.
+    meilleure_aire = -1;
+    j = 1;
+    k = 1;
+    m = 1;
+    for(i = 0; i < h; i++)
+    {
+        ex = enveloppe[(i + 1) % h].colonne - enveloppe[i].colonne;
+        ey = enveloppe[(i + 1) % h].ligne   - enveloppe[i].ligne;
+
+        while(ex * (enveloppe[(j + 1) % h].colonne - enveloppe[j].colonne) +
+              ey * (enveloppe[(j + 1) % h].ligne   - enveloppe[j].ligne) > 0)
+            j = (j + 1) % h;
+
+        if(i == 0)
+            k = j;
+        while(ex * (enveloppe[(k + 1) % h].ligne   - enveloppe[k].ligne) -
+              ey * (enveloppe[(k + 1) % h].colonne - enveloppe[k].colonne) > 0)
+            k = (k + 1) % h;
+
+        if(i == 0)
+            m = k;
+        while(ex * (enveloppe[(m + 1) % h].colonne - enveloppe[m].colonne) +
+              ey * (enveloppe[(m + 1) % h].ligne   - enveloppe[m].ligne) < 0)
+            m = (m + 1) % h;
+
+        // La longueur et la hauteur, fois |e| chacune, sont des entiers exacts;
+        // seule la division par |e|^2 arrondit l'aire.
+        aire = (ex * (enveloppe[j].colonne - enveloppe[m].colonne) +
+                ey * (enveloppe[j].ligne   - enveloppe[m].ligne)) *
+               (ex * (enveloppe[k].ligne   - enveloppe[i].ligne) -
+                ey * (enveloppe[k].colonne - enveloppe[i].colonne)) / (ex * ex + ey * ey);
+
+        if(meilleure_aire < 0 || aire < meilleure_aire)
+        {
+            meilleure_aire = aire;
+            meilleur[0] = i;
+            meilleur[1] = j;
+            meilleur[2] = k;
+            meilleur[3] = m;
+        }
+    }
+
+    i  = meilleur[0];
+    x0 = enveloppe[i].colonne;
+    y0 = enveloppe[i].ligne;
+    ex = enveloppe[(i + 1) % h].colonne - x0;
+    ey = enveloppe[(i + 1) % h].ligne   - y0;
+
+    norme = sqrt(ex * ex + ey * ey);
+    ux    = ex / norme;
+    uy    = ey / norme;
+    vx    = -uy;
+    vy    = ux;
+
+    s_max   = (enveloppe[meilleur[1]].colonne - x0) * ux + (enveloppe[meilleur[1]].ligne - y0) * uy;
+    hauteur = (enveloppe[meilleur[2]].colonne - x0) * vx + (enveloppe[meilleur[2]].ligne - y0) * vy;
+    s_min   = (enveloppe[meilleur[3]].colonne - x0) * ux + (enveloppe[meilleur[3]].ligne - y0) * uy;
+
+    rectangle->coins[0][0] = x0 + s_min * ux;
+    rectangle->coins[0][1] = y0 + s_min * uy;
+    rectangle->coins[1][0] = x0 + s_max * ux;
+    rectangle->coins[1][1] = y0 + s_max * uy;
+    rectangle->coins[2][0] = rectangle->coins[1][0] + hauteur * vx;
+    rectangle->coins[2][1] = rectangle->coins[1][1] + hauteur * vy;
+    rectangle->coins[3][0] = rectangle->coins[0][0] + hauteur * vx;
+    rectangle->coins[3][1] = rectangle->coins[0][1] + hauteur * vy;
+
+    if(s_max - s_min >= hauteur)
+    {
+        rectangle->longueur = s_max - s_min;
+        rectangle->largeur  = hauteur;
+        rectangle->angle    = atan2(uy, ux);
+    }
+    else
+    {
+        rectangle->longueur = hauteur;
+        rectangle->largeur  = s_max - s_min;
+        rectangle->angle    = atan2(vy, vx);
+    }
+
+    if(rectangle->angle > PI / 2)
+        rectangle->angle -= PI;
+    else if(rectangle->angle <= -PI / 2)
+        rectangle->angle += PI;
+
+    rectangle->aire = rectangle->longueur * rectangle->largeur;
+
+    return VRAI;
+}
+
+
+
+int est_convexe(const t_contours* contours, int indice)
+{
+    const t_point* points;      // Les points du contour.
+    int            n;           // Le nombre de points du contour.
+    int            q;           // Iterateur sur les points.
+    int            suivant;     // Le premier point distinct apres q.
+    int            sens;        // Le signe des virages (0 tant qu'il est inconnu).
+    int            nb_aretes;   // Le nombre d'aretes non nulles.
+    double         ax, ay;      // L'arete precedente.
+    double         bx, by;      // L'arete courante.
+    double         premier_x;   // La premiere arete, pour fermer le tour.
+    double         premier_y;
+    double         vectoriel;   // Le produit vectoriel de deux aretes.
+    double         tour;        // La somme des angles des virages.
+
+    if(contours == NULL || indice < 0 || indice >= contours->nb_contours)
+        return FAUX;
+
+    points = contours->points + contours->contours[indice].debut;
+    n      = contours->contours[indice].nb_points;
+    if(n == 0)
+        return FAUX;
+
+    sens      = 0;
+    nb_aretes = 0;
+    tour      = 0;
+    ax = ay   = 0;
+    premier_x = premier_y = 0;
+
+    // Les aretes nulles (points repetes) sont sautees. L'arete qui ferme le
+    // tour est suivie de la premiere arete, pour le dernier virage.
+    for(q = 0; q <= n; q++)
+    {
+        suivant = (q + 1) % n;
+        bx = points[suivant].colonne - points[q % n].colonne;
+        by = points[suivant].ligne   - points[q % n].ligne;
+
+        if(q == n)
+        {
+            bx = premier_x;
+            by = premier_y;
+        }
+        else if(bx == 0 && by == 0)
+            continue;
+
+        if(nb_aretes == 0)
+        {
+            premier_x = bx;
+            premier_y = by;
+        }
+        else
+        {
+            vectoriel = ax * by - ay * bx;
+
+            // Un retour en arriere.
+            if(vectoriel == 0 && ax * bx + ay * by < 0)
+                return FAUX;
+
+            if(vectoriel != 0)
+            {
+                if(sens == 0)
+                    sens = vectoriel > 0 ? 1 : -1;
+                else if((vectoriel > 0) != (sens > 0))
+                    return FAUX;
+            }
+
+            tour += atan2(vectoriel, ax * bx + ay * by);
+        }
+
+        if(q < n)
+            nb_aretes++;
+        ax = bx;
+        ay = by;
+    }
+
+    // Au moins 3 points distincts, et un seul tour.
+    return nb_aretes >= 3 && sens != 0 && fabs(fabs(tour) - 2 * PI) < PI;
+}
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PRIVEES                            *
+****************************************************************************************/
+
+
+static int reserver(void** tableau, int* capacite, int nombre, size_t taille, int initiale)
+{
+    int   nouvelle;     // La nouvelle capacite.
+    void* agrandi;      // Le tableau agrandi.
+
+    if(nombre <= *capacite)
+        return VRAI;
+
+    nouvelle = *capacite > 0 ? *capacite : initiale;
+    while(nouvelle < nombre)
+        nouvelle *= 2;
+
+    agrandi = REALLOUER(*tableau, (size_t) nouvelle * taille);
+    if(agrandi == NULL)
+        return FAUX;
+    INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 1);
+
+    *tableau  = agrandi;
+    *capacite = nouvelle;
+
+    return VRAI;
+}
+
+
+
+static void* reserver_travail(t_contours* contours, size_t taille)
+{
+    if(taille > contours->taille_travail)
+    {
+        LIBERER(contours->travail);
+        contours->travail = ALLOUER(taille);
+        contours->taille_travail = contours->travail != NULL ? taille : 0;
+        if(contours->travail != NULL)
+            INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 1);
+    }
+
+    return contours->travail;
+}
+
+
+
+static int suivre_bordure(t_contours* contours, int largeur, int depart, int voisin,
+                          int numero)
+{
+    int*     etiquettes;                // L'image des etiquettes.
+    int      decalages[NB_VOISINS];     // Les decalages des voisins dans l'image.
+    int      premier;                   // Le premier voisin allume du depart (i1, j1).
+    int      courant;                   // Le pixel courant (i3, j3).
+    int      direction;                 // La direction du pixel precedent (i2, j2),
+                                        // vu du pixel courant.
+    int      d;                         // La direction examinee.
+    int      k;                         // Iterateur sur les voisins.
+    int      est_vu;                    // Vrai si le voisin est du pixel courant a
+                                        // ete examine (et est eteint).
+    int      nb_points;                 // Le nombre de points de la bordure.
+    t_point* point;                     // Le point ajoute.
+
+    etiquettes = contours->etiquettes;
+    for(k = 0; k < NB_VOISINS; k++)
+        decalages[k] = VOISIN_LIGNE[k] * largeur + VOISIN_COLONNE[k];
+
+    // 3.1: le premier voisin allume, dans le sens horaire a partir du voisin
+    // eteint.
+    premier   = -1;
+    direction = 0;
+    for(k = 0; k < NB_VOISINS; k++)
+    {
+        d = (voisin + k) % NB_VOISINS;
+        if(etiquettes[depart + decalages[d]] != 0)
+        {
+            premier   = depart + decalages[d];
+            direction = d;
+            break;
+        }
+    }
+
+    nb_points = 0;
+
+    // Un pixel isole.
+    if(premier < 0)
+    {
+        if(!reserver((void**) &contours->points, &contours->capacite_points,
+                     contours->nb_points + 1, sizeof(t_point), CAPACITE_POINTS))
+            return -1;
+
+        point = &contours->points[contours->nb_points++];
+        point->ligne   = depart / largeur - 1;
+        point->colonne = depart % largeur - 1;
+        etiquettes[depart] = -numero;
+        return 1;
+    }
+
+    // 3.2 a 3.5: le tour de la bordure, dans le sens anti-horaire autour de
+    // chaque pixel a partir du pixel precedent.
+    courant = depart;
+    for(;;)
+    {
+        est_vu = FAUX;
+        for(k = 1; k <= NB_VOISINS; k++)
+        {
+            d = (direction - k + NB_VOISINS) % NB_VOISINS;
+            if(etiquettes[courant + decalages[d]] != 0)
+                break;
+            if(d == 0)
+                est_vu = VRAI;
+        }
+
+        if(!reserver((void**) &contours->points, &contours->capacite_points,
+                     contours->nb_points + 1, sizeof(t_point), CAPACITE_POINTS))
+            return -1;
+
+        point = &contours->points[contours->nb_points++];
+        point->ligne   = courant / largeur - 1;
+        point->colonne = courant % largeur - 1;
+        nb_points++;
+
+        if(est_vu)
+            etiquettes[courant] = -numero;
+        else if(etiquettes[courant] == 1)
+            etiquettes[courant] = numero;
+
+        if(courant + decalages[d] == depart && courant == premier)
+            break;
+
+        courant  += decalages[d];
+        direction = (d + NB_VOISINS / 2) % NB_VOISINS;
+    }
+
+    return nb_points;
+}
+
+
+
+static int comparer_points(const void* a, const void* b)
+{
+    const t_point* p = (const t_point*) a;
+    const t_point* q = (const t_point*) b;
+
+    if(p->colonne != q->colonne)
+        return p->colonne < q->colonne ? -1 : 1;
+    if(p->ligne != q->ligne)
+        return p->ligne < q->ligne ? -1 : 1;
+    return 0;
+}
+
+
+
+static int enveloppe_convexe(const t_point* points, int nb_points, t_point* enveloppe)
+{
+    int h;          // Le nombre de sommets retenus.
+    int bas;        // Le nombre de sommets de la chaine du bas.
+    int q;          // Iterateur sur les points.
+
+    // La chaine du bas, de gauche a droite.
+    h = 0;
+    for(q = 0; q < nb_points; q++)
+    {
+        while(h >= 2 && produit_vectoriel(enveloppe[h - 2], enveloppe[h - 1], points[q]) <= 0)
+            h--;
+        enveloppe[h++] = points[q];
+    }
+
+    // La chaine du haut, de droite a gauche.
+    bas = h + 1;
+    for(q = nb_points - 2; q >= 0; q--)
+    {
+        while(h >= bas && produit_vectoriel(enveloppe[h - 2], enveloppe[h - 1], points[q]) <= 0)
+            h--;
+        enveloppe[h++] = points[q];
+    }
+
+    // Le dernier sommet repete le premier; si tous les points sont confondus,
+    // il ne reste que celui-ci.
+    h = h > 1 ? h - 1 : h;
+    if(h == 2 && enveloppe[0].ligne == enveloppe[1].ligne &&
+       enveloppe[0].colonne == enveloppe[1].colonne)
+        h = 1;
+
+    return h;
+}
+
+
+
+static double produit_vectoriel(t_point o, t_point a, t_point b)
+{
+    return (double) (a.colonne - o.colonne) * (b.ligne - o.ligne) -
+           (double) (a.ligne - o.ligne) * (b.colonne - o.colonne);
+}
@@ -0,0 +1,243 @@
+/****************************************************************************************
+    CONTOURS.H
+
+    Ce module contient le suivi des bordures de Suzuki et Abe, qui trouve les
+    contours de toutes les composantes (8-connexes) d'une image binaire en un
+    seul balayage, ainsi que quelques mesures des contours trouves: la
+    simplification de Douglas-Peucker, le rectangle d'aire minimale et le test
+    de convexite, utilises pour retenir les plaques candidates.
+
+    Les points de tous les contours sont ranges dans une seule arene, et les
+    contours ne sont que des intervalles de cette arene. Un t_contours est
+    cree une fois et reutilise d'une image a l'autre: ses tableaux ne grandissent
+    que lorsqu'une image a plus de points ou de contours que les precedentes,
+    et aucune allocation n'est faite pour un contour en particulier.
+
+    Un contour est soit la bordure exterieure d'une composante, soit la
+    bordure d'un trou dans une composante. Chaque contour connait celui qui
+    l'entoure directement, ce qui donne la hierarchie des composantes et des
+    trous (par exemple, les caracteres a l'interieur d'une plaque).
+
+    Liste des sous-programmes publiques:
+      - creer_contours       : Cree un ensemble de contours vide;
+      - detruire_contours    : Libere un ensemble de contours;
+      - trouver_contours     : Trouve les contours d'une image binaire;
+      - simplifier_contours  : Simplifie tous les contours (Douglas-Peucker);
+      - rectangle_minimal    : Le rectangle d'aire minimale qui contient un contour;
+      - est_convexe          : Vrai si un contour est un polygone convexe.
+
+*****************************************************************************************/
+#ifndef CONTOURS
+#define CONTOURS
+
+#include "transformation.h"
+
+#include <stddef.h>
+
+
+/****************************************************************************************
+*                               DEFINTION DES CONSTANTES                                *
+****************************************************************************************/
+
+/*
+    T_POINT
+
+    Un pixel d'un contour.
+*/
+typedef struct
+{
+    int ligne;
+    int colonne;
+
+}t_point;
+
+
+/*
+    T_CONTOUR
+
+    Un contour: un intervalle de l'arene des points, dans l'ordre du suivi.
+*/
+typedef struct
+{
+    int debut;          // L'indice du premier point dans l'arene.
+    int nb_points;      // Le nombre de points du contour.
+    int parent;         // L'indice du contour qui entoure celui-ci, -1 si aucun.
+    int est_trou;       // 1 pour la bordure d'un trou, 0 pour une bordure exterieure.
+
+}t_contour;
+
+
+/*
+    T_CONTOURS
+
+    Les contours d'une image. Les champs points, nb_points, contours et
+    nb_contours peuvent etre lus directement; les autres ne servent qu'au
+    module.
+*/
+typedef struct
+{
+    t_point*   points;              // L'arene des points de tous les contours.
+    int        nb_points;
+    int        capacite_points;
+    t_contour* contours;            // Les contours, dans l'ordre du balayage.
+    int        nb_contours;
+    int        capacite_contours;
+    int*       etiquettes;          // Les numeros de bordure (image avec une marge).
+    size_t     taille_etiquettes;
+    void*      travail;             // L'espace de travail des mesures.
+    size_t     taille_travail;
+
+}t_contours;
+
+
+/*
+    T_RECTANGLE
+
+    Un rectangle oriente. Les coins sont des points (x, y) = (colonne, ligne),
+    dans l'ordre du tour du rectangle, comme les attend calculer_homographie.
+*/
+typedef struct
+{
+    double coins[NB_COINS][2];  // Les 4 coins.
+    double longueur;            // Le plus long cote.
+    double largeur;             // Le plus court cote.
+    double angle;               // L'angle du plus long cote avec l'horizontale, en
+                                // radians, entre -pi / 2 (exclu) et pi / 2.
+    double aire;                // longueur * largeur.
+
+}t_rectangle;
+
+
+/****************************************************************************************
+*                       DECLARATION DES FONCTIONS PUBLIQUES                             *
+****************************************************************************************/
+
+
+/*
+    CREER_CONTOURS
+
+    Cette fonction cree un ensemble de contours vide. Les tableaux sont alloues
+    au premier appel de trouver_contours.
+
+    Retour:
+        L'ensemble cree, ou NULL si la memoire manque.
+*/
+t_contours* creer_contours(void);
+
+
+
+/*
+    DETRUIRE_CONTOURS
+
+    Cette procedure libere un ensemble de contours et tous ses tableaux.
+
+    Parametres:
+        - [t_contours*] contours : L'ensemble a liberer (NULL est accepte).
+*/
+void detruire_contours(t_contours* contours);
+
+
+
+/*
+    TROUVER_CONTOURS
+
+    Cette fonction trouve les contours des composantes 8-connexes des pixels
+    plus grands que le seuil, en un seul balayage de l'image (Suzuki et Abe).
+    Les contours precedents de l'ensemble sont remplaces.
+
+    Une composante d'un seul pixel donne un contour d'un point. Un contour
+    repasse par les pixels des parties minces (d'un pixel de large), qui y
+    apparaissent donc plus d'une fois.
+
+    Parametres:
+        - [double**   ] image       : L'image binaire (ou une carte de contours).
+        - [int        ] nb_lignes   : Le nombre de lignes de l'image.
+        - [int        ] nb_colonnes : Le nombre de colonnes de l'image.
+        - [double     ] seuil       : Les pixels plus grands que le seuil sont allumes.
+        - [t_contours*] contours    : Recoit les contours.
+
+    Retour:
+        Le nombre de contours trouves, ou -1 si les parametres sont invalides
+        ou si la memoire manque.
+
+    Exemple d'utilisation:
+
+        t_contours* contours = creer_contours();
+        t_rectangle rectangle;
+        int         i;
+
+        trouver_contours(binaire, nb_lignes, nb_colonnes, 0.5, contours);
+        simplifier_contours(contours, 2.0);
+
+        for(i = 0; i < contours->nb_contours; i++)
+            if(!contours->contours[i].est_trou && est_convexe(contours, i) &&
+               rectangle_minimal(contours, i, &rectangle))
+                [ ... rectangle est une plaque candidate ... ]
+
+        detruire_contours(contours);
+*/
+int trouver_contours(double** image, int nb_lignes, int nb_colonnes, double seuil,
+                     t_contours* contours);
+
+
+
+/*
+    SIMPLIFIER_CONTOURS
+
+    Cette fonction simplifie chaque contour (ferme) par l'algorithme de
+    Douglas-Peucker: les points retenus sont tels qu'aucun point retire n'est
+    a plus de 'tolerance' pixels du polygone simplifie. Les contours sont
+    simplifies sur place, dans l'arene.
+
+    Parametres:
+        - [t_contours*] contours  : Les contours a simplifier.
+        - [double     ] tolerance : L'ecart maximal permis, en pixels.
+
+    Retour:
+        1 si les contours ont ete simplifies, 0 si la tolerance est negative ou
+        si la memoire manque (les contours sont alors inchanges).
+*/
+int simplifier_contours(t_contours* contours, double tolerance);
+
+
+
+/*
+    RECTANGLE_MINIMAL
+
+    Cette fonction calcule le rectangle d'aire minimale qui contient les
+    centres des pixels d'un contour, par les pieds a coulisse tournants
+    (rotating calipers) sur l'enveloppe convexe du contour.
+
+    Parametres:
+        - [t_contours* ] contours  : Les contours.
+        - [int         ] indice    : L'indice du contour.
+        - [t_rectangle*] rectangle : Recoit le rectangle.
+
+    Retour:
+        1 si le rectangle a ete calcule, 0 si l'indice est invalide ou si la
+        memoire manque.
+*/
+int rectangle_minimal(t_contours* contours, int indice, t_rectangle* rectangle);
+
+
+
+/*
+    EST_CONVEXE
+
+    Cette fonction verifie qu'un contour est un polygone convexe: il tourne
+    toujours dans le meme sens et en fait le tour une seule fois. Les points
+    repetes et alignes sont permis, mais pas les retours en arriere. Le test
+    est surtout utile sur un contour simplifie.
+
+    Parametres:
+        - [t_contours*] contours : Les contours.
+        - [int        ] indice   : L'indice du contour.
+
+    Retour:
+        1 si le contour est convexe, 0 sinon (ou si le contour a moins de 3
+        points distincts, ou si l'indice est invalide).
+*/
+int est_convexe(const t_contours* contours, int indice);
+
+
+#endif
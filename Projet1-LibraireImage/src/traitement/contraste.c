@@ -0,0 +1,377 @@
+/****************************************************************************************
+    CONTRASTE.C
+
+    Ce module contient l'egalisation par tuiles. La tuile (a, b) d'une
+    grille de T x U tuiles couvre les lignes a * nb_lignes / T a
+    (a + 1) * nb_lignes / T - 1, et de meme pour les colonnes; son centre
+    est a (a + 1/2) * nb_lignes / T.
+****************************************************************************************/
+#include "contraste.h"
+#include "../outils/instrumentation.h"
+#include "../outils/memoire.h"
+#include "../outils/parallele.h"
+
+#include <string.h>
+
+
+/****************************************************************************************
+*                               DEFINTION DES CONSTANTES                                *
+****************************************************************************************/
+
+#define VRAI    1
+#define FAUX    0
+
+// Le nombre de lignes interpolees par un fil a la fois.
+#define ELEMENTS_PAR_PAQUET     16
+
+
+/*
+    T_EGALISATION
+
+    Une egalisation en cours, partagee par les fils.
+*/
+typedef struct
+{
+    double**     image;
+    double**     resultat;
+    int          nb_lignes;
+    int          nb_colonnes;
+    int          tuiles_lignes;
+    int          tuiles_colonnes;
+    double       limite;
+    float*       tables;
+    const int*   tuiles;
+    const float* poids;
+
+}t_egalisation;
+
+
+/****************************************************************************************
+*                           DECLARATION DES FONCTIONS PRIVEES                           *
+****************************************************************************************/
+
+
+/*
+    TACHE_TABLES
+
+    Cette procedure (de type t_tache) calcule les tables des tuiles debut a
+    fin - 1, numerotees ligne de tuiles par ligne de tuiles.
+*/
+static void tache_tables(void* donnees, int debut, int fin);
+
+
+
+/*
+    TACHE_INTERPOLER
+
+    Cette procedure (de type t_tache) egalise les lignes debut a fin - 1.
+*/
+static void tache_interpoler(void* donnees, int debut, int fin);
+
+
+
+/*
+    NIVEAU
+
+    Cette fonction donne la classe d'un pixel entre 0 et 1: son niveau
+    arrondi, entre 0 et NB_NIVEAUX_GRIS - 1.
+*/
+static int niveau(double pixel);
+
+
+
+/*
+    POSITION_TUILE
+
+    Cette procedure situe un pixel entre les centres de deux tuiles voisines
+    (les memes au bord de l'image).
+
+    Parametres:
+        - [int   ] pixel     : La ligne ou la colonne du pixel.
+        - [int   ] taille    : Le nombre de lignes ou de colonnes de l'image.
+        - [int   ] nb_tuiles : Le nombre de tuiles dans cette direction.
+        - [int*  ] premiere  : Recoit la tuile dont le centre precede le pixel.
+        - [int*  ] seconde   : Recoit celle dont le centre le suit.
+        - [float*] poids     : Recoit le poids de la seconde, entre 0 et 1.
+*/
+static void position_tuile(int pixel, int taille, int nb_tuiles, int* premiere, int* seconde,
+                           float* poids);
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PUBLIQUES                            *
+****************************************************************************************/
+t_egaliseur* creer_egaliseur(void)
+{
+    t_egaliseur* egaliseur;     // L'egaliseur cree.
+
+    egaliseur = (t_egaliseur*) ALLOUER(sizeof(t_egaliseur));
+    if(egaliseur == NULL)
+        return NULL;
+    INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 1);
+
+    memset(egaliseur, 0, sizeof(t_egaliseur));
+
+    return egaliseur;
+}
+
+
+
+void detruire_egaliseur(t_egaliseur* egaliseur)
+{
+    if(egaliseur == NULL)
+        return;
+
+    LIBERER(egaliseur->tables);
+    LIBERER(egaliseur->tuiles);
+    LIBERER(egaliseur->poids);
+    LIBERER(egaliseur);
+}
+
+
+
+int egaliser_contraste(t_egaliseur* egaliseur, double** image, int nb_lignes,
+                       int nb_colonnes, int tuiles_lignes, int tuiles_colonnes,
+                       double limite, double** resultat)
+{
+    t_egalisation egalisation;  // L'egalisation partagee par les fils.
+    size_t        taille;       // Le nombre de reels des tables.
+    int           j;            // Iterateur sur les colonnes.
+
+    if(egaliseur == NULL || image == NULL || resultat == NULL || nb_lignes < 1 ||
+       nb_colonnes < 1 || tuiles_lignes < 1 || tuiles_colonnes < 1 ||
+       tuiles_lignes > nb_lignes || tuiles_colonnes > nb_colonnes || !(limite >= 1))
+        return FAUX;
+
+    INSTRUMENTER_DEBUT(ETAPE_CONTRASTE);
+
+    // Les tables et les colonnes ne grandissent qu'au besoin.
+    taille = (size_t) tuiles_lignes * tuiles_colonnes * NB_NIVEAUX_GRIS;
+    if(taille > egaliseur->capacite_tables)
+    {
+        LIBERER(egaliseur->tables);
+        egaliseur->capacite_tables = 0;
+        egaliseur->tables = (float*) ALLOUER(taille * sizeof(float));
+        if(egaliseur->tables == NULL)
+        {
+            INSTRUMENTER_FIN(ETAPE_CONTRASTE);
+            return FAUX;
+        }
+        INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 1);
+        egaliseur->capacite_tables = taille;
+    }
+
+    if(nb_colonnes > egaliseur->capacite_colonnes)
+    {
+        LIBERER(egaliseur->tuiles);
+        LIBERER(egaliseur->poids);
+        egaliseur->capacite_colonnes = 0;
+        egaliseur->tuiles = (int*) ALLOUER(2 * (size_t) nb_colonnes * sizeof(int));
+        egaliseur->poids  = (float*) ALLOUER((size_t) nb_colonnes * sizeof(float));
+        if(egaliseur->tuiles == NULL || egaliseur->poids == NULL)
+        {
+            INSTRUMENTER_FIN(ETAPE_CONTRASTE);
+            return FAUX;
+        }
+        INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 2);
+        egaliseur->capacite_colonnes = nb_colonnes;
+    }
+
+    // Les tuiles d'une colonne sont donnees par le debut de leur table dans
+    // une ligne de tuiles.
+    for(j = 0; j < nb_colonnes; j++)
+    {
+        position_tuile(j, nb_colonnes, tuiles_colonnes, &egaliseur->tuiles[2 * j],
+                       &egaliseur->tuiles[2 * j + 1], &egaliseur->poids[j]);
+        egaliseur->tuiles[2 * j]     *= NB_NIVEAUX_GRIS;
+        egaliseur->tuiles[2 * j + 1] *= NB_NIVEAUX_GRIS;
+    }
+
+    egalisation.image           = image;
+    egalisation.resultat        = resultat;
+    egalisation.nb_lignes       = nb_lignes;
+    egalisation.nb_colonnes     = nb_colonnes;
+    egalisation.tuiles_lignes   = tuiles_lignes;
+    egalisation.tuiles_colonnes = tuiles_colonnes;
+    egalisation.limite          = limite;
+    egalisation.tables          = egaliseur->tables;
+    egalisation.tuiles          = egaliseur->tuiles;
+    egalisation.poids           = egaliseur->poids;
+
+    // Tous les histogrammes sont faits avant qu'un pixel soit ecrit: le
+    // resultat peut etre l'image.
+    parallele_pour(tuiles_lignes * tuiles_colonnes, 1, tache_tables, &egalisation);
+    parallele_pour(nb_lignes, ELEMENTS_PAR_PAQUET, tache_interpoler, &egalisation);
+
+    INSTRUMENTER_FIN(ETAPE_CONTRASTE);
+
+    return VRAI;
+}
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PRIVEES                            *
+****************************************************************************************/
+
+
+static void tache_tables(void* donnees, int debut, int fin)
+{
+    const t_egalisation* egalisation = (const t_egalisation*) donnees;
+    int                  histogramme[NB_NIVEAUX_GRIS];  // L'histogramme de la tuile.
+    float*               table;         // La table de la tuile.
+    const double*        ligne;         // Une ligne de l'image.
+    long                 aire;          // Le nombre de pixels de la tuile.
+    long                 plafond;       // La hauteur maximale d'une classe.
+    long                 excedent;      // Les pixels retires des classes trop hautes.
+    long                 cumul;         // La fonction de repartition.
+    int                  reste;         // L'excedent qui ne se repartit pas egalement.
+    int                  intervalle;    // L'ecart des classes qui recoivent le reste.
+    int                  ligne_min;     // Les pixels de la tuile.
+    int                  ligne_max;
+    int                  colonne_min;
+    int                  colonne_max;
+    int                  t;             // Iterateur sur les tuiles.
+    int                  i, j;          // Iterateurs sur les pixels.
+    int                  v;             // Iterateur sur les classes.
+
+    for(t = debut; t < fin; t++)
+    {
+        ligne_min   = (int) ((long long) egalisation->nb_lignes *
+                             (t / egalisation->tuiles_colonnes) / egalisation->tuiles_lignes);
+        ligne_max   = (int) ((long long) egalisation->nb_lignes *
+                             (t / egalisation->tuiles_colonnes + 1) / egalisation->tuiles_lignes);
+        colonne_min = (int) ((long long) egalisation->nb_colonnes *
+                             (t % egalisation->tuiles_colonnes) / egalisation->tuiles_colonnes);
+        colonne_max = (int) ((long long) egalisation->nb_colonnes *
+                             (t % egalisation->tuiles_colonnes + 1) /
+                             egalisation->tuiles_colonnes);
+        aire        = (long) (ligne_max - ligne_min) * (colonne_max - colonne_min);
+        table       = egalisation->tables + (size_t) t * NB_NIVEAUX_GRIS;
+
+        memset(histogramme, 0, sizeof(histogramme));
+        for(i = ligne_min; i < ligne_max; i++)
+        {
+            ligne = egalisation->image[i];
+            for(j = colonne_min; j < colonne_max; j++)
+                histogramme[niveau(ligne[j])]++;
+        }
+
+        // Les classes sont plafonnees; l'excedent est reparti egalement, et
+        // ce qui reste, une unite par classe a intervalles reguliers.
+        plafond = (long) (egalisation->limite * aire / NB_NIVEAUX_GRIS);
+        if(plafond < 1)
+            plafond = 1;
+
+        excedent = 0;
+        for(v = 0; v < NB_NIVEAUX_GRIS; v++)
+        {
+            if(histogramme[v] > plafond)
+            {
+                excedent       += histogramme[v] - plafond;
+                histogramme[v]  = (int) plafond;
+            }
+        }
+
+        reste = (int) (excedent % NB_NIVEAUX_GRIS);
+        for(v = 0; v < NB_NIVEAUX_GRIS; v++)
+            histogramme[v] += (int) (excedent / NB_NIVEAUX_GRIS);
+        if(reste > 0)
+        {
+            intervalle = NB_NIVEAUX_GRIS / reste;
+            for(v = 0; v < NB_NIVEAUX_GRIS && reste > 0; v += intervalle, reste--)
+                histogramme[v]++;
+        }
+
+        cumul = 0;
+        for(v = 0; v < NB_NIVEAUX_GRIS; v++)
+        {
+            cumul    += histogramme[v];
+            table[v]  = (float) ((double) cumul / aire);
+        }
+    }
+}
+
+
+
+static void tache_interpoler(void* donnees, int debut, int fin)
+{
+    const t_egalisation*  egalisation = (const t_egalisation*) donnees;
+    const float*          haut;         // Les tables de la ligne de tuiles du dessus,
+    const float*          bas;          // et du dessous.
+    const double*         ligne;        // La ligne de l'image.
+    double*               egalisee;     // La ligne du resultat.
+    const int* restrict   tuiles;       // Les tuiles de chaque colonne.
+    const float* restrict poids;        // Les poids de chaque colonne.
+    float                 poids_bas;    // Le poids de la ligne de tuiles du dessous.
+    float                 dessus;       // Les valeurs interpolees horizontalement,
+    float                 dessous;      // dans les deux lignes de tuiles.
+    int                   premiere;     // Les lignes de tuiles qui entourent la ligne.
+    int                   seconde;
+    int                   v;            // La classe d'un pixel.
+    int                   i, j;         // Iterateurs sur les pixels.
+
+    tuiles = egalisation->tuiles;
+    poids  = egalisation->poids;
+
+    for(i = debut; i < fin; i++)
+    {
+        position_tuile(i, egalisation->nb_lignes, egalisation->tuiles_lignes, &premiere,
+                       &seconde, &poids_bas);
+        haut     = egalisation->tables + (size_t) premiere * egalisation->tuiles_colonnes *
+                                         NB_NIVEAUX_GRIS;
+        bas      = egalisation->tables + (size_t) seconde * egalisation->tuiles_colonnes *
+                                         NB_NIVEAUX_GRIS;
+        ligne    = egalisation->image[i];
+        egalisee = egalisation->resultat[i];
+
+        for(j = 0; j < egalisation->nb_colonnes; j++)
+        {
+            v           = niveau(ligne[j]);
+            dessus      = haut[tuiles[2 * j] + v] +
+                          poids[j] * (haut[tuiles[2 * j + 1] + v] - haut[tuiles[2 * j] + v]);
+            dessous     = bas[tuiles[2 * j] + v] +
+                          poids[j] * (bas[tuiles[2 * j + 1] + v] - bas[tuiles[2 * j] + v]);
+            egalisee[j] = dessus + poids_bas * (dessous - dessus);
+        }
+    }
+}
+
+
+
+static int niveau(double pixel)
+{
+    if(!(pixel > 0))
+        return 0;
+    if(pixel >= 1)
+        return NB_NIVEAUX_GRIS - 1;
+
+    return (int) (pixel * (NB_NIVEAUX_GRIS - 1) + 0.5);
+}
+
+
+
+static void position_tuile(int pixel, int taille, int nb_tuiles, int* premiere, int* seconde,
+                           float* poids)
+{
+    double position;    // La position du pixel, en tuiles, par rapport au premier centre.
+
+    position = (pixel + 0.5) * nb_tuiles / taille - 0.5;
+    if(position <= 0)
+    {
+        *premiere = 0;
+        *seconde  = 0;
+        *poids    = 0;
+    }
+    else if(position >= nb_tuiles - 1)
+    {
+        *premiere = nb_tuiles - 1;
+        *seconde  = nb_tuiles - 1;
+        *poids    = 0;
+    }
+    else
+    {
+        *premiere = (int) position;
+        *seconde  = *premiere + 1;
+        *poids    = (float) (position - *premiere);
+    }
+}
@@ -0,0 +1,129 @@
+/****************************************************************************************
+    CONTRASTE.H
+
+    Ce module contient l'egalisation adaptative de l'histogramme a contraste
+    limite (CLAHE) de Zuiderveld. L'image est decoupee en une grille de
+    tuiles, et chaque tuile recoit sa propre table d'egalisation: la
+    fonction de repartition de son histogramme. Pour que le bruit des zones
+    uniformes ne soit pas amplifie, les classes de l'histogramme sont
+    plafonnees a la limite et l'excedent est redistribue sur toutes les
+    classes. Chaque pixel recoit l'interpolation bilineaire des tables des
+    quatre tuiles dont les centres l'entourent, ce qui efface les frontieres
+    des tuiles.
+
+    Les histogrammes des tuiles sont calcules en parallele, puis les lignes
+    de l'image (voir parallele.h). Les tuiles et les poids d'interpolation de
+    chaque colonne sont calcules une fois par image plutot que par pixel.
+    Les tables et les poids sont gardes dans un t_egaliseur, reutilise d'une
+    image a l'autre.
+
+    Les pixels sont entre 0 et 1, comme ceux retournes par lire. Ils sont
+    repartis en NB_NIVEAUX_GRIS classes pour les histogrammes, et l'image
+    egalisee reste entre 0 et 1.
+
+    Liste des sous-programmes publiques:
+      - creer_egaliseur       : Cree un egaliseur et son espace de travail;
+      - detruire_egaliseur    : Libere un egaliseur;
+      - egaliser_contraste    : Egalise une image par tuiles (CLAHE).
+
+*****************************************************************************************/
+#ifndef CONTRASTE
+#define CONTRASTE
+
+#include <stddef.h>
+
+
+/****************************************************************************************
+*                               DEFINTION DES CONSTANTES                                *
+****************************************************************************************/
+
+// Le nombre de niveaux de gris (et de classes des histogrammes).
+#define NB_NIVEAUX_GRIS     256
+
+
+/*
+    T_EGALISEUR
+
+    L'espace de travail des egalisations. Les champs ne servent qu'au module.
+*/
+typedef struct
+{
+    float*  tables;                 // Les tables des tuiles, ligne de tuiles par
+    size_t  capacite_tables;        // ligne de tuiles.
+    int*    tuiles;                 // Pour chaque colonne, ses deux tuiles,
+    float*  poids;                  // et le poids de la seconde.
+    int     capacite_colonnes;
+
+}t_egaliseur;
+
+
+/****************************************************************************************
+*                       DECLARATION DES FONCTIONS PUBLIQUES                             *
+****************************************************************************************/
+
+
+/*
+    CREER_EGALISEUR
+
+    Cette fonction cree un egaliseur. Son espace de travail est alloue a la
+    premiere image.
+
+    Retour:
+        L'egaliseur, ou NULL si la memoire manque.
+*/
+t_egaliseur* creer_egaliseur(void);
+
+
+
+/*
+    DETRUIRE_EGALISEUR
+
+    Cette procedure libere un egaliseur et son espace de travail.
+
+    Parametres:
+        - [t_egaliseur*] egaliseur : L'egaliseur (NULL est accepte).
+*/
+void detruire_egaliseur(t_egaliseur* egaliseur);
+
+
+
+/*
+    EGALISER_CONTRASTE
+
+    Cette fonction egalise une image par tuiles, a contraste limite. Un
+    egaliseur ne doit etre utilise que par un fil a la fois.
+
+    Parametres:
+        - [t_egaliseur*] egaliseur       : L'egaliseur.
+        - [double**    ] image           : L'image, comme retournee par lire.
+        - [int         ] nb_lignes       : Le nombre de lignes de l'image.
+        - [int         ] nb_colonnes     : Le nombre de colonnes de l'image.
+        - [int         ] tuiles_lignes   : La grille des tuiles (par exemple 8 x 8),
+        - [int         ] tuiles_colonnes   au plus une tuile par pixel.
+        - [double      ] limite          : La hauteur maximale d'une classe, en
+                                           multiple de la hauteur moyenne (au
+                                           moins 1; 1 ne change presque rien,
+                                           une tres grande limite donne
+                                           l'egalisation sans limite).
+        - [double**    ] resultat        : Recoit l'image egalisee (deja
+                                           allouee). Ce peut etre l'image
+                                           elle-meme.
+
+    Retour:
+        1 si l'image a ete egalisee, 0 si les parametres sont invalides ou
+        si la memoire manque.
+
+    Exemple d'utilisation (avant le seuillage d'une image de nuit):
+
+        t_egaliseur* egaliseur = creer_egaliseur();
+
+        egaliser_contraste(egaliseur, image, nl, nc, 8, 8, 3.0, image);
+
+        detruire_egaliseur(egaliseur);
+*/
+int egaliser_contraste(t_egaliseur* egaliseur, double** image, int nb_lignes,
+                       int nb_colonnes, int tuiles_lignes, int tuiles_colonnes,
+                       double limite, double** resultat);
+
+
+#endif
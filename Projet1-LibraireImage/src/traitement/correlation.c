@@ -0,0 +1,437 @@
+/****************************************************************************************
+    CORRELATION.C
+
+    Ce module contient la correlation normalisee. Avec N pixels dans le
+    gabarit T (de moyenne mT) et, pour une fenetre W de l'image, S1 la somme
+    et S2 la somme des carres de ses pixels:
+
+        NCC = (somme W T - mT S1) / racine((S2 - S1^2 / N) (somme T^2 - N mT^2))
+
+    Seul le premier terme (somme W T) depend de la methode.
+****************************************************************************************/
+#include "correlation.h"
+#include "../outils/instrumentation.h"
+#include "../outils/memoire.h"
+#include "../outils/parallele.h"
+
+#include <math.h>
+#include <string.h>
+
+
+/****************************************************************************************
+*                               DEFINTION DES CONSTANTES                                *
+****************************************************************************************/
+
+#define VRAI    1
+#define FAUX    0
+
+// Le nombre de lignes du resultat traitees par un fil a la fois.
+#define ELEMENTS_PAR_PAQUET     16
+
+// La variance par pixel sous laquelle une fenetre (ou le gabarit) est
+// consideree uniforme.
+#define VARIANCE_MIN            1e-10
+
+// Le cout d'un element d'une FFT, par etage, relativement a une
+// multiplication-addition de la methode directe. La correlation par FFT fait
+// trois transformees; les deux methodes coutent alors autant pour un gabarit
+// d'environ 8 x 8 dans une image de 512 x 512.
+#define COUT_ELEMENT_FFT        1.5
+
+
+/*
+    T_CORRELATION
+
+    Une correlation en cours, partagee par les fils.
+*/
+typedef struct
+{
+    double**      image;
+    int           nb_colonnes;      // Le nombre de colonnes de l'image.
+    double**      gabarit;
+    int           nb_lignes_gabarit;
+    int           nb_colonnes_gabarit;
+    double        moyenne_gabarit;
+    double        variance_gabarit; // somme T^2 - N mT^2.
+    const double* somme1;           // Les images integrales, de nb_colonnes + 1
+    const double* somme2;           // colonnes.
+    int           nb_colonnes_resultat;
+    double**      resultat;
+
+}t_correlation;
+
+
+/****************************************************************************************
+*                           DECLARATION DES FONCTIONS PRIVEES                           *
+****************************************************************************************/
+
+
+/*
+    TACHE_DIRECTE / TACHE_NORMALISER
+
+    Ces procedures (de type t_tache) traitent les lignes debut a fin - 1 du
+    resultat: tache_directe y calcule la somme des produits de la fenetre et
+    du gabarit, tache_normaliser la change en correlation normalisee.
+
+    Parametres:
+        - [void*] donnees : La correlation (t_correlation*).
+        - [int  ] debut   : La premiere ligne.
+        - [int  ] fin     : La ligne qui suit la derniere.
+*/
+static void tache_directe(void* donnees, int debut, int fin);
+static void tache_normaliser(void* donnees, int debut, int fin);
+
+
+
+/*
+    CORRELER_FOURIER
+
+    Cette fonction calcule la somme des produits par FFT: la correlation
+    est la transformee inverse du produit du spectre de l'image par le
+    conjugue de celui du gabarit.
+
+    Retour: 1 si le calcul a ete fait, 0 si la memoire manque.
+*/
+static int correler_fourier(t_correlateur* correlateur, double** image, int nb_lignes,
+                            int nb_colonnes, double** gabarit, int nb_lignes_gabarit,
+                            int nb_colonnes_gabarit, double** resultat);
+
+
+
+/*
+    CALCULER_INTEGRALES
+
+    Cette fonction calcule les images integrales des pixels et de leurs
+    carres: l'element (i, j) est la somme du rectangle des i premieres
+    lignes et j premieres colonnes.
+
+    Retour: 1 si le calcul a ete fait, 0 si la memoire manque.
+*/
+static int calculer_integrales(t_correlateur* correlateur, double** image, int nb_lignes,
+                               int nb_colonnes);
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PUBLIQUES                            *
+****************************************************************************************/
+t_correlateur* creer_correlateur(void)
+{
+    t_correlateur* correlateur;     // Le correlateur cree.
+
+    correlateur = (t_correlateur*) ALLOUER(sizeof(t_correlateur));
+    if(correlateur == NULL)
+        return NULL;
+    INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 1);
+
+    memset(correlateur, 0, sizeof(t_correlateur));
+
+    return correlateur;
+}
+
+
+
+void detruire_correlateur(t_correlateur* correlateur)
+{
+    if(correlateur == NULL)
+        return;
+
+    detruire_plan_fft2d(correlateur->plan);
+    LIBERER(correlateur->spectres);
+    LIBERER(correlateur->integrales);
+    LIBERER(correlateur);
+}
+
+
+
+int correler(t_correlateur* correlateur, double** image, int nb_lignes, int nb_colonnes,
+             double** gabarit, int nb_lignes_gabarit, int nb_colonnes_gabarit, int methode,
+             double** resultat)
+{
+    t_correlation correlation;  // La correlation partagee par les fils.
+    double        cout_direct;  // Le nombre d'operations de chaque methode.
+    double        cout_fourier;
+    double        somme;        // Les sommes des pixels du gabarit.
+    double        somme_carres;
+    double        taille;       // Le nombre de pixels des images a transformer.
+    int           nb_lignes_resultat;
+    int           i, j;         // Iterateurs sur le gabarit.
+
+    if(correlateur == NULL || image == NULL || gabarit == NULL || resultat == NULL ||
+       nb_lignes_gabarit <= 0 || nb_colonnes_gabarit <= 0 ||
+       nb_lignes_gabarit > nb_lignes || nb_colonnes_gabarit > nb_colonnes ||
+       methode < CORRELATION_AUTOMATIQUE || methode > CORRELATION_FOURIER)
+        return -1;
+
+    INSTRUMENTER_DEBUT(ETAPE_CORRELER);
+
+    nb_lignes_resultat = nb_lignes - nb_lignes_gabarit + 1;
+
+    correlation.image                = image;
+    correlation.nb_colonnes          = nb_colonnes;
+    correlation.gabarit              = gabarit;
+    correlation.nb_lignes_gabarit    = nb_lignes_gabarit;
+    correlation.nb_colonnes_gabarit  = nb_colonnes_gabarit;
+    correlation.nb_colonnes_resultat = nb_colonnes - nb_colonnes_gabarit + 1;
+    correlation.resultat             = resultat;
+
+    if(methode == CORRELATION_AUTOMATIQUE)
+    {
+        cout_direct  = (double) nb_lignes_resultat * correlation.nb_colonnes_resultat *
+                       nb_lignes_gabarit * nb_colonnes_gabarit;
+        taille       = (double) taille_fft_rapide(nb_lignes) * taille_fft_rapide(nb_colonnes);
+        cout_fourier = 3 * COUT_ELEMENT_FFT * taille * log2(taille);
+        methode      = cout_direct <= cout_fourier ? CORRELATION_DIRECTE : CORRELATION_FOURIER;
+    }
+
+    // Les statistiques du gabarit.
+    somme        = 0;
+    somme_carres = 0;
+    for(i = 0; i < nb_lignes_gabarit; i++)
+    {
+        for(j = 0; j < nb_colonnes_gabarit; j++)
+        {
+            somme        += gabarit[i][j];
+            somme_carres += gabarit[i][j] * gabarit[i][j];
+        }
+    }
+    correlation.moyenne_gabarit  = somme / ((double) nb_lignes_gabarit * nb_colonnes_gabarit);
+    correlation.variance_gabarit = somme_carres - correlation.moyenne_gabarit * somme;
+
+    // Le numerateur, puis la normalisation.
+    if(methode == CORRELATION_DIRECTE)
+        parallele_pour(nb_lignes_resultat, ELEMENTS_PAR_PAQUET, tache_directe, &correlation);
+    else if(!correler_fourier(correlateur, image, nb_lignes, nb_colonnes, gabarit,
+                              nb_lignes_gabarit, nb_colonnes_gabarit, resultat))
+        methode = -1;
+
+    if(methode != -1 && !calculer_integrales(correlateur, image, nb_lignes, nb_colonnes))
+        methode = -1;
+
+    if(methode != -1)
+    {
+        correlation.somme1 = correlateur->integrales;
+        correlation.somme2 = correlateur->integrales + (size_t) (nb_lignes + 1) *
+                                                       (nb_colonnes + 1);
+        parallele_pour(nb_lignes_resultat, ELEMENTS_PAR_PAQUET, tache_normaliser,
+                       &correlation);
+    }
+
+    INSTRUMENTER_FIN(ETAPE_CORRELER);
+
+    return methode;
+}
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PRIVEES                            *
+****************************************************************************************/
+
+
+static void tache_directe(void* donnees, int debut, int fin)
+{
+    t_correlation* correlation = (t_correlation*) donnees;
+    double*        ligne;       // La ligne du resultat.
+    const double*  source;      // La ligne de l'image, decalee de la colonne du gabarit.
+    double         valeur;      // Le pixel du gabarit.
+    int            y;           // Iterateur sur les lignes du resultat.
+    int            i, j;        // Iterateurs sur le gabarit.
+    int            x;           // Iterateur sur les colonnes du resultat.
+
+    // Chaque pixel du gabarit s'ajoute, multiplie, a toute la ligne: la
+    // boucle interne est contigue.
+    for(y = debut; y < fin; y++)
+    {
+        ligne = correlation->resultat[y];
+        for(x = 0; x < correlation->nb_colonnes_resultat; x++)
+            ligne[x] = 0;
+
+        for(i = 0; i < correlation->nb_lignes_gabarit; i++)
+        {
+            for(j = 0; j < correlation->nb_colonnes_gabarit; j++)
+            {
+                valeur = correlation->gabarit[i][j];
+                source = correlation->image[y + i] + j;
+                for(x = 0; x < correlation->nb_colonnes_resultat; x++)
+                    ligne[x] += valeur * source[x];
+            }
+        }
+    }
+}
+
+
+
+static void tache_normaliser(void* donnees, int debut, int fin)
+{
+    t_correlation* correlation = (t_correlation*) donnees;
+    const double*  haut1;       // Les lignes des images integrales au-dessus et
+    const double*  bas1;        // au-dessous de la fenetre.
+    const double*  haut2;
+    const double*  bas2;
+    double*        ligne;       // La ligne du resultat.
+    double         n;           // Le nombre de pixels du gabarit.
+    double         s1, s2;      // Les sommes de la fenetre.
+    double         variance;    // La variance de la fenetre fois n.
+    double         denominateur;
+    double         valeur;      // La correlation.
+    int            largeur;     // La largeur des images integrales.
+    int            hauteur;     // La hauteur du gabarit.
+    int            w;           // La largeur du gabarit.
+    int            y, x;        // Iterateurs sur le resultat.
+
+    largeur = correlation->nb_colonnes + 1;
+    hauteur = correlation->nb_lignes_gabarit;
+    w       = correlation->nb_colonnes_gabarit;
+    n       = (double) hauteur * w;
+
+    for(y = debut; y < fin; y++)
+    {
+        ligne = correlation->resultat[y];
+        haut1 = correlation->somme1 + (size_t) y * largeur;
+        bas1  = haut1 + (size_t) hauteur * largeur;
+        haut2 = correlation->somme2 + (size_t) y * largeur;
+        bas2  = haut2 + (size_t) hauteur * largeur;
+
+        for(x = 0; x < correlation->nb_colonnes_resultat; x++)
+        {
+            s1       = bas1[x + w] - bas1[x] - haut1[x + w] + haut1[x];
+            s2       = bas2[x + w] - bas2[x] - haut2[x + w] + haut2[x];
+            variance = s2 - s1 * s1 / n;
+
+            if(variance <= VARIANCE_MIN * n || correlation->variance_gabarit <= VARIANCE_MIN * n)
+            {
+                ligne[x] = 0;
+                continue;
+            }
+
+            denominateur = sqrt(variance * correlation->variance_gabarit);
+            valeur       = (ligne[x] - correlation->moyenne_gabarit * s1) / denominateur;
+
+            // Les erreurs d'arrondi peuvent depasser un peu les bornes.
+            ligne[x] = valeur > 1 ? 1 : (valeur < -1 ? -1 : valeur);
+        }
+    }
+}
+
+
+
+static int correler_fourier(t_correlateur* correlateur, double** image, int nb_lignes,
+                            int nb_colonnes, double** gabarit, int nb_lignes_gabarit,
+                            int nb_colonnes_gabarit, double** resultat)
+{
+    t_plan_fft2d* plan;         // Le plan de la taille de l'image.
+    double*       image_r;      // Le spectre de l'image, puis le produit.
+    double*       image_i;
+    double*       gabarit_r;    // Le spectre du gabarit.
+    double*       gabarit_i;
+    double        produit_r;    // Un element du produit.
+    size_t        taille;       // Le nombre d'elements d'un spectre.
+    size_t        k;            // Iterateur sur les spectres.
+    int           nl, nc;       // La taille rapide de l'image.
+
+    // Le plan est garde tant que la taille des images ne change pas. Il
+    // suffit que la taille rapide couvre l'image: le gabarit est dedans, et
+    // les positions du resultat ne font pas le tour de l'image.
+    nl = taille_fft_rapide(nb_lignes);
+    nc = taille_fft_rapide(nb_colonnes);
+    if(nl < 0 || nc < 0)
+        return FAUX;
+
+    plan = correlateur->plan;
+    if(plan == NULL || plan->nb_lignes != nl || plan->nb_colonnes != nc)
+    {
+        detruire_plan_fft2d(plan);
+        correlateur->plan = plan = creer_plan_fft2d(nl, nc);
+        if(plan == NULL)
+            return FAUX;
+    }
+
+    taille = (size_t) plan->nb_lignes * plan->largeur;
+    if(4 * taille > correlateur->capacite_spectres)
+    {
+        LIBERER(correlateur->spectres);
+        correlateur->spectres = (double*) ALLOUER(4 * taille * sizeof(double));
+        correlateur->capacite_spectres = correlateur->spectres != NULL ? 4 * taille : 0;
+        if(correlateur->spectres == NULL)
+            return FAUX;
+        INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 1);
+    }
+
+    image_r   = correlateur->spectres;
+    image_i   = image_r + taille;
+    gabarit_r = image_i + taille;
+    gabarit_i = gabarit_r + taille;
+
+    fft2d_reelle(plan, image, nb_lignes, nb_colonnes, image_r, image_i);
+    fft2d_reelle(plan, gabarit, nb_lignes_gabarit, nb_colonnes_gabarit, gabarit_r, gabarit_i);
+
+    // I * conj(T).
+    for(k = 0; k < taille; k++)
+    {
+        produit_r  = image_r[k] * gabarit_r[k] + image_i[k] * gabarit_i[k];
+        image_i[k] = image_i[k] * gabarit_r[k] - image_r[k] * gabarit_i[k];
+        image_r[k] = produit_r;
+    }
+
+    fft2d_reelle_inverse(plan, image_r, image_i, resultat,
+                         nb_lignes - nb_lignes_gabarit + 1,
+                         nb_colonnes - nb_colonnes_gabarit + 1);
+
+    return VRAI;
+}
+
+
+
+static int calculer_integrales(t_correlateur* correlateur, double** image, int nb_lignes,
+                               int nb_colonnes)
+{
+    double* somme1;         // Les images integrales.
+    double* somme2;
+    double* haut1;          // Les lignes i et i + 1 des images integrales.
+    double* bas1;
+    double* haut2;
+    double* bas2;
+    double  ligne1;         // Les sommes de la ligne courante.
+    double  ligne2;
+    size_t  taille;         // Le nombre d'elements d'une image integrale.
+    int     largeur;        // La largeur d'une image integrale.
+    int     i, j;           // Iterateurs sur l'image.
+
+    largeur = nb_colonnes + 1;
+    taille  = (size_t) (nb_lignes + 1) * largeur;
+    if(2 * taille > correlateur->capacite_integrales)
+    {
+        LIBERER(correlateur->integrales);
+        correlateur->integrales = (double*) ALLOUER(2 * taille * sizeof(double));
+        correlateur->capacite_integrales = correlateur->integrales != NULL ? 2 * taille : 0;
+        if(correlateur->integrales == NULL)
+            return FAUX;
+        INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 1);
+    }
+
+    somme1 = correlateur->integrales;
+    somme2 = somme1 + taille;
+
+    memset(somme1, 0, largeur * sizeof(double));
+    memset(somme2, 0, largeur * sizeof(double));
+    for(i = 0; i < nb_lignes; i++)
+    {
+        haut1 = somme1 + (size_t) i * largeur;
+        haut2 = somme2 + (size_t) i * largeur;
+        bas1  = haut1 + largeur;
+        bas2  = haut2 + largeur;
+
+        bas1[0] = 0;
+        bas2[0] = 0;
+        ligne1  = 0;
+        ligne2  = 0;
+        for(j = 0; j < nb_colonnes; j++)
+        {
+            ligne1 += image[i][j];
+            ligne2 += image[i][j] * image[i][j];
+            bas1[j + 1] = haut1[j + 1] + ligne1;
+            bas2[j + 1] = haut2[j + 1] + ligne2;
+        }
+    }
+
+    return VRAI;
+}
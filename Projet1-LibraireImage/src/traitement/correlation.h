@@ -0,0 +1,140 @@
+/****************************************************************************************
+    CORRELATION.H
+
+    Ce module contient la correlation croisee normalisee (NCC) d'un gabarit
+    avec toutes les positions d'une image. A chaque position, la fenetre de
+    l'image et le gabarit sont centres et la correlation vaut 1 pour une
+    fenetre qui est une transformation affine (a x + b, a > 0) du gabarit,
+    -1 pour une image inversee; elle ne depend donc ni de la luminosite ni
+    du contraste.
+
+    Le numerateur (la somme des produits de la fenetre et du gabarit) est
+    calcule soit directement, en temps proportionnel au nombre de positions
+    fois la taille du gabarit, soit par FFT (voir fourier.h), en temps
+    proportionnel a n log n pour une image de n pixels quelle que soit la
+    taille du gabarit. La methode la moins chere est choisie d'apres la
+    taille du gabarit. Les sommes des fenetres (pour la moyenne et l'ecart
+    type) viennent d'images integrales.
+
+    Les plans de FFT et les spectres sont gardes dans un t_correlateur,
+    reutilise d'un appel a l'autre: pour une image de meme taille, les
+    facteurs de rotation ne sont pas recalcules et rien n'est alloue. Un
+    correlateur ne doit etre utilise que par un fil a la fois. La methode
+    directe et la normalisation sont reparties sur plusieurs fils (voir
+    parallele.h).
+
+    Liste des sous-programmes publiques:
+      - creer_correlateur     : Cree un correlateur et son espace de travail;
+      - detruire_correlateur  : Libere un correlateur;
+      - correler              : La correlation normalisee d'un gabarit avec une image.
+
+*****************************************************************************************/
+#ifndef CORRELATION
+#define CORRELATION
+
+#include "fourier.h"
+
+#include <stddef.h>
+
+
+/****************************************************************************************
+*                               DEFINTION DES CONSTANTES                                *
+****************************************************************************************/
+
+// Les methodes de calcul du numerateur.
+#define CORRELATION_AUTOMATIQUE     0   // La moins chere des deux.
+#define CORRELATION_DIRECTE         1
+#define CORRELATION_FOURIER         2
+
+
+/*
+    T_CORRELATEUR
+
+    L'espace de travail des correlations. Les champs ne servent qu'au module.
+*/
+typedef struct
+{
+    t_plan_fft2d* plan;                 // Le plan de la derniere taille d'image.
+    double*       spectres;             // Les spectres de l'image et du gabarit.
+    size_t        capacite_spectres;
+    double*       integrales;           // Les images integrales des pixels et de
+    size_t        capacite_integrales;  // leurs carres.
+
+}t_correlateur;
+
+
+/****************************************************************************************
+*                       DECLARATION DES FONCTIONS PUBLIQUES                             *
+****************************************************************************************/
+
+
+/*
+    CREER_CORRELATEUR
+
+    Cette fonction cree un correlateur. Son espace de travail est alloue a
+    la premiere correlation.
+
+    Retour:
+        Le correlateur, ou NULL si la memoire manque.
+*/
+t_correlateur* creer_correlateur(void);
+
+
+
+/*
+    DETRUIRE_CORRELATEUR
+
+    Cette procedure libere un correlateur et son espace de travail.
+
+    Parametres:
+        - [t_correlateur*] correlateur : Le correlateur (NULL est accepte).
+*/
+void detruire_correlateur(t_correlateur* correlateur);
+
+
+
+/*
+    CORRELER
+
+    Cette fonction calcule la correlation normalisee du gabarit a chaque
+    position de l'image ou il entre au complet. La correlation d'une fenetre
+    uniforme (ou d'un gabarit uniforme) est mise a 0.
+
+    Parametres:
+        - [t_correlateur*] correlateur : Le correlateur.
+        - [double**      ] image       : L'image.
+        - [int           ] nb_lignes   : Le nombre de lignes de l'image.
+        - [int           ] nb_colonnes : Le nombre de colonnes de l'image.
+        - [double**      ] gabarit     : Le gabarit, au plus de la taille de l'image.
+        - [int           ] nb_lignes_gabarit
+        - [int           ] nb_colonnes_gabarit
+        - [int           ] methode     : CORRELATION_AUTOMATIQUE, CORRELATION_DIRECTE
+                                         ou CORRELATION_FOURIER.
+        - [double**      ] resultat    : Recoit les correlations (deja allouee):
+                                         nb_lignes - nb_lignes_gabarit + 1 lignes de
+                                         nb_colonnes - nb_colonnes_gabarit + 1 valeurs.
+                                         resultat[y][x] est la correlation du gabarit
+                                         place en (y, x).
+
+    Retour:
+        La methode utilisee, ou -1 si les parametres sont invalides ou si la
+        memoire manque.
+
+    Exemple d'utilisation (retrouver un caractere dans une plaque):
+
+        t_correlateur* correlateur = creer_correlateur();
+        double**       scores      = creer_tableau2d(nl - 24 + 1, nc - 16 + 1);
+
+        correler(correlateur, plaque, nl, nc, caractere, 24, 16,
+                 CORRELATION_AUTOMATIQUE, scores);
+
+        [ ... les maximums de scores proches de 1 sont les occurrences ... ]
+
+        detruire_correlateur(correlateur);
+*/
+int correler(t_correlateur* correlateur, double** image, int nb_lignes, int nb_colonnes,
+             double** gabarit, int nb_lignes_gabarit, int nb_colonnes_gabarit, int methode,
+             double** resultat);
+
+
+#endif
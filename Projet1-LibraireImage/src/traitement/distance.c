@@ -0,0 +1,253 @@
+/****************************************************************************************
+    DISTANCE.C
+
+    Ce module contient la transformee en distance de Felzenszwalb et 
+    Huttenlocher. La passe des colonnes donne la distance au carre a la cible
+    la plus proche dans la meme colonne; la passe des lignes combine ces
+    distances pour obtenir la distance au carre exacte, dont on prend la
+    racine.
+****************************************************************************************/
+#include "distance.h"
+#include "../outils/instrumentation.h"
+#include "../outils/memoire.h"
+#include "../outils/parallele.h"
+
+#include <math.h>
+#include <stdatomic.h>
+
+
+/****************************************************************************************
+*                               DEFINTION DES CONSTANTES                                *
+****************************************************************************************/
+
+#define VRAI    1
+#define FAUX    0
+
+// La distance au carre d'un pixel qui n'a pas encore de cible. Elle est finie
+// pour que les intersections des paraboles restent calculables.
+#define DISTANCE_CARREE_MAX     (DISTANCE_MAX * DISTANCE_MAX)
+
+// Le nombre de colonnes ou de lignes traitees par un fil a la fois.
+#define ELEMENTS_PAR_PAQUET     32
+
+
+/*
+    T_DISTANCES
+
+    Une transformee en cours, partagee par les fils.
+*/
+typedef struct
+{
+    double** image;         // L'image binaire.
+    int      nb_lignes;
+    int      nb_colonnes;
+    double   seuil;         // Le seuil des pixels allumes.
+    int      cible;         // PIXELS_ALLUMES ou PIXELS_ETEINTS.
+    double** distances;     // Les distances calculees.
+    atomic_int a_echoue;    // Vrai si un fil a manque de memoire.
+
+}t_distances;
+
+
+/****************************************************************************************
+*                           DECLARATION DES FONCTIONS PRIVEES                           *
+****************************************************************************************/
+
+
+/*
+    DISTANCE_1D
+
+    Cette procedure calcule la transformee en distance au carre d'une suite:
+    d[q] = min sur p de (q - p)^2 + f[p], par l'enveloppe inferieure des
+    paraboles.
+
+    Parametres:
+        - [double*] f         : Les valeurs de depart (n elements).
+        - [double*] d         : Recoit les distances au carre (n elements).
+        - [int    ] n         : Le nombre d'elements.
+        - [int*   ] sommets   : Espace de travail: n entiers.
+        - [double*] frontieres: Espace de travail: n + 1 reels.
+*/
+static void distance_1d(const double* f, double* d, int n, int* sommets, double* frontieres);
+
+
+
+/*
+    PASSE_COLONNES / PASSE_LIGNES
+
+    Ces procedures (de type t_tache) traitent les colonnes (ou les lignes)
+    debut a fin - 1.
+
+    Parametres:
+        - [void*] donnees : La transformee (t_distances*).
+        - [int  ] debut   : La premiere colonne (ou ligne).
+        - [int  ] fin     : La colonne (ou ligne) qui suit la derniere.
+*/
+static void passe_colonnes(void* donnees, int debut, int fin);
+static void passe_lignes(void* donnees, int debut, int fin);
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PUBLIQUES                            *
+****************************************************************************************/
+int calculer_distances(double** image, int nb_lignes, int nb_colonnes, double seuil,
+                       int cible, double** distances)
+{
+    t_distances transformee;    // La transformee partagee par les fils.
+
+    if(image == NULL || distances == NULL || nb_lignes <= 0 || nb_colonnes <= 0 ||
+       (cible != PIXELS_ALLUMES && cible != PIXELS_ETEINTS))
+        return FAUX;
+
+    INSTRUMENTER_DEBUT(ETAPE_DISTANCES);
+
+    transformee.image       = image;
+    transformee.nb_lignes   = nb_lignes;
+    transformee.nb_colonnes = nb_colonnes;
+    transformee.seuil       = seuil;
+    transformee.cible       = cible;
+    transformee.distances   = distances;
+    atomic_init(&transformee.a_echoue, FAUX);
+
+    // La passe des lignes a besoin de toutes les colonnes.
+    parallele_pour(nb_colonnes, ELEMENTS_PAR_PAQUET, passe_colonnes, &transformee);
+    if(!atomic_load(&transformee.a_echoue))
+        parallele_pour(nb_lignes, ELEMENTS_PAR_PAQUET, passe_lignes, &transformee);
+
+    INSTRUMENTER_FIN(ETAPE_DISTANCES);
+
+    return !atomic_load(&transformee.a_echoue);
+}
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PRIVEES                            *
+****************************************************************************************/
+
+
+static void distance_1d(const double* f, double* d, int n, int* sommets, double* frontieres)
+{
+    int    k;       // Le nombre de paraboles de l'enveloppe, moins 1.
+    int    q;       // Iterateur sur les elements.
+    double s;       // L'intersection de la parabole q et de la derniere retenue.
+
+    // L'enveloppe commence avec la parabole 0, qui couvre tout l'axe.
+    k             = 0;
+    sommets[0]    = 0;
+    frontieres[0] = -DISTANCE_CARREE_MAX;
+    frontieres[1] =  DISTANCE_CARREE_MAX;
+
+    for(q = 1; q < n; q++)
+    {
+        // Les paraboles cachees par la nouvelle sont retirees de l'enveloppe.
+        // Une intersection est toujours plus grande que -DISTANCE_CARREE_MAX,
+        // ce qui arrete la boucle a la premiere parabole.
+        for(;;)
+        {
+            s = ((f[q] + (double) q * q) - (f[sommets[k]] + (double) sommets[k] * sommets[k])) /
+                (2.0 * (q - sommets[k]));
+            if(s > frontieres[k])
+                break;
+            k--;
+        }
+
+        k++;
+        sommets[k]        = q;
+        frontieres[k]     = s;
+        frontieres[k + 1] = DISTANCE_CARREE_MAX;
+    }
+
+    // Chaque element prend la valeur de la parabole qui le couvre.
+    k = 0;
+    for(q = 0; q < n; q++)
+    {
+        while(frontieres[k + 1] < q)
+            k++;
+        d[q] = (double) (q - sommets[k]) * (q - sommets[k]) + f[sommets[k]];
+    }
+}
+
+
+static void passe_colonnes(void* donnees, int debut, int fin)
+{
+    t_distances* transformee;   // La transformee.
+    double*      f;             // La colonne de depart.
+    double*      d;             // La colonne calculee.
+    double*      frontieres;    // Les espaces de travail de distance_1d.
+    int*         sommets;
+    int          n;             // Le nombre de lignes.
+    int          i, j;          // Iterateurs sur les lignes et les colonnes.
+    int          est_allume;    // Vrai si un pixel est superieur au seuil.
+
+    transformee = (t_distances*) donnees;
+    n           = transformee->nb_lignes;
+
+    // Un seul bloc pour les espaces de travail d'un paquet.
+    f = (double*) ALLOUER((size_t) n * (3 * sizeof(double) + sizeof(int)) + sizeof(double));
+    if(f == NULL)
+    {
+        atomic_store(&transformee->a_echoue, VRAI);
+        return;
+    }
+    INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 1);
+    d          = f + n;
+    frontieres = d + n;
+    sommets    = (int*) (frontieres + n + 1);
+
+    for(j = debut; j < fin; j++)
+    {
+        // Une cible est a distance 0, les autres pixels sont a l'infini. La
+        // colonne est lue au complet avant d'etre ecrite: les distances 
+        // peuvent remplacer l'image.
+        for(i = 0; i < n; i++)
+        {
+            est_allume = transformee->image[i][j] > transformee->seuil;
+            f[i] = est_allume == transformee->cible ? 0.0 : DISTANCE_CARREE_MAX;
+        }
+
+        distance_1d(f, d, n, sommets, frontieres);
+
+        for(i = 0; i < n; i++)
+            transformee->distances[i][j] = d[i];
+    }
+
+    LIBERER(f);
+}
+
+
+static void passe_lignes(void* donnees, int debut, int fin)
+{
+    t_distances* transformee;   // La transformee.
+    double*      d;             // La ligne calculee.
+    double*      frontieres;    // Les espaces de travail de distance_1d.
+    int*         sommets;
+    double*      ligne;         // La ligne des distances en cours.
+    int          n;             // Le nombre de colonnes.
+    int          i, j;          // Iterateurs sur les lignes et les colonnes.
+
+    transformee = (t_distances*) donnees;
+    n           = transformee->nb_colonnes;
+
+    d = (double*) ALLOUER((size_t) n * (2 * sizeof(double) + sizeof(int)) + sizeof(double));
+    if(d == NULL)
+    {
+        atomic_store(&transformee->a_echoue, VRAI);
+        return;
+    }
+    INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 1);
+    frontieres = d + n;
+    sommets    = (int*) (frontieres + n + 1);
+
+    for(i = debut; i < fin; i++)
+    {
+        ligne = transformee->distances[i];
+
+        distance_1d(ligne, d, n, sommets, frontieres);
+
+        // Une ligne sans cible dans aucune colonne reste a l'infini.
+        for(j = 0; j < n; j++)
+            ligne[j] = d[j] < DISTANCE_CARREE_MAX ? sqrt(d[j]) : DISTANCE_MAX;
+    }
+
+    LIBERER(d);
+}
@@ -0,0 +1,71 @@
+/****************************************************************************************
+    DISTANCE.H
+
+    Ce module contient la transformee en distance euclidienne exacte d'une
+    image binaire: chaque pixel recoit la distance au pixel cible le plus
+    proche. Elle sert par exemple a estimer l'epaisseur des traits d'un
+    caractere (la distance au fond, au centre du trait) ou a comparer des
+    squelettes.
+
+    L'algorithme est celui de Felzenszwalb et Huttenlocher: la distance au
+    carre est separable, et chaque passe (colonnes, puis lignes) calcule en
+    temps lineaire l'enveloppe inferieure des paraboles centrees sur les
+    pixels. Le cout total est proportionnel au nombre de pixels. Les colonnes,
+    puis les lignes, sont reparties sur plusieurs fils (voir parallele.h).
+
+    Liste des sous-programmes publiques:
+      - calculer_distances : La distance de chaque pixel a la cible la plus proche.
+
+*****************************************************************************************/
+#ifndef DISTANCE
+#define DISTANCE
+
+
+/****************************************************************************************
+*                               DEFINTION DES CONSTANTES                                *
+****************************************************************************************/
+
+// Les pixels cibles.
+#define PIXELS_ETEINTS      0   // Les pixels inferieurs ou egaux au seuil.
+#define PIXELS_ALLUMES      1   // Les pixels superieurs au seuil.
+
+// La distance donnee a tous les pixels d'une image sans aucun pixel cible.
+#define DISTANCE_MAX        1e10
+
+
+/****************************************************************************************
+*                       DECLARATION DES FONCTIONS PUBLIQUES                             *
+****************************************************************************************/
+
+
+/*
+    CALCULER_DISTANCES
+
+    Cette fonction calcule, pour chaque pixel, la distance euclidienne (en
+    pixels) au pixel cible le plus proche. Les pixels cibles sont a 0.
+
+    Parametres:
+        - [double**] image       : L'image binaire (ou a seuiller).
+        - [int     ] nb_lignes   : Le nombre de lignes de l'image.
+        - [int     ] nb_colonnes : Le nombre de colonnes de l'image.
+        - [double  ] seuil       : Le seuil qui separe les pixels allumes et eteints.
+        - [int     ] cible       : PIXELS_ALLUMES ou PIXELS_ETEINTS.
+        - [double**] distances   : Recoit les distances (deja allouee). Ce peut
+                                   etre l'image elle-meme.
+
+    Retour:
+        1 si les distances ont ete calculees, 0 si les parametres sont 
+        invalides ou si la memoire manque.
+
+    Exemple d'utilisation (l'epaisseur des traits noirs d'une plaque):
+
+        calculer_distances(plaque, nb_lignes, nb_colonnes, 0.5, PIXELS_ALLUMES,
+                           distances);
+
+        [ ... sur les traits, distances[i][j] est la demi-epaisseur locale ... ]
+*/
+int calculer_distances(double** image, int nb_lignes, int nb_colonnes, double seuil,
+                       int cible, double** distances);
+
+
+#endif
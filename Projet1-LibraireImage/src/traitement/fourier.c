@@ -0,0 +1,687 @@
+/****************************************************************************************
+    FOURIER.C
+
+    Ce module contient la FFT de Stockham. Apres les etages de longueur
+    cumulee l, l'element j de la transformee de la sous-suite k (les
+    elements k, k + m, k + 2m, ... avec m = taille / l) est a la place
+    j * m + k. Un etage de base p combine p sous-suites voisines: les blocs
+    de m / p elements lus et ecrits sont contigus, quel que soit l'etage.
+****************************************************************************************/
+#include "fourier.h"
+#include "../outils/instrumentation.h"
+#include "../outils/memoire.h"
+
+#include <limits.h>
+#include <math.h>
+#include <string.h>
+
+
+/****************************************************************************************
+*                               DEFINTION DES CONSTANTES                                *
+****************************************************************************************/
+
+#define VRAI    1
+#define FAUX    0
+
+#define PI      3.14159265358979323846
+
+// Les constantes des papillons de base 3 et 5.
+#define SIN_60      0.86602540378443864676      // sin(2 pi / 3)
+#define COS_72      0.30901699437494742410      // cos(2 pi / 5)
+#define COS_144     (-0.80901699437494742410)   // cos(4 pi / 5)
+#define SIN_72      0.95105651629515357212      // sin(2 pi / 5)
+#define SIN_144     0.58778525229247312917      // sin(4 pi / 5)
+
+
+/****************************************************************************************
+*                           DECLARATION DES FONCTIONS PRIVEES                           *
+****************************************************************************************/
+
+
+/*
+    ETAGE_2 / ETAGE_3 / ETAGE_4 / ETAGE_5
+
+    Ces procedures calculent un etage de la FFT: pour chaque j < l, les p
+    blocs d'entree (j * p + q) * bloc sont tournes de w^(q j) puis combines
+    par une DFT de p points en p blocs de sortie (j + l * s) * bloc.
+
+    Parametres:
+        - [int    ] l          : La longueur des transformees deja calculees.
+        - [int    ] bloc       : Le nombre d'elements contigus d'un bloc.
+        - [double*] wr, wi     : Les facteurs de rotation de l'etage.
+        - [double*] xr, xi     : L'entree.
+        - [double*] yr, yi     : La sortie.
+*/
+static void etage_2(int l, int bloc, const double* wr, const double* wi,
+                    const double* restrict xr, const double* restrict xi,
+                    double* restrict yr, double* restrict yi);
+static void etage_3(int l, int bloc, const double* wr, const double* wi,
+                    const double* restrict xr, const double* restrict xi,
+                    double* restrict yr, double* restrict yi);
+static void etage_4(int l, int bloc, const double* wr, const double* wi,
+                    const double* restrict xr, const double* restrict xi,
+                    double* restrict yr, double* restrict yi);
+static void etage_5(int l, int bloc, const double* wr, const double* wi,
+                    const double* restrict xr, const double* restrict xi,
+                    double* restrict yr, double* restrict yi);
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PUBLIQUES                            *
+****************************************************************************************/
+int taille_fft_rapide(int taille)
+{
+    long candidate;     // La taille essayee.
+    long reste;         // Ce qui reste de la taille apres les facteurs 2, 3 et 5.
+
+    if(taille < 1)
+        taille = 1;
+
+    for(candidate = taille; candidate <= INT_MAX; candidate++)
+    {
+        reste = candidate;
+        while(reste % 2 == 0)
+            reste /= 2;
+        while(reste % 3 == 0)
+            reste /= 3;
+        while(reste % 5 == 0)
+            reste /= 5;
+
+        if(reste == 1)
+            return (int) candidate;
+    }
+
+    return -1;
+}
+
+
+
+t_plan_fft* creer_plan_fft(int taille)
+{
+    static const int BASES[] = { 4, 2, 3, 5 };  // Les bases, dans l'ordre des etages.
+
+    t_plan_fft* plan;       // Le plan cree.
+    size_t      nb_rotations;   // Le nombre de facteurs de rotation.
+    double*     wr;         // Les facteurs d'un etage.
+    double*     wi;
+    double      angle;      // L'angle d'un facteur.
+    int         reste;      // Ce qui reste de la taille a factoriser.
+    int         l;          // La longueur cumulee des etages precedents.
+    int         p;          // La base de l'etage.
+    int         b, e, j, q; // Iterateurs sur les bases, etages et facteurs.
+
+    if(taille < 1)
+        return NULL;
+
+    plan = (t_plan_fft*) ALLOUER(sizeof(t_plan_fft));
+    if(plan == NULL)
+        return NULL;
+
+    plan->taille    = taille;
+    plan->nb_etages = 0;
+    plan->rotations = NULL;
+
+    // La factorisation, et la place des facteurs de chaque etage.
+    reste        = taille;
+    l            = 1;
+    nb_rotations = 0;
+    for(b = 0; b < (int) (sizeof(BASES) / sizeof(BASES[0])); b++)
+    {
+        while(reste % BASES[b] == 0 && plan->nb_etages < NB_ETAGES_MAX)
+        {
+            plan->bases[plan->nb_etages]  = BASES[b];
+            plan->debuts[plan->nb_etages] = (int) nb_rotations;
+            plan->nb_etages++;
+
+            nb_rotations += 2 * (size_t) (BASES[b] - 1) * l;
+            reste /= BASES[b];
+            l     *= BASES[b];
+        }
+    }
+
+    if(reste != 1)
+    {
+        LIBERER(plan);
+        return NULL;
+    }
+
+    plan->rotations = (double*) ALLOUER((nb_rotations > 0 ? nb_rotations : 1) * sizeof(double));
+    if(plan->rotations == NULL)
+    {
+        LIBERER(plan);
+        return NULL;
+    }
+    INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 2);
+
+    // Le facteur (j, q) d'un etage de longueur cumulee l * p est w^(q j),
+    // avec w = exp(-2 pi i / (l * p)).
+    l = 1;
+    for(e = 0; e < plan->nb_etages; e++)
+    {
+        p  = plan->bases[e];
+        wr = plan->rotations + plan->debuts[e];
+        wi = wr + (size_t) (p - 1) * l;
+
+        for(j = 0; j < l; j++)
+        {
+            for(q = 1; q < p; q++)
+            {
+                angle = -2.0 * PI * q * j / ((double) l * p);
+                wr[j * (p - 1) + q - 1] = cos(angle);
+                wi[j * (p - 1) + q - 1] = sin(angle);
+            }
+        }
+        l *= p;
+    }
+
+    return plan;
+}
+
+
+
+void detruire_plan_fft(t_plan_fft* plan)
+{
+    if(plan == NULL)
+        return;
+
+    LIBERER(plan->rotations);
+    LIBERER(plan);
+}
+
+
+
+void fft(const t_plan_fft* plan, double* reels, double* imaginaires, int lot, int sens,
+         double* travail)
+{
+    const double* wr;       // Les facteurs de rotation de l'etage.
+    const double* wi;
+    double*       xr;       // L'entree de l'etage.
+    double*       xi;
+    double*       yr;       // La sortie de l'etage.
+    double*       yi;
+    double*       echange;  // Pour echanger deux pointeurs.
+    size_t        nb;       // Le nombre d'elements du lot.
+    int           bloc;     // Le nombre d'elements contigus d'un bloc.
+    int           l;        // La longueur cumulee des etages precedents.
+    int           p;        // La base de l'etage.
+    int           e;        // Iterateur sur les etages.
+
+    nb = (size_t) plan->taille * lot;
+
+    // L'inverse est la transformee directe des parties echangees:
+    // conj(x) = i * echange(x), donc FFT^-1(x) = echange(FFT(echange(x))).
+    if(sens == FFT_INVERSE)
+    {
+        echange     = reels;
+        reels       = imaginaires;
+        imaginaires = echange;
+    }
+
+    xr = reels;
+    xi = imaginaires;
+    yr = travail;
+    yi = travail + nb;
+
+    l = 1;
+    for(e = 0; e < plan->nb_etages; e++)
+    {
+        p    = plan->bases[e];
+        bloc = plan->taille / (l * p) * lot;
+        wr   = plan->rotations + plan->debuts[e];
+        wi   = wr + (size_t) (p - 1) * l;
+
+        switch(p)
+        {
+            case 2: etage_2(l, bloc, wr, wi, xr, xi, yr, yi); break;
+            case 3: etage_3(l, bloc, wr, wi, xr, xi, yr, yi); break;
+            case 4: etage_4(l, bloc, wr, wi, xr, xi, yr, yi); break;
+            case 5: etage_5(l, bloc, wr, wi, xr, xi, yr, yi); break;
+        }
+
+        echange = xr; xr = yr; yr = echange;
+        echange = xi; xi = yi; yi = echange;
+        l *= p;
+    }
+
+    // Apres un nombre impair d'etages, le resultat est dans l'espace de travail.
+    if(xr != reels)
+    {
+        memcpy(reels,       xr, nb * sizeof(double));
+        memcpy(imaginaires, xi, nb * sizeof(double));
+    }
+}
+
+
+
+t_plan_fft2d* creer_plan_fft2d(int nb_lignes, int nb_colonnes)
+{
+    t_plan_fft2d* plan;     // Le plan cree.
+    size_t        taille;   // La taille de l'espace de travail.
+
+    plan = (t_plan_fft2d*) ALLOUER(sizeof(t_plan_fft2d));
+    if(plan == NULL)
+        return NULL;
+
+    plan->nb_lignes     = nb_lignes;
+    plan->nb_colonnes   = nb_colonnes;
+    plan->largeur       = nb_colonnes / 2 + 1;
+    plan->plan_lignes   = creer_plan_fft(nb_colonnes);
+    plan->plan_colonnes = creer_plan_fft(nb_lignes);
+
+    // Un spectre pour les etages des colonnes, puis deux lignes complexes.
+    taille = 2 * (size_t) nb_lignes * plan->largeur + 4 * (size_t) nb_colonnes;
+    plan->travail = (double*) ALLOUER(taille * sizeof(double));
+
+    if(plan->plan_lignes == NULL || plan->plan_colonnes == NULL || plan->travail == NULL)
+    {
+        detruire_plan_fft2d(plan);
+        return NULL;
+    }
+    INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 2);
+
+    return plan;
+}
+
+
+
+void detruire_plan_fft2d(t_plan_fft2d* plan)
+{
+    if(plan == NULL)
+        return;
+
+    detruire_plan_fft(plan->plan_lignes);
+    detruire_plan_fft(plan->plan_colonnes);
+    LIBERER(plan->travail);
+    LIBERER(plan);
+}
+
+
+
+void fft2d_reelle(t_plan_fft2d* plan, double** image, int nb_lignes, int nb_colonnes,
+                  double* reels, double* imaginaires)
+{
+    double* zr;         // Deux lignes transformees ensemble: z = a + i b.
+    double* zi;
+    double* travail;    // L'espace de travail des lignes.
+    double* ar;         // Les spectres des deux lignes.
+    double* ai;
+    double* br;
+    double* bi;
+    int     largeur;    // La largeur du spectre.
+    int     k, kk;      // Une frequence et son opposee.
+    int     ligne;      // Iterateur sur les paires de lignes.
+
+    largeur = plan->largeur;
+    zr      = plan->travail + 2 * (size_t) plan->nb_lignes * largeur;
+    zi      = zr + plan->nb_colonnes;
+    travail = zi + plan->nb_colonnes;
+
+    for(ligne = 0; ligne < plan->nb_lignes; ligne += 2)
+    {
+        // Les lignes de zeros ont un spectre nul.
+        if(ligne >= nb_lignes)
+        {
+            memset(reels + (size_t) ligne * largeur, 0,
+                   (size_t) (plan->nb_lignes - ligne) * largeur * sizeof(double));
+            memset(imaginaires + (size_t) ligne * largeur, 0,
+                   (size_t) (plan->nb_lignes - ligne) * largeur * sizeof(double));
+            break;
+        }
+
+        memcpy(zr, image[ligne], nb_colonnes * sizeof(double));
+        memset(zr + nb_colonnes, 0, (plan->nb_colonnes - nb_colonnes) * sizeof(double));
+        if(ligne + 1 < nb_lignes)
+        {
+            memcpy(zi, image[ligne + 1], nb_colonnes * sizeof(double));
+            memset(zi + nb_colonnes, 0, (plan->nb_colonnes - nb_colonnes) * sizeof(double));
+        }
+        else
+            memset(zi, 0, plan->nb_colonnes * sizeof(double));
+
+        fft(plan->plan_lignes, zr, zi, 1, FFT_DIRECTE, travail);
+
+        // A(k) = (Z(k) + conj Z(-k)) / 2 et B(k) = (Z(k) - conj Z(-k)) / 2i.
+        ar = reels       + (size_t) ligne * largeur;
+        ai = imaginaires + (size_t) ligne * largeur;
+        br = ar + largeur;
+        bi = ai + largeur;
+        for(k = 0; k < largeur; k++)
+        {
+            kk    = k == 0 ? 0 : plan->nb_colonnes - k;
+            ar[k] = (zr[k] + zr[kk]) / 2;
+            ai[k] = (zi[k] - zi[kk]) / 2;
+            if(ligne + 1 < plan->nb_lignes)
+            {
+                br[k] =  (zi[k] + zi[kk]) / 2;
+                bi[k] = -(zr[k] - zr[kk]) / 2;
+            }
+        }
+    }
+
+    fft(plan->plan_colonnes, reels, imaginaires, largeur, FFT_DIRECTE, plan->travail);
+}
+
+
+
+void fft2d_reelle_inverse(t_plan_fft2d* plan, double* reels, double* imaginaires,
+                          double** image, int nb_lignes, int nb_colonnes)
+{
+    double* zr;         // Deux lignes transformees ensemble: z = a + i b.
+    double* zi;
+    double* travail;    // L'espace de travail des lignes.
+    double* ar;         // Les spectres des deux lignes.
+    double* ai;
+    double* br;
+    double* bi;
+    double  echelle;    // La division par le nombre de pixels.
+    double  a_r, a_i;   // Les frequences k des deux lignes.
+    double  b_r, b_i;
+    int     largeur;    // La largeur du spectre.
+    int     deux;       // Vrai si la deuxieme ligne de la paire est voulue.
+    int     k, kk;      // Une frequence et sa place dans la moitie gardee.
+    int     ligne;      // Iterateur sur les paires de lignes.
+    int     colonne;    // Iterateur sur les colonnes.
+
+    largeur = plan->largeur;
+    zr      = plan->travail + 2 * (size_t) plan->nb_lignes * largeur;
+    zi      = zr + plan->nb_colonnes;
+    travail = zi + plan->nb_colonnes;
+    echelle = 1.0 / ((double) plan->nb_lignes * plan->nb_colonnes);
+
+    fft(plan->plan_colonnes, reels, imaginaires, largeur, FFT_INVERSE, plan->travail);
+
+    for(ligne = 0; ligne < nb_lignes; ligne += 2)
+    {
+        deux = ligne + 1 < nb_lignes;
+        ar   = reels       + (size_t) ligne * largeur;
+        ai   = imaginaires + (size_t) ligne * largeur;
+        br   = ar + largeur;
+        bi   = ai + largeur;
+
+        // Z(k) = A(k) + i B(k), la seconde moitie par symetrie: A(-k) = conj A(k).
+        for(k = 0; k < plan->nb_colonnes; k++)
+        {
+            kk  = k < largeur ? k : plan->nb_colonnes - k;
+            a_r = ar[kk];
+            a_i = k < largeur ? ai[kk] : -ai[kk];
+            b_r = deux ? br[kk] : 0;
+            b_i = deux ? (k < largeur ? bi[kk] : -bi[kk]) : 0;
+
+            zr[k] = a_r - b_i;
+            zi[k] = a_i + b_r;
+        }
+
+        fft(plan->plan_lignes, zr, zi, 1, FFT_INVERSE, travail);
+
+        for(colonne = 0; colonne < nb_colonnes; colonne++)
+            image[ligne][colonne] = zr[colonne] * echelle;
+        if(deux)
+            for(colonne = 0; colonne < nb_colonnes; colonne++)
+                image[ligne + 1][colonne] = zi[colonne] * echelle;
+    }
+}
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PRIVEES                            *
+****************************************************************************************/
+
+
+static void etage_2(int l, int bloc, const double* wr, const double* wi,
+                    const double* restrict xr, const double* restrict xi,
+                    double* restrict yr, double* restrict yi)
+{
+    const double* x0r;  // Les blocs d'entree.
+    const double* x0i;
+    const double* x1r;
+    const double* x1i;
+    double*       y0r;  // Les blocs de sortie.
+    double*       y0i;
+    double*       y1r;
+    double*       y1i;
+    double        a1r, a1i;     // L'element tourne.
+    int           j, t;         // Iterateurs sur les transformees et les blocs.
+
+    for(j = 0; j < l; j++)
+    {
+        x0r = xr + (size_t) (2 * j) * bloc;     x0i = xi + (size_t) (2 * j) * bloc;
+        x1r = x0r + bloc;                       x1i = x0i + bloc;
+        y0r = yr + (size_t) j * bloc;           y0i = yi + (size_t) j * bloc;
+        y1r = y0r + (size_t) l * bloc;          y1i = y0i + (size_t) l * bloc;
+
+        for(t = 0; t < bloc; t++)
+        {
+            a1r = x1r[t] * wr[j] - x1i[t] * wi[j];
+            a1i = x1r[t] * wi[j] + x1i[t] * wr[j];
+
+            y0r[t] = x0r[t] + a1r;
+            y0i[t] = x0i[t] + a1i;
+            y1r[t] = x0r[t] - a1r;
+            y1i[t] = x0i[t] - a1i;
+        }
+    }
+}
+
+
+
+static void etage_3(int l, int bloc, const double* wr, const double* wi,
+                    const double* restrict xr, const double* restrict xi,
+                    double* restrict yr, double* restrict yi)
+{
+    const double* x0r;  // Les blocs d'entree.
+    const double* x0i;
+    const double* x1r;
+    const double* x1i;
+    const double* x2r;
+    const double* x2i;
+    double*       y0r;  // Les blocs de sortie.
+    double*       y0i;
+    double*       y1r;
+    double*       y1i;
+    double*       y2r;
+    double*       y2i;
+    double        w1r, w1i, w2r, w2i;   // Les facteurs de rotation.
+    double        a1r, a1i, a2r, a2i;   // Les elements tournes.
+    double        sr, si;               // a1 + a2.
+    double        mr, mi;               // a0 - (a1 + a2) / 2.
+    double        dr, di;               // sin(60) (a1 - a2).
+    int           j, t;                 // Iterateurs sur les transformees et les blocs.
+
+    for(j = 0; j < l; j++)
+    {
+        w1r = wr[2 * j];    w1i = wi[2 * j];
+        w2r = wr[2 * j + 1]; w2i = wi[2 * j + 1];
+
+        x0r = xr + (size_t) (3 * j) * bloc;     x0i = xi + (size_t) (3 * j) * bloc;
+        x1r = x0r + bloc;                       x1i = x0i + bloc;
+        x2r = x1r + bloc;                       x2i = x1i + bloc;
+        y0r = yr + (size_t) j * bloc;           y0i = yi + (size_t) j * bloc;
+        y1r = y0r + (size_t) l * bloc;          y1i = y0i + (size_t) l * bloc;
+        y2r = y1r + (size_t) l * bloc;          y2i = y1i + (size_t) l * bloc;
+
+        for(t = 0; t < bloc; t++)
+        {
+            a1r = x1r[t] * w1r - x1i[t] * w1i;
+            a1i = x1r[t] * w1i + x1i[t] * w1r;
+            a2r = x2r[t] * w2r - x2i[t] * w2i;
+            a2i = x2r[t] * w2i + x2i[t] * w2r;
+
+            sr = a1r + a2r;
+            si = a1i + a2i;
+            mr = x0r[t] - 0.5 * sr;
+            mi = x0i[t] - 0.5 * si;
+            dr = SIN_60 * (a1r - a2r);
+            di = SIN_60 * (a1i - a2i);
+
+            // b1 = m - i d et b2 = m + i d.
+            y0r[t] = x0r[t] + sr;
+            y0i[t] = x0i[t] + si;
+            y1r[t] = mr + di;
+            y1i[t] = mi - dr;
+            y2r[t] = mr - di;
+            y2i[t] = mi + dr;
+        }
+    }
+}
+
+
+
+static void etage_4(int l, int bloc, const double* wr, const double* wi,
+                    const double* restrict xr, const double* restrict xi,
+                    double* restrict yr, double* restrict yi)
+{
+    const double* x0r;  // Les blocs d'entree.
+    const double* x0i;
+    const double* x1r;
+    const double* x1i;
+    const double* x2r;
+    const double* x2i;
+    const double* x3r;
+    const double* x3i;
+    double*       y0r;  // Les blocs de sortie.
+    double*       y0i;
+    double*       y1r;
+    double*       y1i;
+    double*       y2r;
+    double*       y2i;
+    double*       y3r;
+    double*       y3i;
+    double        w1r, w1i, w2r, w2i, w3r, w3i;     // Les facteurs de rotation.
+    double        a1r, a1i, a2r, a2i, a3r, a3i;     // Les elements tournes.
+    double        s02r, s02i, d02r, d02i;           // a0 +/- a2.
+    double        s13r, s13i, d13r, d13i;           // a1 +/- a3.
+    int           j, t;     // Iterateurs sur les transformees et les blocs.
+
+    for(j = 0; j < l; j++)
+    {
+        w1r = wr[3 * j];     w1i = wi[3 * j];
+        w2r = wr[3 * j + 1]; w2i = wi[3 * j + 1];
+        w3r = wr[3 * j + 2]; w3i = wi[3 * j + 2];
+
+        x0r = xr + (size_t) (4 * j) * bloc;     x0i = xi + (size_t) (4 * j) * bloc;
+        x1r = x0r + bloc;                       x1i = x0i + bloc;
+        x2r = x1r + bloc;                       x2i = x1i + bloc;
+        x3r = x2r + bloc;                       x3i = x2i + bloc;
+        y0r = yr + (size_t) j * bloc;           y0i = yi + (size_t) j * bloc;
+        y1r = y0r + (size_t) l * bloc;          y1i = y0i + (size_t) l * bloc;
+        y2r = y1r + (size_t) l * bloc;          y2i = y1i + (size_t) l * bloc;
+        y3r = y2r + (size_t) l * bloc;          y3i = y2i + (size_t) l * bloc;
+
+        for(t = 0; t < bloc; t++)
+        {
+            a1r = x1r[t] * w1r - x1i[t] * w1i;
+            a1i = x1r[t] * w1i + x1i[t] * w1r;
+            a2r = x2r[t] * w2r - x2i[t] * w2i;
+            a2i = x2r[t] * w2i + x2i[t] * w2r;
+            a3r = x3r[t] * w3r - x3i[t] * w3i;
+            a3i = x3r[t] * w3i + x3i[t] * w3r;
+
+            s02r = x0r[t] + a2r;    s02i = x0i[t] + a2i;
+            d02r = x0r[t] - a2r;    d02i = x0i[t] - a2i;
+            s13r = a1r + a3r;       s13i = a1i + a3i;
+            d13r = a1r - a3r;       d13i = a1i - a3i;
+
+            // b1 = d02 - i d13 et b3 = d02 + i d13.
+            y0r[t] = s02r + s13r;
+            y0i[t] = s02i + s13i;
+            y1r[t] = d02r + d13i;
+            y1i[t] = d02i - d13r;
+            y2r[t] = s02r - s13r;
+            y2i[t] = s02i - s13i;
+            y3r[t] = d02r - d13i;
+            y3i[t] = d02i + d13r;
+        }
+    }
+}
+
+
+
+static void etage_5(int l, int bloc, const double* wr, const double* wi,
+                    const double* restrict xr, const double* restrict xi,
+                    double* restrict yr, double* restrict yi)
+{
+    const double* x0r;  // Les blocs d'entree.
+    const double* x0i;
+    const double* x1r;
+    const double* x1i;
+    const double* x2r;
+    const double* x2i;
+    const double* x3r;
+    const double* x3i;
+    const double* x4r;
+    const double* x4i;
+    double*       y0r;  // Les blocs de sortie.
+    double*       y0i;
+    double*       y1r;
+    double*       y1i;
+    double*       y2r;
+    double*       y2i;
+    double*       y3r;
+    double*       y3i;
+    double*       y4r;
+    double*       y4i;
+    double        w1r, w1i, w2r, w2i, w3r, w3i, w4r, w4i;   // Les facteurs de rotation.
+    double        a1r, a1i, a2r, a2i, a3r, a3i, a4r, a4i;   // Les elements tournes.
+    double        s14r, s14i, d14r, d14i;   // a1 +/- a4.
+    double        s23r, s23i, d23r, d23i;   // a2 +/- a3.
+    double        m1r, m1i, m2r, m2i;       // Les parties paires.
+    double        n1r, n1i, n2r, n2i;       // Les parties impaires.
+    int           j, t;     // Iterateurs sur les transformees et les blocs.
+
+    for(j = 0; j < l; j++)
+    {
+        w1r = wr[4 * j];     w1i = wi[4 * j];
+        w2r = wr[4 * j + 1]; w2i = wi[4 * j + 1];
+        w3r = wr[4 * j + 2]; w3i = wi[4 * j + 2];
+        w4r = wr[4 * j + 3]; w4i = wi[4 * j + 3];
+
+        x0r = xr + (size_t) (5 * j) * bloc;     x0i = xi + (size_t) (5 * j) * bloc;
+        x1r = x0r + bloc;                       x1i = x0i + bloc;
+        x2r = x1r + bloc;                       x2i = x1i + bloc;
+        x3r = x2r + bloc;                       x3i = x2i + bloc;
+        x4r = x3r + bloc;                       x4i = x3i + bloc;
+        y0r = yr + (size_t) j * bloc;           y0i = yi + (size_t) j * bloc;
+        y1r = y0r + (size_t) l * bloc;          y1i = y0i + (size_t) l * bloc;
+        y2r = y1r + (size_t) l * bloc;          y2i = y1i + (size_t) l * bloc;
+        y3r = y2r + (size_t) l * bloc;          y3i = y2i + (size_t) l * bloc;
+        y4r = y3r + (size_t) l * bloc;          y4i = y3i + (size_t) l * bloc;
+
+        for(t = 0; t < bloc; t++)
+        {
+            a1r = x1r[t] * w1r - x1i[t] * w1i;
+            a1i = x1r[t] * w1i + x1i[t] * w1r;
+            a2r = x2r[t] * w2r - x2i[t] * w2i;
+            a2i = x2r[t] * w2i + x2i[t] * w2r;
+            a3r = x3r[t] * w3r - x3i[t] * w3i;
+            a3i = x3r[t] * w3i + x3i[t] * w3r;
+            a4r = x4r[t] * w4r - x4i[t] * w4i;
+            a4i = x4r[t] * w4i + x4i[t] * w4r;
+
+            s14r = a1r + a4r;   s14i = a1i + a4i;
+            d14r = a1r - a4r;   d14i = a1i - a4i;
+            s23r = a2r + a3r;   s23i = a2i + a3i;
+            d23r = a2r - a3r;   d23i = a2i - a3i;
+
+            m1r = x0r[t] + COS_72 * s14r + COS_144 * s23r;
+            m1i = x0i[t] + COS_72 * s14i + COS_144 * s23i;
+            m2r = x0r[t] + COS_144 * s14r + COS_72 * s23r;
+            m2i = x0i[t] + COS_144 * s14i + COS_72 * s23i;
+            n1r = SIN_72 * d14r + SIN_144 * d23r;
+            n1i = SIN_72 * d14i + SIN_144 * d23i;
+            n2r = SIN_144 * d14r - SIN_72 * d23r;
+            n2i = SIN_144 * d14i - SIN_72 * d23i;
+
+            // b1 = m1 - i n1, b4 = m1 + i n1, b2 = m2 - i n2 et b3 = m2 + i n2.
+            y0r[t] = x0r[t] + s14r + s23r;
+            y0i[t] = x0i[t] + s14i + s23i;
+            y1r[t] = m1r + n1i;
+            y1i[t] = m1i - n1r;
+            y4r[t] = m1r - n1i;
+            y4i[t] = m1i + n1r;
+            y2r[t] = m2r + n2i;
+            y2i[t] = m2i - n2r;
+            y3r[t] = m2r - n2i;
+            y3i[t] = m2i + n2r;
+        }
+    }
+}
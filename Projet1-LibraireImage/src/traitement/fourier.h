@@ -0,0 +1,249 @@
+/****************************************************************************************
+    FOURIER.H
+
+    Ce module contient la transformee de Fourier rapide (FFT) en une et deux
+    dimensions, pour les tailles de la forme 2^a 3^b 5^c. Une image plus
+    grande est completee par des zeros jusqu'a la taille rapide suivante
+    (voir taille_fft_rapide).
+
+    Une transformee est decrite par un plan, cree une fois pour une taille
+    puis reutilise: il garde la factorisation de la taille et les facteurs
+    de rotation (twiddles) de chaque etage, calcules a la creation.
+
+    L'algorithme est celui de Stockham (sans permutation des indices), par
+    etages de base 4, 2, 3 et 5. Les parties reelles et imaginaires sont
+    dans des tableaux separes, et chaque papillon traite un bloc d'elements
+    contigus: la boucle interne est vectorisee par le compilateur. La meme
+    boucle transforme un lot de suites entrelacees (les colonnes d'une
+    image), ce qui evite de parcourir les colonnes une a une.
+
+    La transformee 2D d'une image reelle transforme deux lignes a la fois
+    (l'une comme partie reelle, l'autre comme partie imaginaire), puis
+    toutes les colonnes ensemble. Seule la moitie du spectre est gardee, la
+    seconde s'en deduisant par symetrie.
+
+    Liste des sous-programmes publiques:
+      - taille_fft_rapide     : La plus petite taille rapide superieure ou egale;
+      - creer_plan_fft        : Cree le plan d'une FFT 1D;
+      - detruire_plan_fft     : Libere un plan 1D;
+      - fft                   : FFT 1D d'une suite, ou d'un lot de suites;
+      - creer_plan_fft2d      : Cree le plan d'une FFT 2D d'images reelles;
+      - detruire_plan_fft2d   : Libere un plan 2D;
+      - fft2d_reelle          : Le spectre d'une image reelle;
+      - fft2d_reelle_inverse  : L'image reelle d'un spectre.
+
+*****************************************************************************************/
+#ifndef FOURIER
+#define FOURIER
+
+
+/****************************************************************************************
+*                               DEFINTION DES CONSTANTES                                *
+****************************************************************************************/
+
+// Le nombre maximal d'etages d'une FFT (une taille de 2^62 au plus).
+#define NB_ETAGES_MAX       32
+
+// Le sens d'une transformee.
+#define FFT_DIRECTE         1       // Exposant -2 pi i j k / n.
+#define FFT_INVERSE         (-1)    // Exposant +2 pi i j k / n, sans division par n.
+
+
+/*
+    T_PLAN_FFT
+
+    Le plan d'une FFT 1D. Les champs ne servent qu'au module.
+*/
+typedef struct
+{
+    int     taille;                 // Le nombre d'elements transformes.
+    int     nb_etages;              // Le nombre d'etages.
+    int     bases[NB_ETAGES_MAX];   // La base de chaque etage.
+    double* rotations;              // Les facteurs de rotation, etage par etage
+                                    // (parties reelles puis imaginaires).
+    int     debuts[NB_ETAGES_MAX];  // Le debut de chaque etage dans rotations.
+
+}t_plan_fft;
+
+
+/*
+    T_PLAN_FFT2D
+
+    Le plan d'une FFT 2D d'images reelles, avec son espace de travail. Un
+    spectre a nb_lignes lignes de largeur = nb_colonnes / 2 + 1 nombres
+    complexes, ligne par ligne, parties reelles et imaginaires separees. Les
+    champs ne servent qu'au module.
+*/
+typedef struct
+{
+    int         nb_lignes;          // La taille (rapide) des images transformees.
+    int         nb_colonnes;
+    int         largeur;            // nb_colonnes / 2 + 1.
+    t_plan_fft* plan_lignes;
+    t_plan_fft* plan_colonnes;
+    double*     travail;            // Deux spectres et quatre lignes de travail.
+
+}t_plan_fft2d;
+
+
+/****************************************************************************************
+*                       DECLARATION DES FONCTIONS PUBLIQUES                             *
+****************************************************************************************/
+
+
+/*
+    TAILLE_FFT_RAPIDE
+
+    Cette fonction donne la plus petite taille de la forme 2^a 3^b 5^c
+    superieure ou egale a une taille.
+
+    Parametres:
+        - [int] taille : La taille voulue (au moins 1).
+
+    Retour:
+        La taille rapide, ou -1 si elle depasse la capacite d'un int.
+*/
+int taille_fft_rapide(int taille);
+
+
+
+/*
+    CREER_PLAN_FFT
+
+    Cette fonction cree le plan d'une FFT 1D et calcule ses facteurs de
+    rotation.
+
+    Parametres:
+        - [int] taille : Le nombre d'elements, de la forme 2^a 3^b 5^c.
+
+    Retour:
+        Le plan, ou NULL si la taille n'est pas rapide ou si la memoire manque.
+*/
+t_plan_fft* creer_plan_fft(int taille);
+
+
+
+/*
+    DETRUIRE_PLAN_FFT
+
+    Cette procedure libere un plan 1D.
+
+    Parametres:
+        - [t_plan_fft*] plan : Le plan (NULL est accepte).
+*/
+void detruire_plan_fft(t_plan_fft* plan);
+
+
+
+/*
+    FFT
+
+    Cette procedure calcule, sur place, la FFT d'un lot de 'lot' suites de
+    plan->taille nombres complexes. L'element k de la suite s est a la place
+    k * lot + s: avec lot = 1, c'est une suite simple; avec lot = le nombre
+    de colonnes d'une image rangee ligne par ligne, ce sont ses colonnes.
+
+    Parametres:
+        - [t_plan_fft*] plan         : Le plan.
+        - [double*    ] reels        : Les parties reelles (plan->taille * lot).
+        - [double*    ] imaginaires  : Les parties imaginaires (meme taille).
+        - [int        ] lot          : Le nombre de suites.
+        - [int        ] sens         : FFT_DIRECTE ou FFT_INVERSE.
+        - [double*    ] travail      : Espace de travail: 2 * plan->taille * lot reels.
+
+    Exemple d'utilisation:
+
+        t_plan_fft* plan = creer_plan_fft(360);
+
+        fft(plan, re, im, 1, FFT_DIRECTE, travail);
+        [ ... ]
+        fft(plan, re, im, 1, FFT_INVERSE, travail);     // 360 fois la suite de depart.
+
+        detruire_plan_fft(plan);
+*/
+void fft(const t_plan_fft* plan, double* reels, double* imaginaires, int lot, int sens,
+         double* travail);
+
+
+
+/*
+    CREER_PLAN_FFT2D
+
+    Cette fonction cree le plan d'une FFT 2D d'images reelles et son espace
+    de travail.
+
+    Parametres:
+        - [int] nb_lignes   : Le nombre de lignes, de la forme 2^a 3^b 5^c.
+        - [int] nb_colonnes : Le nombre de colonnes, de la meme forme.
+
+    Retour:
+        Le plan, ou NULL si une taille n'est pas rapide ou si la memoire manque.
+*/
+t_plan_fft2d* creer_plan_fft2d(int nb_lignes, int nb_colonnes);
+
+
+
+/*
+    DETRUIRE_PLAN_FFT2D
+
+    Cette procedure libere un plan 2D et son espace de travail.
+
+    Parametres:
+        - [t_plan_fft2d*] plan : Le plan (NULL est accepte).
+*/
+void detruire_plan_fft2d(t_plan_fft2d* plan);
+
+
+
+/*
+    FFT2D_REELLE
+
+    Cette procedure calcule la moitie du spectre d'une image reelle,
+    completee par des zeros a la taille du plan. Un plan ne doit etre
+    utilise que par un fil a la fois.
+
+    Parametres:
+        - [t_plan_fft2d*] plan        : Le plan.
+        - [double**     ] image       : L'image.
+        - [int          ] nb_lignes   : La taille de l'image (au plus celle du plan).
+        - [int          ] nb_colonnes
+        - [double*      ] reels       : Recoit les parties reelles du spectre
+                                        (plan->nb_lignes * plan->largeur).
+        - [double*      ] imaginaires : Recoit les parties imaginaires.
+*/
+void fft2d_reelle(t_plan_fft2d* plan, double** image, int nb_lignes, int nb_colonnes,
+                  double* reels, double* imaginaires);
+
+
+
+/*
+    FFT2D_REELLE_INVERSE
+
+    Cette procedure calcule l'image reelle d'un spectre (la moitie donnee
+    par fft2d_reelle, apres d'eventuelles operations qui gardent sa
+    symetrie) et en garde le coin superieur gauche. Le resultat est divise
+    par le nombre de pixels: l'inverse de fft2d_reelle redonne l'image.
+
+    Parametres:
+        - [t_plan_fft2d*] plan        : Le plan.
+        - [double*      ] reels       : Le spectre. Il est detruit.
+        - [double*      ] imaginaires
+        - [double**     ] image       : Recoit le coin de l'image (deja allouee).
+        - [int          ] nb_lignes   : La taille du coin (au plus celle du plan).
+        - [int          ] nb_colonnes
+
+    Exemple d'utilisation (une convolution circulaire):
+
+        fft2d_reelle(plan, image, nl, nc, re_image, im_image);
+        fft2d_reelle(plan, noyau, nl_noyau, nc_noyau, re_noyau, im_noyau);
+
+        for(k = 0; k < plan->nb_lignes * plan->largeur; k++)
+            [ ... produit complexe des deux spectres, dans re_image, im_image ... ]
+
+        fft2d_reelle_inverse(plan, re_image, im_image, resultat, nl, nc);
+*/
+void fft2d_reelle_inverse(t_plan_fft2d* plan, double* reels, double* imaginaires,
+                          double** image, int nb_lignes, int nb_colonnes);
+
+
+#endif
@@ -0,0 +1,366 @@
+/****************************************************************************************
+    HOUGH.C
+
+    Ce module contient la transformee de Hough des droites. Le tableau des
+    votes a une ligne par angle et une colonne par valeur de rho, de -rho_max
+    a rho_max.
+****************************************************************************************/
+#include "hough.h"
+#include "../outils/instrumentation.h"
+#include "../outils/memoire.h"
+#include "../outils/parallele.h"
+
+#include <math.h>
+#include <string.h>
+
+
+/****************************************************************************************
+*                               DEFINTION DES CONSTANTES                                *
+****************************************************************************************/
+
+#define VRAI    1
+#define FAUX    0
+
+// Le nombre d'angles additionnes par un fil a la fois lors de la fusion.
+#define ANGLES_PAR_PAQUET   4
+
+// Le nombre minimal de pixels d'une bande par colonne du tableau des votes.
+// Chaque bande ajoute une addition par case a la fusion; avec 2 % de points
+// de contour, ses votes en font un peu plus.
+#define PIXELS_PAR_CASE     64
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+
+/*
+    T_TRANSFORMEE
+
+    Une transformee en cours, partagee par les fils.
+*/
+typedef struct
+{
+    double**     contours;      // La carte de contours.
+    int          nb_lignes;
+    int          nb_colonnes;
+    double       seuil;         // Le seuil des points de contour.
+    int          nb_angles;     // Le nombre de lignes du tableau des votes.
+    int          nb_rho;        // Le nombre de colonnes du tableau des votes.
+    int          rho_max;       // La valeur de rho de la derniere colonne.
+    const float* cosinus;       // Les tables des angles.
+    const float* sinus;
+    int          nb_bandes;     // Le nombre de bandes de lignes.
+    int*         votes;         // Les tableaux des votes des bandes, bout a bout.
+    size_t       taille_votes;  // Le nombre de cases d'un tableau.
+
+}t_transformee;
+
+
+/****************************************************************************************
+*                           DECLARATION DES FONCTIONS PRIVEES                           *
+****************************************************************************************/
+
+
+/*
+    VOTER
+
+    Cette procedure (de type t_tache) fait voter les points de contour des
+    bandes debut a fin - 1, chacune dans son propre tableau.
+
+    Parametres:
+        - [void*] donnees : La transformee (t_transformee*).
+        - [int  ] debut   : La premiere bande.
+        - [int  ] fin     : La bande qui suit la derniere bande.
+*/
+static void voter(void* donnees, int debut, int fin);
+
+
+
+/*
+    FUSIONNER
+
+    Cette procedure (de type t_tache) additionne, pour les angles debut a
+    fin - 1, les votes de toutes les bandes dans le tableau de la premiere.
+
+    Parametres:
+        - [void*] donnees : La transformee (t_transformee*).
+        - [int  ] debut   : Le premier angle.
+        - [int  ] fin     : L'angle qui suit le dernier angle.
+*/
+static void fusionner(void* donnees, int debut, int fin);
+
+
+
+/*
+    EST_MAXIMUM_LOCAL
+
+    Retour: Vrai si la case (angle, rho) est le maximum de son voisinage. Lors
+            d'une egalite, seule la premiere case (dans l'ordre des lignes) est
+            retenue.
+*/
+static int est_maximum_local(const t_transformee* transformee, const int* votes,
+                             int angle, int rho);
+
+
+
+/*
+    RESERVER
+
+    Cette fonction agrandit un tableau a au moins 'voulu' elements de
+    'taille' octets; le contenu n'est pas garde.
+
+    Retour: 1 si le tableau a la capacite voulue, 0 si la memoire manque.
+*/
+static int reserver(void** tableau, size_t* capacite, size_t voulu, size_t taille);
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PUBLIQUES                            *
+****************************************************************************************/
+t_hough* creer_hough(void)
+{
+    t_hough* hough;     // La transformee creee.
+
+    hough = (t_hough*) ALLOUER(sizeof(t_hough));
+    if(hough == NULL)
+        return NULL;
+    INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 1);
+
+    memset(hough, 0, sizeof(t_hough));
+
+    return hough;
+}
+
+
+
+void detruire_hough(t_hough* hough)
+{
+    if(hough == NULL)
+        return;
+
+    LIBERER(hough->votes);
+    LIBERER(hough->tables);
+    LIBERER(hough);
+}
+
+
+
+int detecter_droites(t_hough* hough, double** contours, int nb_lignes, int nb_colonnes,
+                     double seuil, double theta_min, double theta_max, int votes_min,
+                     t_droite* droites, int nb_droites_max)
+{
+    t_transformee transformee;  // La transformee partagee par les fils.
+    float*        tables;       // Les cosinus, puis les sinus.
+    int*          votes;        // Les votes additionnes.
+    long long     nb_bandes;    // Le nombre de bandes que la carte justifie.
+    int           nb_droites;   // Le nombre de droites retenues.
+    int           angle, rho;   // Iterateurs sur le tableau des votes.
+    int           k;            // Iterateur sur les droites.
+    t_droite      droite;       // Une droite trouvee.
+
+    if(hough == NULL || contours == NULL || droites == NULL || nb_lignes <= 0 ||
+       nb_colonnes <= 0 || nb_droites_max <= 0 || theta_max <= theta_min)
+        return -1;
+
+    transformee.contours     = contours;
+    transformee.nb_lignes    = nb_lignes;
+    transformee.nb_colonnes  = nb_colonnes;
+    transformee.seuil        = seuil;
+    transformee.nb_angles    = (int) ceil((theta_max - theta_min) / RESOLUTION_THETA - 1e-9);
+    transformee.rho_max      = (int) ceil(sqrt((double) nb_lignes * nb_lignes +
+                                               (double) nb_colonnes * nb_colonnes));
+    transformee.nb_rho       = 2 * transformee.rho_max + 1;
+    transformee.taille_votes = (size_t) transformee.nb_angles * transformee.nb_rho;
+
+    if(transformee.nb_angles > (int) ceil(M_PI / RESOLUTION_THETA))
+        return -1;
+
+    // Au plus une bande par fil, et seulement autant que la carte en justifie:
+    // au-dela, la fusion coute plus que les votes qu'elle partage.
+    nb_bandes = (long long) nb_lignes * nb_colonnes /
+                ((long long) PIXELS_PAR_CASE * transformee.nb_rho);
+    if(nb_bandes > parallele_nb_fils())
+        nb_bandes = parallele_nb_fils();
+    if(nb_bandes > nb_lignes)
+        nb_bandes = nb_lignes;
+    transformee.nb_bandes = nb_bandes < 1 ? 1 : (int) nb_bandes;
+
+    INSTRUMENTER_DEBUT(ETAPE_HOUGH);
+
+    // Les tables des angles et un tableau de votes par bande, gardes d'une
+    // carte a l'autre.
+    if(!reserver((void**) &hough->tables, &hough->capacite_tables,
+                 2 * (size_t) transformee.nb_angles, sizeof(float)) ||
+       !reserver((void**) &hough->votes, &hough->capacite_votes,
+                 (size_t) transformee.nb_bandes * transformee.taille_votes, sizeof(int)))
+    {
+        INSTRUMENTER_FIN(ETAPE_HOUGH);
+        return -1;
+    }
+
+    tables = hough->tables;
+    for(angle = 0; angle < transformee.nb_angles; angle++)
+    {
+        tables[angle]                         = (float) cos(theta_min + angle * RESOLUTION_THETA);
+        tables[transformee.nb_angles + angle] = (float) sin(theta_min + angle * RESOLUTION_THETA);
+    }
+    transformee.cosinus = tables;
+    transformee.sinus   = tables + transformee.nb_angles;
+    transformee.votes   = hough->votes;
+
+    parallele_pour(transformee.nb_bandes, 1, voter, &transformee);
+    parallele_pour(transformee.nb_angles, ANGLES_PAR_PAQUET, fusionner, &transformee);
+    votes = transformee.votes;
+
+    // Les maximums locaux, gardes en ordre decroissant de votes.
+    nb_droites = 0;
+    for(angle = 0; angle < transformee.nb_angles; angle++)
+    {
+        for(rho = 0; rho < transformee.nb_rho; rho++)
+        {
+            if(votes[angle * transformee.nb_rho + rho] < votes_min ||
+               (nb_droites == nb_droites_max &&
+                votes[angle * transformee.nb_rho + rho] <= droites[nb_droites - 1].votes) ||
+               !est_maximum_local(&transformee, votes, angle, rho))
+                continue;
+
+            droite.rho   = rho - transformee.rho_max;
+            droite.theta = theta_min + angle * RESOLUTION_THETA;
+            droite.votes = votes[angle * transformee.nb_rho + rho];
+
+            k = nb_droites < nb_droites_max ? nb_droites++ : nb_droites - 1;
+            for(; k > 0 && droites[k - 1].votes < droite.votes; k--)
+                droites[k] = droites[k - 1];
+            droites[k] = droite;
+        }
+    }
+
+    INSTRUMENTER_FIN(ETAPE_HOUGH);
+
+    return nb_droites;
+}
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PRIVEES                            *
+****************************************************************************************/
+
+
+static void voter(void* donnees, int debut, int fin)
+{
+    const t_transformee* transformee;   // La transformee.
+    int* restrict        votes;         // Le tableau de la bande.
+    const double*        ligne;         // La ligne de la carte en cours.
+    int                  bande;         // Iterateur sur les bandes.
+    int                  ligne_min;     // Les lignes de la bande.
+    int                  ligne_max;
+    int                  i, j;          // Iterateurs sur la carte.
+    int                  angle;         // Iterateur sur les angles.
+    float                x, y;          // La position d'un point de contour.
+
+    transformee = (const t_transformee*) donnees;
+
+    for(bande = debut; bande < fin; bande++)
+    {
+        votes     = transformee->votes + (size_t) bande * transformee->taille_votes;
+        ligne_min = (int) ((long long) transformee->nb_lignes * bande / transformee->nb_bandes);
+        ligne_max = (int) ((long long) transformee->nb_lignes * (bande + 1) /
+                           transformee->nb_bandes);
+
+        memset(votes, 0, transformee->taille_votes * sizeof(int));
+
+        for(i = ligne_min; i < ligne_max; i++)
+        {
+            ligne = transformee->contours[i];
+            y     = (float) i;
+
+            for(j = 0; j < transformee->nb_colonnes; j++)
+            {
+                if(!(ligne[j] > transformee->seuil))
+                    continue;
+
+                // Un vote par angle; rho est arrondi a la case la plus proche,
+                // decalee de rho_max pour etre positive.
+                x = (float) j;
+                for(angle = 0; angle < transformee->nb_angles; angle++)
+                    votes[angle * transformee->nb_rho +
+                          (int) (x * transformee->cosinus[angle] + y * transformee->sinus[angle] +
+                                 transformee->rho_max + 0.5f)]++;
+            }
+        }
+    }
+}
+
+
+static void fusionner(void* donnees, int debut, int fin)
+{
+    const t_transformee* transformee;   // La transformee.
+    int* restrict        total;         // Les votes de la premiere bande.
+    const int* restrict  votes;         // Les votes d'une autre bande.
+    size_t               premier;       // La premiere case des angles.
+    size_t               dernier;       // La case qui suit la derniere case.
+    size_t               n;             // Iterateur sur les cases.
+    int                  bande;         // Iterateur sur les bandes.
+
+    transformee = (const t_transformee*) donnees;
+    total       = transformee->votes;
+    premier     = (size_t) debut * transformee->nb_rho;
+    dernier     = (size_t) fin   * transformee->nb_rho;
+
+    for(bande = 1; bande < transformee->nb_bandes; bande++)
+    {
+        votes = transformee->votes + (size_t) bande * transformee->taille_votes;
+        for(n = premier; n < dernier; n++)
+            total[n] += votes[n];
+    }
+}
+
+
+static int est_maximum_local(const t_transformee* transformee, const int* votes,
+                             int angle, int rho)
+{
+    int valeur;     // Les votes de la case.
+    int a, r;       // Iterateurs sur le voisinage.
+    int voisin;     // Les votes d'une case voisine.
+
+    valeur = votes[angle * transformee->nb_rho + rho];
+
+    for(a = angle - RAYON_SUPPRESSION; a <= angle + RAYON_SUPPRESSION; a++)
+    {
+        if(a < 0 || a >= transformee->nb_angles)
+            continue;
+
+        for(r = rho - RAYON_SUPPRESSION; r <= rho + RAYON_SUPPRESSION; r++)
+        {
+            if(r < 0 || r >= transformee->nb_rho || (a == angle && r == rho))
+                continue;
+
+            voisin = votes[a * transformee->nb_rho + r];
+            if(voisin > valeur || (voisin == valeur && (a < angle || (a == angle && r < rho))))
+                return 0;
+        }
+    }
+
+    return 1;
+}
+
+
+static int reserver(void** tableau, size_t* capacite, size_t voulu, size_t taille)
+{
+    void* agrandi;      // Le tableau agrandi.
+
+    if(voulu <= *capacite)
+        return VRAI;
+
+    agrandi = ALLOUER(voulu * taille);
+    if(agrandi == NULL)
+        return FAUX;
+    INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 1);
+
+    LIBERER(*tableau);
+    *tableau  = agrandi;
+    *capacite = voulu;
+
+    return VRAI;
+}
@@ -0,0 +1,151 @@
+/****************************************************************************************
+    HOUGH.H
+
+    Ce module contient la transformee de Hough des droites, qui trouve les
+    droites d'une carte de contours, par exemple les bordures horizontales et
+    verticales d'une plaque.
+
+    Une droite est representee par (rho, theta): les points (x, y) = (colonne,
+    ligne) qui verifient x cos(theta) + y sin(theta) = rho. Une droite 
+    verticale a theta = 0 et une droite horizontale a theta = pi / 2. Chaque
+    point de contour vote pour toutes les droites qui passent par lui, par pas
+    de RESOLUTION_THETA et de 1 pixel en rho; les droites sont les maximums
+    locaux du tableau des votes.
+
+    L'intervalle des angles peut etre restreint (par exemple a +/- 10 degres 
+    autour de l'horizontale), ce qui reduit le travail d'autant. Les lignes de
+    la carte sont reparties en bandes sur plusieurs fils (voir parallele.h),
+    chacune avec son propre tableau de votes, additionnes a la fin. Le nombre
+    de bandes suit la taille de la carte plutot que le nombre de fils, pour
+    que la fusion ne coute pas plus que les votes. Les tableaux sont gardes
+    dans un t_hough, reutilise d'une image a l'autre.
+
+    Liste des sous-programmes publiques:
+      - creer_hough      : Cree une transformee et son espace de travail;
+      - detruire_hough   : Libere une transformee;
+      - detecter_droites : Trouve les droites d'une carte de contours.
+
+*****************************************************************************************/
+#ifndef HOUGH
+#define HOUGH
+
+#include <stddef.h>
+
+
+/****************************************************************************************
+*                               DEFINTION DES CONSTANTES                                *
+****************************************************************************************/
+
+// Le pas des angles, en radians (1 degre).
+#define RESOLUTION_THETA    (3.14159265358979323846 / 180.0)
+
+// Le rayon (en cases du tableau des votes) de la suppression des non-maximums:
+// deux droites retournees different d'au moins ce nombre de degres ou de pixels.
+#define RAYON_SUPPRESSION   3
+
+
+/*
+    T_DROITE
+
+    Une droite trouvee et son nombre de votes.
+*/
+typedef struct
+{
+    double rho;         // La distance signee de la droite a l'origine, en pixels.
+    double theta;       // L'angle de la normale a la droite, en radians.
+    int    votes;       // Le nombre de points de contour sur la droite.
+
+}t_droite;
+
+
+/*
+    T_HOUGH
+
+    L'espace de travail des transformees. Les champs ne servent qu'au module.
+*/
+typedef struct
+{
+    int*    votes;                  // Les tableaux de votes des bandes, bout a
+    size_t  capacite_votes;         // bout.
+    float*  tables;                 // Les cosinus, puis les sinus.
+    size_t  capacite_tables;
+
+}t_hough;
+
+
+/****************************************************************************************
+*                       DECLARATION DES FONCTIONS PUBLIQUES                             *
+****************************************************************************************/
+
+
+/*
+    CREER_HOUGH
+
+    Cette fonction cree une transformee. Son espace de travail est alloue a
+    la premiere carte.
+
+    Retour:
+        La transformee, ou NULL si la memoire manque.
+*/
+t_hough* creer_hough(void);
+
+
+
+/*
+    DETRUIRE_HOUGH
+
+    Cette procedure libere une transformee et son espace de travail.
+
+    Parametres:
+        - [t_hough*] hough : La transformee (NULL est accepte).
+*/
+void detruire_hough(t_hough* hough);
+
+
+
+/*
+    DETECTER_DROITES
+
+    Cette fonction trouve les droites d'une carte de contours dont l'angle est
+    entre theta_min et theta_max. Les droites sont les cases du tableau des
+    votes qui ont au moins votes_min votes et qui sont le maximum de leur
+    voisinage (RAYON_SUPPRESSION cases de chaque cote). Une transformee ne
+    doit etre utilisee que par un fil a la fois.
+
+    Parametres:
+        - [t_hough*  ] hough          : La transformee.
+        - [double**  ] contours       : La carte de contours.
+        - [int       ] nb_lignes      : Le nombre de lignes de la carte.
+        - [int       ] nb_colonnes    : Le nombre de colonnes de la carte.
+        - [double    ] seuil          : Les pixels plus grands que le seuil sont
+                                        des points de contour.
+        - [double    ] theta_min      : Le plus petit angle, en radians (il peut
+                                        etre negatif).
+        - [double    ] theta_max      : Le plus grand angle, en radians, au plus
+                                        theta_min + pi (exclu).
+        - [int       ] votes_min      : Le nombre minimal de votes d'une droite.
+        - [t_droite* ] droites        : Recoit les droites, par votes decroissants.
+        - [int       ] nb_droites_max : La capacite de 'droites'.
+
+    Retour:
+        Le nombre de droites trouvees (au plus nb_droites_max), ou -1 si les
+        parametres sont invalides ou si la memoire manque.
+
+    Exemple d'utilisation (les bordures presque horizontales):
+
+        t_hough* hough = creer_hough();
+        t_droite bordures[4];
+        int      nb_bordures;
+
+        nb_bordures = detecter_droites(hough, contours, nb_lignes, nb_colonnes, 0.5,
+                                       80 * RESOLUTION_THETA, 100 * RESOLUTION_THETA,
+                                       50, bordures, 4);
+
+        detruire_hough(hough);
+*/
+int detecter_droites(t_hough* hough, double** contours, int nb_lignes, int nb_colonnes,
+                     double seuil, double theta_min, double theta_max, int votes_min,
+                     t_droite* droites, int nb_droites_max);
+
+
+#endif
@@ -0,0 +1,281 @@
+/****************************************************************************************
+    PYRAMIDE.C
+
+    Ce module contient la construction des pyramides d'images. Le bloc alloue
+    contient, dans l'ordre, la structure t_pyramide, les pointeurs de lignes
+    de tous les niveaux, puis leurs pixels.
+****************************************************************************************/
+#include "pyramide.h"
+#include "../outils/instrumentation.h"
+#include "../outils/memoire.h"
+#include "../outils/parallele.h"
+
+#include <stdatomic.h>
+#include <stddef.h>
+
+
+/****************************************************************************************
+*                               DEFINTION DES CONSTANTES                                *
+****************************************************************************************/
+
+#define VRAI    1
+#define FAUX    0
+
+// Le nombre de lignes d'un niveau traitees par un fil a la fois.
+#define LIGNES_PAR_PAQUET   16
+
+// La moyenne d'un bloc de 2 x 2 pixels.
+#define POIDS_BOITE         0.25
+
+// Les poids du noyau binomial (1 4 6 4 1), appliques de chaque cote, et la
+// normalisation du noyau 5 x 5 (16 x 16).
+#define POIDS_CENTRE        6.0
+#define POIDS_VOISIN        4.0
+#define NORMALISATION_GAUSS (1.0 / 256.0)
+
+
+/*
+    T_REDUCTION
+
+    Le calcul d'un niveau a partir du precedent, partage par les fils.
+*/
+typedef struct
+{
+    double**   source;              // Le niveau precedent.
+    int        nb_lignes_source;
+    int        nb_colonnes_source;
+    double**   destination;         // Le niveau a calculer.
+    int        nb_colonnes;
+    atomic_int a_echoue;            // Vrai si un fil a manque de memoire.
+
+}t_reduction;
+
+
+/****************************************************************************************
+*                           DECLARATION DES FONCTIONS PRIVEES                           *
+****************************************************************************************/
+
+
+/*
+    REDUIRE_BOITE / REDUIRE_GAUSS
+
+    Ces procedures (de type t_tache) calculent les lignes debut a fin - 1 d'un
+    niveau avec le filtre correspondant.
+
+    Parametres:
+        - [void*] donnees : Le calcul du niveau (t_reduction*).
+        - [int  ] debut   : La premiere ligne a calculer.
+        - [int  ] fin     : La ligne qui suit la derniere ligne a calculer.
+*/
+static void reduire_boite(void* donnees, int debut, int fin);
+static void reduire_gauss(void* donnees, int debut, int fin);
+
+
+
+/*
+    BORNER
+
+    Retour: L'indice ramene entre 0 et maximum (bords repetes).
+*/
+static int borner(int indice, int maximum);
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PUBLIQUES                            *
+****************************************************************************************/
+t_pyramide* creer_pyramide(double** image, int nb_lignes, int nb_colonnes, int nb_niveaux,
+                                                                           int filtre)
+{
+    t_pyramide* pyramide;       // La pyramide, au debut du bloc.
+    t_reduction reduction;      // Le calcul du niveau en cours.
+    size_t      nb_pointeurs;   // Le nombre de pointeurs de lignes des niveaux 1 et +.
+    size_t      nb_pixels;      // Le nombre de pixels des niveaux 1 et +.
+    double**    lignes;         // Le prochain pointeur de ligne libre du bloc.
+    double*     pixels;         // Le prochain pixel libre du bloc.
+    int         lignes_k[NB_NIVEAUX_MAX];       // La taille de chaque niveau.
+    int         colonnes_k[NB_NIVEAUX_MAX];
+    int         k;              // Iterateur sur les niveaux.
+    int         i;              // Iterateur sur les lignes d'un niveau.
+
+    if(image == NULL || nb_lignes <= 0 || nb_colonnes <= 0 || nb_niveaux < 0 ||
+       (filtre != PYRAMIDE_BOITE && filtre != PYRAMIDE_GAUSS))
+        return NULL;
+
+    if(nb_niveaux == 0 || nb_niveaux > NB_NIVEAUX_MAX)
+        nb_niveaux = NB_NIVEAUX_MAX;
+
+    // La taille des niveaux, jusqu'a ce qu'un cote devienne nul.
+    lignes_k[0]   = nb_lignes;
+    colonnes_k[0] = nb_colonnes;
+    nb_pointeurs  = 0;
+    nb_pixels     = 0;
+    for(k = 1; k < nb_niveaux && lignes_k[k - 1] >= 2 && colonnes_k[k - 1] >= 2; k++)
+    {
+        lignes_k[k]   = lignes_k[k - 1]   / 2;
+        colonnes_k[k] = colonnes_k[k - 1] / 2;
+        nb_pointeurs += lignes_k[k];
+        nb_pixels    += (size_t) lignes_k[k] * colonnes_k[k];
+    }
+    nb_niveaux = k;
+
+    // Un seul bloc pour la structure, les pointeurs et les pixels.
+    pyramide = (t_pyramide*) ALLOUER(sizeof(t_pyramide) + nb_pointeurs * sizeof(double*) +
+                                                          nb_pixels    * sizeof(double));
+    INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 1);
+    if(pyramide == NULL)
+        return NULL;
+
+    INSTRUMENTER_DEBUT(ETAPE_PYRAMIDE);
+
+    lignes = (double**) (pyramide + 1);
+    pixels = (double*) (lignes + nb_pointeurs);
+
+    pyramide->nb_niveaux     = nb_niveaux;
+    pyramide->nb_lignes[0]   = nb_lignes;
+    pyramide->nb_colonnes[0] = nb_colonnes;
+    pyramide->niveaux[0]     = image;
+
+    atomic_init(&reduction.a_echoue, FAUX);
+    for(k = 1; k < nb_niveaux && !atomic_load(&reduction.a_echoue); k++)
+    {
+        pyramide->nb_lignes[k]   = lignes_k[k];
+        pyramide->nb_colonnes[k] = colonnes_k[k];
+        pyramide->niveaux[k]     = lignes;
+
+        for(i = 0; i < lignes_k[k]; i++, pixels += colonnes_k[k])
+            lignes[i] = pixels;
+        lignes += lignes_k[k];
+
+        // Chaque niveau depend du precedent: seules ses lignes sont reparties.
+        reduction.source             = pyramide->niveaux[k - 1];
+        reduction.nb_lignes_source   = lignes_k[k - 1];
+        reduction.nb_colonnes_source = colonnes_k[k - 1];
+        reduction.destination        = pyramide->niveaux[k];
+        reduction.nb_colonnes        = colonnes_k[k];
+
+        parallele_pour(lignes_k[k], LIGNES_PAR_PAQUET,
+                       filtre == PYRAMIDE_BOITE ? reduire_boite : reduire_gauss, &reduction);
+    }
+
+    INSTRUMENTER_FIN(ETAPE_PYRAMIDE);
+
+    if(atomic_load(&reduction.a_echoue))
+    {
+        LIBERER(pyramide);
+        return NULL;
+    }
+
+    return pyramide;
+}
+
+
+
+void detruire_pyramide(t_pyramide* pyramide)
+{
+    LIBERER(pyramide);
+}
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PRIVEES                            *
+****************************************************************************************/
+
+
+static void reduire_boite(void* donnees, int debut, int fin)
+{
+    const t_reduction* reduction;   // Le calcul du niveau.
+    const double* restrict haut;    // Les deux lignes sources d'une ligne.
+    const double* restrict bas;
+    double* restrict       ligne;   // La ligne calculee.
+    int i, j;                       // Iterateurs sur les lignes et les colonnes.
+
+    reduction = (const t_reduction*) donnees;
+
+    for(i = debut; i < fin; i++)
+    {
+        haut  = reduction->source[2 * i];
+        bas   = reduction->source[2 * i + 1];
+        ligne = reduction->destination[i];
+
+        for(j = 0; j < reduction->nb_colonnes; j++)
+            ligne[j] = POIDS_BOITE * ((haut[2 * j] + haut[2 * j + 1]) +
+                                      (bas[2 * j]  + bas[2 * j + 1]));
+    }
+}
+
+
+static void reduire_gauss(void* donnees, int debut, int fin)
+{
+    t_reduction* reduction;         // Le calcul du niveau.
+    const double* restrict l0;      // Les cinq lignes sources d'une ligne, bords
+    const double* restrict l1;      // repetes.
+    const double* restrict l2;
+    const double* restrict l3;
+    const double* restrict l4;
+    double* restrict       ligne;   // La ligne calculee.
+    double* restrict       tampon;  // Le filtre vertical, sur toute la ligne source.
+    int largeur;                    // Le nombre de colonnes de la source.
+    int derniere;                   // La derniere ligne de la source.
+    int i, j, x;                    // Iterateurs sur les lignes et les colonnes.
+    int fin_interieur;              // La premiere colonne dont le noyau depasse a droite.
+
+    reduction = (t_reduction*) donnees;
+    largeur   = reduction->nb_colonnes_source;
+    derniere  = reduction->nb_lignes_source - 1;
+
+    // Un tampon par paquet, pour que les fils ne partagent rien en ecriture.
+    tampon = (double*) ALLOUER((size_t) largeur * sizeof(double));
+    if(tampon == NULL)
+    {
+        atomic_store(&reduction->a_echoue, VRAI);
+        return;
+    }
+    INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 1);
+
+    // Les colonnes j dont les 5 voisins 2j - 2 a 2j + 2 sont dans la source.
+    fin_interieur = (largeur - 3) / 2 + 1;
+
+    for(i = debut; i < fin; i++)
+    {
+        l0 = reduction->source[borner(2 * i - 2, derniere)];
+        l1 = reduction->source[borner(2 * i - 1, derniere)];
+        l2 = reduction->source[2 * i];
+        l3 = reduction->source[borner(2 * i + 1, derniere)];
+        l4 = reduction->source[borner(2 * i + 2, derniere)];
+        ligne = reduction->destination[i];
+
+        // Le filtre vertical est applique a toutes les colonnes, contigues.
+        for(x = 0; x < largeur; x++)
+            tampon[x] = (l0[x] + l4[x]) + POIDS_VOISIN * (l1[x] + l3[x]) + POIDS_CENTRE * l2[x];
+
+        // Le filtre horizontal n'est evalue qu'aux colonnes paires conservees.
+        ligne[0] = NORMALISATION_GAUSS * ((tampon[0] + tampon[borner(2, largeur - 1)]) +
+                                          POIDS_VOISIN * (tampon[0] + tampon[1]) +
+                                          POIDS_CENTRE * tampon[0]);
+
+        for(j = 1; j < fin_interieur && j < reduction->nb_colonnes; j++)
+            ligne[j] = NORMALISATION_GAUSS * ((tampon[2 * j - 2] + tampon[2 * j + 2]) +
+                                              POIDS_VOISIN * (tampon[2 * j - 1] + tampon[2 * j + 1]) +
+                                              POIDS_CENTRE * tampon[2 * j]);
+
+        for(; j < reduction->nb_colonnes; j++)
+        {
+            x = 2 * j;
+            ligne[j] = NORMALISATION_GAUSS * ((tampon[x - 2] + tampon[borner(x + 2, largeur - 1)]) +
+                                              POIDS_VOISIN * (tampon[x - 1] +
+                                                              tampon[borner(x + 1, largeur - 1)]) +
+                                              POIDS_CENTRE * tampon[x]);
+        }
+    }
+
+    LIBERER(tampon);
+}
+
+
+static int borner(int indice, int maximum)
+{
+    if(indice < 0)
+        return 0;
+
+    return indice > maximum ? maximum : indice;
+}
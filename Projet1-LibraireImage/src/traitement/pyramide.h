@@ -0,0 +1,115 @@
+/****************************************************************************************
+    PYRAMIDE.H
+
+    Ce module contient des sous-programmes qui construisent la pyramide d'une
+    image: une suite d'images dont chacune a la moitie des lignes et des
+    colonnes de la precedente. Elle sert aux recherches a plusieurs echelles
+    (par exemple une fenetre glissante de taille fixe pour trouver les plaques
+    proches et lointaines).
+
+    Tous les niveaux (pointeurs de lignes et pixels) sont dans un seul bloc de
+    memoire, alloue une fois et libere par detruire_pyramide. Chaque niveau est
+    une image ordinaire (double**) qui s'utilise partout ou une image est
+    attendue. Le niveau 0 est l'image d'origine elle-meme, sans copie: elle
+    doit rester valide tant que la pyramide est utilisee.
+
+    Chaque niveau est calcule en une seule passe sur le precedent: le filtre
+    n'est evalue qu'aux pixels conserves. Les lignes d'un niveau sont reparties
+    sur plusieurs fils (voir parallele.h).
+
+    Liste des sous-programmes publiques:
+      - creer_pyramide    : Construit les niveaux d'une image;
+      - detruire_pyramide : Libere les niveaux.
+
+*****************************************************************************************/
+#ifndef PYRAMIDE
+#define PYRAMIDE
+
+
+/****************************************************************************************
+*                               DEFINTION DES CONSTANTES                                *
+****************************************************************************************/
+
+// Les filtres appliques avant de garder un pixel sur deux.
+#define PYRAMIDE_BOITE      0   // La moyenne de chaque bloc de 2 x 2 pixels.
+#define PYRAMIDE_GAUSS      1   // Le noyau binomial 5 x 5 (1 4 6 4 1) / 16 de 
+                                // chaque cote, avec les bords repetes.
+
+// Le nombre maximal de niveaux, image d'origine comprise.
+#define NB_NIVEAUX_MAX      16
+
+
+/*
+    T_PYRAMIDE
+
+    Les niveaux d'une pyramide. Le niveau k a nb_lignes[k] x nb_colonnes[k]
+    pixels, soit la moitie (arrondie vers le bas) du niveau k - 1.
+*/
+typedef struct
+{
+    int      nb_niveaux;                    // Le nombre de niveaux, dont l'origine.
+    int      nb_lignes[NB_NIVEAUX_MAX];     // La taille de chaque niveau.
+    int      nb_colonnes[NB_NIVEAUX_MAX];
+    double** niveaux[NB_NIVEAUX_MAX];       // Les images; niveaux[0] est l'origine.
+
+}t_pyramide;
+
+
+/****************************************************************************************
+*                       DECLARATION DES FONCTIONS PUBLIQUES                             *
+****************************************************************************************/
+
+
+/*
+    CREER_PYRAMIDE
+
+    Cette fonction construit la pyramide d'une image.
+
+    Parametres:
+        - [double**] image       : L'image d'origine (ou une vue).
+        - [int     ] nb_lignes   : Le nombre de lignes de l'image.
+        - [int     ] nb_colonnes : Le nombre de colonnes de l'image.
+        - [int     ] nb_niveaux  : Le nombre de niveaux voulus, origine comprise,
+                                   ou 0 pour descendre jusqu'a une ligne ou une 
+                                   colonne. Il est reduit au besoin.
+        - [int     ] filtre      : PYRAMIDE_BOITE ou PYRAMIDE_GAUSS.
+
+    Retour:
+        La pyramide, ou NULL si les parametres sont invalides ou si la memoire
+        manque.
+
+    Exemple d'utilisation:
+
+        t_pyramide* pyramide;
+        int         k;
+
+        pyramide = creer_pyramide(image, nb_lignes, nb_colonnes, 0, PYRAMIDE_GAUSS);
+        if(pyramide != NULL)
+        {
+            for(k = 0; k < pyramide->nb_niveaux; k++)
+                [ ... chercher dans pyramide->niveaux[k] ... ]
+
+            detruire_pyramide(pyramide);
+        }
+*/
+t_pyramide* creer_pyramide(double** image, int nb_lignes, int nb_colonnes, int nb_niveaux,
+                                                                           int filtre);
+
+
+
+/*
+    DETRUIRE_PYRAMIDE
+
+    Cette procedure libere les niveaux d'une pyramide. L'image d'origine n'est
+    pas touchee.
+
+    Parametres:
+        - [t_pyramide*] pyramide : La pyramide a liberer (NULL est accepte).
+
+    Retour:
+        Aucun.
+*/
+void detruire_pyramide(t_pyramide* pyramide);
+
+
+#endif
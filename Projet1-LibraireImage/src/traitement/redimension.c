@@ -0,0 +1,475 @@
+/****************************************************************************************
+    REDIMENSION.C
+
+    Ce module contient le redimensionnement separable des images. Une table de
+    poids donne, pour chaque pixel destination d'un axe, le premier pixel
+    source utilise et un nombre fixe de poids (completes par des zeros), de
+    sorte que la boucle interne n'a jamais de cas particulier aux bords.
+****************************************************************************************/
+#include "redimension.h"
+#include "../outils/instrumentation.h"
+#include "../outils/memoire.h"
+#include "../outils/parallele.h"
+
+#include <math.h>
+#include <string.h>
+
+
+/****************************************************************************************
+*                               DEFINTION DES CONSTANTES                                *
+****************************************************************************************/
+
+#define VRAI    1
+#define FAUX    0
+
+// Le nombre de tables de poids conservees par fil.
+#define NB_TABLES_CACHE     8
+
+// Le nombre de lignes d'une passe traitees par un fil a la fois.
+#define LIGNES_PAR_PAQUET   16
+
+// Le rayon de chaque filtre, en pixels sources (sans elargissement).
+#define RAYON_BILINEAIRE    1.0
+#define RAYON_BICUBIQUE     2.0
+#define RAYON_LANCZOS3      3.0
+
+// Le parametre de la cubique de Keys.
+#define A_BICUBIQUE         (-0.5)
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+
+/*
+    T_TABLE_POIDS
+
+    Les poids d'un axe, pour une taille source, une taille destination et un
+    filtre. Le pixel destination x vaut la somme, pour k de 0 a nb_poids - 1,
+    de poids[x * nb_poids + k] * source[debut[x] + k].
+*/
+typedef struct
+{
+    int     taille_source;      // La cle de la table.
+    int     taille_destination;
+    int     filtre;
+    int     nb_poids;           // Le nombre de poids de chaque pixel destination.
+    double* poids;              // Les poids, puis les debuts, dans un seul bloc.
+    int*    debut;
+    long    dernier_usage;      // Le moment de la derniere utilisation, 0 si libre.
+
+}t_table_poids;
+
+
+/*
+    T_REDIMENSION
+
+    Un redimensionnement en cours, partage par les fils des deux passes.
+*/
+typedef struct
+{
+    double**             source;            // L'image source.
+    double*              intermediaire;     // Le resultat de la passe horizontale:
+                                            // nb_lignes x colonnes_dest, contigu.
+    double**             destination;       // L'image destination.
+    int                  colonnes_dest;     // La largeur de la destination.
+    const t_table_poids* horizontale;       // Les poids de chaque axe.
+    const t_table_poids* verticale;
+
+}t_redimension;
+
+
+// Les tables conservees par le fil courant, et son horloge d'utilisation.
+static _Thread_local t_table_poids cache[NB_TABLES_CACHE];
+static _Thread_local long          horloge_cache = 0;
+
+
+/****************************************************************************************
+*                           DECLARATION DES FONCTIONS PRIVEES                           *
+****************************************************************************************/
+
+
+/*
+    OBTENIR_TABLE
+
+    Cette fonction retourne la table de poids d'un axe. Elle est prise du cache
+    du fil si elle s'y trouve, sinon elle est calculee et remplace la table la
+    moins recemment utilisee.
+
+    Parametres:
+        - [int] taille_source      : Le nombre de pixels source de l'axe.
+        - [int] taille_destination : Le nombre de pixels destination de l'axe.
+        - [int] filtre             : Le filtre d'interpolation.
+
+    Retour: La table, valide jusqu'au prochain appel, ou NULL si la memoire 
+            manque.
+*/
+static const t_table_poids* obtenir_table(int taille_source, int taille_destination,
+                                                             int filtre);
+
+
+
+/*
+    CALCULER_TABLE
+
+    Cette fonction calcule les poids d'une table dont la cle est remplie.
+
+    Parametres:
+        - [t_table_poids*] table : La table a remplir (poids et debut alloues).
+*/
+static void calculer_table(t_table_poids* table);
+
+
+
+/*
+    NB_POIDS_FILTRE
+
+    Retour: Le nombre de poids de chaque pixel destination d'un axe.
+*/
+static int nb_poids_filtre(int taille_source, int taille_destination, int filtre);
+
+
+
+/*
+    EVALUER_FILTRE
+
+    Retour: La valeur du filtre a une distance (en pixels sources, sans
+            elargissement) du centre.
+*/
+static double evaluer_filtre(int filtre, double distance);
+
+
+
+/*
+    RAYON_FILTRE
+
+    Retour: Le rayon du filtre, sans elargissement.
+*/
+static double rayon_filtre(int filtre);
+
+
+
+/*
+    PASSE_HORIZONTALE / PASSE_VERTICALE
+
+    Ces procedures (de type t_tache) calculent les lignes debut a fin - 1 de
+    l'image intermediaire (passe horizontale) ou de la destination (passe 
+    verticale).
+
+    Parametres:
+        - [void*] donnees : Le redimensionnement (t_redimension*).
+        - [int  ] debut   : La premiere ligne a calculer.
+        - [int  ] fin     : La ligne qui suit la derniere ligne a calculer.
+*/
+static void passe_horizontale(void* donnees, int debut, int fin);
+static void passe_verticale(void* donnees, int debut, int fin);
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PUBLIQUES                            *
+****************************************************************************************/
+int redimensionner(double** source, int nb_lignes, int nb_colonnes,
+                   double** destination, int lignes_dest, int colonnes_dest, int filtre)
+{
+    t_redimension redimension;  // Le redimensionnement partage par les fils.
+    int           a_reussi;     // La reussite ou l'echec du redimensionnement.
+
+    if(source == NULL || destination == NULL || nb_lignes <= 0 || nb_colonnes <= 0 ||
+       lignes_dest <= 0 || colonnes_dest <= 0 ||
+       filtre < REDIMENSION_PLUS_PROCHE || filtre > REDIMENSION_LANCZOS3)
+        return FAUX;
+
+    INSTRUMENTER_DEBUT(ETAPE_REDIMENSIONNER);
+
+    a_reussi = FAUX;
+
+    // Les deux tables sont obtenues avant les passes: les fils ne font que
+    // les lire.
+    redimension.source        = source;
+    redimension.destination   = destination;
+    redimension.colonnes_dest = colonnes_dest;
+    redimension.horizontale   = obtenir_table(nb_colonnes, colonnes_dest, filtre);
+    redimension.verticale     = obtenir_table(nb_lignes,   lignes_dest,   filtre);
+    redimension.intermediaire = (double*) ALLOUER((size_t) nb_lignes * colonnes_dest *
+                                                  sizeof(double));
+    INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 1);
+
+    if(redimension.horizontale != NULL && redimension.verticale != NULL &&
+       redimension.intermediaire != NULL)
+    {
+        parallele_pour(nb_lignes,   LIGNES_PAR_PAQUET, passe_horizontale, &redimension);
+        parallele_pour(lignes_dest, LIGNES_PAR_PAQUET, passe_verticale,   &redimension);
+        a_reussi = VRAI;
+    }
+
+    LIBERER(redimension.intermediaire);
+
+    INSTRUMENTER_FIN(ETAPE_REDIMENSIONNER);
+
+    return a_reussi;
+}
+
+
+
+void redimension_vider_cache(void)
+{
+    int i;  // Iterateur sur les tables.
+
+    for(i = 0; i < NB_TABLES_CACHE; i++)
+    {
+        LIBERER(cache[i].poids);
+        memset(&cache[i], 0, sizeof(cache[i]));
+    }
+}
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PRIVEES                            *
+****************************************************************************************/
+
+
+static const t_table_poids* obtenir_table(int taille_source, int taille_destination,
+                                                             int filtre)
+{
+    t_table_poids* table;   // La table trouvee ou remplacee.
+    int            nb_poids;// Le nombre de poids d'un pixel destination.
+    int            i;       // Iterateur sur les tables.
+
+    horloge_cache++;
+
+    // Chercher la table, ou sinon la moins recemment utilisee.
+    table = &cache[0];
+    for(i = 0; i < NB_TABLES_CACHE; i++)
+    {
+        if(cache[i].dernier_usage != 0 && cache[i].taille_source == taille_source &&
+           cache[i].taille_destination == taille_destination && cache[i].filtre == filtre)
+        {
+            cache[i].dernier_usage = horloge_cache;
+            return &cache[i];
+        }
+
+        if(cache[i].dernier_usage < table->dernier_usage)
+            table = &cache[i];
+    }
+
+    LIBERER(table->poids);
+    memset(table, 0, sizeof(*table));
+
+    nb_poids    = nb_poids_filtre(taille_source, taille_destination, filtre);
+    table->poids = (double*) ALLOUER((size_t) taille_destination *
+                                     (nb_poids * sizeof(double) + sizeof(int)));
+    INSTRUMENTER_COMPTER(COMPTEUR_ALLOCATIONS, 1);
+    if(table->poids == NULL)
+        return NULL;
+
+    table->taille_source      = taille_source;
+    table->taille_destination = taille_destination;
+    table->filtre             = filtre;
+    table->nb_poids           = nb_poids;
+    table->debut              = (int*) (table->poids + (size_t) taille_destination * nb_poids);
+    table->dernier_usage      = horloge_cache;
+
+    calculer_table(table);
+
+    return table;
+}
+
+
+static void calculer_table(t_table_poids* table)
+{
+    double  echelle;        // Le nombre de pixels sources par pixel destination.
+    double  etirement;      // L'elargissement du filtre (reduction seulement).
+    double  support;        // Le rayon du filtre elargi.
+    double  centre;         // La position du centre d'un pixel destination.
+    double  somme;          // La somme des poids d'un pixel, pour les normaliser.
+    double* poids;          // Les poids du pixel destination en cours.
+    int     premier;        // Les pixels sources sous le filtre: premier a 
+    int     dernier;        // dernier - 1.
+    int     x;              // Iterateur sur les pixels destination.
+    int     k;              // Iterateur sur les pixels sources.
+
+    echelle   = (double) table->taille_source / table->taille_destination;
+    etirement = echelle > 1.0 ? echelle : 1.0;
+    support   = rayon_filtre(table->filtre) * etirement;
+
+    for(x = 0; x < table->taille_destination; x++)
+    {
+        poids  = table->poids + (size_t) x * table->nb_poids;
+        centre = (x + 0.5) * echelle;
+        memset(poids, 0, table->nb_poids * sizeof(double));
+
+        // Le plus proche voisin n'a qu'un poids, jamais elargi.
+        if(table->filtre == REDIMENSION_PLUS_PROCHE)
+        {
+            table->debut[x] = (int) centre < table->taille_source ? (int) centre :
+                                                                    table->taille_source - 1;
+            poids[0] = 1.0;
+            continue;
+        }
+
+        premier = (int) floor(centre - support + 0.5);
+        dernier = (int) floor(centre + support + 0.5);
+        if(premier < 0)
+            premier = 0;
+        if(dernier > table->taille_source)
+            dernier = table->taille_source;
+
+        // La fenetre de nb_poids pixels est decalee vers la gauche si elle 
+        // depasse a droite; les poids hors du filtre restent nuls.
+        table->debut[x] = premier < table->taille_source - table->nb_poids ?
+                          premier : table->taille_source - table->nb_poids;
+
+        somme = 0;
+        for(k = premier; k < dernier; k++)
+        {
+            poids[k - table->debut[x]] = evaluer_filtre(table->filtre,
+                                                        (k + 0.5 - centre) / etirement);
+            somme += poids[k - table->debut[x]];
+        }
+
+        // Les poids sont normalises: les bords coupes ne changent pas la 
+        // luminosite.
+        if(somme != 0)
+        {
+            for(k = 0; k < table->nb_poids; k++)
+                poids[k] /= somme;
+        }
+        else
+        {
+            poids[premier - table->debut[x]] = 1.0;
+        }
+    }
+}
+
+
+static int nb_poids_filtre(int taille_source, int taille_destination, int filtre)
+{
+    double echelle;     // Le nombre de pixels sources par pixel destination.
+    int    nb_poids;    // Le nombre de poids, avant d'etre borne.
+
+    if(filtre == REDIMENSION_PLUS_PROCHE)
+        return 1;
+
+    echelle  = (double) taille_source / taille_destination;
+    nb_poids = 2 * (int) ceil(rayon_filtre(filtre) * (echelle > 1.0 ? echelle : 1.0)) + 1;
+
+    return nb_poids < taille_source ? nb_poids : taille_source;
+}
+
+
+static double evaluer_filtre(int filtre, double distance)
+{
+    double x;   // La distance absolue.
+
+    x = fabs(distance);
+
+    switch(filtre)
+    {
+        case REDIMENSION_BILINEAIRE:
+            return x < RAYON_BILINEAIRE ? 1.0 - x : 0.0;
+
+        case REDIMENSION_BICUBIQUE:
+            if(x < 1.0)
+                return ((A_BICUBIQUE + 2.0) * x - (A_BICUBIQUE + 3.0)) * x * x + 1.0;
+            if(x < RAYON_BICUBIQUE)
+                return ((A_BICUBIQUE * x - 5.0 * A_BICUBIQUE) * x + 8.0 * A_BICUBIQUE) * x -
+                       4.0 * A_BICUBIQUE;
+            return 0.0;
+
+        case REDIMENSION_LANCZOS3:
+            if(x == 0.0)
+                return 1.0;
+            if(x < RAYON_LANCZOS3)
+                return RAYON_LANCZOS3 * sin(M_PI * x) * sin(M_PI * x / RAYON_LANCZOS3) /
+                       (M_PI * M_PI * x * x);
+            return 0.0;
+
+        default:
+            return 0.0;
+    }
+}
+
+
+static double rayon_filtre(int filtre)
+{
+    switch(filtre)
+    {
+        case REDIMENSION_BILINEAIRE: return RAYON_BILINEAIRE;
+        case REDIMENSION_BICUBIQUE:  return RAYON_BICUBIQUE;
+        case REDIMENSION_LANCZOS3:   return RAYON_LANCZOS3;
+        default:                     return 0.5;
+    }
+}
+
+
+static void passe_horizontale(void* donnees, int debut, int fin)
+{
+    const t_redimension*   redimension;     // Le redimensionnement.
+    const t_table_poids*   table;           // Les poids horizontaux.
+    const double* restrict ligne_source;    // La ligne source en cours.
+    const double* restrict pixels;          // Les pixels sous le filtre.
+    const double* restrict poids;           // Les poids d'un pixel destination.
+    double* restrict       ligne;           // La ligne intermediaire calculee.
+    double                 somme;           // La somme ponderee d'un pixel.
+    int i, j, k;                            // Iterateurs.
+
+    redimension = (const t_redimension*) donnees;
+    table       = redimension->horizontale;
+
+    for(i = debut; i < fin; i++)
+    {
+        ligne_source = redimension->source[i];
+        ligne        = redimension->intermediaire + (size_t) i * redimension->colonnes_dest;
+
+        for(j = 0; j < redimension->colonnes_dest; j++)
+        {
+            pixels = ligne_source + table->debut[j];
+            poids  = table->poids + (size_t) j * table->nb_poids;
+
+            somme = 0;
+            for(k = 0; k < table->nb_poids; k++)
+                somme += poids[k] * pixels[k];
+            ligne[j] = somme;
+        }
+    }
+}
+
+
+static void passe_verticale(void* donnees, int debut, int fin)
+{
+    const t_redimension*   redimension;     // Le redimensionnement.
+    const t_table_poids*   table;           // Les poids verticaux.
+    const double* restrict ligne_source;    // Une ligne intermediaire sous le filtre.
+    double* restrict       ligne;           // La ligne destination calculee.
+    double                 poids;           // Le poids de la ligne intermediaire.
+    size_t                 largeur;         // La largeur des lignes.
+    int i, j, k;                            // Iterateurs.
+
+    redimension = (const t_redimension*) donnees;
+    table       = redimension->verticale;
+    largeur     = (size_t) redimension->colonnes_dest;
+
+    // Chaque ligne destination accumule des lignes intermediaires entieres:
+    // la boucle interne parcourt des pixels contigus.
+    for(i = debut; i < fin; i++)
+    {
+        ligne = redimension->destination[i];
+
+        for(k = 0; k < table->nb_poids; k++)
+        {
+            ligne_source = redimension->intermediaire + (table->debut[i] + k) * largeur;
+            poids        = table->poids[(size_t) i * table->nb_poids + k];
+
+            if(k == 0)
+            {
+                for(j = 0; j < (int) largeur; j++)
+                    ligne[j] = poids * ligne_source[j];
+            }
+            else
+            {
+                for(j = 0; j < (int) largeur; j++)
+                    ligne[j] += poids * ligne_source[j];
+            }
+        }
+    }
+}
@@ -0,0 +1,97 @@
+/****************************************************************************************
+    REDIMENSION.H
+
+    Ce module contient des sous-programmes qui changent la taille d'une image
+    d'un facteur quelconque, par exemple pour ramener chaque plaque a une
+    taille fixe avant la reconnaissance des caracteres.
+
+    Le redimensionnement est separable: une passe horizontale (chaque ligne
+    source vers la nouvelle largeur) suivie d'une passe verticale. Chaque
+    pixel d'une passe est une somme ponderee de pixels voisins; les poids ne
+    dependent que des tailles et du filtre, et sont precalcules une fois par
+    axe. Les tables des tailles recentes sont conservees (par fil) et
+    reutilisees d'un appel a l'autre. Les lignes de chaque passe sont
+    reparties sur plusieurs fils (voir parallele.h).
+
+    Lors d'une reduction, le filtre est elargi du facteur de reduction afin de
+    moyenner tous les pixels sources (sans crenelage), sauf pour le plus
+    proche voisin.
+
+    Liste des sous-programmes publiques:
+      - redimensionner          : Redimensionne une image dans une autre;
+      - redimension_vider_cache : Libere les tables de poids conservees.
+
+*****************************************************************************************/
+#ifndef REDIMENSION
+#define REDIMENSION
+
+
+/****************************************************************************************
+*                               DEFINTION DES CONSTANTES                                *
+****************************************************************************************/
+
+// Les filtres d'interpolation.
+#define REDIMENSION_PLUS_PROCHE    0   // Le plus proche voisin.
+#define REDIMENSION_BILINEAIRE     1   // Le triangle de rayon 1.
+#define REDIMENSION_BICUBIQUE      2   // La cubique de Keys (a = -0.5), de rayon 2.
+#define REDIMENSION_LANCZOS3       3   // Le sinus cardinal fenetre, de rayon 3.
+
+
+/****************************************************************************************
+*                       DECLARATION DES FONCTIONS PUBLIQUES                             *
+****************************************************************************************/
+
+
+/*
+    REDIMENSIONNER
+
+    Cette fonction redimensionne une image dans une image destination deja
+    allouee (creer_tableau2d, une vue, etc.), dont la taille determine le 
+    facteur de chaque axe. La source n'est pas modifiee.
+
+    Les filtres bicubique et Lanczos peuvent donner des valeurs legerement
+    hors de [0, 1] pres des contours francs.
+
+    Parametres:
+        - [double**] source        : L'image a redimensionner.
+        - [int     ] nb_lignes     : Le nombre de lignes de la source.
+        - [int     ] nb_colonnes   : Le nombre de colonnes de la source.
+        - [double**] destination   : L'image qui recevra le resultat.
+        - [int     ] lignes_dest   : Le nombre de lignes de la destination.
+        - [int     ] colonnes_dest : Le nombre de colonnes de la destination.
+        - [int     ] filtre        : REDIMENSION_PLUS_PROCHE, REDIMENSION_BILINEAIRE,
+                                     REDIMENSION_BICUBIQUE ou REDIMENSION_LANCZOS3.
+
+    Retour:
+        1 si l'image a ete redimensionnee, 0 si les parametres sont invalides
+        ou si la memoire manque.
+
+    Exemple d'utilisation:
+
+        double** normalisee;
+
+        normalisee = creer_tableau2d(32, 128);
+
+        [ ... pour chaque plaque (une vue) ... ]
+            redimensionner(plaque, nb_lignes, nb_colonnes, normalisee, 32, 128,
+                           REDIMENSION_BICUBIQUE);
+*/
+int redimensionner(double** source, int nb_lignes, int nb_colonnes,
+                   double** destination, int lignes_dest, int colonnes_dest, int filtre);
+
+
+
+/*
+    REDIMENSION_VIDER_CACHE
+
+    Cette procedure libere les tables de poids conservees par le fil courant.
+    Un fil qui a redimensionne des images devrait l'appeler avant de se
+    terminer.
+
+    Retour:
+        Aucun.
+*/
+void redimension_vider_cache(void);
+
+
+#endif
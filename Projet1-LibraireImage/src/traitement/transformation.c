@@ -0,0 +1,303 @@
+/****************************************************************************************
+    TRANSFORMATION.C
+
+    Ce module contient les transformations affines et perspectives. Les deux
+    partagent le meme parcours par tuiles; une transformation affine est une
+    homographie dont la coordonnee homogene vaut toujours 1, ce qui evite la
+    division par pixel.
+****************************************************************************************/
+#include "transformation.h"
+#include "../algebre/matrice_fixe.h"
+#include "../outils/instrumentation.h"
+#include "../outils/parallele.h"
+
+#include <math.h>
+
+
+/****************************************************************************************
+*                               DEFINTION DES CONSTANTES                                *
+****************************************************************************************/
+
+#define VRAI    1
+#define FAUX    0
+
+// Le cote d'une tuile de la destination, en pixels.
+#define TAILLE_TUILE    32
+
+// Le nombre d'inconnues d'une homographie (h22 vaut 1).
+#define NB_INCONNUES    8
+
+
+/*
+    T_TRANSFORMATION
+
+    Une transformation en cours, partagee par les fils.
+*/
+typedef struct
+{
+    double**   source;          // L'image source.
+    int        nb_lignes;
+    int        nb_colonnes;
+    double**   destination;     // L'image destination.
+    int        lignes_dest;
+    int        colonnes_dest;
+    t_matrice3 inverse;         // De la destination vers la source.
+    int        est_affine;      // Vrai si la derniere ligne est 0 0 1.
+    double     fond;            // La valeur hors de la source.
+
+}t_transformation;
+
+
+/****************************************************************************************
+*                           DECLARATION DES FONCTIONS PRIVEES                           *
+****************************************************************************************/
+
+
+/*
+    TRANSFORMER
+
+    Cette fonction inverse la matrice et transforme l'image, par rangees de
+    tuiles reparties sur les fils.
+
+    Parametres:
+        - [t_transformation*] transformation : La transformation, dont 'inverse'
+                                               contient la matrice a inverser.
+
+    Retour: 1 si la matrice est inversible, 0 sinon.
+*/
+static int transformer(t_transformation* transformation);
+
+
+
+/*
+    TRANSFORMER_TUILES
+
+    Cette procedure (de type t_tache) calcule les rangees de tuiles debut a
+    fin - 1 de la destination.
+
+    Parametres:
+        - [void*] donnees : La transformation (t_transformation*).
+        - [int  ] debut   : La premiere rangee de tuiles.
+        - [int  ] fin     : La rangee qui suit la derniere rangee a calculer.
+*/
+static void transformer_tuiles(void* donnees, int debut, int fin);
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PUBLIQUES                            *
+****************************************************************************************/
+int transformer_affine(double** source, int nb_lignes, int nb_colonnes,
+                       double** destination, int lignes_dest, int colonnes_dest,
+                       double** matrice, double fond)
+{
+    t_transformation transformation;    // La transformation a appliquer.
+    int              i, j;              // Iterateurs sur la matrice.
+
+    if(matrice == NULL)
+        return FAUX;
+
+    transformation.source        = source;
+    transformation.nb_lignes     = nb_lignes;
+    transformation.nb_colonnes   = nb_colonnes;
+    transformation.destination   = destination;
+    transformation.lignes_dest   = lignes_dest;
+    transformation.colonnes_dest = colonnes_dest;
+    transformation.est_affine    = VRAI;
+    transformation.fond          = fond;
+
+    // La matrice 2 x 3 est completee par la ligne 0 0 1.
+    for(i = 0; i < 2; i++)
+        for(j = 0; j < 3; j++)
+            transformation.inverse.m[i][j] = matrice[i][j];
+    transformation.inverse.m[2][0] = 0;
+    transformation.inverse.m[2][1] = 0;
+    transformation.inverse.m[2][2] = 1;
+
+    return transformer(&transformation);
+}
+
+
+
+int transformer_perspective(double** source, int nb_lignes, int nb_colonnes,
+                            double** destination, int lignes_dest, int colonnes_dest,
+                            double** matrice, double fond)
+{
+    t_transformation transformation;    // La transformation a appliquer.
+
+    if(matrice == NULL)
+        return FAUX;
+
+    transformation.source        = source;
+    transformation.nb_lignes     = nb_lignes;
+    transformation.nb_colonnes   = nb_colonnes;
+    transformation.destination   = destination;
+    transformation.lignes_dest   = lignes_dest;
+    transformation.colonnes_dest = colonnes_dest;
+    transformation.fond          = fond;
+
+    matrice3_depuis_tableau2d(matrice, &transformation.inverse);
+    transformation.est_affine = transformation.inverse.m[2][0] == 0 &&
+                                transformation.inverse.m[2][1] == 0 &&
+                                transformation.inverse.m[2][2] == 1;
+
+    return transformer(&transformation);
+}
+
+
+
+int calculer_homographie(double source[NB_COINS][2], double destination[NB_COINS][2],
+                         double** matrice)
+{
+    double  a[NB_INCONNUES][NB_INCONNUES];  // Le systeme, sur la pile.
+    double* lignes[NB_INCONNUES];           // Les lignes du systeme, pour le solveur.
+    double  b[NB_INCONNUES];                // Le second membre.
+    double  h[NB_INCONNUES];                // Les coefficients h00 a h21.
+    double  x, y, xp, yp;                   // Un point et son image.
+    int     k;                              // Iterateur sur les points.
+
+    // Chaque point donne deux equations lineaires en h00 ... h21:
+    // h00 x + h01 y + h02 - h20 x x' - h21 y x' = x' (et de meme pour y').
+    for(k = 0; k < NB_COINS; k++)
+    {
+        x  = source[k][0];
+        y  = source[k][1];
+        xp = destination[k][0];
+        yp = destination[k][1];
+
+        lignes[2 * k]     = a[2 * k];
+        lignes[2 * k + 1] = a[2 * k + 1];
+
+        a[2 * k][0] = x;  a[2 * k][1] = y;  a[2 * k][2] = 1;
+        a[2 * k][3] = 0;  a[2 * k][4] = 0;  a[2 * k][5] = 0;
+        a[2 * k][6] = -x * xp;  a[2 * k][7] = -y * xp;
+        b[2 * k]    = xp;
+
+        a[2 * k + 1][0] = 0;  a[2 * k + 1][1] = 0;  a[2 * k + 1][2] = 0;
+        a[2 * k + 1][3] = x;  a[2 * k + 1][4] = y;  a[2 * k + 1][5] = 1;
+        a[2 * k + 1][6] = -x * yp;  a[2 * k + 1][7] = -y * yp;
+        b[2 * k + 1]    = yp;
+    }
+
+    if(!resoudre_systeme(lignes, NB_INCONNUES, b, h))
+        return FAUX;
+
+    matrice[0][0] = h[0];  matrice[0][1] = h[1];  matrice[0][2] = h[2];
+    matrice[1][0] = h[3];  matrice[1][1] = h[4];  matrice[1][2] = h[5];
+    matrice[2][0] = h[6];  matrice[2][1] = h[7];  matrice[2][2] = 1;
+
+    return VRAI;
+}
+
+
+/****************************************************************************************
+*                           DEFINTION DES FONCTIONS PRIVEES                            *
+****************************************************************************************/
+
+
+static int transformer(t_transformation* transformation)
+{
+    if(transformation->source == NULL || transformation->destination == NULL ||
+       transformation->nb_lignes <= 0 || transformation->nb_colonnes <= 0 ||
+       transformation->lignes_dest <= 0 || transformation->colonnes_dest <= 0)
+        return FAUX;
+
+    // Chaque pixel de la destination va chercher sa valeur dans la source.
+    if(!matrice3_inverser(&transformation->inverse, &transformation->inverse))
+        return FAUX;
+
+    INSTRUMENTER_DEBUT(ETAPE_TRANSFORMER);
+
+    parallele_pour((transformation->lignes_dest + TAILLE_TUILE - 1) / TAILLE_TUILE, 1,
+                   transformer_tuiles, transformation);
+
+    INSTRUMENTER_FIN(ETAPE_TRANSFORMER);
+
+    return VRAI;
+}
+
+
+static void transformer_tuiles(void* donnees, int debut, int fin)
+{
+    const t_transformation* t;          // La transformation.
+    const t_matrice3*       h;          // La matrice de la destination vers la source.
+    double* restrict        ligne;      // La ligne de la destination en cours.
+    double  u[TAILLE_TUILE];            // La position source des pixels d'une ligne
+    double  v[TAILLE_TUILE];            // de tuile.
+    double  xs, ys, ws;                 // La position homogene du premier pixel.
+    double  fx, fy;                     // Les parties fractionnaires de la position.
+    double  haut, bas;                  // L'interpolation sur les deux lignes sources.
+    double  x_max, y_max;               // La derniere position interpolable.
+    int     rangee;                     // Iterateur sur les rangees de tuiles.
+    int     ligne_min, ligne_max;       // Les lignes de la tuile.
+    int     colonne_min, largeur;       // Les colonnes de la tuile.
+    int     i, k;                       // Iterateurs sur les lignes et les pixels.
+    int     x0, y0, x1, y1;             // Les quatre voisins d'une position.
+
+    t     = (const t_transformation*) donnees;
+    h     = &t->inverse;
+    x_max = t->nb_colonnes - 1;
+    y_max = t->nb_lignes   - 1;
+
+    for(rangee = debut; rangee < fin; rangee++)
+    {
+        ligne_min = rangee * TAILLE_TUILE;
+        ligne_max = ligne_min + TAILLE_TUILE < t->lignes_dest ? ligne_min + TAILLE_TUILE :
+                                                                 t->lignes_dest;
+
+        for(colonne_min = 0; colonne_min < t->colonnes_dest; colonne_min += TAILLE_TUILE)
+        {
+            largeur = t->colonnes_dest - colonne_min < TAILLE_TUILE ?
+                      t->colonnes_dest - colonne_min : TAILLE_TUILE;
+
+            for(i = ligne_min; i < ligne_max; i++)
+            {
+                ligne = t->destination[i] + colonne_min;
+
+                // La position du premier pixel, puis des pas constants le long
+                // de la ligne (la position homogene est lineaire en x).
+                xs = h->m[0][0] * colonne_min + h->m[0][1] * i + h->m[0][2];
+                ys = h->m[1][0] * colonne_min + h->m[1][1] * i + h->m[1][2];
+                ws = h->m[2][0] * colonne_min + h->m[2][1] * i + h->m[2][2];
+
+                if(t->est_affine)
+                {
+                    for(k = 0; k < largeur; k++)
+                    {
+                        u[k] = xs + k * h->m[0][0];
+                        v[k] = ys + k * h->m[1][0];
+                    }
+                }
+                else
+                {
+                    for(k = 0; k < largeur; k++)
+                    {
+                        u[k] = (xs + k * h->m[0][0]) / (ws + k * h->m[2][0]);
+                        v[k] = (ys + k * h->m[1][0]) / (ws + k * h->m[2][0]);
+                    }
+                }
+
+                // L'interpolation bilineaire des quatre voisins; les positions
+                // hors de la source (ou non finies) recoivent le fond.
+                for(k = 0; k < largeur; k++)
+                {
+                    if(!(u[k] >= 0 && u[k] <= x_max && v[k] >= 0 && v[k] <= y_max))
+                    {
+                        ligne[k] = t->fond;
+                        continue;
+                    }
+
+                    x0 = (int) u[k];
+                    y0 = (int) v[k];
+                    x1 = x0 < t->nb_colonnes - 1 ? x0 + 1 : x0;
+                    y1 = y0 < t->nb_lignes   - 1 ? y0 + 1 : y0;
+                    fx = u[k] - x0;
+                    fy = v[k] - y0;
+
+                    haut = t->source[y0][x0] + fx * (t->source[y0][x1] - t->source[y0][x0]);
+                    bas  = t->source[y1][x0] + fx * (t->source[y1][x1] - t->source[y1][x0]);
+                    ligne[k] = haut + fy * (bas - haut);
+                }
+            }
+        }
+    }
+}
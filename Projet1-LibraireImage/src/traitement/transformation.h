@@ -0,0 +1,138 @@
+/****************************************************************************************
+    TRANSFORMATION.H
+
+    Ce module contient des sous-programmes qui appliquent une transformation
+    geometrique (affine ou perspective) a une image, par exemple pour 
+    redresser une plaque vue de biais en un rectangle.
+
+    Les coordonnees d'un pixel sont (x, y) = (colonne, ligne). La matrice 
+    recue transforme les coordonnees de la source en celles de la destination;
+    elle est inversee une fois, puis chaque pixel de la destination va chercher
+    sa valeur dans la source par interpolation bilineaire. Les pixels dont la
+    position tombe hors de la source recoivent une valeur de fond.
+
+    Les matrices sont des tableaux 2D (voir tableau2d.h): 3 x 3 pour une 
+    homographie, 2 x 3 pour une transformation affine.
+
+    La destination est parcourue par tuiles carrees, pour que les pixels 
+    sources lus restent en cache meme lors d'une rotation, et les rangees de
+    tuiles sont reparties sur plusieurs fils (voir parallele.h). Le long d'une
+    ligne, la position source est obtenue par additions successives plutot 
+    que par un produit matrice-vecteur a chaque pixel.
+
+    Liste des sous-programmes publiques:
+      - transformer_affine      : Applique une matrice affine 2 x 3;
+      - transformer_perspective : Applique une homographie 3 x 3;
+      - calculer_homographie    : L'homographie qui envoie 4 points sur 4 autres.
+
+*****************************************************************************************/
+#ifndef TRANSFORMATION
+#define TRANSFORMATION
+
+
+/****************************************************************************************
+*                               DEFINTION DES CONSTANTES                                *
+****************************************************************************************/
+
+// Le nombre de points qui determinent une homographie.
+#define NB_COINS    4
+
+
+/****************************************************************************************
+*                       DECLARATION DES FONCTIONS PUBLIQUES                             *
+****************************************************************************************/
+
+
+/*
+    TRANSFORMER_AFFINE
+
+    Cette fonction applique une transformation affine a une image:
+    (x', y') = (a00 x + a01 y + a02, a10 x + a11 y + a12).
+
+    Parametres:
+        - [double**] source        : L'image a transformer.
+        - [int     ] nb_lignes     : Le nombre de lignes de la source.
+        - [int     ] nb_colonnes   : Le nombre de colonnes de la source.
+        - [double**] destination   : L'image qui recevra le resultat (deja allouee).
+        - [int     ] lignes_dest   : Le nombre de lignes de la destination.
+        - [int     ] colonnes_dest : Le nombre de colonnes de la destination.
+        - [double**] matrice       : La matrice 2 x 3, de la source vers la destination.
+        - [double  ] fond          : La valeur des pixels hors de la source.
+
+    Retour:
+        1 si l'image a ete transformee, 0 si la matrice n'est pas inversible
+        ou si les parametres sont invalides.
+
+    Exemple d'utilisation (rotation de 5 degres autour de l'origine):
+
+        double** rotation = creer_tableau2d(2, 3);
+
+        rotation[0][0] = cos(a);  rotation[0][1] = -sin(a);  rotation[0][2] = 0;
+        rotation[1][0] = sin(a);  rotation[1][1] =  cos(a);  rotation[1][2] = 0;
+
+        transformer_affine(image, nb_lignes, nb_colonnes, resultat, nb_lignes,
+                           nb_colonnes, rotation, 0.0);
+*/
+int transformer_affine(double** source, int nb_lignes, int nb_colonnes,
+                       double** destination, int lignes_dest, int colonnes_dest,
+                       double** matrice, double fond);
+
+
+
+/*
+    TRANSFORMER_PERSPECTIVE
+
+    Cette fonction applique une homographie a une image: (x', y') = 
+    ((h00 x + h01 y + h02) / w, (h10 x + h11 y + h12) / w), ou 
+    w = h20 x + h21 y + h22.
+
+    Parametres:
+        - [double**] source        : L'image a transformer.
+        - [int     ] nb_lignes     : Le nombre de lignes de la source.
+        - [int     ] nb_colonnes   : Le nombre de colonnes de la source.
+        - [double**] destination   : L'image qui recevra le resultat (deja allouee).
+        - [int     ] lignes_dest   : Le nombre de lignes de la destination.
+        - [int     ] colonnes_dest : Le nombre de colonnes de la destination.
+        - [double**] matrice       : La matrice 3 x 3, de la source vers la destination.
+        - [double  ] fond          : La valeur des pixels hors de la source.
+
+    Retour:
+        1 si l'image a ete transformee, 0 si la matrice n'est pas inversible
+        ou si les parametres sont invalides.
+*/
+int transformer_perspective(double** source, int nb_lignes, int nb_colonnes,
+                            double** destination, int lignes_dest, int colonnes_dest,
+                            double** matrice, double fond);
+
+
+
+/*
+    CALCULER_HOMOGRAPHIE
+
+    Cette fonction calcule l'homographie qui envoie 4 points sur 4 autres, 
+    par exemple les coins d'une plaque vue de biais sur les coins d'un
+    rectangle. Le coefficient h22 vaut 1.
+
+    Parametres:
+        - [double  ] source[][2]      : Les 4 points (x, y) de depart.
+        - [double  ] destination[][2] : Les 4 points (x, y) d'arrivee.
+        - [double**] matrice          : Recoit l'homographie 3 x 3.
+
+    Retour:
+        1 si l'homographie a ete calculee, 0 si trois des points sont alignes.
+
+    Exemple d'utilisation:
+
+        double   coins[NB_COINS][2]     = { ... les coins de la plaque ... };
+        double   rectangle[NB_COINS][2] = { {0, 0}, {127, 0}, {127, 31}, {0, 31} };
+        double** h = creer_tableau2d(3, 3);
+
+        if(calculer_homographie(coins, rectangle, h))
+            transformer_perspective(image, nb_lignes, nb_colonnes, plaque, 32, 128,
+                                    h, 0.0);
+*/
+int calculer_homographie(double source[NB_COINS][2], double destination[NB_COINS][2],
+                         double** matrice);
+
+
+#endif